@@ -123,6 +123,8 @@ SOURCES += main.cpp\
     core/ObservableMsa.cpp \
     core/Seq.cpp \
     core/Subseq.cpp \
+    core/NonGapRunIndex.cpp \
+    core/SubseqChangeRecord.cpp \
     core/UngappedSubseq.cpp \
     core/constants.cpp \
     core/misc.cpp \
@@ -355,7 +357,13 @@ SOURCES += main.cpp\
     gui/wizards/LicenseWizard.cpp \
     gui/Commands/Msa/MoveRowsCommand.cpp \
     gui/forms/dialogs/ConsensusGroupsDialog.cpp \
-    gui/models/ConsensusGroupsModel.cpp
+    gui/models/ConsensusGroupsModel.cpp \
+    core/PackedDnaString.cpp \
+    core/DataSources/Crud/SequenceCodec.cpp \
+    core/DataSources/SqliteAdocCompactor.cpp \
+    core/DataSources/Crud/MultiIdSelect.cpp \
+    core/DataSources/Crud/MultiRowInsert.cpp \
+    core/DataSources/SqliteAdocPrefetcher.cpp
 
 HEADERS  += \
     core/DataMappers/AbstractAnonSeqMapper.h \
@@ -443,10 +451,13 @@ HEADERS  += \
     core/ObservableMsa.h \
     core/Seq.h \
     core/Subseq.h \
+    core/NonGapRunIndex.h \
+    core/SubseqChangeRecord.h \
     core/TreeNode.h \
     core/UngappedSubseq.h \
     core/constants.h \
     core/enums.h \
+    core/GapMatcher.h \
     core/global.h \
     core/macros.h \
     core/metatypes.h \
@@ -579,6 +590,7 @@ HEADERS  += \
     gui/delegates/MsaLineEditDelegate.h \
     gui/MsaTools/MsaToolTypes.h \
     gui/Commands/Msa/AbstractCollapseMsaRectCommand.h \
+    gui/Commands/Msa/AbstractSubseqChangeCommand.h \
     gui/Commands/CommandIds.h \
     core/Services/AbstractProcessWrapper.h \
     core/PODs/BlastDatabaseMetaPod.h \
@@ -747,7 +759,15 @@ HEADERS  += \
     gui/Commands/Msa/MoveRowsCommand.h \
     gui/forms/dialogs/ConsensusGroupsDialog.h \
     gui/models/ConsensusGroupsModel.h \
-    gui/delegates/RegexDelegate.h
+    gui/delegates/RegexDelegate.h \
+    core/PackedDnaString.h \
+    core/DataSources/Crud/SequenceCodec.h \
+    core/DataSources/SqliteAdocCompactor.h \
+    core/DataSources/Crud/MultiIdSelect.h \
+    core/DataSources/Crud/MultiRowInsert.h \
+    core/DataSources/IPrefetchRequest.h \
+    core/DataSources/SqliteAdocPrefetcher.h \
+    core/util/SegmentTree.h
 
 FORMS    += gui/forms/MainWindow.ui \
     gui/forms/SelectGroupNodeDialog.ui \
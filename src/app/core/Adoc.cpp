@@ -25,6 +25,7 @@
 #include "Entities/TransientTask.h"
 #include "Repositories/IRepository.h"
 #include "AdocTreeNode.h"
+#include "constants.h"
 
 
 IncrementNumberGenerator Adoc::temporaryDocumentNumberIncrementor_(0);
@@ -62,6 +63,9 @@ Adoc::Adoc(QObject *parent) : QObject(parent)
     modified_ = false;
     temporary_ = false;
     temporaryDocumentNumber_ = 0;
+
+    connect(&compactor_, SIGNAL(error(QString,QString)), SIGNAL(compactionError(QString,QString)));
+    sqliteAdocSource_.setPrefetcher(&prefetcher_);
 }
 
 /**
@@ -164,6 +168,7 @@ AdocTreeNode *Adoc::entityTree() const
 
 void Adoc::vacuum()
 {
+    waitForCompaction();
     sqliteAdocSource_.vacuum();
 }
 
@@ -385,6 +390,7 @@ bool Adoc::open(const QString &fileName)
     ASSERT(temporary_ == false);
 
     initialize();
+    prefetcher_.open(sqliteAdocSource_.fileName());
 
     // Note: we call the fileName method instead of simply returning the fileName method argument to return a consistent
     // filename that may be retrieved later via the fileName() method.
@@ -410,6 +416,9 @@ void Adoc::close()
     // It is mandatory that repositories are deleted before their corresponding mappers becuase presumably the
     // repository will be calling the mapper instance!
 
+    // Prefetch requests refer to the mappers and therefore must be stopped before any mapper is deleted
+    prefetcher_.stop();
+
     // First order of business: deallocate the entity tree to release any associated entities. This is essential to
     // perform *before* the corresponding repository confirms that all references have been released.
     delete entityTreeRoot_;             entityTreeRoot_ = nullptr;
@@ -439,6 +448,9 @@ void Adoc::close()
     // Finally the MemoryOnlyRepositories
     delete transientTaskRepository_;    transientTaskRepository_ = nullptr;
 
+    // Allow any compaction of this database to complete before closing it
+    waitForCompaction();
+
     if (isOpen())
     {
         sqliteAdocSource_.close();
@@ -480,6 +492,9 @@ bool Adoc::save()
     if (!isOpen())
         return false;
 
+    // Sqlite permits only one writer at a time; therefore, wait for the compaction following the previous save (if any)
+    waitForCompaction();
+
     sqliteAdocSource_.begin();
 
     // Note: it is important to save all the repositories before the entity tree so that any newly added entities
@@ -515,12 +530,25 @@ bool Adoc::save()
     // Yehaw! Let's clean 'er up!
     sqliteAdocSource_.end();
 
-    sqliteAdocSource_.begin();
-    sqliteAdocSource_.removeCruft();
-    sqliteAdocSource_.end();
+    // Any records read ahead before these changes were committed may no longer be current
+    prefetcher_.invalidate();
 
-    // Note: cannot vacuum from within transaction
-    sqliteAdocSource_.vacuum();
+    // Removing cruft and vacuuming (which rewrites the entire file) take the bulk of the time to save a large document
+    // and thus are performed in the background for file databases. In-memory databases are only accessible via this
+    // connection.
+    if (sqliteAdocSource_.fileName() == ":memory:")
+    {
+        sqliteAdocSource_.begin();
+        sqliteAdocSource_.removeCruft();
+        sqliteAdocSource_.end();
+
+        // Note: cannot vacuum from within transaction
+        sqliteAdocSource_.vacuum();
+    }
+    else
+    {
+        compactor_.compact(sqliteAdocSource_.fileName());
+    }
 
     setModified(false);
     return true;
@@ -542,10 +570,12 @@ bool Adoc::saveAs(const QString &fileName)
     //      2.1: Unsaved input memory
     //      2.2: Saved input memory
 
-    if (!sqliteAdocSource_.saveAs(fileName))
-        return false;
-
-    if (!save())
+    // The prefetcher connection must follow the document to its new file
+    waitForCompaction();
+    prefetcher_.stop();
+    bool saved = sqliteAdocSource_.saveAs(fileName) && save();
+    prefetcher_.open(sqliteAdocSource_.fileName());
+    if (!saved)
         return false;
 
     temporary_ = false;
@@ -594,8 +624,10 @@ void Adoc::initializeDDD()
     ASSERT(aminoSeqRepository_ == nullptr);
     astringMapper_ = new AnonSeqMapper<Astring, AstringPod>(adocSource());
     astringRepository_ = new AnonSeqRepository<Astring>(astringMapper_);
-    aminoSeqMapper_ = new AminoSeqMapper(adocSource(), astringRepository_);
+    astringRepository_->setCacheLimit(constants::kRepositoryCacheLimit);
+    aminoSeqMapper_ = new AminoSeqMapper(adocSource(), astringRepository_, astringMapper_);
     aminoSeqRepository_ = new GenericRepository<AminoSeq>(aminoSeqMapper_);
+    aminoSeqRepository_->setCacheLimit(constants::kRepositoryCacheLimit);
 
     ASSERT(aminoMsaMapper_ == nullptr);
     ASSERT(aminoMsaRepository_ == nullptr);
@@ -608,8 +640,10 @@ void Adoc::initializeDDD()
     ASSERT(dnaSeqRepository_ == nullptr);
     dstringMapper_ = new AnonSeqMapper<Dstring, DstringPod>(adocSource());
     dstringRepository_ = new AnonSeqRepository<Dstring>(dstringMapper_);
-    dnaSeqMapper_ = new DnaSeqMapper(adocSource(), dstringRepository_);
+    dstringRepository_->setCacheLimit(constants::kRepositoryCacheLimit);
+    dnaSeqMapper_ = new DnaSeqMapper(adocSource(), dstringRepository_, dstringMapper_);
     dnaSeqRepository_ = new GenericRepository<DnaSeq>(dnaSeqMapper_);
+    dnaSeqRepository_->setCacheLimit(constants::kRepositoryCacheLimit);
 
     ASSERT(dnaMsaMapper_ == nullptr);
     ASSERT(dnaMsaRepository_ == nullptr);
@@ -644,3 +678,18 @@ QString Adoc::temporaryDocumentName() const
 {
     return QString("Untitled-%1").arg(temporaryDocumentNumber_);
 }
+
+/**
+  * Vacuuming a large document may take a considerable amount of time. So that the user is not left with a frozen
+  * window, compactionWaitStarted and compactionWaitFinished are emitted around the wait (but only if a compaction is
+  * actually in progress).
+  */
+void Adoc::waitForCompaction()
+{
+    if (!compactor_.isRunning())
+        return;
+
+    emit compactionWaitStarted(compactor_.fileName());
+    compactor_.wait();
+    emit compactionWaitFinished();
+}
@@ -14,6 +14,8 @@
 
 #include "DataMappers/AnonSeqMapper.h"
 #include "DataMappers/BlastReportMapper.h"
+#include "DataSources/SqliteAdocCompactor.h"
+#include "DataSources/SqliteAdocPrefetcher.h"
 #include "DataSources/SqliteAdocSource.h"
 #include "Repositories/AnonSeqRepository.h"
 #include "Repositories/GenericRepository.h"
@@ -96,6 +98,10 @@ public Q_SLOTS:
 
 Q_SIGNALS:
     void closed();
+    void compactionError(const QString &fileName, const QString &message);  //!< Emitted if the background compaction following a save fails
+    void compactionWaitFinished();                                          //!< Emitted when the wait announced by compactionWaitStarted is over
+    //! Emitted immediately before blocking until the background compaction of fileName has finished
+    void compactionWaitStarted(const QString &fileName);
     void modifiedChanged(bool isModified);
     void opened(const QString &fileName);
 
@@ -104,8 +110,11 @@ private:
     void initializeDDD();
     void loadEntityTree();
     QString temporaryDocumentName() const;
+    void waitForCompaction();               //!< Blocks until any background compaction has finished
 
     SqliteAdocSource sqliteAdocSource_;
+    SqliteAdocCompactor compactor_;
+    SqliteAdocPrefetcher prefetcher_;
     AdocTreeNode *entityTreeRoot_;
 
     AnonSeqMapper<Astring, AstringPod> *astringMapper_;
@@ -23,7 +23,13 @@ AdocTreeNode::AdocTreeNode(const IEntitySPtr &sourceEntity)
     : TreeNode<AdocTreeNode>(),
       loaded_(false),
       entity_(sourceEntity),
-      entityId_(0)
+      entityId_(0),
+      nodeId_(0),
+      savedParentNodeId_(0),
+      savedRow_(0),
+      savedNodeType_(eUndefinedNode),
+      savedEntityId_(0),
+      canFetchChildren_(false)
 {
     ASSERT(sourceEntity);
     nodeType_ = mapNodeType(sourceEntity->type());
@@ -39,7 +45,13 @@ AdocTreeNode::AdocTreeNode(AdocNodeType nodeType, const QString &label, int enti
       nodeType_(nodeType),
       label_(label),
       loaded_(false),
-      entityId_(entityId)
+      entityId_(entityId),
+      nodeId_(0),
+      savedParentNodeId_(0),
+      savedRow_(0),
+      savedNodeType_(eUndefinedNode),
+      savedEntityId_(0),
+      canFetchChildren_(false)
 {
 }
 
@@ -121,6 +133,68 @@ void AdocTreeNode::setEntity(const IEntitySPtr &newEntity)
 }
 
 
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Persistence methods
+/**
+  * @returns bool
+  */
+bool AdocTreeNode::canFetchChildren() const
+{
+    return canFetchChildren_;
+}
+
+/**
+  * Because the tree structure is only known relative to a parent, the caller must provide the current parent node id
+  * and row of this node.
+  *
+  * @param parentNodeId [int]
+  * @param row [int]
+  * @returns bool
+  */
+bool AdocTreeNode::isDirty(int parentNodeId, int row) const
+{
+    return nodeId_ == 0 ||
+            parentNodeId != savedParentNodeId_ ||
+            row != savedRow_ ||
+            nodeType_ != savedNodeType_ ||
+            entityId() != savedEntityId_ ||
+            label_ != savedLabel_;
+}
+
+/**
+  * @param nodeId [int]
+  * @param parentNodeId [int]
+  * @param row [int]
+  */
+void AdocTreeNode::markSaved(int nodeId, int parentNodeId, int row)
+{
+    ASSERT(nodeId > 0);
+    nodeId_ = nodeId;
+    savedParentNodeId_ = parentNodeId;
+    savedRow_ = row;
+    savedNodeType_ = nodeType_;
+    savedLabel_ = label_;
+    savedEntityId_ = entityId();
+}
+
+/**
+  * @returns int
+  */
+int AdocTreeNode::nodeId() const
+{
+    return nodeId_;
+}
+
+/**
+  * @param canFetchChildren [bool]
+  */
+void AdocTreeNode::setCanFetchChildren(bool canFetchChildren)
+{
+    canFetchChildren_ = canFetchChildren;
+}
+
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Public static methods
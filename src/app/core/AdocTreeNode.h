@@ -39,6 +39,17 @@ public:
     void setEntity(const IEntitySPtr &newEntity);
 
 
+    // ------------------------------------------------------------------------------------------------
+    // Persistence methods
+    bool canFetchChildren() const;                  //!< Returns true if this node has children in the data source that have not been read
+    //! Returns true if this node has never been saved or differs from when it was saved as the row'th child of parentNodeId
+    bool isDirty(int parentNodeId, int row) const;
+    //! Records that this node has been saved with nodeId as the row'th child of parentNodeId
+    void markSaved(int nodeId, int parentNodeId, int row);
+    int nodeId() const;                             //!< Returns the data source identifier of this node or 0 if it has not been saved
+    void setCanFetchChildren(bool canFetchChildren);
+
+
     // ------------------------------------------------------------------------------------------------
     // Static public methods
     static AdocNodeType mapNodeType(int typeId);
@@ -57,6 +68,15 @@ private:
     // Private members
     IEntitySPtr entity_;
     int entityId_;
+
+    // State as of the last time this node was read from or saved to the data source
+    int nodeId_;
+    int savedParentNodeId_;
+    int savedRow_;
+    AdocNodeType savedNodeType_;
+    QString savedLabel_;
+    int savedEntityId_;
+    bool canFetchChildren_;
 };
 
 Q_DECLARE_TYPEINFO(AdocTreeNode, Q_MOVABLE_TYPE);
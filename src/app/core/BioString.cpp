@@ -6,9 +6,14 @@
 **
 ****************************************************************************/
 
-#include <QtCore/QCryptographicHash>
+#ifdef __SSE2__
+  #include <emmintrin.h>
+#endif
+
+#include <QtCore/QVarLengthArray>
 
 #include "BioString.h"
+#include "GapMatcher.h"
 #include "constants.h"
 #include "macros.h"
 #include "misc.h"
@@ -23,7 +28,117 @@ static int qRegisterTypes()
 }
 Q_CONSTRUCTOR_FUNCTION(qRegisterTypes)
 
-QByteArray BioString::swapByteArray_;   // Static storage for the slide method
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Character transform kernels
+/**
+  * Builds a 256-entry translation table in which each character of query maps to the corresponding character of
+  * replacement and all other characters map to themselves. If a character occurs more than once in query, the first
+  * occurrence takes precedence.
+  *
+  * @param query [const char *]
+  * @param replacement [const char *]
+  * @param table [unsigned char *]
+  */
+static void buildTranslationTable(const char *query, const char *replacement, unsigned char *table)
+{
+    for (int i=0; i< 256; ++i)
+        table[i] = static_cast<unsigned char>(i);
+
+    for (int i=qstrlen(query) - 1; i>=0; --i)
+        table[static_cast<unsigned char>(query[i])] = static_cast<unsigned char>(replacement[i]);
+}
+
+/**
+  * Copies the n characters beginning at x which are not gaps to y and returns the number of characters copied. x and y
+  * may refer to the same buffer provided that y does not come after x.
+  *
+  * With SSE2, blocks of 16 characters without any gaps are copied as a unit and blocks consisting entirely of gaps are
+  * skipped.
+  *
+  * @param x [const char *]
+  * @param n [int]
+  * @param y [char *]
+  * @returns int
+  */
+static int copyNonGaps(const char *x, int n, char *y)
+{
+    char *start = y;
+    int i = 0;
+    const bool *isGap = characterTables().isGap_;
+
+#ifdef __SSE2__
+    GapMatcher gapMatcher;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i));
+        int gapBits = _mm_movemask_epi8(gapMatcher.gaps(chars));
+        if (gapBits == 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(y), chars);
+            y += 16;
+        }
+        else if (gapBits != 0xFFFF)
+        {
+            for (int j=0; j< 16; ++j)
+            {
+                *y = x[i + j];
+                y += !isGap[static_cast<unsigned char>(x[i + j])];
+            }
+        }
+    }
+#endif
+
+    for (; i< n; ++i)
+    {
+        *y = x[i];
+        y += !isGap[static_cast<unsigned char>(x[i])];
+    }
+
+    return y - start;
+}
+
+/**
+  * @param x [const char *]
+  * @param n [int]
+  * @returns bool
+  */
+static bool onlyACGT(const char *x, int n)
+{
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128i a = _mm_set1_epi8('A');
+    const __m128i c = _mm_set1_epi8('C');
+    const __m128i g = _mm_set1_epi8('G');
+    const __m128i t = _mm_set1_epi8('T');
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i));
+        __m128i isACGT = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, a), _mm_cmpeq_epi8(chars, c)),
+                                      _mm_or_si128(_mm_cmpeq_epi8(chars, g), _mm_cmpeq_epi8(chars, t)));
+        if (_mm_movemask_epi8(isACGT) != 0xFFFF)
+            return false;
+    }
+#endif
+
+    for (; i< n; ++i)
+    {
+        switch (x[i])
+        {
+        case 'A':
+        case 'C':
+        case 'G':
+        case 'T':
+            continue;
+
+        default:
+            return false;
+        }
+    }
+
+    return true;
+}
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -432,17 +547,21 @@ ClosedIntRange BioString::collapseRight(const ClosedIntRange &range)
 BioString BioString::complement() const
 {
     BioString dna(*this, eDnaGrammar);
-    dna.tr("ABCDGHKMTVabcdghkmtv", "TVGHCDMKABtvghcdmkab");
+    const unsigned char *table = characterTables().complement_;
+    unsigned char *x = reinterpret_cast<unsigned char *>(dna.data());
+    for (int i=0, z=dna.length(); i<z; ++i)
+        x[i] = table[x[i]];
 
     return dna;
 }
 
 /**
   * @returns QByteArray
+  * @see hash128()
   */
 QByteArray BioString::digest() const
 {
-    return QCryptographicHash::hash(asByteArray(), QCryptographicHash::Md5);
+    return ::hash128(constData(), length());
 }
 
 /**
@@ -628,10 +747,13 @@ BioString &BioString::insertGaps(int position, int nGaps, char gapChar)
     if (nGaps < 1)
         return *this;
 
-    QByteArray gap;
-    gap.resize(1);
-    gap[0] = gapChar;
-    QByteArray::insert(position - 1, gap.repeated(nGaps));
+    // Open the gaps in place rather than building and inserting a temporary gap string. The capacity grows
+    // geometrically, thus repeated insertions into the same row (e.g. while dragging gap columns) rarely reallocate.
+    int oldLength = length();
+    resize(oldLength + nGaps);
+    char *x = data() + position - 1;
+    memmove(x + nGaps, x, oldLength - position + 1);
+    memset(x, gapChar, nGaps);
 
     return *this;
 }
@@ -816,22 +938,7 @@ bool BioString::onlyContainsACGT() const
     if (isEmpty())
         return false;
 
-    for (const char *x = constData(); *x; ++x)
-    {
-        switch (*x)
-        {
-        case 'A':
-        case 'C':
-        case 'G':
-        case 'T':
-            continue;
-
-        default:
-            return false;
-        }
-    }
-
-    return true;
+    return onlyACGT(constData(), length());
 }
 
 /**
@@ -845,23 +952,7 @@ bool BioString::onlyContainsACGT(const ClosedIntRange &range) const
 
     ASSERT_X(isValidRange(range), "Invalid range");
 
-    const char *x = constData() + range.begin_ - 1;
-    for (int i=range.begin_; i<= range.end_; ++i, ++x)
-    {
-        switch (*x)
-        {
-        case 'A':
-        case 'C':
-        case 'G':
-        case 'T':
-            continue;
-
-        default:
-            return false;
-        }
-    }
-
-    return true;
+    return onlyACGT(constData() + range.begin_ - 1, range.length());
 }
 
 /**
@@ -922,17 +1013,8 @@ BioString &BioString::remove(const ClosedIntRange &range)
   */
 BioString &BioString::removeGaps()
 {
-    int nNonGaps = 0;
-    for (char *x = data(), *y = x; *x; ++x)
-    {
-        if (!::isGapCharacter(*x))
-        {
-            *y = *x;
-            ++y;
-            ++nNonGaps;
-        }
-    }
-    resize(nNonGaps);
+    char *x = data();
+    resize(copyNonGaps(x, length(), x));
 
     return *this;
 }
@@ -970,6 +1052,39 @@ BioString &BioString::removeGaps(int position, int nGaps)
     return *this;
 }
 
+/**
+  * Equivalent to calling removeGaps(position, nGaps) for each range in gapRanges in reverse order; however, the
+  * characters are compacted in one pass rather than shifting the trailing data once per range. Each range must consist
+  * entirely of gap characters and gapRanges must be sorted in ascending order with no overlapping ranges.
+  *
+  * @param gapRanges [const QVector<ClosedIntRange> &]
+  * @returns BioString &
+  */
+BioString &BioString::removeGaps(const QVector<ClosedIntRange> &gapRanges)
+{
+    if (gapRanges.isEmpty())
+        return *this;
+
+    char *x = data();
+    char *y = x + gapRanges.first().begin_ - 1;
+    for (int i=0, z=gapRanges.size(); i<z; ++i)
+    {
+        const ClosedIntRange &gapRange = gapRanges.at(i);
+        ASSERT_X(gapRange.begin_ >= 1 && gapRange.end_ <= length(), "gapRange out of range");
+        ASSERT_X(i == 0 || gapRange.begin_ > gapRanges.at(i-1).end_, "gapRanges must be sorted and non-overlapping");
+        ASSERT(gapRange.length() == gapsBetween(gapRange));
+
+        // Copy the characters between this gap range and the next one (or the end of the sequence)
+        int nextBegin = (i + 1 < z) ? gapRanges.at(i+1).begin_ : length() + 1;
+        int nCharsToKeep = nextBegin - gapRange.end_ - 1;
+        memmove(y, x + gapRange.end_, nCharsToKeep);
+        y += nCharsToKeep;
+    }
+    resize(y - x);
+
+    return *this;
+}
+
 /**
   * An amount of zero, behaves identically to an insert.
   *
@@ -1040,12 +1155,22 @@ BioString &BioString::reverse()
 }
 
 /**
+  * Complements and reverses the sequence in a single pass.
+  *
   * @returns BioString
   */
 BioString BioString::reverseComplement() const
 {
-    BioString dna = complement();
-    dna.reverse();
+    int l = length();
+    BioString dna(eDnaGrammar);
+    dna.resize(l);
+
+    const unsigned char *table = characterTables().complement_;
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(constData());
+    unsigned char *y = reinterpret_cast<unsigned char *>(dna.data());
+    for (int i=0, j=l-1; i<l; ++i, --j)
+        y[i] = table[x[j]];
+
     return dna;
 }
 
@@ -1106,7 +1231,8 @@ void BioString::setGrammar(Grammar grammar)
   * slide(9, 11, 2) -> 0, unchanged sequence
   * slide(9, 10, 2) -> 1, sequence = ABC--D-E-F-GH
   *
-  * NOTE: This method is not thread safe because it utilizes a global static swap byte array.
+  * The displaced gaps are held in a per-call buffer (on the stack for small deltas), so that distinct BioStrings may
+  * be slid concurrently.
   *
   * @param range [const ClosedIntRange &]
   * @param delta [int]
@@ -1117,7 +1243,7 @@ int BioString::slide(const ClosedIntRange &range, int delta)
     ASSERT_X(range.begin_ >= 1 && range.begin_ <= length(), "range.begin_ out of range");
     ASSERT_X(range.end_ >= range.begin_ && range.end_ <= length(), "range.end_ out of range");
 
-    char *swapBuffer = swapByteArray_.data();
+    QVarLengthArray<char, 256> swapBuffer;
 
     int actualDelta = 0;                  // Stores the distance (in characters) segment was successfully moved
     if (delta < 0)  // Slide to the left
@@ -1126,12 +1252,8 @@ int BioString::slide(const ClosedIntRange &range, int delta)
         if (actualDelta)
         {
             char *source = data() + range.begin_ - 1;
-            if (actualDelta > swapByteArray_.size())
-            {
-                swapByteArray_.resize(actualDelta);
-                swapBuffer = swapByteArray_.data();
-            }
-            char *swap = swapBuffer;
+            swapBuffer.resize(actualDelta);
+            char *swap = swapBuffer.data();
 
             // A. Get the exact gap representation to the left of the range to be slided
             memcpy(swap, source - actualDelta, actualDelta);
@@ -1149,12 +1271,8 @@ int BioString::slide(const ClosedIntRange &range, int delta)
         if (actualDelta)
         {
             char *source = data() + range.begin_ - 1;
-            if (actualDelta > swapByteArray_.size())
-            {
-                swapByteArray_.resize(actualDelta);
-                swapBuffer = swapByteArray_.data();
-            }
-            char *swap = swapBuffer;
+            swapBuffer.resize(actualDelta);
+            char *swap = swapBuffer.data();
 
             // A. Get the exact gap representation to the right of the range to be slided
             memcpy(swap, source + range.length(), actualDelta);
@@ -1226,22 +1344,12 @@ BioString &BioString::tr(const char *query, const char *replacement)
     checkString(replacement);
 #endif
 
-    int l = qstrlen(query);
+    unsigned char table[256];
+    buildTranslationTable(query, replacement, table);
 
-    char *x = data();
-    while (*x)
-    {
-        for (int i=0; i<l; ++i)
-        {
-            if (*x == query[i])
-            {
-                *x = replacement[i];
-                break;  // Only break out of the innermost for loop
-            }
-        }
-
-        ++x;
-    }
+    unsigned char *x = reinterpret_cast<unsigned char *>(data());
+    for (int i=0, z=length(); i<z; ++i)
+        x[i] = table[x[i]];
 
     return *this;
 }
@@ -1271,9 +1379,26 @@ BioString &BioString::translateGaps(char gapChar)
 {
     ASSERT_X(gapChar >= MIN_ASCII_VAL && gapChar <= MAX_ASCII_VAL, "gapChar out of range");
 
-    for (char *x = data(); *x; ++x)
-        if (::isGapCharacter(*x))
-            *x = gapChar;
+    char *x = data();
+    int n = length();
+    int i = 0;
+
+#ifdef __SSE2__
+    GapMatcher gapMatcher;
+    const __m128i replacement = _mm_set1_epi8(gapChar);
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i));
+        __m128i isGap = gapMatcher.gaps(chars);
+        chars = _mm_or_si128(_mm_and_si128(isGap, replacement), _mm_andnot_si128(isGap, chars));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(x + i), chars);
+    }
+#endif
+
+    const bool *isGap = characterTables().isGap_;
+    for (; i< n; ++i)
+        if (isGap[static_cast<unsigned char>(x[i])])
+            x[i] = gapChar;
 
     return *this;
 }
@@ -1285,20 +1410,7 @@ BioString BioString::ungapped() const
 {
     BioString result(grammar_);
     result.resize(length());
-
-    char *y = result.data();
-    const char *x = constData();
-    while (*x)
-    {
-        if (!::isGapCharacter(*x))
-        {
-            *y = *x;
-            ++y;
-        }
-        ++x;
-    }
-    *y = '\0';
-    result.resize(qstrlen(result.constData()));
+    result.resize(copyNonGaps(constData(), length(), result.data()));
 
     return result;
 }
@@ -98,7 +98,7 @@ public:
     ClosedIntRange collapseLeft(const ClosedIntRange &range);                   //!< Collapses all characters in range to the left and returns the range of columns changed or empty if none were changed
     ClosedIntRange collapseRight(const ClosedIntRange &range);                  //!< Collapses all characters in range to the right and returns the range of columns changed or empty if none were changed
     BioString complement() const;                                               //!< Returns the DNA complement
-    QByteArray digest() const;                                                  //!< Returns the Md5 sequence digest of this BioString
+    QByteArray digest() const;                                                  //!< Returns the 128-bit sequence digest of this BioString (see hash128)
     int gapsBetween(const ClosedIntRange &range) const;                         //!< Returns the number of gaps in range
     int gapsLeftOf(int position) const;                                         //!< Returns the number of contiguous gap characters to the left of the character at position
     int gapsRightOf(int position) const;                                        //!< Returns the number of contiguous gap characters to the right of the character at position
@@ -125,6 +125,7 @@ public:
     BioString &remove(const ClosedIntRange &range);                             //!< Removes the characters in range and returns a reference to this object
     BioString &removeGaps();                                                    //!< Removes all gaps from the sequence and returns a reference to this object
     BioString &removeGaps(int position, int nGaps);                             //!< Remove up to nGaps contiguous gaps beginning with the gap at position, if the character at position is a gap and return a reference to this object
+    BioString &removeGaps(const QVector<ClosedIntRange> &gapRanges);            //!< Removes the ordered, non-overlapping gapRanges in a single pass and returns a reference to this object
     BioString &replace(int position, int amount, const BioString &bioString);   //!< Replace amount character starting from position (1-based) with bioString and return a reference to this object
     BioString &replace(const ClosedIntRange &range, const BioString &bioString);//!< Replace the characters in range with bioString and return a reference to this object
     BioString &replace(const BioString &before, const BioString &after);        //!< Replace all occurrences of the BioString, before, with the BioString, after, and return a reference to this object
@@ -224,8 +225,6 @@ private:
     void safeSlideLeft(const ClosedIntRange &range, int delta);                 //!< Helper method to slideViaSwap
     void safeSlideRight(const ClosedIntRange &range, int delta);                //!< Helper method to slideViaSwap
 
-    static QByteArray swapByteArray_;   // Static storage for the slide method
-
     friend class TestBioString;
 };
 
@@ -7,21 +7,70 @@
 ****************************************************************************/
 
 #include "CharCountDistribution.h"
+#include "global.h"
 #include "macros.h"
 #include "misc.h"
 
 #include <QtDebug>
 
+const int CharCountDistribution::kDenseSize;
+
+// Characters whose counts are stored in the dense array; the index of each character is its slot within a column
+static const char kDenseCharacters[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ-.*";
+static const int kNumberDenseCharacters = sizeof(kDenseCharacters) - 1;
+
+/**
+  * Maps each character to its dense slot or -1 if it is not stored densely. The single instance returned by
+  * denseIndexTable() is fully built by its constructor.
+  */
+struct DenseIndexTable
+{
+    DenseIndexTable()
+    {
+        ASSERT(kNumberDenseCharacters <= CharCountDistribution::kDenseSize);
+        for (int i=0; i< 256; ++i)
+            index_[i] = -1;
+        for (int i=0; i< kNumberDenseCharacters; ++i)
+            index_[static_cast<unsigned char>(kDenseCharacters[i])] = i;
+    }
+
+    signed char index_[256];
+};
+
+/**
+  * @returns const signed char *
+  */
+static const signed char *denseIndexTable()
+{
+    static const DenseIndexTable table;
+    return table.index_;
+}
+
+/**
+  * Builds the dense index table during static initialization (see initializeCharacterTables in misc.cpp).
+  *
+  * @returns int
+  */
+static int initializeDenseIndexTable()
+{
+    denseIndexTable();
+    return 0;
+}
+Q_CONSTRUCTOR_FUNCTION(initializeDenseIndexTable)
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Constructor and destructor
 /**
-  * @param charCounts [const ListHashCharInt &]
+  * @param charCounts [const VectorHashCharInt &]
   * @param divisor [int]
   */
 CharCountDistribution::CharCountDistribution(const VectorHashCharInt &charCounts, int divisor)
-    : charCounts_(charCounts), divisor_(divisor)
+    : divisor_(divisor)
 {
+    resizeColumns(charCounts.size());
+    for (int i=0, z=charCounts.size(); i<z; ++i)
+        addHashCharInt(i, charCounts.at(i));
 }
 
 
@@ -29,6 +78,9 @@ CharCountDistribution::CharCountDistribution(const VectorHashCharInt &charCounts
 // ------------------------------------------------------------------------------------------------
 // Operators
 /**
+  * Because a dense count is always zero when its character is not a key, comparing the raw storage is equivalent to
+  * comparing the hash representations.
+  *
   * @param other [const CharCountDistribution &]
   * @returns bool
   */
@@ -37,7 +89,9 @@ bool CharCountDistribution::operator==(const CharCountDistribution &other) const
     if (this == &other)
         return true;
 
-    return charCounts_ == other.charCounts_ &&
+    return denseKeys_ == other.denseKeys_ &&
+            denseCounts_ == other.denseCounts_ &&
+            sparseCounts_ == other.sparseCounts_ &&
             divisor_ == other.divisor_;
 }
 
@@ -75,19 +129,7 @@ bool CharCountDistribution::operator!=(const CharCountDistribution &other) const
   */
 void CharCountDistribution::add(const CharCountDistribution &otherCharCountDistribution, int offset)
 {
-    ASSERT_X(offset > 0 && offset <= length(), "offset out of range");
-    ASSERT_X(offset + otherCharCountDistribution.length() - 1 <= length(), "offset + otherCharCountDistribution - 1 exceeded distribution length");
-
-    const VectorHashCharInt otherCharCounts = otherCharCountDistribution.charCounts();
-    for (int i=0, z=otherCharCounts.size(); i<z; ++i)
-    {
-        const QHash<char, int> &otherHash = otherCharCounts.at(i);
-        QHash<char, int> &thisHash = charCounts_[offset + i - 1];
-
-        QHash<char, int>::ConstIterator it;
-        for (it = otherHash.constBegin(); it != otherHash.constEnd(); ++it)
-            thisHash[it.key()] += it.value();
-    }
+    addDistribution(otherCharCountDistribution, offset, 1);
 }
 
 /**
@@ -97,23 +139,7 @@ void CharCountDistribution::add(const CharCountDistribution &otherCharCountDistr
   */
 void CharCountDistribution::add(const QByteArray &characters, char skipChar, int offset)
 {
-    ASSERT_X(offset > 0 && offset <= length(), "offset out of range");
-    ASSERT_X(offset + characters.length() - 1 <= length(), "offset + characters.length() - 1 exceeded distribution length");
-
-    const char *x = characters.constData();
-
-    // Small optimization
-    if (skipChar == '\0')
-    {
-        for (int i=offset-1; *x; ++i, ++x)
-            ++charCounts_[i][*x];
-    }
-    else // Count all characters regardless
-    {
-        for (int i=offset-1; *x; ++i, ++x)
-            if (*x != skipChar)
-                ++charCounts_[i][*x];
-    }
+    addCharacters(characters, skipChar, offset, 1);
 }
 
 /**
@@ -121,20 +147,34 @@ void CharCountDistribution::add(const QByteArray &characters, char skipChar, int
   */
 bool CharCountDistribution::allColumnsAreEmpty() const
 {
-    VectorHashCharInt::ConstIterator it = charCounts_.constBegin();
-    for (; it != charCounts_.constEnd(); ++it)
-        if ((*it).isEmpty() == false)
+    for (int i=0, z=length(); i<z; ++i)
+        if (denseKeys_.at(i) != 0 || !sparseCounts_.at(i).isEmpty())
             return false;
 
     return true;
 }
 
 /**
+  * Only the columns within range are converted, which is considerably faster than converting all columns when range
+  * is small relative to the length.
+  *
+  * @param range [const ClosedIntRange &]
   * @returns VectorHashCharInt
   */
-VectorHashCharInt CharCountDistribution::charCounts() const
+VectorHashCharInt CharCountDistribution::charCounts(const ClosedIntRange &range) const
 {
-    return charCounts_;
+    ASSERT_X(range.isEmpty() || (range.begin_ > 0 && range.begin_ <= length()), "range.begin_ out of range");
+    ASSERT_X(range.isEmpty() || (range.end_ > 0 && range.end_ <= length()), "range.end_ out of range");
+
+    ClosedIntRange actualRange = range;
+    if (range.isEmpty())
+        actualRange = ClosedIntRange(1, length());
+
+    VectorHashCharInt charCounts(actualRange.length());
+    for (int i=actualRange.begin_ - 1, j=0; i< actualRange.end_; ++i, ++j)
+        charCounts[j] = columnCharCounts(i);
+
+    return charCounts;
 }
 
 /**
@@ -147,12 +187,34 @@ VectorHashCharDouble CharCountDistribution::charPercents(const ClosedIntRange &r
     ASSERT_X(range.isEmpty() || (range.end_ > 0 && range.end_ <= length()), "range.end_ out of range");
     ASSERT_X(range.begin_ <= range.end_ || range.isEmpty(), "invalid range");
 
-    if (charCounts_.isEmpty())
+    if (length() == 0)
         return VectorHashCharDouble();
-    else if (range.isEmpty())
-        return ::divideVectorHashCharInt(charCounts_, divisor_);
-    else
-        return ::divideVectorHashCharInt(charCounts_.mid(range.begin_ - 1, range.length()), divisor_);
+
+    ASSERT_X(divisor_ != 0, "divisor may not be zero");
+
+    ClosedIntRange actualRange = range;
+    if (range.isEmpty())
+        actualRange = ClosedIntRange(1, length());
+
+    qreal divisor = static_cast<qreal>(divisor_);
+    VectorHashCharDouble charPercents(actualRange.length());
+    for (int i=actualRange.begin_ - 1, j=0; i< actualRange.end_; ++i, ++j)
+    {
+        QHash<char, double> &percents = charPercents[j];
+
+        const int *counts = denseCounts_.constData() + i * kDenseSize;
+        quint32 keys = denseKeys_.at(i);
+        for (int k=0; keys != 0; ++k, keys >>= 1)
+            if (keys & 1)
+                percents.insert(kDenseCharacters[k], static_cast<qreal>(counts[k]) / divisor);
+
+        const HashCharInt &sparseCounts = sparseCounts_.at(i);
+        HashCharInt::ConstIterator it = sparseCounts.constBegin();
+        for (; it != sparseCounts.constEnd(); ++it)
+            percents.insert(it.key(), static_cast<qreal>(it.value()) / divisor);
+    }
+
+    return charPercents;
 }
 
 /**
@@ -184,7 +246,9 @@ void CharCountDistribution::insertBlanks(int position, int count)
     ASSERT_X(position > 0 && position <= length()+1, "position out of range");
     ASSERT(count >= 0);
 
-    charCounts_.insert(position-1, count, HashCharInt());
+    denseCounts_.insert((position - 1) * kDenseSize, count * kDenseSize, 0);
+    denseKeys_.insert(position - 1, count, 0);
+    sparseCounts_.insert(position - 1, count, HashCharInt());
 }
 
 /**
@@ -192,7 +256,7 @@ void CharCountDistribution::insertBlanks(int position, int count)
   */
 int CharCountDistribution::length() const
 {
-    return charCounts_.size();
+    return denseKeys_.size();
 }
 
 /**
@@ -203,9 +267,15 @@ CharCountDistribution CharCountDistribution::mid(const ClosedIntRange &range) co
 {
     ASSERT(range.isEmpty() == false);
     ASSERT(range.begin_ > 0 && range.begin_ <= range.end_);
-    ASSERT(range.end_ <= charCounts_.size());
+    ASSERT(range.end_ <= length());
+
+    CharCountDistribution slice;
+    slice.denseCounts_ = denseCounts_.mid((range.begin_ - 1) * kDenseSize, range.length() * kDenseSize);
+    slice.denseKeys_ = denseKeys_.mid(range.begin_ - 1, range.length());
+    slice.sparseCounts_ = sparseCounts_.mid(range.begin_ - 1, range.length());
+    slice.divisor_ = divisor_;
 
-    return CharCountDistribution(charCounts_.mid(range.begin_ - 1, range.length()), divisor_);
+    return slice;
 }
 
 
@@ -232,7 +302,9 @@ void CharCountDistribution::remove(int position, int count)
     ASSERT_X(count >= 0, "count out of range");
     ASSERT_X(position + count - 1 <= length(), "position + count (inclusive) exceeded distribution length");
 
-    charCounts_.remove(position-1, count);
+    denseCounts_.remove((position - 1) * kDenseSize, count * kDenseSize);
+    denseKeys_.remove(position - 1, count);
+    sparseCounts_.remove(position - 1, count);
 }
 
 /**
@@ -255,11 +327,24 @@ void CharCountDistribution::removeZeroValueKeys(int from, int to)
     int actualFrom = (from == 0) ? 1 : from;
     int actualTo = (to == 0) ? length() : to;
 
-    for (int i=actualFrom; i<= actualTo; ++i)
+    for (int i=actualFrom-1; i< actualTo; ++i)
     {
-         QMutableHashIterator<char, int> it(charCounts_[i-1]);
-         while (it.findNext(0))
-             it.remove();
+        quint32 keys = denseKeys_.at(i);
+        if (keys != 0)
+        {
+            const int *counts = denseCounts_.constData() + i * kDenseSize;
+            for (int k=0; k< kNumberDenseCharacters; ++k)
+                if (counts[k] == 0)
+                    keys &= ~(1u << k);
+            denseKeys_[i] = keys;
+        }
+
+        if (!sparseCounts_.at(i).isEmpty())
+        {
+            QMutableHashIterator<char, int> it(sparseCounts_[i]);
+            while (it.findNext(0))
+                it.remove();
+        }
     }
 }
 
@@ -271,6 +356,51 @@ void CharCountDistribution::setDivisor(int divisor)
     divisor_ = divisor;
 }
 
+/**
+  * Characters with a zero count and gap characters are not keys of the resulting column. This is equivalent to
+  * constructing the column from the corresponding HashCharInt without building the hash.
+  *
+  * Because each column occupies distinct storage, multiple threads may set distinct columns simultaneously provided
+  * that this distribution is neither copied nor otherwise modified in the meantime.
+  *
+  * @param position [int]
+  * @param histogram [const int *]
+  */
+void CharCountDistribution::setColumnHistogram(int position, const int *histogram)
+{
+    ASSERT_X(position > 0 && position <= length(), "position out of range");
+    ASSERT(histogram != nullptr);
+
+    const signed char *denseIndex = denseIndexTable();
+    const bool *isGap = characterTables().isGap_;
+    int *counts = denseCounts_.data() + (position - 1) * kDenseSize;
+    quint32 keys = 0;
+    HashCharInt &sparseCounts = sparseCounts_[position - 1];
+
+    for (int k=0; k< kDenseSize; ++k)
+        counts[k] = 0;
+    sparseCounts.clear();
+
+    for (int ch=0; ch< 256; ++ch)
+    {
+        if (histogram[ch] == 0 || isGap[ch])
+            continue;
+
+        int slot = denseIndex[ch];
+        if (slot >= 0)
+        {
+            counts[slot] = histogram[ch];
+            keys |= 1u << slot;
+        }
+        else
+        {
+            sparseCounts.insert(static_cast<char>(ch), histogram[ch]);
+        }
+    }
+
+    denseKeys_[position - 1] = keys;
+}
+
 /**
   * Subtracts the character count values in otherCharCountDistribution to this distribution beginning at
   * offset (1-based).
@@ -292,18 +422,60 @@ void CharCountDistribution::setDivisor(int divisor)
   * @param offset [int]
   */
 void CharCountDistribution::subtract(const CharCountDistribution &otherCharCountDistribution, int offset)
+{
+    addDistribution(otherCharCountDistribution, offset, -1);
+}
+
+/**
+  * @param characters [const QByteArray &]
+  * @param skipChar [char]
+  * @param offset [int]
+  */
+void CharCountDistribution::subtract(const QByteArray &characters, char skipChar, int offset)
+{
+    addCharacters(characters, skipChar, offset, -1);
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  * The dense counts of both distributions are laid out identically, so the dense portion reduces to a single loop
+  * over contiguous integers.
+  *
+  * @param otherCharCountDistribution [const CharCountDistribution &]
+  * @param offset [int]
+  * @param sign [int]
+  */
+void CharCountDistribution::addDistribution(const CharCountDistribution &otherCharCountDistribution, int offset, int sign)
 {
     ASSERT_X(offset > 0 && offset <= length(), "offset out of range");
     ASSERT_X(offset + otherCharCountDistribution.length() - 1 <= length(), "offset + otherCharCountDistribution - 1 exceeded distribution length");
+    ASSERT(sign == 1 || sign == -1);
+
+    int otherLength = otherCharCountDistribution.length();
+
+    const int *y = otherCharCountDistribution.denseCounts_.constData();
+    int *x = denseCounts_.data() + (offset - 1) * kDenseSize;
+    for (int i=0, z=otherLength * kDenseSize; i<z; ++i)
+        x[i] += sign * y[i];
+
+    const quint32 *otherKeys = otherCharCountDistribution.denseKeys_.constData();
+    quint32 *keys = denseKeys_.data() + offset - 1;
+    for (int i=0; i< otherLength; ++i)
+        keys[i] |= otherKeys[i];
 
-    const VectorHashCharInt otherCharCounts = otherCharCountDistribution.charCounts();
-    for (int i=0, z=otherCharCounts.size(); i<z; ++i)
+    for (int i=0; i< otherLength; ++i)
     {
-        const QHash<char, int> &otherHash = otherCharCounts.at(i);
-        QHash<char, int> &thisHash = charCounts_[offset + i - 1];
-        QHash<char, int>::const_iterator it;
+        const HashCharInt &otherHash = otherCharCountDistribution.sparseCounts_.at(i);
+        if (otherHash.isEmpty())
+            continue;
+
+        HashCharInt &thisHash = sparseCounts_[offset + i - 1];
+        HashCharInt::ConstIterator it;
         for (it = otherHash.constBegin(); it != otherHash.constEnd(); ++it)
-            thisHash[it.key()] -= it.value();
+            thisHash[it.key()] += sign * it.value();
     }
 }
 
@@ -311,23 +483,86 @@ void CharCountDistribution::subtract(const CharCountDistribution &otherCharCount
   * @param characters [const QByteArray &]
   * @param skipChar [char]
   * @param offset [int]
+  * @param sign [int]
   */
-void CharCountDistribution::subtract(const QByteArray &characters, char skipChar, int offset)
+void CharCountDistribution::addCharacters(const QByteArray &characters, char skipChar, int offset, int sign)
 {
     ASSERT_X(offset > 0 && offset <= length(), "offset out of range");
     ASSERT_X(offset + characters.length() - 1 <= length(), "offset + characters.length() - 1 exceeded distribution length");
+    ASSERT(sign == 1 || sign == -1);
 
+    const signed char *denseIndex = denseIndexTable();
+    int *counts = denseCounts_.data() + (offset - 1) * kDenseSize;
+    quint32 *keys = denseKeys_.data() + offset - 1;
+
+    // Because the loop terminates at the null character, a skipChar of '\0' never matches and every character is
+    // counted
     const char *x = characters.constData();
-    // Small optimization
-    if (skipChar == '\0')
+    for (int i=offset-1; *x; ++i, ++x, counts += kDenseSize, ++keys)
     {
-        for (int i=offset-1; *x; ++i, ++x)
-            --charCounts_[i][*x];
+        if (*x == skipChar)
+            continue;
+
+        int slot = denseIndex[static_cast<unsigned char>(*x)];
+        if (slot >= 0)
+        {
+            counts[slot] += sign;
+            *keys |= 1u << slot;
+        }
+        else
+        {
+            sparseCounts_[i][*x] += sign;
+        }
     }
-    else
+}
+
+/**
+  * @param column [int]
+  * @param hashCharInt [const HashCharInt &]
+  */
+void CharCountDistribution::addHashCharInt(int column, const HashCharInt &hashCharInt)
+{
+    const signed char *denseIndex = denseIndexTable();
+    int *counts = denseCounts_.data() + column * kDenseSize;
+    HashCharInt::ConstIterator it = hashCharInt.constBegin();
+    for (; it != hashCharInt.constEnd(); ++it)
     {
-        for (int i=offset-1; *x; ++i, ++x)
-            if (*x != skipChar)
-                --charCounts_[i][*x];
+        int slot = denseIndex[static_cast<unsigned char>(it.key())];
+        if (slot >= 0)
+        {
+            counts[slot] += it.value();
+            denseKeys_[column] |= 1u << slot;
+        }
+        else
+        {
+            sparseCounts_[column][it.key()] += it.value();
+        }
     }
 }
+
+/**
+  * @param column [int]
+  * @returns HashCharInt
+  */
+HashCharInt CharCountDistribution::columnCharCounts(int column) const
+{
+    HashCharInt hashCharInt = sparseCounts_.at(column);
+
+    const int *counts = denseCounts_.constData() + column * kDenseSize;
+    quint32 keys = denseKeys_.at(column);
+    for (int k=0; keys != 0; ++k, keys >>= 1)
+        if (keys & 1)
+            hashCharInt.insert(kDenseCharacters[k], counts[k]);
+
+    return hashCharInt;
+}
+
+/**
+  * @param columns [int]
+  */
+void CharCountDistribution::resizeColumns(int columns)
+{
+    denseCounts_.fill(0, columns * kDenseSize);
+    denseKeys_.fill(0, columns);
+    sparseCounts_.fill(HashCharInt(), columns);
+}
@@ -10,24 +10,31 @@
 #define CHARCOUNTDISTRIBUTION_H
 
 #include <QtCore/QByteArray>
+#include <QtCore/QVector>
 #include "util/ClosedIntRange.h"
 #include "types.h"
 
 /**
   * CharCountDistribution encapsulates the manipulation of a character count distribution which is represented by a
-  * ListHashCharInt (see global.h).
+  * VectorHashCharInt (see types.h).
   *
-  * CharCountDistribution merely wraps a ListHashCharInt and provides useful methods for tweaking its contents. It does
-  * not produce any such raw distribution data - this must be supplied upon construction.
+  * CharCountDistribution stores a set of character counts for each column and provides useful methods for tweaking its
+  * contents. It does not produce any such raw distribution data - this must be supplied upon construction.
   *
   * Specifically, methods are provided for adding and subtracting other character count distributions with respect
   * to this distribution. Additionally, blanks - empty character counts for one or more columns - may be added to the
   * distribution as well as removal of any columns.
   *
+  * Internally, the counts for the most common characters (the upper case letters, the gap characters, and '*') are
+  * stored in one contiguous array of kDenseSize integers per column that is indexed via a lookup table. This avoids
+  * hashing and memory allocation when adding and subtracting. Counts for any other character are kept in a per-column
+  * QHash. The charCounts() method converts this data into the equivalent VectorHashCharInt on demand.
+  *
   * Note: It is possible to have hash keys with a value of 0. This typically would result from adding or subtracting
   *       another distribution. In essence, this is functionally the same thing as not having this key at all; however,
   *       no care is taken to automatically remove these keys because 1) it requires additional code that carries no
-  *       significant benefit and 2) it may be desired in some user cases.
+  *       significant benefit and 2) it may be desired in some user cases. To preserve this behavior with the dense
+  *       representation, a bit mask records which dense characters are keys in each column.
   *
   *       The removeZeroValueKeys method is a convenience method for removing all keys that have a zero value if it is
   *       desired to not have these present.
@@ -50,7 +57,8 @@ public:
     void add(const CharCountDistribution &otherCharCountDistribution, int offset = 1);      //!< Adds otherCharCountDistribution to this distribution at the specified offset (1-based)
     void add(const QByteArray &characters, char skipChar = '\0', int offset = 1);           //!< Adds all characters except skipChar (if non-zero) beginning at offset to the distribution
     bool allColumnsAreEmpty() const;                                                        //!< Returns true if every column is empty; false otherwise
-    VectorHashCharInt charCounts() const;                                                   //!< Returns a copy of the raw character count structure
+    //! Returns a copy of the raw character count structure spanning range (all columns if range is empty)
+    VectorHashCharInt charCounts(const ClosedIntRange &range = ClosedIntRange()) const;
     //! Transform the character counts spanning range (all columns if range is empty) into percentages and return a vector with this information
     VectorHashCharDouble charPercents(const ClosedIntRange &range = ClosedIntRange()) const;
     int divisor() const;                                                                    //!< Returns the divisor for this distribution
@@ -60,11 +68,31 @@ public:
     void remove(int position, int count = 1);                                               //!< Removes count entries from the distribution starting at the given position index (1-based)
     void removeZeroValueKeys(int from = 0, int to = 0);                                     //!< Iterates through all values in each column between from and to and removes those keys that have 0 for their value; if both from and to are 0, then analyzes every column; if only from is non-zero, then analyzes all columns of from to length()
     void setDivisor(int divisor);                                                           //!< Sets the divisor value
+    //! Replaces the counts of the column at position (1-based) with the 256 non-gap character counts in histogram (indexed by unsigned char)
+    void setColumnHistogram(int position, const int *histogram);
     void subtract(const CharCountDistribution &otherCharCountDistribution, int offset = 1); //!< Subtracts otherCharCountDistribution from this distribution at the specified offset (1-based)
     void subtract(const QByteArray &characters, char skipChar = '\0', int offset = 1);      //!< Subtracts all characters except skipChar (if non-zero) beginning at offset from the distribution
 
+    // ------------------------------------------------------------------------------------------------
+    // Public constants
+    static const int kDenseSize = 32;                                                       //!< Number of characters with dense storage in each column
+
 private:
-    VectorHashCharInt charCounts_;
+    // ------------------------------------------------------------------------------------------------
+    // Private methods
+    //! Adds sign * each character count in otherCharCountDistribution to this distribution at offset (1-based)
+    void addDistribution(const CharCountDistribution &otherCharCountDistribution, int offset, int sign);
+    void addCharacters(const QByteArray &characters, char skipChar, int offset, int sign);  //!< Adds sign to the count of each character except skipChar beginning at offset (1-based)
+    void addHashCharInt(int column, const HashCharInt &hashCharInt);                        //!< Adds the counts in hashCharInt to column (0-based)
+    HashCharInt columnCharCounts(int column) const;                                         //!< Returns the character counts of column (0-based) as a hash
+    void resizeColumns(int columns);                                                        //!< Resets the internal storage to columns blank columns
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Private members
+    QVector<int> denseCounts_;                  //!< kDenseSize counts per column
+    QVector<quint32> denseKeys_;                //!< Bit mask per column of the dense characters that are keys
+    QVector<HashCharInt> sparseCounts_;         //!< Counts of all other characters per column
     int divisor_;
 };
 
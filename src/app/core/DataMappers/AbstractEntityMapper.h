@@ -31,6 +31,9 @@ public:
     using IEntityMapper<T>::find;
     T *find(const int id) const;
 
+    QFuture<void> prefetch(const QVector<int> &ids) const;
+    void readAhead(IAdocSource *adocSource, const QVector<int> &ids, int generation) const;
+
     using IEntityMapper<T>::save;
     bool save(T *entity) const;
 
@@ -136,6 +139,31 @@ T *AbstractEntityMapper<T, PodT>::find(const int id) const
     return this->find(ids).first();
 }
 
+/**
+  * Default implementation does not support prefetching and returns a canceled future.
+  *
+  * @param ids [const QVector<int> &]
+  * @returns QFuture<void>
+  */
+template<typename T, typename PodT>
+inline
+QFuture<void> AbstractEntityMapper<T, PodT>::prefetch(const QVector<int> & /* ids */) const
+{
+    return QFuture<void>();
+}
+
+/**
+  * @param adocSource [IAdocSource *]
+  * @param ids [const QVector<int> &]
+  * @param generation [int]
+  */
+template<typename T, typename PodT>
+inline
+void AbstractEntityMapper<T, PodT>::readAhead(IAdocSource * /* adocSource */, const QVector<int> & /* ids */, int /* generation */) const
+{
+    // Empty stub - base class method does nothing
+}
+
 /**
   * @param entity [T *]
   * @returns bool
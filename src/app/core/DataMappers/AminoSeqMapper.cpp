@@ -16,9 +16,10 @@
 /**
   * @param adocSource [IAdocSource *]
   * @param astringRepository [AnonSeqRepository<Astring> *]
+  * @param astringMapper [IEntityMapper<Astring> *]
   */
-AminoSeqMapper::AminoSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Astring> *astringRepository) :
-    GenericEntityMapper<AminoSeq, AminoSeqPod>(adocSource), astringRepository_(astringRepository)
+AminoSeqMapper::AminoSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Astring> *astringRepository, IEntityMapper<Astring> *astringMapper) :
+    GenericEntityMapper<AminoSeq, AminoSeqPod>(adocSource), astringRepository_(astringRepository), astringMapper_(astringMapper)
 {
 }
 
@@ -80,3 +81,23 @@ QVector<AminoSeq *> AminoSeqMapper::convertPodsToEntities(QVector<AminoSeqPod> &
 
     return aminoSeqs;
 }
+
+/**
+  * Reads ahead the astrings referenced by pods so that converting them into entities does not need to wait on the
+  * data store either.
+  *
+  * @param adocSource [IAdocSource *]
+  * @param pods [const QVector<AminoSeqPod> &]
+  * @param generation [int]
+  */
+void AminoSeqMapper::readAheadDependencies(IAdocSource *adocSource, const QVector<AminoSeqPod> &pods, int generation) const
+{
+    QVector<int> astringIds;
+    astringIds.reserve(pods.size());
+    foreach (const AminoSeqPod &pod, pods)
+        if (pod.isNull() == false)
+            astringIds << pod.astringId_;
+
+    if (astringIds.size() > 0)
+        astringMapper_->readAhead(adocSource, astringIds, generation);
+}
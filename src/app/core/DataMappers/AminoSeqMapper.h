@@ -19,17 +19,19 @@ class Astring;
 class AminoSeqMapper : public GenericEntityMapper<AminoSeq, AminoSeqPod>
 {
 public:
-    AminoSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Astring> *astringRepository);
+    AminoSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Astring> *astringRepository, IEntityMapper<Astring> *astringMapper);
 
     bool save(const QVector<AminoSeq *> &aminoSeqs) const;
 
 
 protected:
     virtual QVector<AminoSeq *> convertPodsToEntities(QVector<AminoSeqPod> &pods) const;
+    virtual void readAheadDependencies(IAdocSource *adocSource, const QVector<AminoSeqPod> &pods, int generation) const;
 
 
 private:
     AnonSeqRepository<Astring> *astringRepository_;
+    IEntityMapper<Astring> *astringMapper_;     //!< Reads ahead astrings on the prefetching thread, which may not access astringRepository_
 };
 
 #endif // AMINOSEQMAPPER_H
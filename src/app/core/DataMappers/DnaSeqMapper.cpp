@@ -16,9 +16,10 @@
 /**
   * @param adocSource [IAdocSource *]
   * @param dstringRepository [AnonSeqRepository<Dstring> *]
+  * @param dstringMapper [IEntityMapper<Dstring> *]
   */
-DnaSeqMapper::DnaSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Dstring> *dstringRepository) :
-    GenericEntityMapper<DnaSeq, DnaSeqPod>(adocSource), dstringRepository_(dstringRepository)
+DnaSeqMapper::DnaSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Dstring> *dstringRepository, IEntityMapper<Dstring> *dstringMapper) :
+    GenericEntityMapper<DnaSeq, DnaSeqPod>(adocSource), dstringRepository_(dstringRepository), dstringMapper_(dstringMapper)
 {
 }
 
@@ -73,3 +74,23 @@ QVector<DnaSeq *> DnaSeqMapper::convertPodsToEntities(QVector<DnaSeqPod> &pods)
 
     return dnaSeqs;
 }
+
+/**
+  * Reads ahead the dstrings referenced by pods so that converting them into entities does not need to wait on the
+  * data store either.
+  *
+  * @param adocSource [IAdocSource *]
+  * @param pods [const QVector<DnaSeqPod> &]
+  * @param generation [int]
+  */
+void DnaSeqMapper::readAheadDependencies(IAdocSource *adocSource, const QVector<DnaSeqPod> &pods, int generation) const
+{
+    QVector<int> dstringIds;
+    dstringIds.reserve(pods.size());
+    foreach (const DnaSeqPod &pod, pods)
+        if (pod.isNull() == false)
+            dstringIds << pod.dstringId_;
+
+    if (dstringIds.size() > 0)
+        dstringMapper_->readAhead(adocSource, dstringIds, generation);
+}
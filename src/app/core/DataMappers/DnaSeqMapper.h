@@ -19,15 +19,17 @@ class Dstring;
 class DnaSeqMapper : public GenericEntityMapper<DnaSeq, DnaSeqPod>
 {
 public:
-    DnaSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Dstring> *dstringRepository);
+    DnaSeqMapper(IAdocSource *adocSource, AnonSeqRepository<Dstring> *dstringRepository, IEntityMapper<Dstring> *dstringMapper);
 
     bool save(const QVector<DnaSeq *> &dnaSeqs) const;
 
 protected:
     virtual QVector<DnaSeq *> convertPodsToEntities(QVector<DnaSeqPod> &pods) const;
+    virtual void readAheadDependencies(IAdocSource *adocSource, const QVector<DnaSeqPod> &pods, int generation) const;
 
 private:
     AnonSeqRepository<Dstring> *dstringRepository_;
+    IEntityMapper<Dstring> *dstringMapper_;     //!< Reads ahead dstrings on the prefetching thread, which may not access dstringRepository_
 };
 
 #endif // DNASEQMAPPER_H
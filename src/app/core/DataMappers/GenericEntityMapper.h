@@ -9,15 +9,28 @@
 #ifndef GENERICENTITYMAPPER_H
 #define GENERICENTITYMAPPER_H
 
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
 #include "AbstractEntityMapper.h"
 #include "../DataSources/IAdocSource.h"
+#include "../DataSources/IPrefetchRequest.h"
 #include "../global.h"
 
+/**
+  * GenericEntityMapper reads and writes entities via the crud of its adoc source that corresponds to T.
+  *
+  * Records may be read ahead of time on a background thread via prefetch. The resulting pods are held until they are
+  * requested by find or until they are no longer current with respect to the adoc source's prefetch generation.
+  * Subclasses that depend on other records to construct their entities (e.g. the astrings of amino seqs) should
+  * reimplement readAheadDependencies to read those as well.
+  */
 template<typename T, typename PodT>
 class GenericEntityMapper : public AbstractEntityMapper<T, PodT>
 {
 public:
-    GenericEntityMapper(IAdocSource *adocSource) : AbstractEntityMapper<T, PodT>(adocSource) {}
+    GenericEntityMapper(IAdocSource *adocSource) : AbstractEntityMapper<T, PodT>(adocSource), prefetchGeneration_(0) {}
 
     virtual bool erase(const QVector<T *> &entities) const
     {
@@ -45,12 +58,31 @@ public:
         }
     }
 
+    // Only those ids that have not been prefetched are read from the adoc source
     virtual QVector<T *> find(const QVector<int> &ids) const
     {
         try
         {
+            QVector<PodT> pods = takePrefetchedPods(ids);
+            QVector<int> idsNotPrefetched;
+            QVector<int> indicesOfIdsNotPrefetched;
+            for (int i=0, z=pods.size(); i<z; ++i)
+            {
+                if (pods.at(i).isNull())
+                {
+                    idsNotPrefetched << ids.at(i);
+                    indicesOfIdsNotPrefetched << i;
+                }
+            }
+
             AbstractEntityMapper<T, PodT>::adocSource_->begin();
-            QVector<PodT> pods = AbstractEntityMapper<T, PodT>::adocSource_->crud(static_cast<T *>(nullptr))->read(ids);
+            if (idsNotPrefetched.size() > 0)
+            {
+                QVector<PodT> readPods = AbstractEntityMapper<T, PodT>::adocSource_->crud(static_cast<T *>(nullptr))->read(idsNotPrefetched);
+                ASSERT(readPods.size() == idsNotPrefetched.size());
+                for (int i=0, z=readPods.size(); i<z; ++i)
+                    pods[indicesOfIdsNotPrefetched.at(i)] = readPods.at(i);
+            }
             QVector<T *> entities = this->convertPodsToEntities(pods);
             AbstractEntityMapper<T, PodT>::adocSource_->end();
 
@@ -62,6 +94,36 @@ public:
         }
     }
 
+    virtual QFuture<void> prefetch(const QVector<int> &ids) const
+    {
+        if (ids.isEmpty())
+            return QFuture<void>();
+
+        IAdocSource *adocSource = AbstractEntityMapper<T, PodT>::adocSource_;
+        return adocSource->prefetch(new PrefetchRequest(this, ids, adocSource->prefetchGeneration()));
+    }
+
+    virtual void readAhead(IAdocSource *adocSource, const QVector<int> &ids, int generation) const
+    {
+        QVector<PodT> pods = adocSource->crud(static_cast<T *>(nullptr))->read(ids);
+
+        {
+            QMutexLocker locker(&prefetchMutex_);
+            if (generation < prefetchGeneration_)
+                return;
+
+            if (generation > prefetchGeneration_ || prefetchedPods_.size() + pods.size() > kMaxPrefetchedPods)
+                prefetchedPods_.clear();
+            prefetchGeneration_ = generation;
+
+            foreach (const PodT &pod, pods)
+                if (pod.isNull() == false)
+                    prefetchedPods_.insert(pod.id_, pod);
+        }
+
+        readAheadDependencies(adocSource, pods, generation);
+    }
+
     virtual bool save(const QVector<T *> &entities) const
     {
         try
@@ -74,6 +136,63 @@ public:
             return false;
         }
     }
+
+
+protected:
+    // Called on the prefetching thread after pods have been read ahead; does nothing by default
+    virtual void readAheadDependencies(IAdocSource * /* adocSource */, const QVector<PodT> & /* pods */, int /* generation */) const
+    {
+    }
+
+
+private:
+    class PrefetchRequest : public IPrefetchRequest
+    {
+    public:
+        PrefetchRequest(const GenericEntityMapper<T, PodT> *entityMapper, const QVector<int> &ids, int generation)
+            : entityMapper_(entityMapper), ids_(ids), generation_(generation)
+        {
+        }
+
+        void run(IAdocSource *adocSource)
+        {
+            entityMapper_->readAhead(adocSource, ids_, generation_);
+        }
+
+    private:
+        const GenericEntityMapper<T, PodT> *entityMapper_;
+        QVector<int> ids_;
+        int generation_;
+    };
+
+    // Returns the current prefetched pod for each id (or a null pod if there is none) and releases them
+    QVector<PodT> takePrefetchedPods(const QVector<int> &ids) const
+    {
+        QVector<PodT> pods(ids.size());
+
+        QMutexLocker locker(&prefetchMutex_);
+        if (prefetchedPods_.isEmpty())
+            return pods;
+
+        if (prefetchGeneration_ != AbstractEntityMapper<T, PodT>::adocSource_->prefetchGeneration())
+        {
+            prefetchedPods_.clear();
+            return pods;
+        }
+
+        for (int i=0, z=ids.size(); i<z; ++i)
+            pods[i] = prefetchedPods_.value(ids.at(i));
+        foreach (int id, ids)
+            prefetchedPods_.remove(id);
+
+        return pods;
+    }
+
+    static const int kMaxPrefetchedPods = 10000;        // Bounds the memory held by pods that are never found
+
+    mutable QMutex prefetchMutex_;
+    mutable QHash<int, PodT> prefetchedPods_;           // {id => pod}; guarded by prefetchMutex_
+    mutable int prefetchGeneration_;                    // Generation of prefetchedPods_; guarded by prefetchMutex_
 };
 
 #endif // GENERICENTITYMAPPER_H
@@ -9,6 +9,7 @@
 #ifndef IENTITYMAPPER_H
 #define IENTITYMAPPER_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QVector>
 
 class IAdocSource;
@@ -32,6 +33,13 @@ public:
     virtual T *find(const int id) const = 0;
     virtual QVector<T *> find(const QVector<int> &ids) const = 0;
 
+    // Asynchronously reads the records for ids so that a later find of the same ids need not wait on the data store.
+    // Prefetching is only a hint; the returned future finishes once the records have been read (or discarded).
+    virtual QFuture<void> prefetch(const QVector<int> &ids) const = 0;
+    // Called on the prefetching thread to read the records for ids (and any records they depend upon) from
+    // adocSource, which is specific to that thread. Must not access any entities or repositories.
+    virtual void readAhead(IAdocSource *adocSource, const QVector<int> &ids, int generation) const = 0;
+
     virtual bool save(T *entity) const = 0;
     virtual bool save(const QVector<T *> &entities) const = 0;
     // Trigger method for properly uninitializing entity. This may entail such things as removing from other
@@ -15,7 +15,7 @@
 #include "IMsaMapper.h"
 #include "../DataSources/IAdocSource.h"
 #include "../Repositories/GenericRepository.h"
-#include "../Entities/AbstractMsa.h"    // For MsaMembersPod, see loadAlignmentStep
+#include "../Entities/AbstractMsa.h"    // For MsaMembersPod, see beginLoadAlignment
 #include "../ObservableMsa.h"
 #include "../Subseq.h"
 #include "../global.h"
@@ -47,7 +47,11 @@ public:
 
         loadRequest_.msaEntity_ = msaEntity;
         loadRequest_.msa_ = new ObservableMsa(msaEntity->grammar());
-        loadRequest_.memberCount_ = GenericEntityMapper<T, PodT>::adocSource_->crud(msaEntity)->countMembers(msaEntity->id());
+
+        // The member rows are small relative to their sequences and thus are read with a single query up front. Only
+        // the sequences are read incrementally by loadAlignmentStep.
+        loadRequest_.membersPod_ = GenericEntityMapper<T, PodT>::adocSource_->crud(msaEntity)->readMsaMembers(msaEntity->id(), 0, -1);
+        loadRequest_.memberCount_ = loadRequest_.membersPod_.seqIds_.size();
 
         // Return total number of sequences to load
         return loadRequest_.memberCount_;
@@ -71,6 +75,7 @@ public:
         loadRequest_.msaEntity_ = nullptr;
         loadRequest_.msa_ = nullptr;
         loadRequest_.memberCount_ = 0;
+        loadRequest_.membersPod_ = MsaMembersPod();
     }
 
     virtual int loadAlignmentStep(int stepsToTake)
@@ -80,21 +85,24 @@ public:
         ASSERT(stepsToTake != 0);
         ASSERT(loadRequest_.msa_ != nullptr);
 
-        // TODO: Wrap in a try/catch block
         int currentStep = loadRequest_.msa_->subseqCount();
-        MsaMembersPod pod = GenericEntityMapper<T, PodT>::adocSource_->crud(static_cast<T *>(nullptr))->readMsaMembers(
-                    loadRequest_.msaEntity_->id(),
-                    currentStep,
-                    stepsToTake);
+        int remainingSteps = loadRequest_.memberCount_ - currentStep;
+        int nSteps = (stepsToTake < 0) ? remainingSteps : qMin(stepsToTake, remainingSteps);
+        const MsaMembersPod &pod = loadRequest_.membersPod_;
+
+        // Read the sequences of the following step in the background while this step is processed
+        if (stepsToTake > 0 && nSteps < remainingSteps)
+            seqRepository_->prefetch(pod.seqIds_.mid(currentStep + nSteps, stepsToTake));
 
-        QVector<typename SeqT::SPtr> seqEntities = seqRepository_->find(pod.seqIds_);
-        ASSERT(seqEntities.size() == pod.gappedSequences_.size());
+        // The seq repository reads all sequences that are not already loaded in bulk
+        QVector<typename SeqT::SPtr> seqEntities = seqRepository_->find(pod.seqIds_.mid(currentStep, nSteps));
+        ASSERT(seqEntities.size() == nSteps);
 
         for (int i=0, z=seqEntities.size(); i<z; ++i)
         {
             ASSERT(seqEntities.at(i) != nullptr);
             QScopedPointer<Subseq> subseq(new Subseq(seqEntities.at(i)->abstractAnonSeq()->seq_));
-            if (!subseq->setBioString(pod.gappedSequences_.at(i)) ||
+            if (!subseq->setGapRunEncoding(pod.gapRunEncodings_.at(currentStep + i)) ||
                 !loadRequest_.msa_->append(subseq.data()))
             {
                 clearLoadData();        // De-allocates the msa and its subseqs; unfinds the subseq entities
@@ -184,6 +192,7 @@ private:
         ObservableMsa *msa_;
         T *msaEntity_;
         int memberCount_;
+        MsaMembersPod membersPod_;              // All members of msaEntity_ in order
 
         LoadAlignmentRequest() : msa_(nullptr), msaEntity_(nullptr), memberCount_(0)
         {
@@ -201,6 +210,7 @@ private:
 
             msaEntity_ = nullptr;
             memberCount_ = 0;
+            membersPod_ = MsaMembersPod();
         }
     };
     LoadAlignmentRequest loadRequest_;
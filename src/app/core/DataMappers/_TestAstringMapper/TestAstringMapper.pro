@@ -21,6 +21,7 @@ SOURCES += TestAstringMapper.cpp \
            ../../Entities/DnaSeq.cpp \
            ../../DataSources/AbstractDbSource.cpp \
            ../../DataSources/SqliteAdocSource.cpp \
+           ../../DataSources/SqliteAdocPrefetcher.cpp \
            ../../BioString.cpp \
            ../../Seq.cpp \
            ../../UngappedSubseq.cpp \
@@ -29,6 +30,9 @@ SOURCES += TestAstringMapper.cpp \
            ../../MpttNode.cpp \
            ../../MpttTreeConverter.cpp \
            ../../DataSources/Crud/DbAstringCrud.cpp \
+           ../../DataSources/Crud/SequenceCodec.cpp \
+           ../../DataSources/Crud/MultiIdSelect.cpp \
+           ../../DataSources/Crud/MultiRowInsert.cpp \
            ../../DataSources/Crud/DbAminoSeqCrud.cpp \
            ../../DataSources/Crud/DbDstringCrud.cpp \
            ../../DataSources/Crud/DbDnaSeqCrud.cpp
@@ -6,8 +6,11 @@
 **
 ****************************************************************************/
 
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
 #include <QtTest/QtTest>
 
+#include "../../DataSources/SqliteAdocPrefetcher.h"
 #include "../../DataSources/SqliteAdocSource.h"
 #include "../GenericEntityMapper.h"
 #include "../../Entities/Astring.h"
@@ -19,8 +22,30 @@ class TestGenericEntityMapper : public QObject
 private slots:
     void construction();
     void insertion();
+    void readAhead();
+    void readAheadGeneration();
+    void prefetch();
 };
 
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Helper functions
+// Removes the astring with id via a separate connection so that any result must have been read ahead
+static bool deleteAstring(int id)
+{
+    bool deleted = false;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", "TestGenericEntityMapper");
+        database.setDatabaseName("test.db");
+        if (database.open())
+            deleted = QSqlQuery(database).exec(QString("DELETE FROM astrings WHERE id = %1").arg(id));
+        database.close();
+    }
+    QSqlDatabase::removeDatabase("TestGenericEntityMapper");
+
+    return deleted;
+}
+
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 // Actual test functions
@@ -55,6 +80,164 @@ void TestGenericEntityMapper::insertion()
     QFile::remove("test.db");
 }
 
+void TestGenericEntityMapper::readAhead()
+{
+    if (QFile::exists("test.db"))
+        QFile::remove("test.db");
+
+    SqliteAdocSource source;
+    source.createAndOpen("test.db");
+    QVERIFY(source.isOpen());
+
+    GenericEntityMapper<Astring, AstringPod> astringMapper(&source);
+
+    Astring *astring = new Astring(::newEntityId<Astring>(), Seq("ABCDEF", eAminoGrammar));
+    QVERIFY(astringMapper.save(QVector<Astring *>() << astring));
+    int id = astring->id();
+    delete astring;
+
+    // Test: read ahead pods are returned by find even though the record no longer exists
+    source.begin();
+    astringMapper.readAhead(&source, QVector<int>() << id, source.prefetchGeneration());
+    source.end();
+    QVERIFY(deleteAstring(id));
+
+    astring = astringMapper.find(QVector<int>() << id).first();
+    QVERIFY(astring != nullptr);
+    QCOMPARE(astring->id(), id);
+    QCOMPARE(astring->seq_.asByteArray(), QByteArray("ABCDEF"));
+    delete astring;
+
+    // Test: prefetched pods are released once they have been found
+    astring = astringMapper.find(QVector<int>() << id).first();
+    QVERIFY(astring == nullptr);
+
+    // Test: ids that have not been read ahead are read from the source
+    astring = new Astring(::newEntityId<Astring>(), Seq("GHIKL", eAminoGrammar));
+    QVERIFY(astringMapper.save(QVector<Astring *>() << astring));
+    int id2 = astring->id();
+    delete astring;
+
+    source.begin();
+    astringMapper.readAhead(&source, QVector<int>() << id2, source.prefetchGeneration());
+    source.end();
+    astring = new Astring(::newEntityId<Astring>(), Seq("MNPQ", eAminoGrammar));
+    QVERIFY(astringMapper.save(QVector<Astring *>() << astring));
+    int id3 = astring->id();
+    delete astring;
+
+    QVector<Astring *> astrings = astringMapper.find(QVector<int>() << id3 << id2);
+    QCOMPARE(astrings.size(), 2);
+    QVERIFY(astrings.at(0) != nullptr);
+    QCOMPARE(astrings.at(0)->id(), id3);
+    QCOMPARE(astrings.at(0)->seq_.asByteArray(), QByteArray("MNPQ"));
+    QVERIFY(astrings.at(1) != nullptr);
+    QCOMPARE(astrings.at(1)->id(), id2);
+    QCOMPARE(astrings.at(1)->seq_.asByteArray(), QByteArray("GHIKL"));
+    qDeleteAll(astrings);
+
+    source.close();
+    QFile::remove("test.db");
+}
+
+void TestGenericEntityMapper::readAheadGeneration()
+{
+    if (QFile::exists("test.db"))
+        QFile::remove("test.db");
+
+    SqliteAdocSource source;
+    source.createAndOpen("test.db");
+    QVERIFY(source.isOpen());
+
+    // The prefetcher thread is not needed to track generations
+    SqliteAdocPrefetcher prefetcher;
+    source.setPrefetcher(&prefetcher);
+    QCOMPARE(source.prefetchGeneration(), 0);
+
+    GenericEntityMapper<Astring, AstringPod> astringMapper(&source);
+
+    Astring *astring = new Astring(::newEntityId<Astring>(), Seq("ABCDEF", eAminoGrammar));
+    QVERIFY(astringMapper.save(QVector<Astring *>() << astring));
+    int id = astring->id();
+    delete astring;
+
+    // Test: pods read in a previous generation are discarded
+    int generation = source.prefetchGeneration();
+    source.begin();
+    astringMapper.readAhead(&source, QVector<int>() << id, generation);
+    source.end();
+    prefetcher.invalidate();
+    QCOMPARE(source.prefetchGeneration(), generation + 1);
+    QVERIFY(deleteAstring(id));
+
+    astring = astringMapper.find(QVector<int>() << id).first();
+    QVERIFY(astring == nullptr);
+
+    // Test: a request submitted before the invalidation is ignored when it completes afterwards
+    astring = new Astring(::newEntityId<Astring>(), Seq("GHIKL", eAminoGrammar));
+    QVERIFY(astringMapper.save(QVector<Astring *>() << astring));
+    int id2 = astring->id();
+    delete astring;
+
+    source.begin();
+    astringMapper.readAhead(&source, QVector<int>() << id2, source.prefetchGeneration());
+    astringMapper.readAhead(&source, QVector<int>() << id2, generation);
+    source.end();
+    QVERIFY(deleteAstring(id2));
+
+    astring = astringMapper.find(QVector<int>() << id2).first();
+    QVERIFY(astring != nullptr);
+    QCOMPARE(astring->seq_.asByteArray(), QByteArray("GHIKL"));
+    delete astring;
+
+    source.setPrefetcher(nullptr);
+    source.close();
+    QFile::remove("test.db");
+}
+
+void TestGenericEntityMapper::prefetch()
+{
+    if (QFile::exists("test.db"))
+        QFile::remove("test.db");
+
+    SqliteAdocSource source;
+    source.createAndOpen("test.db");
+    QVERIFY(source.isOpen());
+
+    GenericEntityMapper<Astring, AstringPod> astringMapper(&source);
+
+    Astring *astring = new Astring(::newEntityId<Astring>(), Seq("ABCDEF", eAminoGrammar));
+    QVERIFY(astringMapper.save(QVector<Astring *>() << astring));
+    int id = astring->id();
+    delete astring;
+
+    // Test: without a prefetcher, requests are discarded
+    QVERIFY(astringMapper.prefetch(QVector<int>() << id).isCanceled());
+
+    // Test: with a prefetcher, the records are read on its thread
+    SqliteAdocPrefetcher prefetcher;
+    source.setPrefetcher(&prefetcher);
+    QVERIFY(prefetcher.open("test.db"));
+
+    QFuture<void> future = astringMapper.prefetch(QVector<int>() << id);
+    future.waitForFinished();
+    QVERIFY(future.isCanceled() == false);
+
+    // Test: the source connection survives the prefetcher opening its own connection to the same file
+    QVERIFY(source.isOpen());
+    QVERIFY(deleteAstring(id));
+
+    astring = astringMapper.find(QVector<int>() << id).first();
+    QVERIFY(astring != nullptr);
+    QCOMPARE(astring->seq_.asByteArray(), QByteArray("ABCDEF"));
+    delete astring;
+
+    prefetcher.stop();
+    source.setPrefetcher(nullptr);
+    source.close();
+    QFile::remove("test.db");
+}
+
 
 QTEST_APPLESS_MAIN(TestGenericEntityMapper)
 #include "TestGenericEntityMapper.moc"
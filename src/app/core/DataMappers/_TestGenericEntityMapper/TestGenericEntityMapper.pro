@@ -23,9 +23,12 @@ SOURCES += TestGenericEntityMapper.cpp \
            ../../Entities/Dstring.cpp \
            ../../DataSources/AbstractDbSource.cpp \
            ../../DataSources/SqliteAdocSource.cpp \
+           ../../DataSources/SqliteAdocPrefetcher.cpp \
            ../../BioString.cpp \
            ../../Seq.cpp \
            ../../Subseq.cpp \
+           ../../NonGapRunIndex.cpp \
+           ../../SubseqChangeRecord.cpp \
            ../../Msa.cpp \
            ../../UngappedSubseq.cpp \
            ../../MpttNode.cpp \
@@ -33,6 +36,9 @@ SOURCES += TestGenericEntityMapper.cpp \
            ../../misc.cpp \
            ../../constants.cpp \
            ../../DataSources/Crud/DbAstringCrud.cpp \
+           ../../DataSources/Crud/SequenceCodec.cpp \
+           ../../DataSources/Crud/MultiIdSelect.cpp \
+           ../../DataSources/Crud/MultiRowInsert.cpp \
            ../../DataSources/Crud/DbAminoSeqCrud.cpp \
            ../../DataSources/Crud/DbAminoMsaCrud.cpp \
            ../../DataSources/Crud/DbDstringCrud.cpp \
@@ -10,6 +10,7 @@
 #define ABSTRACTADOCSOURCE_H
 
 #include "IAdocSource.h"
+#include "IPrefetchRequest.h"
 #include "../macros.h"
 
 class AbstractAdocSource : public IAdocSource
@@ -21,6 +22,10 @@ public:
     virtual void vacuum() {}
     virtual void removeCruft() {}
 
+    // By default, prefetching is not supported and all records are read on demand
+    virtual QFuture<void> prefetch(IPrefetchRequest *request)   { delete request; return QFuture<void>(); }
+    virtual int prefetchGeneration() const                      { return 0; }
+
     IAnonSeqEntityCrud<Astring, AstringPod> *crud(Astring *)        { return astringCrud();  }
     IEntityCrud<AminoSeq, AminoSeqPod> *crud(AminoSeq *)            { return aminoSeqCrud(); }
     IAnonSeqEntityCrud<Dstring, DstringPod> *crud(Dstring *)        { return dstringCrud();  }
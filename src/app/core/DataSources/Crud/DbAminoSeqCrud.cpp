@@ -6,10 +6,13 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QHash>
 #include <QtCore/QVariant>
 #include <QtSql/QSqlError>
 
 #include "DbAminoSeqCrud.h"
+#include "MultiIdSelect.h"
+#include "MultiRowInsert.h"
 
 #include "../IDbSource.h"
 #include "../../Entities/AbstractAnonSeq.h"
@@ -40,6 +43,7 @@ DbAminoSeqCrud::DbAminoSeqCrud(IDbSource *dbSource) : AbstractDbEntityCrud<Amino
   */
 void DbAminoSeqCrud::save(const QVector<AminoSeq *> &aminoSeqs)
 {
+    QVector<AminoSeq *> newAminoSeqs;
     foreach (AminoSeq *aminoSeq, aminoSeqs)
     {
         if (!aminoSeq->isNew())
@@ -52,9 +56,11 @@ void DbAminoSeqCrud::save(const QVector<AminoSeq *> &aminoSeqs)
         }
         else
         {
-            insert(aminoSeq);
+            newAminoSeqs << aminoSeq;
         }
     }
+
+    insert(newAminoSeqs);
 }
 
 /**
@@ -110,84 +116,79 @@ void DbAminoSeqCrud::eraseByIds(const QVector<int> &ids)
   */
 QVector<AminoSeqPod> DbAminoSeqCrud::read(const QVector<int> &ids)
 {
-    QSqlQuery query = dbSource()->getPreparedQuery("readAminoSeqs",
-                                                   "SELECT a.id, astring_id, start, stop, name, source, description, "
-                                                   "       notes "
-                                                   "FROM amino_seqs a JOIN astrings b ON (a.astring_id = b.id) "
-                                                   "WHERE a.id = ? AND "
-                                                   "    start > 0 AND "
-                                                   "    stop >= start AND "
-                                                   "    stop <= length(b.sequence);");
+    MultiIdSelect select(dbSource(), "readAminoSeqs",
+                         "SELECT a.id, astring_id, start, stop, name, source, description, notes "
+                         "FROM amino_seqs a JOIN astrings b ON (a.astring_id = b.id) "
+                         "WHERE a.id IN (%1) AND "
+                         "    start > 0 AND "
+                         "    stop >= start AND "
+                         "    stop <= b.length");
 
     // --------------------------
     // --------------------------
-    QVector<AminoSeqPod> aminoSeqPods;
-    aminoSeqPods.reserve(ids.size());
-    foreach (int id, ids)
+    QHash<int, AminoSeqPod> aminoSeqPods;   // {id => pod}
+    for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
     {
-        query.bindValue(0, id);
-        if (!query.exec())
-        {
-            qDebug() << Q_FUNC_INFO << query.lastError().text();
-            throw 0;
-        }
-
-        if (!query.next())
+        QSqlQuery query = select.exec(ids, i);
+        while (query.next())
         {
-            aminoSeqPods << AminoSeqPod();
-            continue;
+            AminoSeqPod pod(query.value(0).toInt());
+            pod.start_ = query.value(2).toInt();
+            pod.stop_ = query.value(3).toInt();
+            pod.name_ = query.value(4).toString();
+            pod.source_ = query.value(5).toString();
+            pod.description_ = query.value(6).toString();
+            pod.notes_ = query.value(7).toString();
+
+            // Note, we do not assign the astring_ pointer because we do not know anything about creating the relevant
+            // astring. Thus, we simply pass the identifier of the associated astring into the constructor and leave the
+            // job of associating / finding the relevant astring to the data mapper.
+            pod.astringId_ = query.value(1).toInt();
+            aminoSeqPods.insert(pod.id_, pod);
         }
-
-        aminoSeqPods << AminoSeqPod(query.value(0).toInt());
-        AminoSeqPod &pod = aminoSeqPods.last();
-        pod.start_ = query.value(2).toInt();
-        pod.stop_ = query.value(3).toInt();
-        pod.name_ = query.value(4).toString();
-        pod.source_ = query.value(5).toString();
-        pod.description_ = query.value(6).toString();
-        pod.notes_ = query.value(7).toString();
-
-        // Note, we do not assign the astring_ pointer because we do not know anything about creating the relevant
-        // astring. Thus, we simply pass the identifier of the associated astring into the constructor and leave the job
-        // of associating / finding the relevant astring to the data mapper.
-        pod.astringId_ = query.value(1).toInt();
+        query.finish();
     }
 
-    query.finish();
+    // Return the pods in the same order as ids with a null pod for each id that was not found
+    QVector<AminoSeqPod> orderedAminoSeqPods;
+    orderedAminoSeqPods.reserve(ids.size());
+    foreach (int id, ids)
+        orderedAminoSeqPods << aminoSeqPods.value(id);
 
-    return aminoSeqPods;
+    return orderedAminoSeqPods;
 }
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Private methods
 /**
-  * @aminoSeq [AminoSeq *]
+  * All new sequences are inserted with as few statements as possible and then assigned their identifiers.
+  *
+  * @param aminoSeqs [const QVector<AminoSeq *> &]
   */
-void DbAminoSeqCrud::insert(AminoSeq *aminoSeq)
+void DbAminoSeqCrud::insert(const QVector<AminoSeq *> &aminoSeqs)
 {
-    ASSERT(aminoSeq->isNew());
-    QSqlQuery insert = dbSource()->getPreparedQuery("insertAminoSeq",
-                                                    "INSERT INTO amino_seqs (astring_id, start, stop, name, source, "
-                                                    "                        description, notes) "
-                                                    "VALUES (?, ?, ?, ?, ?, ?, ?)");
-
-    insert.bindValue(0, aminoSeq->abstractAnonSeq()->id());
-    insert.bindValue(1, aminoSeq->start());
-    insert.bindValue(2, aminoSeq->stop());
-    insert.bindValue(3, aminoSeq->name());
-    insert.bindValue(4, aminoSeq->source());
-    insert.bindValue(5, aminoSeq->description());
-    insert.bindValue(6, aminoSeq->notes());
-    if (!insert.exec())
+    if (aminoSeqs.isEmpty())
+        return;
+
+    MultiRowInsert insert(dbSource(), "amino_seqs", QStringList() << "astring_id" << "start" << "stop" << "name"
+                                                                  << "source" << "description" << "notes");
+    foreach (const AminoSeq *aminoSeq, aminoSeqs)
     {
-        qDebug() << Q_FUNC_INFO << insert.lastError().text();
-        throw 0;
+        ASSERT(aminoSeq->isNew());
+        insert.addRow(QVariantList() << aminoSeq->abstractAnonSeq()->id()
+                                     << aminoSeq->start()
+                                     << aminoSeq->stop()
+                                     << aminoSeq->name()
+                                     << aminoSeq->source()
+                                     << aminoSeq->description()
+                                     << aminoSeq->notes());
     }
+    insert.exec();
 
-    aminoSeq->setId(insert.lastInsertId().toInt());
-
-    insert.finish();
+    QVector<int> ids = insert.insertIds();
+    for (int i=0, z=aminoSeqs.size(); i<z; ++i)
+        aminoSeqs.at(i)->setId(ids.at(i));
 }
 
 /**
@@ -26,7 +26,7 @@ public:
     virtual QVector<AminoSeqPod> read(const QVector<int> &ids);
 
 private:
-    void insert(AminoSeq *aminoSeq);
+    void insert(const QVector<AminoSeq *> &aminoSeqs);
     void update(const AminoSeq *aminoSeq);
 };
 
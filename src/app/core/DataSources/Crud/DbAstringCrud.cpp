@@ -6,6 +6,7 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QHash>
 #include <QtCore/QVariant>
 #include <QtCore/QScopedPointer>
 #include <QtSql/QSqlError>
@@ -19,6 +20,9 @@
 #include "../../global.h"
 #include "../../macros.h"
 #include "../IDbSource.h"
+#include "MultiIdSelect.h"
+#include "MultiRowInsert.h"
+#include "SequenceCodec.h"
 
 
 // -------------------------------------------------------------------------------------------------
@@ -50,49 +54,44 @@ void DbAstringCrud::eraseByIds(const QVector<int> & /* ids */)
 }
 
 /**
+  * The astrings and their annotations are read in bulk (see MultiIdSelect) rather than one record at a time.
+  *
   * @param ids [const QVector<int> &]
   * @returns QVector<AstringPod>
   */
 QVector<AstringPod> DbAstringCrud::read(const QVector<int> &ids)
 {
     // Gather the base information
-    QSqlQuery query = dbSource()->getPreparedQuery("readAstring",
-                                                   "SELECT id, sequence "
-                                                   "FROM astrings "
-                                                   "WHERE id = ?");
+    MultiIdSelect select(dbSource(), "readAstrings",
+                         "SELECT id, length, codec, sequence "
+                         "FROM astrings "
+                         "WHERE id IN (%1)");
 
-    QVector<AstringPod> astringPods;
-    astringPods.reserve(ids.size());
-    foreach (int id, ids)
+    QHash<int, AstringPod> astringPods;     // {id => pod}
+    for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
     {
-        query.bindValue(0, id);
-        if (!query.exec())
-            throw 0;
-
-        if (!query.next())
-        {
-            astringPods << AstringPod();
-            continue;
-        }
-
-        astringPods << AstringPod(query.value(0).toInt());
-        AstringPod &pod = astringPods.last();
-        pod.seq_ = Seq(query.value(1).toByteArray(), eAminoGrammar);
-        try
+        QSqlQuery query = select.exec(ids, i);
+        while (query.next())
         {
-            pod.coils_ = readCoils(pod.id_, pod.seq_.length());
-            pod.segs_ = readSegs(pod.id_, pod.seq_.length());
-            pod.q3_ = readQ3(pod.id_);
-        }
-        catch(...)
-        {
-            throw;
+            AstringPod pod(query.value(0).toInt());
+            QByteArray sequence = SequenceCodec::decode(query.value(3).toByteArray(),
+                                                        query.value(2).toInt(),
+                                                        query.value(1).toInt());
+            pod.seq_ = Seq(sequence, eAminoGrammar);
+            astringPods.insert(pod.id_, pod);
         }
+        query.finish();
     }
 
-    query.finish();
+    readAnnotations(astringPods);
 
-    return astringPods;
+    // Return the pods in the same order as ids with a null pod for each id that was not found
+    QVector<AstringPod> orderedAstringPods;
+    orderedAstringPods.reserve(ids.size());
+    foreach (int id, ids)
+        orderedAstringPods << astringPods.value(id);
+
+    return orderedAstringPods;
 }
 
 /**
@@ -103,12 +102,13 @@ QVector<AstringPod> DbAstringCrud::readByDigests(const QVector<QByteArray> &dige
 {
     // Gather the base information
     QSqlQuery query = dbSource()->getPreparedQuery("readAstringViaDigest",
-                                                   "SELECT id, sequence "
+                                                   "SELECT id, length, codec, sequence "
                                                    "FROM astrings "
                                                    "WHERE digest = ?");
 
-    QVector<AstringPod> astringPods;
-    astringPods.reserve(digests.size());
+    QHash<int, AstringPod> astringPods;     // {id => pod}
+    QVector<int> ids;
+    ids.reserve(digests.size());
     foreach (const QByteArray &digest, digests)
     {
         query.bindValue(0, digest);
@@ -117,28 +117,29 @@ QVector<AstringPod> DbAstringCrud::readByDigests(const QVector<QByteArray> &dige
 
         if (!query.next())
         {
-            astringPods << AstringPod();
+            ids << 0;
             continue;
         }
 
-        astringPods << AstringPod(query.value(0).toInt());
-        AstringPod &pod = astringPods.last();
-        pod.seq_ = Seq(query.value(1).toByteArray(), eAminoGrammar);
-        try
-        {
-            pod.coils_ = readCoils(pod.id_, pod.seq_.length());
-            pod.segs_ = readSegs(pod.id_, pod.seq_.length());
-            pod.q3_ = readQ3(pod.id_);
-        }
-        catch(...)
-        {
-            throw;
-        }
+        AstringPod pod(query.value(0).toInt());
+        QByteArray sequence = SequenceCodec::decode(query.value(3).toByteArray(),
+                                                    query.value(2).toInt(),
+                                                    query.value(1).toInt());
+        pod.seq_ = Seq(sequence, eAminoGrammar);
+        astringPods.insert(pod.id_, pod);
+        ids << pod.id_;
     }
 
     query.finish();
 
-    return astringPods;
+    readAnnotations(astringPods);
+
+    QVector<AstringPod> orderedAstringPods;
+    orderedAstringPods.reserve(ids.size());
+    foreach (int id, ids)
+        orderedAstringPods << astringPods.value(id);
+
+    return orderedAstringPods;
 }
 
 /**
@@ -148,11 +149,14 @@ void DbAstringCrud::save(const QVector<Astring *> &astrings)
 {
     using namespace Ag;
 
+    QVector<Astring *> newAstrings;
     foreach (Astring *astring, astrings)
-    {
         if (astring->isNew())
-            insertCoreAstring(astring);
+            newAstrings << astring;
+    insertCoreAstrings(newAstrings);
 
+    foreach (Astring *astring, astrings)
+    {
         // Coils
         if (astring->isDirty(eCoilsFlag))
         {
@@ -188,119 +192,106 @@ void DbAstringCrud::save(const QVector<Astring *> &astrings)
 // -------------------------------------------------------------------------------------------------
 // Private methods
 /**
-  * @param astring [Astring *]
-  */
-void DbAstringCrud::insertCoreAstring(Astring *astring) const
-{
-    ASSERT(astring);
-    ASSERT(astring->isNew());
-
-    QSqlQuery insert = dbSource()->getPreparedQuery("insertAstring",
-                                                    "INSERT INTO astrings (digest, length, sequence) "
-                                                    "VALUES (?, ?, ?)");
-
-    insert.bindValue(0, astring->seq_.digest());
-    insert.bindValue(1, astring->seq_.length());
-    insert.bindValue(2, astring->seq_.asByteArray());
-    if (!insert.exec())
-        throw 0;
-
-    astring->setId(insert.lastInsertId().toInt());
-
-    insert.finish();
-
-    astring->setDirty(Ag::eCoreDataFlag, false);
-}
-
-/**
-  * @param astringId [int]
-  * @param maxStop [int]
-  * @returns QVector<Coil>
-  */
-QVector<Coil> DbAstringCrud::readCoils(int astringId, int maxStop) const
-{
-    ASSERT(maxStop > 0);
-    QSqlQuery query = dbSource()->getPreparedQuery("readCoils",
-                                                   "SELECT id, start, stop "
-                                                   "FROM coils "
-                                                   "WHERE astring_id = ? AND start > 0 AND stop >= start AND stop <= ? " // Ensure they are in the proper range
-                                                   "GROUP BY start, stop "    // Prevent duplicates
-                                                   "ORDER BY start");
-
-    // --------------------------
-    // --------------------------
-    query.bindValue(0, astringId);
-    query.bindValue(1, maxStop);
-    if (!query.exec())
-        throw 0;
-
-    QVector<Coil> coils;
-    while (query.next())
-        coils << Coil(query.value(0).toInt(), ClosedIntRange(query.value(1).toInt(), query.value(2).toInt()));
-
-    query.finish();
-
-    return coils;
-}
-
-/**
-  * @param astringId [int]
-  * @param maxStop [int]
-  * @returns QVector<Seg>
+  * @param astrings [const QVector<Astring *> &]
   */
-QVector<Seg> DbAstringCrud::readSegs(int astringId, int maxStop) const
+void DbAstringCrud::insertCoreAstrings(const QVector<Astring *> &astrings) const
 {
-    ASSERT(maxStop > 0);
-    QSqlQuery query = dbSource()->getPreparedQuery("readSegs",
-                                                   "SELECT id, start, stop "
-                                                   "FROM segs "
-                                                   "WHERE astring_id = ? AND start > 0 AND stop >= start AND stop <= ? " // Ensure they are in the proper range
-                                                   "GROUP BY start, stop "    // Prevent duplicates
-                                                   "ORDER BY start");
-
-    // --------------------------
-    // --------------------------
-    query.bindValue(0, astringId);
-    query.bindValue(1, maxStop);
-    if (!query.exec())
-        throw 0;
+    if (astrings.isEmpty())
+        return;
 
-    QVector<Seg> segs;
-    while (query.next())
-        segs << Seg(query.value(0).toInt(), ClosedIntRange(query.value(1).toInt(), query.value(2).toInt()));
-
-    query.finish();
+    MultiRowInsert insert(dbSource(), "astrings", QStringList() << "digest" << "length" << "codec" << "sequence");
+    foreach (const Astring *astring, astrings)
+    {
+        ASSERT(astring);
+        ASSERT(astring->isNew());
+
+        SequenceCodec::Codec codec;
+        QByteArray data = SequenceCodec::encode(astring->seq_.asByteArray(), codec);
+        insert.addRow(QVariantList() << astring->seq_.digest()
+                                     << astring->seq_.length()
+                                     << codec
+                                     << data);
+    }
+    insert.exec();
 
-    return segs;
+    QVector<int> ids = insert.insertIds();
+    for (int i=0, z=astrings.size(); i<z; ++i)
+    {
+        Astring *astring = astrings.at(i);
+        astring->setId(ids.at(i));
+        astring->setDirty(Ag::eCoreDataFlag, false);
+    }
 }
 
 /**
-  * @param astringId [int astringId]
-  * @returns Q3Prediction
+  * Reads the coils, segs, and q3 prediction of each astring in astringPods. Only those coils and segs that lie within
+  * the astring sequence are included.
+  *
+  * @param astringPods [QHash<int, AstringPod> &]
   */
-Q3Prediction DbAstringCrud::readQ3(int astringId) const
+void DbAstringCrud::readAnnotations(QHash<int, AstringPod> &astringPods) const
 {
-    QSqlQuery query = dbSource()->getPreparedQuery("readQ3",
-                                                   "SELECT q3, confidence "
-                                                   "FROM q3 "
-                                                   "WHERE astring_id = ?");
-
-    // --------------------------
-    // --------------------------
-    query.bindValue(0, astringId);
-    if (!query.exec())
-        throw 0;
-
-    Q3Prediction q3;
-    if (query.next())
+    if (astringPods.isEmpty())
+        return;
+
+    QVector<int> ids = astringPods.keys().toVector();
+
+    MultiIdSelect coilSelect(dbSource(), "readCoils",
+                             "SELECT astring_id, id, start, stop "
+                             "FROM coils "
+                             "WHERE astring_id IN (%1) AND start > 0 AND stop >= start "
+                             "GROUP BY astring_id, start, stop "    // Prevent duplicates
+                             "ORDER BY astring_id, start");
+    for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
     {
-        q3.q3_ = query.value(0).toByteArray();
-        q3.confidence_ = Q3Prediction::decodeConfidence(query.value(1).toString());
+        QSqlQuery query = coilSelect.exec(ids, i);
+        while (query.next())
+        {
+            AstringPod &pod = astringPods[query.value(0).toInt()];
+            ClosedIntRange range(query.value(2).toInt(), query.value(3).toInt());
+            if (range.end_ <= pod.seq_.length())
+                pod.coils_ << Coil(query.value(1).toInt(), range);
+        }
+        query.finish();
     }
 
-    query.finish();
+    MultiIdSelect segSelect(dbSource(), "readSegs",
+                            "SELECT astring_id, id, start, stop "
+                            "FROM segs "
+                            "WHERE astring_id IN (%1) AND start > 0 AND stop >= start "
+                            "GROUP BY astring_id, start, stop "    // Prevent duplicates
+                            "ORDER BY astring_id, start");
+    for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
+    {
+        QSqlQuery query = segSelect.exec(ids, i);
+        while (query.next())
+        {
+            AstringPod &pod = astringPods[query.value(0).toInt()];
+            ClosedIntRange range(query.value(2).toInt(), query.value(3).toInt());
+            if (range.end_ <= pod.seq_.length())
+                pod.segs_ << Seg(query.value(1).toInt(), range);
+        }
+        query.finish();
+    }
 
-    return q3;
+    MultiIdSelect q3Select(dbSource(), "readQ3",
+                           "SELECT astring_id, q3, confidence "
+                           "FROM q3 "
+                           "WHERE astring_id IN (%1)");
+    for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
+    {
+        QSqlQuery query = q3Select.exec(ids, i);
+        while (query.next())
+        {
+            AstringPod &pod = astringPods[query.value(0).toInt()];
+            if (pod.q3_.isEmpty())
+            {
+                pod.q3_.q3_ = query.value(1).toByteArray();
+                pod.q3_.confidence_ = Q3Prediction::decodeConfidence(query.value(2).toString());
+            }
+        }
+        query.finish();
+    }
 }
 
 /**
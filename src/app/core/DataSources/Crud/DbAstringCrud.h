@@ -9,6 +9,8 @@
 #ifndef DBASTRINGCRUD_H
 #define DBASTRINGCRUD_H
 
+#include <QtCore/QHash>
+
 #include "AbstractDbEntityCrud.h"
 #include "IAnonSeqEntityCrud.h"
 
@@ -34,10 +36,8 @@ public:
     virtual void save(const QVector<Astring *> &astrings);
 
 private:
-    void insertCoreAstring(Astring *astring) const;
-    QVector<Coil> readCoils(int astringId, int maxStop) const;
-    QVector<Seg> readSegs(int astringId, int maxStop) const;
-    Q3Prediction readQ3(int astringId) const;
+    void insertCoreAstrings(const QVector<Astring *> &astrings) const;
+    void readAnnotations(QHash<int, AstringPod> &astringPods) const;
     void saveCoils(int astringId, QVector<Coil> &coils) const;
     void saveSegs(int astringId, QVector<Seg> &segs) const;
     void saveQ3(int astringId, const Q3Prediction &q3) const;
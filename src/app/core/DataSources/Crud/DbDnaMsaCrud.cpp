@@ -11,6 +11,7 @@
 #include <QtSql/QSqlError>
 
 #include "DbDnaMsaCrud.h"
+#include "MultiRowInsert.h"
 
 #include "../IDbSource.h"
 #include "../../Entities/DnaSeq.h"
@@ -220,7 +221,7 @@ int DbDnaMsaCrud::countMembers(int dnaMsaId)
 MsaMembersPod DbDnaMsaCrud::readMsaMembers(int msaId, int offset, int limit)
 {
     QSqlQuery query = dbSource()->getPreparedQuery("DbDnaMsaCrud::readMsaMembers",
-                                                   "SELECT dna_seq_id, sequence "
+                                                   "SELECT dna_seq_id, gap_runs "
                                                    "FROM dna_msas_members "
                                                    "WHERE dna_msa_id = ? "
                                                    "ORDER BY position ASC "
@@ -241,20 +242,20 @@ MsaMembersPod DbDnaMsaCrud::readMsaMembers(int msaId, int offset, int limit)
     if (limit > 0)
     {
         pod.seqIds_.reserve(limit);
-        pod.gappedSequences_.reserve(limit);
+        pod.gapRunEncodings_.reserve(limit);
     }
     else if (limit < 0)
     {
         // Fetching all rows, count the members so that we can reserve space in the vector
         int memberCount = countMembers(msaId);
         pod.seqIds_.reserve(memberCount);
-        pod.gappedSequences_.reserve(memberCount);
+        pod.gapRunEncodings_.reserve(memberCount);
     }
 
     while (query.next())
     {
         pod.seqIds_ << query.value(0).toInt();
-        pod.gappedSequences_ << query.value(1).toByteArray();
+        pod.gapRunEncodings_ << query.value(1).toByteArray();
     }
 
     query.finish();
@@ -307,17 +308,12 @@ void DbDnaMsaCrud::insertCoreDnaMsa(DnaMsa *dnaMsa) const
   */
 void DbDnaMsaCrud::insertDnaMsaMembers(const DnaMsa *dnaMsa) const
 {
-    QSqlQuery insert =
-        dbSource()->getPreparedQuery("DbDnaMsaCrud::insertDnaMsaMembers",
-                                     "INSERT INTO dna_msas_members (dna_msa_id, dna_seq_id, position, sequence) "
-                                     "VALUES (?, ?, ?, ?)");
-
     Msa *msa = dnaMsa->msa();
     if (msa == nullptr)
         return;
 
-    insert.bindValue(0, dnaMsa->id());
-
+    MultiRowInsert insert(dbSource(), "dna_msas_members", QStringList() << "dna_msa_id" << "dna_seq_id"
+                                                                        << "position" << "gap_runs");
     for (int i=0, z= msa->subseqCount(); i<z; ++i)
     {
         const Subseq *subseq = msa->at(i+1);
@@ -325,18 +321,12 @@ void DbDnaMsaCrud::insertDnaMsaMembers(const DnaMsa *dnaMsa) const
         ASSERT(entity != nullptr);
         ASSERT(dynamic_cast<const DnaSeq *>(entity) != 0);
 
-        insert.bindValue(1, entity->id());
-        insert.bindValue(2, i+1);               // Position index
-        insert.bindValue(3, subseq->asByteArray());
-
-        if (!insert.exec())
-        {
-            qDebug() << Q_FUNC_INFO << insert.lastError().text();
-            throw 0;
-        }
+        insert.addRow(QVariantList() << dnaMsa->id()
+                                     << entity->id()
+                                     << i+1             // Position index
+                                     << subseq->gapRunEncoding());
     }
-
-    insert.finish();
+    insert.exec();
 }
 
 /**
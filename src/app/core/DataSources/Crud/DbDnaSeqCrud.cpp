@@ -6,13 +6,15 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QHash>
 #include <QtCore/QVariant>
 
 #include <QtSql/QSqlError>
 
 #include "DbDnaSeqCrud.h"
 
-#include "DbPrimerSearchParametersCache.h"
+#include "MultiIdSelect.h"
+#include "MultiRowInsert.h"
 #include "../IDbSource.h"
 #include "../../Entities/AbstractAnonSeq.h"
 #include "../../Entities/DnaSeq.h"
@@ -30,7 +32,9 @@
 /**
   * @param dbSource [IDbSource *]
   */
-DbDnaSeqCrud::DbDnaSeqCrud(IDbSource *dbSource) : AbstractDbEntityCrud<DnaSeq, DnaSeqPod>(dbSource)
+DbDnaSeqCrud::DbDnaSeqCrud(IDbSource *dbSource)
+    : AbstractDbEntityCrud<DnaSeq, DnaSeqPod>(dbSource),
+      primerSearchParametersCache_(dbSource)
 {
     ASSERT(dbSource);
 }
@@ -44,13 +48,16 @@ DbDnaSeqCrud::DbDnaSeqCrud(IDbSource *dbSource) : AbstractDbEntityCrud<DnaSeq, D
   */
 void DbDnaSeqCrud::save(const QVector<DnaSeq *> &dnaSeqs)
 {
+    QVector<DnaSeq *> newDnaSeqs;
     foreach (DnaSeq *dnaSeq, dnaSeqs)
     {
         if (!dnaSeq->isNew())
             update(dnaSeq);
         else
-            insert(dnaSeq);
+            newDnaSeqs << dnaSeq;
     }
+
+    insert(newDnaSeqs);
 }
 
 /**
@@ -103,60 +110,57 @@ void DbDnaSeqCrud::eraseByIds(const QVector<int> &ids)
 }
 
 /**
+  * Primers are read separately for each dna seq.
+  *
   * @param ids [const QVector<int> &]
   * @returns QVector<DnaSeqPod>
   */
 QVector<DnaSeqPod> DbDnaSeqCrud::read(const QVector<int> &ids)
 {
-    QSqlQuery query = dbSource()->getPreparedQuery("readDnaSeqs",
-                                                   "SELECT a.id, dstring_id, start, stop, name, source, description, "
-                                                   "       notes "
-                                                   "FROM dna_seqs a JOIN dstrings b ON (a.dstring_id = b.id) "
-                                                   "WHERE a.id = ? AND "
-                                                   "    start > 0 AND "
-                                                   "    stop >= start AND "
-                                                   "    stop <= length(b.sequence);");
+    MultiIdSelect select(dbSource(), "readDnaSeqs",
+                         "SELECT a.id, dstring_id, start, stop, name, source, description, notes "
+                         "FROM dna_seqs a JOIN dstrings b ON (a.dstring_id = b.id) "
+                         "WHERE a.id IN (%1) AND "
+                         "    start > 0 AND "
+                         "    stop >= start AND "
+                         "    stop <= b.length");
 
     // --------------------------
     // --------------------------
-    QVector<DnaSeqPod> dnaSeqPods;
-    dnaSeqPods.reserve(ids.size());
-    foreach (int id, ids)
+    QHash<int, DnaSeqPod> dnaSeqPods;       // {id => pod}
+    for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
     {
-        query.bindValue(0, id);
-        if (!query.exec())
+        QSqlQuery query = select.exec(ids, i);
+        while (query.next())
         {
-            qDebug() << Q_FUNC_INFO << query.lastError().text();
-            throw 0;
+            DnaSeqPod pod(query.value(0).toInt());
+            pod.start_ = query.value(2).toInt();
+            pod.stop_ = query.value(3).toInt();
+            pod.name_ = query.value(4).toString();
+            pod.source_ = query.value(5).toString();
+            pod.description_ = query.value(6).toString();
+            pod.notes_ = query.value(7).toString();
+
+            // Note, we do not assign the dstring_ pointer because we do not know anything about creating the relevant
+            // dstring. Thus, we simply pass the identifier of the associated dstring into the constructor and leave the
+            // job of associating / finding the relevant dstring to the data mapper.
+            pod.dstringId_ = query.value(1).toInt();
+            dnaSeqPods.insert(pod.id_, pod);
         }
-
-        if (!query.next())
-        {
-            dnaSeqPods << DnaSeqPod();
-            continue;
-        }
-
-        int dnaSeqId = query.value(0).toInt();
-        dnaSeqPods << DnaSeqPod(dnaSeqId);
-        DnaSeqPod &pod = dnaSeqPods.last();
-        pod.start_ = query.value(2).toInt();
-        pod.stop_ = query.value(3).toInt();
-        pod.name_ = query.value(4).toString();
-        pod.source_ = query.value(5).toString();
-        pod.description_ = query.value(6).toString();
-        pod.notes_ = query.value(7).toString();
-
-        pod.primers_ = readPrimers(dnaSeqId);
-
-        // Note, we do not assign the dstring_ pointer because we do not know anything about creating the relevant
-        // dstring. Thus, we simply pass the identifier of the associated dstring into the constructor and leave the job
-        // of associating / finding the relevant dstring to the data mapper.
-        pod.dstringId_ = query.value(1).toInt();
+        query.finish();
     }
 
-    query.finish();
+    QHash<int, DnaSeqPod>::Iterator it = dnaSeqPods.begin();
+    for (; it != dnaSeqPods.end(); ++it)
+        it.value().primers_ = readPrimers(it.key());
 
-    return dnaSeqPods;
+    // Return the pods in the same order as ids with a null pod for each id that was not found
+    QVector<DnaSeqPod> orderedDnaSeqPods;
+    orderedDnaSeqPods.reserve(ids.size());
+    foreach (int id, ids)
+        orderedDnaSeqPods << dnaSeqPods.value(id);
+
+    return orderedDnaSeqPods;
 }
 
 void DbDnaSeqCrud::erasePrimers(const int dnaSeqId)
@@ -206,38 +210,44 @@ void DbDnaSeqCrud::update(DnaSeq *dnaSeq)
 }
 
 /**
-  * @dnaSeq [DnaSeq *]
+  * The core data of all new sequences is inserted with as few statements as possible; primers are saved once each
+  * sequence has been assigned its identifier.
+  *
+  * @param dnaSeqs [const QVector<DnaSeq *> &]
   */
-void DbDnaSeqCrud::insert(DnaSeq *dnaSeq)
+void DbDnaSeqCrud::insert(const QVector<DnaSeq *> &dnaSeqs)
 {
-    ASSERT(dnaSeq->isNew());
-    insertCoreDnaSeq(dnaSeq);
-    savePrimers(dnaSeq->id(), dnaSeq->primers_);
+    if (dnaSeqs.isEmpty())
+        return;
+
+    insertCoreDnaSeqs(dnaSeqs);
+    foreach (DnaSeq *dnaSeq, dnaSeqs)
+        savePrimers(dnaSeq->id(), dnaSeq->primers_);
 }
 
-void DbDnaSeqCrud::insertCoreDnaSeq(DnaSeq *dnaSeq)
+/**
+  * @param dnaSeqs [const QVector<DnaSeq *> &]
+  */
+void DbDnaSeqCrud::insertCoreDnaSeqs(const QVector<DnaSeq *> &dnaSeqs)
 {
-    QSqlQuery query = dbSource()->getPreparedQuery("insertDnaSeq",
-                                                   "INSERT INTO dna_seqs (dstring_id, start, stop, name, source, "
-                                                   "                        description, notes) "
-                                                   "VALUES (?, ?, ?, ?, ?, ?, ?)");
-
-    query.bindValue(0, dnaSeq->abstractAnonSeq()->id());
-    query.bindValue(1, dnaSeq->start());
-    query.bindValue(2, dnaSeq->stop());
-    query.bindValue(3, dnaSeq->name());
-    query.bindValue(4, dnaSeq->source());
-    query.bindValue(5, dnaSeq->description());
-    query.bindValue(6, dnaSeq->notes());
-    if (!query.exec())
+    MultiRowInsert insert(dbSource(), "dna_seqs", QStringList() << "dstring_id" << "start" << "stop" << "name"
+                                                                << "source" << "description" << "notes");
+    foreach (const DnaSeq *dnaSeq, dnaSeqs)
     {
-        qDebug() << Q_FUNC_INFO << query.lastError().text();
-        throw 0;
+        ASSERT(dnaSeq->isNew());
+        insert.addRow(QVariantList() << dnaSeq->abstractAnonSeq()->id()
+                                     << dnaSeq->start()
+                                     << dnaSeq->stop()
+                                     << dnaSeq->name()
+                                     << dnaSeq->source()
+                                     << dnaSeq->description()
+                                     << dnaSeq->notes());
     }
+    insert.exec();
 
-    dnaSeq->setId(query.lastInsertId().toInt());
-
-    query.finish();
+    QVector<int> ids = insert.insertIds();
+    for (int i=0, z=dnaSeqs.size(); i<z; ++i)
+        dnaSeqs.at(i)->setId(ids.at(i));
 }
 
 /**
@@ -489,10 +499,8 @@ void DbDnaSeqCrud::deleteFromDnaSeqPrimersTable(const int dnaSeqId, const QStrin
 
 PrimerVector DbDnaSeqCrud::readPrimers(const int dnaSeqId) const
 {
-    static DbPrimerSearchParametersCache *pspCache = new DbPrimerSearchParametersCache(dbSource());
-
     QVector<int> uniquePSPids = fetchUniquePrimerSearchParameterIds(dnaSeqId);
-    pspCache->cacheRecords(uniquePSPids);
+    primerSearchParametersCache_.cacheRecords(uniquePSPids);
 
     QSqlQuery query = dbSource()->getPreparedQuery("readPrimers",
                                                    "SELECT b.id, b.primer_search_parameters_id, b.name, "
@@ -515,7 +523,7 @@ PrimerVector DbDnaSeqCrud::readPrimers(const int dnaSeqId) const
         int primerId = query.value(0).toInt();
         QSharedPointer<PrimerSearchParameters> psp;
         if (!query.isNull(1))
-            psp = pspCache->read(query.value(1).toInt());
+            psp = primerSearchParametersCache_.read(query.value(1).toInt());
         QString name = query.value(2).toString();
         QString REName = query.value(3).toString();
         BioString RESite = BioString(query.value(4).toByteArray(), eDnaGrammar);
@@ -10,6 +10,7 @@
 #define DBDNASEQCRUD_H
 
 #include "AbstractDbEntityCrud.h"
+#include "DbPrimerSearchParametersCache.h"
 
 class DnaSeq;
 struct DnaSeqPod;
@@ -31,8 +32,8 @@ public:
 private:
     void erasePrimers(const int dnaSeqId);
     void update(DnaSeq *dnaSeq);
-    void insert(DnaSeq *aminoSeq);
-    void insertCoreDnaSeq(DnaSeq *aminoSeq);
+    void insert(const QVector<DnaSeq *> &dnaSeqs);
+    void insertCoreDnaSeqs(const QVector<DnaSeq *> &dnaSeqs);
     void updateCoreDnaSeq(const DnaSeq *aminoSeq);
     void savePrimers(int dnaSeqId, PrimerVector &primers);
     QVector<int> primerIdVector(const PrimerVector &primers) const;
@@ -46,6 +47,9 @@ private:
 
     PrimerVector readPrimers(const int dnaSeqId) const;
     QVector<int> fetchUniquePrimerSearchParameterIds(const int dnaSeqId) const;
+
+    // Specific to the database connection of this instance; thus, it must not be shared between instances
+    mutable DbPrimerSearchParametersCache primerSearchParametersCache_;
 };
 
 #endif // DBDNASEQCRUD_H
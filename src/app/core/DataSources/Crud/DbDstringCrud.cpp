@@ -6,6 +6,7 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QHash>
 #include <QtCore/QVariant>
 #include <QtCore/QScopedPointer>
 #include <QtSql/QSqlError>
@@ -18,6 +19,9 @@
 #include "../../global.h"
 #include "../../macros.h"
 #include "../IDbSource.h"
+#include "MultiIdSelect.h"
+#include "MultiRowInsert.h"
+#include "SequenceCodec.h"
 
 
 // -------------------------------------------------------------------------------------------------
@@ -58,32 +62,34 @@ void DbDstringCrud::eraseByIds(const QVector<int> & /* ids */)
 QVector<DstringPod> DbDstringCrud::read(const QVector<int> &ids)
 {
     // Gather the base information
-    QSqlQuery query = dbSource()->getPreparedQuery("readDstring",
-                                                   "SELECT id, sequence "
-                                                   "FROM dstrings "
-                                                   "WHERE id = ?");
+    MultiIdSelect select(dbSource(), "readDstrings",
+                         "SELECT id, length, codec, sequence "
+                         "FROM dstrings "
+                         "WHERE id IN (%1)");
 
-    QVector<DstringPod> dstringPods;
-    dstringPods.reserve(ids.size());
-    foreach (int id, ids)
+    QHash<int, DstringPod> dstringPods;     // {id => pod}
+    for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
     {
-        query.bindValue(0, id);
-        if (!query.exec())
-            throw 0;
-
-        if (!query.next())
+        QSqlQuery query = select.exec(ids, i);
+        while (query.next())
         {
-            dstringPods << DstringPod();
-            continue;
+            DstringPod pod(query.value(0).toInt());
+            QByteArray sequence = SequenceCodec::decode(query.value(3).toByteArray(),
+                                                        query.value(2).toInt(),
+                                                        query.value(1).toInt());
+            pod.seq_ = Seq(sequence, eDnaGrammar);
+            dstringPods.insert(pod.id_, pod);
         }
-
-        dstringPods << DstringPod(query.value(0).toInt());
-        dstringPods.last().seq_ = Seq(query.value(1).toByteArray(), eDnaGrammar);
+        query.finish();
     }
 
-    query.finish();
+    // Return the pods in the same order as ids with a null pod for each id that was not found
+    QVector<DstringPod> orderedDstringPods;
+    orderedDstringPods.reserve(ids.size());
+    foreach (int id, ids)
+        orderedDstringPods << dstringPods.value(id);
 
-    return dstringPods;
+    return orderedDstringPods;
 }
 
 /**
@@ -94,7 +100,7 @@ QVector<DstringPod> DbDstringCrud::readByDigests(const QVector<QByteArray> &dige
 {
     // Gather the base information
     QSqlQuery query = dbSource()->getPreparedQuery("readDstringViaDigest",
-                                                   "SELECT id, sequence "
+                                                   "SELECT id, length, codec, sequence "
                                                    "FROM dstrings "
                                                    "WHERE digest = ?");
 
@@ -113,7 +119,10 @@ QVector<DstringPod> DbDstringCrud::readByDigests(const QVector<QByteArray> &dige
         }
 
         dstringPods << DstringPod(query.value(0).toInt());
-        dstringPods.last().seq_ = Seq(query.value(1).toByteArray(), eDnaGrammar);
+        QByteArray sequence = SequenceCodec::decode(query.value(3).toByteArray(),
+                                                    query.value(2).toInt(),
+                                                    query.value(1).toInt());
+        dstringPods.last().seq_ = Seq(sequence, eDnaGrammar);
     }
 
     query.finish();
@@ -126,25 +135,29 @@ QVector<DstringPod> DbDstringCrud::readByDigests(const QVector<QByteArray> &dige
   */
 void DbDstringCrud::save(const QVector<Dstring *> &dstrings)
 {
-    QSqlQuery insert = dbSource()->getPreparedQuery("insertDstring",
-                                                    "INSERT INTO dstrings (digest, length, sequence) "
-                                                    "VALUES (?, ?, ?)");
+    QVector<Dstring *> newDstrings;
+    MultiRowInsert insert(dbSource(), "dstrings", QStringList() << "digest" << "length" << "codec" << "sequence");
     foreach (Dstring *dstring, dstrings)
     {
         ASSERT(dstring);
         if (dstring->isNew())
         {
-            insert.bindValue(0, dstring->seq_.digest());
-            insert.bindValue(1, dstring->seq_.length());
-            insert.bindValue(2, dstring->seq_.asByteArray());
-            if (!insert.exec())
-                throw 0;
-
-            dstring->setId(insert.lastInsertId().toInt());
-
-            dstring->setDirty(Ag::eCoreDataFlag, false);
+            SequenceCodec::Codec codec;
+            QByteArray data = SequenceCodec::encode(dstring->seq_.asByteArray(), codec);
+            insert.addRow(QVariantList() << dstring->seq_.digest()
+                                         << dstring->seq_.length()
+                                         << codec
+                                         << data);
+            newDstrings << dstring;
         }
     }
+    insert.exec();
 
-    insert.finish();
+    QVector<int> ids = insert.insertIds();
+    for (int i=0, z=newDstrings.size(); i<z; ++i)
+    {
+        Dstring *dstring = newDstrings.at(i);
+        dstring->setId(ids.at(i));
+        dstring->setDirty(Ag::eCoreDataFlag, false);
+    }
 }
@@ -0,0 +1,74 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtCore/QStringList>
+#include <QtSql/QSqlError>
+
+#include "MultiIdSelect.h"
+
+#include "../IDbSource.h"
+#include "../../global.h"
+#include "../../macros.h"
+
+#include <QtDebug>
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Constructor
+/**
+  * @param dbSource [IDbSource *]
+  * @param name [const QString &]
+  * @param sqlTemplate [const QString &]
+  */
+MultiIdSelect::MultiIdSelect(IDbSource *dbSource, const QString &name, const QString &sqlTemplate)
+    : dbSource_(dbSource),
+      name_(name),
+      sqlTemplate_(sqlTemplate)
+{
+    ASSERT(dbSource != nullptr);
+    ASSERT(sqlTemplate.contains("%1"));
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  * @param ids [const QVector<int> &]
+  * @param position [int]
+  * @returns QSqlQuery
+  */
+QSqlQuery MultiIdSelect::exec(const QVector<int> &ids, int position)
+{
+    ASSERT(position >= 0 && position < ids.size());
+
+    int nIds = qMin(kMaxIds, ids.size() - position);
+    int nPlaceholders = 1;
+    while (nPlaceholders < nIds)
+        nPlaceholders *= 2;
+
+    QStringList placeholders;
+    for (int i=0; i<nPlaceholders; ++i)
+        placeholders << "?";
+
+    QSqlQuery query = dbSource_->getPreparedQuery(QString("%1:%2").arg(name_).arg(nPlaceholders),
+                                                  sqlTemplate_.arg(placeholders.join(", ")));
+    for (int i=0; i<nIds; ++i)
+        query.bindValue(i, ids.at(position + i));
+    for (int i=nIds; i<nPlaceholders; ++i)
+        query.bindValue(i, 0);
+
+    if (!query.exec())
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+
+    return query;
+}
@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef MULTIIDSELECT_H
+#define MULTIIDSELECT_H
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtSql/QSqlQuery>
+
+class IDbSource;
+
+/**
+  * MultiIdSelect reads the rows corresponding to many identifiers using as few statements as possible.
+  *
+  * Rather than executing one SELECT per identifier, identifiers are bound in chunks of at most kMaxIds to an IN clause.
+  * The statement is supplied as a template in which %1 denotes the list of placeholders; for example,
+  * SELECT id, sequence FROM astrings WHERE id IN (%1). Thus, callers iterate over the identifiers in steps of kMaxIds:
+  *
+  *   for (int i=0, z=ids.size(); i<z; i+=MultiIdSelect::kMaxIds)
+  *   {
+  *       QSqlQuery query = select.exec(ids, i);
+  *       while (query.next())
+  *           ...
+  *       query.finish();
+  *   }
+  *
+  * To limit the number of distinct statements, each has a power of two number of placeholders and any placeholders
+  * beyond the chunk of identifiers are bound to 0, which is never a valid identifier. Each of these statements is
+  * prepared once via IDbSource::getPreparedQuery.
+  *
+  * Rows are returned in no particular order and only for those identifiers that exist; therefore, callers should key
+  * the results by identifier. Database errors throw 0.
+  */
+class MultiIdSelect
+{
+public:
+    static const int kMaxIds = 512;                     //!< Power of two below the sqlite host parameter limit
+
+    // ------------------------------------------------------------------------------------------------
+    // Constructor
+    MultiIdSelect(IDbSource *dbSource, const QString &name, const QString &sqlTemplate);
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    //! Executes the statement for the (up to kMaxIds) identifiers in ids beginning at position
+    QSqlQuery exec(const QVector<int> &ids, int position = 0);
+
+
+private:
+    IDbSource *dbSource_;
+    QString name_;
+    QString sqlTemplate_;
+};
+
+#endif // MULTIIDSELECT_H
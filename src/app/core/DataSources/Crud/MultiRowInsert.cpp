@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+#include "MultiRowInsert.h"
+
+#include "../IDbSource.h"
+#include "../../global.h"
+#include "../../macros.h"
+
+#include <QtDebug>
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Constructor
+/**
+  * @param dbSource [IDbSource *]
+  * @param tableName [const QString &]
+  * @param columnNames [const QStringList &]
+  */
+MultiRowInsert::MultiRowInsert(IDbSource *dbSource, const QString &tableName, const QStringList &columnNames)
+    : dbSource_(dbSource),
+      tableName_(tableName),
+      columnNames_(columnNames),
+      rowsPerStatement_(0)
+{
+    ASSERT(dbSource != nullptr);
+    ASSERT(columnNames.size() > 0 && columnNames.size() <= kMaxVariables);
+
+    rowsPerStatement_ = kMaxVariables / columnNames_.size();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  * @param values [const QVariantList &]
+  */
+void MultiRowInsert::addRow(const QVariantList &values)
+{
+    ASSERT(values.size() == columnNames_.size());
+
+    values_ << values;
+    if (values_.size() == rowsPerStatement_ * columnNames_.size())
+        flush();
+}
+
+/**
+  */
+void MultiRowInsert::exec()
+{
+    if (!values_.isEmpty())
+        flush();
+}
+
+/**
+  * @returns QVector<int>
+  */
+QVector<int> MultiRowInsert::insertIds() const
+{
+    return insertIds_;
+}
+
+/**
+  * @returns int
+  */
+int MultiRowInsert::rowsPerStatement() const
+{
+    return rowsPerStatement_;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  * Only full-size statements are cached with the data source; the remainder statement varies in size from one call to
+  * the next and thus is prepared on demand.
+  */
+void MultiRowInsert::flush()
+{
+    int nRows = values_.size() / columnNames_.size();
+    QString sql = insertSql(nRows);
+
+    QSqlQuery insert;
+    if (nRows == rowsPerStatement_)
+    {
+        insert = dbSource_->getPreparedQuery("MultiRowInsert:" + sql, sql);
+    }
+    else
+    {
+        insert = QSqlQuery(dbSource_->database());
+        if (!insert.prepare(sql))
+        {
+            qDebug() << Q_FUNC_INFO << insert.lastError().text();
+            throw 0;
+        }
+    }
+
+    for (int i=0, z=values_.size(); i<z; ++i)
+        insert.bindValue(i, values_.at(i));
+
+    if (!insert.exec())
+    {
+        qDebug() << Q_FUNC_INFO << insert.lastError().text();
+        throw 0;
+    }
+
+    // Rows inserted by a single statement receive consecutive identifiers ending with the last insert id
+    int firstId = insert.lastInsertId().toInt() - nRows + 1;
+    for (int i=0; i<nRows; ++i)
+        insertIds_ << firstId + i;
+
+    insert.finish();
+    values_.clear();
+}
+
+/**
+  * @param nRows [int]
+  * @returns QString
+  */
+QString MultiRowInsert::insertSql(int nRows) const
+{
+    ASSERT(nRows > 0);
+
+    QStringList placeholders;
+    for (int i=0, z=columnNames_.size(); i<z; ++i)
+        placeholders << "?";
+    QString rowSql = "(" + placeholders.join(", ") + ")";
+
+    QStringList rowSqls;
+    for (int i=0; i<nRows; ++i)
+        rowSqls << rowSql;
+
+    return QString("INSERT INTO %1 (%2) VALUES %3").arg(tableName_).arg(columnNames_.join(", ")).arg(rowSqls.join(", "));
+}
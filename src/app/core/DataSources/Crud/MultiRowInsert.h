@@ -0,0 +1,66 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef MULTIROWINSERT_H
+#define MULTIROWINSERT_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+class IDbSource;
+
+/**
+  * MultiRowInsert inserts rows into a single table using as few statements as possible.
+  *
+  * Rather than executing one INSERT per row, rows are buffered and written with multi-row statements of the form
+  * INSERT INTO table (columns) VALUES (?, ...), (?, ...), ... Each statement binds at most kMaxVariables values, which
+  * is the default maximum number of host parameters permitted by sqlite. QSqlQuery::execBatch is not used because the
+  * sqlite driver merely emulates it with one statement per row.
+  *
+  * The identifier of each inserted row is available from insertIds() in the order the rows were added. Identifiers
+  * are derived from the last insert id of each statement and therefore assume that the table's integer primary key is
+  * assigned by the database and not bound as one of the columns.
+  *
+  * Full-size statements are prepared once via IDbSource::getPreparedQuery. All rows are written by the time exec()
+  * returns; it should be called within a transaction. Database errors throw 0.
+  */
+class MultiRowInsert
+{
+public:
+    static const int kMaxVariables = 999;
+
+    // ------------------------------------------------------------------------------------------------
+    // Constructor
+    MultiRowInsert(IDbSource *dbSource, const QString &tableName, const QStringList &columnNames);
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    //! Buffers a row consisting of values in the same order as the column names; writes the buffer when it is full
+    void addRow(const QVariantList &values);
+    void exec();                                        //!< Writes any buffered rows
+    QVector<int> insertIds() const;                     //!< Returns the identifiers of all rows written thus far
+    int rowsPerStatement() const;                       //!< Returns the maximum number of rows per statement
+
+
+private:
+    void flush();
+    QString insertSql(int nRows) const;
+
+    IDbSource *dbSource_;
+    QString tableName_;
+    QStringList columnNames_;
+    int rowsPerStatement_;
+    QVariantList values_;                               //!< Buffered values of rows not yet written
+    QVector<int> insertIds_;
+};
+
+#endif // MULTIROWINSERT_H
@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include "SequenceCodec.h"
+
+#include <QtDebug>
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Public static methods
+/**
+  * Sequence data is highly redundant (e.g. a 4 letter alphabet for DNA) and thus typically compresses several-fold.
+  * Short sequences are not worth the decompression cost when read.
+  *
+  * @param sequence [const QByteArray &]
+  * @param codec [Codec &]
+  * @returns QByteArray
+  */
+QByteArray SequenceCodec::encode(const QByteArray &sequence, Codec &codec)
+{
+    codec = eNoCodec;
+    if (sequence.size() < kCompressionThreshold)
+        return sequence;
+
+    QByteArray compressed = qCompress(sequence);
+    if (compressed.size() >= sequence.size())
+        return sequence;
+
+    codec = eZlibCodec;
+    return compressed;
+}
+
+/**
+  * @param data [const QByteArray &]
+  * @param codec [int]
+  * @param length [int]
+  * @returns QByteArray
+  * @throws int
+  */
+QByteArray SequenceCodec::decode(const QByteArray &data, int codec, int length)
+{
+    QByteArray sequence;
+    switch (codec)
+    {
+    case eNoCodec:
+        sequence = data;
+        break;
+    case eZlibCodec:
+        sequence = qUncompress(data);
+        break;
+
+    default:
+        qDebug() << Q_FUNC_INFO << "Unknown sequence codec:" << codec;
+        throw 0;
+    }
+
+    if (sequence.size() != length)
+    {
+        qDebug() << Q_FUNC_INFO << "Sequence data is corrupt";
+        throw 0;
+    }
+
+    return sequence;
+}
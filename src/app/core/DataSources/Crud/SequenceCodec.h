@@ -0,0 +1,39 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef SEQUENCECODEC_H
+#define SEQUENCECODEC_H
+
+#include <QtCore/QByteArray>
+
+/**
+  * SequenceCodec converts the sequence data of anonymous sequences (astrings and dstrings) to and from its stored
+  * representation.
+  *
+  * Sequences of at least kCompressionThreshold bytes are compressed if doing so actually saves space; all other
+  * sequences are stored as is. The codec used is stored with each sequence so that compressed and uncompressed rows
+  * may coexist in the same table.
+  */
+class SequenceCodec
+{
+public:
+    enum Codec
+    {
+        eNoCodec = 0,       //!< Stored as is
+        eZlibCodec          //!< Compressed via qCompress
+    };
+
+    static const int kCompressionThreshold = 1024;
+
+    //! Returns the stored representation of sequence and sets codec to the codec that was used
+    static QByteArray encode(const QByteArray &sequence, Codec &codec);
+    //! Returns the sequence of length characters stored in data with codec; throws 0 if data cannot be decoded
+    static QByteArray decode(const QByteArray &data, int codec, int length);
+};
+
+#endif // SEQUENCECODEC_H
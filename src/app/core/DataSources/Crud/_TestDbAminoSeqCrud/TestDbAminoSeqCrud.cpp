@@ -10,6 +10,7 @@
 #include <QtTest/QtTest>
 
 #include "../DbAminoSeqCrud.h"
+#include "../MultiRowInsert.h"
 #include "../../Entities/AminoSeq.h"
 #include "../../MockDbSource.h"
 
@@ -25,6 +26,7 @@ private slots:
     void erase();
     void read();
     void save_insert();
+    void save_insertMany();
     void save_update();
 };
 
@@ -159,6 +161,49 @@ void TestDbAminoSeqCrud::save_insert()
     }
 }
 
+void TestDbAminoSeqCrud::save_insertMany()
+{
+    MockDbSource source;
+    DbAminoSeqCrud crud(&source);
+    QVector<Seq> seqs = source.aseqs();
+
+    Astring *astring = new Astring(2, seqs.at(1));
+    QVector<AminoSeq *> aseqs;
+
+    try
+    {
+        // Enough sequences to require several statements, the last of which is partially filled
+        int nAseqs = MultiRowInsert::kMaxVariables / 7 * 2 + 5;
+        for (int i=0; i< nAseqs; ++i)
+            aseqs << new AminoSeq(::newEntityId<AminoSeq>(), 1, 13, QString("Seq %1").arg(i), "Source", "description", "Notes", astring);
+        crud.save(aseqs);
+
+        QVector<int> ids;
+        foreach (const AminoSeq *aseq, aseqs)
+        {
+            QCOMPARE(aseq->isNew(), false);
+            ids << aseq->id();
+        }
+
+        // Each sequence must have been assigned the identifier of its own row
+        QVector<AminoSeqPod> pods = crud.read(ids);
+        QCOMPARE(pods.size(), nAseqs);
+        for (int i=0; i< nAseqs; ++i)
+        {
+            QVERIFY(pods.at(i).isNull() == false);
+            QCOMPARE(pods.at(i).id_, aseqs.at(i)->id());
+            QCOMPARE(pods.at(i).name_, aseqs.at(i)->name());
+        }
+    }
+    catch(...)
+    {
+        QVERIFY(0);
+    }
+
+    qDeleteAll(aseqs);
+    delete astring;
+}
+
 void TestDbAminoSeqCrud::save_update()
 {
     MockDbSource source;
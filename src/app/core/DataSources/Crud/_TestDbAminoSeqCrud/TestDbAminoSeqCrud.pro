@@ -18,6 +18,8 @@ SOURCES += TestDbAminoSeqCrud.cpp \
            ../../Entities/Astring.cpp \
            ../../Entities/AminoSeq.cpp \
            DbAminoSeqCrud.cpp \
+           MultiIdSelect.cpp \
+           MultiRowInsert.cpp \
            ../../AbstractDbSource.cpp \
            ../../../Seq.cpp \
            ../../../UngappedSubseq.cpp \
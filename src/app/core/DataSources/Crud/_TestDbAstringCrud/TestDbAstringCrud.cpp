@@ -7,11 +7,13 @@
 ****************************************************************************/
 
 #include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
 
 #include <QtTest/QtTest>
 
 #include "../../Entities/Astring.h"
 #include "../DbAstringCrud.h"
+#include "../SequenceCodec.h"
 #include "../../MockDbSource.h"
 
 #include "../../../Seq.h"
@@ -27,6 +29,7 @@ private slots:
     void read();
     void readByDigests();
     void save_insert();
+    void save_insertCompressed();
     void save_update();
 };
 
@@ -149,6 +152,39 @@ void TestDbAstringCrud::save_insert()
     }
 }
 
+void TestDbAstringCrud::save_insertCompressed()
+{
+    MockDbSource source;
+    DbAstringCrud crud(&source);
+
+    try
+    {
+        Seq seq(QByteArray("RVRQGEGGA").repeated(1000), eAminoGrammar);
+        Astring *astring = new Astring(::newEntityId<Astring>(), seq);
+        crud.save(QVector<Astring *>() << astring);
+
+        // Check that the sequence was stored compressed
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec(QString("SELECT length, codec, length(sequence) FROM astrings WHERE id = %1").arg(astring->id())));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), seq.length());
+        QCOMPARE(query.value(1).toInt(), static_cast<int>(SequenceCodec::eZlibCodec));
+        QVERIFY(query.value(2).toInt() < seq.length() / 10);
+        query.finish();
+
+        // Test: both read variants decompress the sequence
+        QCOMPARE(crud.read(QVector<int>() << astring->id()).first().seq_, seq);
+        QCOMPARE(crud.readByDigests(QVector<QByteArray>() << seq.digest()).first().seq_, seq);
+
+        delete astring;
+        astring = nullptr;
+    }
+    catch(...)
+    {
+        QVERIFY(0);
+    }
+}
+
 void TestDbAstringCrud::save_update()
 {
     MockDbSource source;
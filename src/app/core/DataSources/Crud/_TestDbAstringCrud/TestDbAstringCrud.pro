@@ -12,9 +12,12 @@ TARGET = TestDbAstringCrud
 DEPENDPATH += . ..
 INCLUDEPATH += . ..
 
-HEADERS += DbAstringCrud.h ../../AbstractDbSource.h
+HEADERS += DbAstringCrud.h SequenceCodec.h ../../AbstractDbSource.h
 SOURCES += TestDbAstringCrud.cpp \
            DbAstringCrud.cpp \
+           SequenceCodec.cpp \
+           MultiIdSelect.cpp \
+           MultiRowInsert.cpp \
            ../../AbstractDbSource.cpp \
            ../../../Seq.cpp \
            ../../../BioString.cpp \
@@ -9,12 +9,16 @@
 #ifndef IADOCSOURCE_H
 #define IADOCSOURCE_H
 
+#include <QtCore/QFuture>
+#include <QtCore/QVector>
+
 #include "Crud/IAnonSeqEntityCrud.h"
 #include "Crud/IBlastReportCrud.h"
 #include "Crud/IEntityCrud.h"
 #include "Crud/IMsaCrud.h"
 
 class AdocTreeNode;
+class IPrefetchRequest;
 class Astring;
 struct AstringPod;
 class AminoSeq;
@@ -47,8 +51,14 @@ public:
 
     // Entity tree hierarchy associated with this data source
     virtual AdocTreeNode *readEntityTree() = 0;
+    virtual QVector<AdocTreeNode *> readEntityTreeChildren(AdocTreeNode *parent) = 0;
     virtual void saveEntityTree(AdocTreeNode *root) = 0;
 
+    // Read-ahead support; prefetch takes ownership of request and runs it on a separate connection if possible.
+    // Data read by a request is only valid while prefetchGeneration() remains the same as when it was submitted.
+    virtual QFuture<void> prefetch(IPrefetchRequest *request) = 0;
+    virtual int prefetchGeneration() const = 0;
+
     // Convenience method to provide a single point of access for templated generics!
     virtual IAnonSeqEntityCrud<Astring, AstringPod> *crud(Astring *) = 0;
     virtual IEntityCrud<AminoSeq, AminoSeqPod> *crud(AminoSeq *) = 0;
@@ -0,0 +1,27 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef IPREFETCHREQUEST_H
+#define IPREFETCHREQUEST_H
+
+class IAdocSource;
+
+/**
+  * IPrefetchRequest encapsulates a unit of read-ahead work that is run on a background thread against that thread's own
+  * adoc source (see SqliteAdocPrefetcher). Implementations must only read from adocSource and must not touch any
+  * objects owned by the GUI thread (e.g. repositories or entities) without their own synchronization.
+  */
+class IPrefetchRequest
+{
+public:
+    virtual ~IPrefetchRequest() {}
+
+    virtual void run(IAdocSource *adocSource) = 0;
+};
+
+#endif // IPREFETCHREQUEST_H
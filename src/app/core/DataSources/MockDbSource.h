@@ -57,9 +57,10 @@ public:
                          "  id integer primary key autoincrement,"
                          "  digest text not null,"
                          "  length integer not null,"
-                         "  sequence text not null,"
+                         "  codec integer not null default 0,"
+                         "  sequence blob not null,"
                          "  check(length > 0),"
-                         "  check(length == length(sequence)),"
+                         "  check(codec != 0 OR length == length(sequence)),"
                          "  unique(digest)"
                          ");"))
             throw 0;
@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+#include "SqliteAdocCompactor.h"
+#include "SqliteAdocSource.h"
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructor
+/**
+  * @param parent [QObject *]
+  */
+SqliteAdocCompactor::SqliteAdocCompactor(QObject *parent)
+    : QThread(parent)
+{
+}
+
+/**
+  */
+SqliteAdocCompactor::~SqliteAdocCompactor()
+{
+    wait();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  * @returns QString
+  */
+QString SqliteAdocCompactor::fileName() const
+{
+    return fileName_;
+}
+
+/**
+  * @param fileName [const QString &]
+  * @returns bool
+  */
+bool SqliteAdocCompactor::compact(const QString &fileName)
+{
+    if (isRunning())
+        return false;
+
+    fileName_ = fileName;
+    start(QThread::LowPriority);
+
+    return true;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Protected methods
+/**
+  * The connection is created, used, and removed entirely within this thread as required by QtSql.
+  */
+void SqliteAdocCompactor::run()
+{
+    QString connectionName = QString("SqliteAdocCompactor%1").arg(reinterpret_cast<quintptr>(this));
+    QString errorMessage;
+    bool success = compactDatabase(connectionName, errorMessage);
+    QSqlDatabase::removeDatabase(connectionName);
+
+    if (success)
+        emit compacted(fileName_);
+    else
+        emit error(fileName_, errorMessage);
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  * @param connectionName [const QString &]
+  * @param errorMessage [QString &]
+  * @returns bool
+  */
+bool SqliteAdocCompactor::compactDatabase(const QString &connectionName, QString &errorMessage)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+    db.setDatabaseName(fileName_);
+    if (!db.open())
+    {
+        errorMessage = db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    if (!query.exec("pragma foreign_keys = ON") || !db.transaction())
+    {
+        errorMessage = query.lastError().text();
+        return false;
+    }
+
+    try
+    {
+        SqliteAdocSource::removeCruft(db);
+    }
+    catch (...)
+    {
+        db.rollback();
+        errorMessage = "Unable to remove unreferenced records";
+        return false;
+    }
+
+    if (!db.commit())
+    {
+        errorMessage = db.lastError().text();
+        return false;
+    }
+
+    // Note: cannot vacuum from within transaction
+    if (!query.exec("vacuum") ||
+        !query.exec("pragma wal_checkpoint(TRUNCATE)"))
+    {
+        errorMessage = query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
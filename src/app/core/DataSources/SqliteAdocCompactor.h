@@ -0,0 +1,59 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef SQLITEADOCCOMPACTOR_H
+#define SQLITEADOCCOMPACTOR_H
+
+#include <QtCore/QString>
+#include <QtCore/QThread>
+
+/**
+  * SqliteAdocCompactor performs the maintenance that follows saving an adoc database - removing unreferenced records,
+  * vacuuming, and checkpointing the write-ahead log - in a dedicated thread with its own database connection.
+  *
+  * On large documents, vacuuming rewrites the entire database file and thus would otherwise block the GUI thread for
+  * the duration. The database must be in WAL mode (see SqliteAdocSource::runPragmas) so that the GUI connection may
+  * continue reading while compaction is in progress. Because sqlite permits only one writer at a time, callers should
+  * wait() before writing to the same database.
+  *
+  * Either compacted or error is emitted when compaction completes.
+  */
+class SqliteAdocCompactor : public QThread
+{
+    Q_OBJECT
+
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    explicit SqliteAdocCompactor(QObject *parent = 0);
+    ~SqliteAdocCompactor();                                 //!< Waits for any compaction in progress to finish
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    QString fileName() const;                               //!< Returns the file name of the database being compacted
+    //! Begins compacting the database stored in fileName; returns false if a compaction is already in progress
+    bool compact(const QString &fileName);
+
+
+Q_SIGNALS:
+    void compacted(const QString &fileName);
+    void error(const QString &fileName, const QString &message);
+
+
+protected:
+    void run();
+
+
+private:
+    bool compactDatabase(const QString &connectionName, QString &errorMessage);
+
+    QString fileName_;
+};
+
+#endif // SQLITEADOCCOMPACTOR_H
@@ -0,0 +1,202 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtCore/QMutexLocker>
+
+#include "SqliteAdocPrefetcher.h"
+#include "IPrefetchRequest.h"
+#include "SqliteAdocSource.h"
+#include "../global.h"
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Constructors and destructor
+/**
+  * @param parent [QObject *]
+  */
+SqliteAdocPrefetcher::SqliteAdocPrefetcher(QObject *parent)
+    : QThread(parent),
+      generation_(0),
+      stopRequested_(false)
+{
+}
+
+/**
+  */
+SqliteAdocPrefetcher::~SqliteAdocPrefetcher()
+{
+    stop();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  * @returns QString
+  */
+QString SqliteAdocPrefetcher::fileName() const
+{
+    return fileName_;
+}
+
+/**
+  * @returns int
+  */
+int SqliteAdocPrefetcher::generation() const
+{
+    return generation_;
+}
+
+/**
+  */
+void SqliteAdocPrefetcher::invalidate()
+{
+    ++generation_;
+}
+
+/**
+  * @param fileName [const QString &]
+  * @returns bool
+  */
+bool SqliteAdocPrefetcher::open(const QString &fileName)
+{
+    stop();
+
+    if (fileName.isEmpty() || fileName == ":memory:")
+        return false;
+
+    fileName_ = fileName;
+    stopRequested_ = false;
+    start(QThread::LowPriority);
+
+    return true;
+}
+
+/**
+  * @param request [IPrefetchRequest *]
+  * @returns QFuture<void>
+  */
+QFuture<void> SqliteAdocPrefetcher::prefetch(IPrefetchRequest *request)
+{
+    if (request == nullptr)
+        return QFuture<void>();
+
+    QMutexLocker locker(&mutex_);
+    if (!isRunning() || stopRequested_)
+    {
+        delete request;
+        return QFuture<void>();
+    }
+
+    PendingRequest pendingRequest(request);
+    pendingRequest.futureInterface_.reportStarted();
+    pendingRequests_.enqueue(pendingRequest);
+    requestAvailable_.wakeOne();
+
+    return pendingRequest.futureInterface_.future();
+}
+
+/**
+  * Any request currently being processed is allowed to complete.
+  */
+void SqliteAdocPrefetcher::stop()
+{
+    {
+        QMutexLocker locker(&mutex_);
+        stopRequested_ = true;
+        cancelPendingRequests();
+        requestAvailable_.wakeAll();
+    }
+
+    wait();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Protected methods
+/**
+  * The connection is created, used, and removed entirely within this thread as required by QtSql.
+  */
+void SqliteAdocPrefetcher::run()
+{
+    SqliteAdocSource adocSource;
+
+    bool opened = false;
+    try
+    {
+        opened = adocSource.attach(fileName_);
+    }
+    catch (...)
+    {
+    }
+
+    if (!opened)
+    {
+        QMutexLocker locker(&mutex_);
+        stopRequested_ = true;
+        cancelPendingRequests();
+        return;
+    }
+
+    forever
+    {
+        PendingRequest pendingRequest;
+        {
+            QMutexLocker locker(&mutex_);
+            while (pendingRequests_.isEmpty() && !stopRequested_)
+                requestAvailable_.wait(&mutex_);
+
+            if (stopRequested_)
+                break;
+
+            pendingRequest = pendingRequests_.dequeue();
+        }
+
+        try
+        {
+            adocSource.begin();
+            pendingRequest.request_->run(&adocSource);
+            adocSource.end();
+        }
+        catch (...)
+        {
+            // Prefetching is merely an optimization; any records that could not be read here will be read on demand
+            try
+            {
+                adocSource.rollback();
+                adocSource.end();
+            }
+            catch (...)
+            {
+            }
+        }
+
+        delete pendingRequest.request_;
+        pendingRequest.futureInterface_.reportFinished();
+    }
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  */
+void SqliteAdocPrefetcher::cancelPendingRequests()
+{
+    while (!pendingRequests_.isEmpty())
+    {
+        PendingRequest pendingRequest = pendingRequests_.dequeue();
+        delete pendingRequest.request_;
+        pendingRequest.futureInterface_.reportCanceled();
+        pendingRequest.futureInterface_.reportFinished();
+    }
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef SQLITEADOCPREFETCHER_H
+#define SQLITEADOCPREFETCHER_H
+
+#include <QtCore/QFuture>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+class IPrefetchRequest;
+
+/**
+  * SqliteAdocPrefetcher runs read-ahead requests against an adoc database in a dedicated thread with its own database
+  * connection so that the GUI thread does not block while records it will soon need are read from disk.
+  *
+  * Requests are processed in the order they were submitted, each within its own read transaction. The database must
+  * be in WAL mode (see SqliteAdocSource::runPragmas) so that reading does not conflict with the GUI connection.
+  * In-memory databases are private to their connection and therefore cannot be prefetched.
+  *
+  * Data read by a request reflects the database at the time the request runs. Because the GUI connection may commit
+  * changes at any time, the prefetcher maintains a generation number that is incremented via invalidate() whenever
+  * previously prefetched data may be stale. Requests should record the generation when they are submitted and
+  * consumers should discard any data that was not read in the current generation. Both generation() and invalidate()
+  * are intended to be called from the GUI thread only.
+  */
+class SqliteAdocPrefetcher : public QThread
+{
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Constructors and destructor
+    explicit SqliteAdocPrefetcher(QObject *parent = 0);
+    ~SqliteAdocPrefetcher();                                //!< Stops any prefetching in progress
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    QString fileName() const;                               //!< Returns the file name of the database being prefetched
+    int generation() const;                                 //!< Returns the current generation number
+    void invalidate();                                      //!< Increments the generation number
+    //! Stops any current prefetching and begins servicing requests for fileName; returns false if fileName is in memory
+    bool open(const QString &fileName);
+    //! Queues request for processing and takes ownership of it; returns a canceled future if the thread is not running
+    QFuture<void> prefetch(IPrefetchRequest *request);
+    void stop();                                            //!< Discards all pending requests and waits for the thread to finish
+
+
+protected:
+    void run();
+
+
+private:
+    struct PendingRequest
+    {
+        PendingRequest(IPrefetchRequest *request = 0) : request_(request)
+        {
+        }
+
+        IPrefetchRequest *request_;
+        QFutureInterface<void> futureInterface_;
+    };
+
+    void cancelPendingRequests();                           //!< Must be called while holding mutex_
+
+    QString fileName_;
+    int generation_;
+    bool stopRequested_;                                    //!< Guarded by mutex_
+    QMutex mutex_;
+    QWaitCondition requestAvailable_;
+    QQueue<PendingRequest> pendingRequests_;                //!< Guarded by mutex_
+};
+
+#endif // SQLITEADOCPREFETCHER_H
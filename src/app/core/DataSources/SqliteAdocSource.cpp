@@ -2,9 +2,12 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QPair>
 #include <QtCore/QVariant>
+#include <QtCore/QVector>
 #include <QtSql/QSqlError>
 #include <QtSql/QSqlDriver>
+#include <QtSql/QSqlQuery>
 
 // Include the sqlite library for accessing the sqlite backup API
 #ifdef Q_OS_LINUX
@@ -16,19 +19,107 @@
 #endif
 
 #include "SqliteAdocSource.h"
+#include "SqliteAdocPrefetcher.h"
+
+#include "Crud/SequenceCodec.h"
 
-#include "../exceptions/InvalidMpttNodeError.h"
 #include "../AdocTreeNode.h"
-#include "../Mptt.h"
-#include "../MpttNode.h"
+#include "../Seq.h"
+#include "../Subseq.h"
 #include "../enums.h"
 #include "../macros.h"
 
 #include <QtDebug>
 
-typedef MpttNode<AdocTreeNode> AdocMpttNode;
+QAtomicInt SqliteAdocSource::connectionNumber_(1);
+
+/**
+  * Returns the SQL for creating an anonymous sequence table (e.g. astrings) named tableName. The codec column denotes
+  * how the sequence column is stored (see SequenceCodec); length is always that of the decoded sequence.
+  *
+  * @param tableName [const QString &]
+  * @returns QString
+  */
+static QString createAnonSeqTableSql(const QString &tableName)
+{
+    return QString("CREATE TABLE %1 ("
+                   "    id integer not null primary key,"
+                   "    digest text not null,"
+                   "    length integer not null,"
+                   "    codec integer not null default 0,"
+                   "    sequence blob not null,"
+                   "    check(codec != 0 OR length = length(sequence))"
+                   ");").arg(tableName);
+}
 
-int SqliteAdocSource::connectionNumber_ = 1;
+/**
+  * Returns the SQL for creating an msa members table named tableName for the msa type, prefix (e.g. amino or dna).
+  * Each member is stored as the binary gap run encoding of its Subseq (see Subseq::gapRunEncoding) rather than its
+  * gapped sequence text.
+  *
+  * @param tableName [const QString &]
+  * @param prefix [const QString &]
+  * @returns QString
+  */
+static QString createMsaMembersTableSql(const QString &tableName, const QString &prefix)
+{
+    return QString("CREATE TABLE %1 ("
+                   "    %2_msa_id integer not null,"
+                   "    %2_seq_id integer not null,"
+                   "    position integer not null,"
+                   "    gap_runs blob not null,"
+                   "    primary key(%2_msa_id, %2_seq_id),"
+                   "    foreign key(%2_msa_id) references %2_msas(id) on update cascade on delete cascade,"
+                   "    foreign key(%2_seq_id) references %2_seqs(id) on update cascade on delete cascade"
+                   ");").arg(tableName, prefix);
+}
+
+/**
+  * Returns the SQL for creating the entity_tree table. Each node references its parent (the root has a null parent)
+  * and its position among its siblings, which permits the tree to be changed by updating only the affected rows.
+  * Autoincrement prevents the id of a deleted node from being reused while that node may still be restored (e.g. via
+  * undo) and reference it.
+  *
+  * @returns QString
+  */
+static QString createEntityTreeTableSql()
+{
+    return QString("CREATE TABLE entity_tree ("
+                   "    id integer not null primary key autoincrement,"
+                   "    parent_id integer,"
+                   "    position integer not null,"
+                   "    type_id integer not null,"
+                   "    type text not null,"
+                   "    entity_id integer,"
+                   "    label text,"
+                   "    check(position >= 0),"
+                   "    foreign key(parent_id) references entity_tree(id) on delete cascade"
+                   ");");
+}
+
+/**
+  * Returns a new AdocTreeNode from the current record of query, which must select the id, type_id, entity_id, label,
+  * and has_children columns of an entity_tree row (in that order), or a null pointer if the row has an invalid type.
+  * The node is marked as saved as the row'th child of parentNodeId.
+  *
+  * @param query [const QSqlQuery &]
+  * @param parentNodeId [int]
+  * @param row [int]
+  * @returns AdocTreeNode *
+  */
+static AdocTreeNode *createEntityTreeNode(const QSqlQuery &query, int parentNodeId, int row)
+{
+    AdocNodeType nodeType = AdocTreeNode::mapNodeType(query.value(1).toInt());
+    ASSERT(nodeType != eUndefinedNode);
+    if (nodeType == eUndefinedNode)
+        return nullptr;
+
+    int entityId = (query.value(2).isNull() == false) ? query.value(2).toInt() : 0;
+    AdocTreeNode *node = new AdocTreeNode(nodeType, query.value(3).toString(), entityId);
+    node->markSaved(query.value(0).toInt(), parentNodeId, row);
+    node->setCanFetchChildren(query.value(4).toBool());
+    return node;
+}
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -38,6 +129,7 @@ int SqliteAdocSource::connectionNumber_ = 1;
 SqliteAdocSource::SqliteAdocSource()
     : AbstractAdocSource(),
       AbstractDbSource(),
+      prefetcher_(nullptr),
       astringCrud_(this),
       aminoSeqCrud_(this),
       dstringCrud_(this),
@@ -59,6 +151,21 @@ SqliteAdocSource::~SqliteAdocSource()
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Public methods
+/**
+  * Unlike open, the database is neither checked for integrity nor migrated, which would be redundant (and in the case
+  * of the integrity check, expensive) for a database that is already in use.
+  *
+  * @param fileName [const QString &]
+  * @returns bool
+  */
+bool SqliteAdocSource::attach(const QString &fileName)
+{
+    if (!QFile::exists(fileName))
+        return false;
+
+    return openOrCreate(fileName);
+}
+
 /**
   */
 void SqliteAdocSource::close()
@@ -67,6 +174,7 @@ void SqliteAdocSource::close()
     QSqlDatabase::removeDatabase(connectionName_);
     connectionName_.clear();
     fileName_.clear();
+    entityTreeNodeIds_.clear();
 }
 
 /**
@@ -115,7 +223,7 @@ bool SqliteAdocSource::open(const QString &fileName)
     if (!openOrCreate(fileName))
         return false;
 
-    if (!isValidDatabase())
+    if (!isValidDatabase() || !migrate())
     {
         close();
         return false;
@@ -178,7 +286,7 @@ bool SqliteAdocSource::saveAs(const QString &dstFileName)
         return false;
 
     // Switch databases to the new file
-    QString connectionName = QFileInfo(dstFileName).fileName() + QString::number(connectionNumber_);
+    QString connectionName = nextConnectionName(dstFileName);
     bool opened = false;
     {
         // Hide the QSqlDatabase reference inside a code block so that we can remove it later if it failed to open
@@ -192,14 +300,27 @@ bool SqliteAdocSource::saveAs(const QString &dstFileName)
         return false;
     }
 
+    // The backup is an exact copy; therefore, the entity tree node ids remain valid
+    QSet<int> entityTreeNodeIds = entityTreeNodeIds_;
     close();
 
     connectionName_ = connectionName;
     fileName_ = dstFileName;
+    entityTreeNodeIds_ = entityTreeNodeIds;
+
+    runPragmas();
 
     return true;
 }
 
+/**
+  * @param prefetcher [SqliteAdocPrefetcher *]
+  */
+void SqliteAdocSource::setPrefetcher(SqliteAdocPrefetcher *prefetcher)
+{
+    prefetcher_ = prefetcher;
+}
+
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -245,9 +366,20 @@ void SqliteAdocSource::end()
   */
 void SqliteAdocSource::removeCruft()
 {
-    removeCruftAstrings();
-    removeCruftDstrings();
-    removeOrphanPrimerSearchParameters();
+    removeCruft(database());
+}
+
+/**
+  * Removes all unreferenced records via database, which may be any connection to an adoc database (e.g. one owned by
+  * a SqliteAdocCompactor in another thread).
+  *
+  * @param database [const QSqlDatabase &]
+  */
+void SqliteAdocSource::removeCruft(const QSqlDatabase &database)
+{
+    removeCruftAstrings(database);
+    removeCruftDstrings(database);
+    removeOrphanPrimerSearchParameters(database);
 }
 
 /**
@@ -264,128 +396,251 @@ void SqliteAdocSource::vacuum()
 }
 
 /**
+  * Only the root and its immediate children are read; all other nodes are read on demand via readEntityTreeChildren.
+  * Thus, the time to open a document does not depend upon the size of its tree.
+  *
   * @return AdocTreeNode *
   */
 AdocTreeNode *SqliteAdocSource::readEntityTree()
 {
-    // A: Count the number of records
-    QSqlQuery selectTreeRowCount = getPreparedQuery("countEntityTreeRows",
-                                                    "SELECT count(*) "
-                                                    "FROM entity_tree");
+    entityTreeNodeIds_.clear();
 
-    if (!selectTreeRowCount.exec())
+    QSqlQuery selectRoot = getPreparedQuery("readEntityTreeRoot",
+                                            "SELECT id, type_id, entity_id, label, "
+                                            "       EXISTS (SELECT 1 FROM entity_tree b WHERE b.parent_id = a.id) "
+                                            "FROM entity_tree a "
+                                            "WHERE parent_id IS NULL");
+
+    if (!selectRoot.exec())
     {
-        qDebug() << selectTreeRowCount.lastError().text();
+        qDebug() << selectRoot.lastError().text();
         throw 0;
     }
 
-    selectTreeRowCount.next();
-    int nTreeRows = selectTreeRowCount.value(0).toInt();
-    if (nTreeRows == 0)
+    if (!selectRoot.next())
         return new AdocTreeNode(eRootNode, "Root");
 
-    // B: Read in all the entity data
-    QSqlQuery selectEntityNodes = getPreparedQuery("readEntityTree",
-                                                   "SELECT type_id, entity_id, label, lft, rgt "
-                                                   "FROM entity_tree "
-                                                   "ORDER BY lft");
+    AdocTreeNode *root = createEntityTreeNode(selectRoot, 0, 0);
+    bool hasMultipleRoots = selectRoot.next();
+    selectRoot.finish();
+    if (root == nullptr || hasMultipleRoots)
+    {
+        qDebug() << Q_FUNC_INFO << "Entity tree does not have a single valid root";
+        delete root;
+        throw 0;
+    }
+    entityTreeNodeIds_ << root->nodeId();
 
-    if (!selectEntityNodes.exec())
+    try
+    {
+        root->appendChildren(readEntityTreeChildren(root));
+    }
+    catch (...)
+    {
+        delete root;
+        throw;
+    }
+    root->setCanFetchChildren(false);
+
+    return root;
+}
+
+/**
+  * Returns newly allocated nodes for the children of parent in order. The caller is responsible for adding them to
+  * parent and clearing its canFetchChildren flag. Each node has the canFetchChildren flag set if it has any children
+  * in the data source.
+  *
+  * @param parent [AdocTreeNode *]
+  * @returns QVector<AdocTreeNode *>
+  */
+QVector<AdocTreeNode *> SqliteAdocSource::readEntityTreeChildren(AdocTreeNode *parent)
+{
+    ASSERT(parent != nullptr);
+    QVector<AdocTreeNode *> children;
+    if (parent->nodeId() == 0)
+        return children;
+
+    QSqlQuery selectChildren = getPreparedQuery("readEntityTreeChildren",
+                                                "SELECT id, type_id, entity_id, label, "
+                                                "       EXISTS (SELECT 1 FROM entity_tree b WHERE b.parent_id = a.id) "
+                                                "FROM entity_tree a "
+                                                "WHERE parent_id = ? "
+                                                "ORDER BY position");
+    selectChildren.bindValue(0, parent->nodeId());
+    if (!selectChildren.exec())
     {
-        qDebug() << selectEntityNodes.lastError().text();
+        qDebug() << selectChildren.lastError().text();
         throw 0;
     }
 
-    QVector<AdocMpttNode> mpttNodes;
-    mpttNodes.reserve(nTreeRows);
-    while (selectEntityNodes.next())
+    int row = parent->childCount();
+    while (selectChildren.next())
     {
-        AdocNodeType nodeType = AdocTreeNode::mapNodeType(selectEntityNodes.value(0).toInt());
-        ASSERT(nodeType != eUndefinedNode);
-        if (nodeType == eUndefinedNode)
+        AdocTreeNode *child = createEntityTreeNode(selectChildren, parent->nodeId(), row);
+        if (child == nullptr)
         {
-            Mptt::freeMpttTreeNodes(mpttNodes);
+            qDeleteAll(children);
             throw 0;
         }
 
-        int entityId = (selectEntityNodes.value(1).isNull() == false) ? selectEntityNodes.value(1).toInt() : 0;
-        AdocTreeNode *treeNode = new AdocTreeNode(nodeType, selectEntityNodes.value(2).toString(), entityId);
-        int left = selectEntityNodes.value(3).toInt();
-        int right = selectEntityNodes.value(4).toInt();
-        mpttNodes << AdocMpttNode(treeNode, left, right);
+        children << child;
+        ++row;
     }
+    selectChildren.finish();
 
-    ASSERT(mpttNodes.count() > 0);
-
-    selectTreeRowCount.finish();
-    selectEntityNodes.finish();
+    foreach (AdocTreeNode *child, children)
+        entityTreeNodeIds_ << child->nodeId();
 
-    // C: Convert nodes to a tree
-    try
-    {
-        return Mptt::fromMpttVector(mpttNodes);
-    }
-    catch (InvalidMpttNodeError &e)
-    {
-        qDebug() << Q_FUNC_INFO << e.what();
-        Mptt::freeMpttTreeNodes(mpttNodes);
-        throw;
-    }
-    catch (...)
-    {
-        qDebug() << Q_FUNC_INFO;
-        Mptt::freeMpttTreeNodes(mpttNodes);
-        throw;
-    }
+    return children;
 }
 
 /**
+  * Only writes the changes since the tree was last read or saved: nodes that have never been saved are inserted, nodes
+  * that have been moved, relabeled, or otherwise changed are updated, and nodes no longer present in the tree are
+  * deleted (along with their descendants via the on delete cascade). Unchanged nodes are not written. Rows that have
+  * not yet been read (see readEntityTreeChildren) are left as is and remain beneath their parent.
+  *
+  * Nodes whose rows have since been deleted (e.g. a removal that was undone after saving) are inserted anew. If root
+  * itself has not been saved to this source (e.g. a newly created tree), all existing entity_tree rows are replaced. A
+  * null root removes all entity_tree rows.
+  *
+  * The saved state of each node is only updated once all changes have been written so that the nodes remain
+  * consistent with the database if an error occurs.
+  *
   * root [AdocTreeNode *]
   */
 void SqliteAdocSource::saveEntityTree(AdocTreeNode *root)
 {
-    QSqlQuery emptyTree = getPreparedQuery("truncateEntityTree",
-                                           "DELETE FROM entity_tree");
-
-    if (!emptyTree.exec())
+    if (root == nullptr || !entityTreeNodeIds_.contains(root->nodeId()))
     {
-        qDebug() << emptyTree.lastError().text();
-        throw 0;
-    }
+        QSqlQuery emptyTree = getPreparedQuery("truncateEntityTree",
+                                               "DELETE FROM entity_tree");
 
-    // A. Convert to a list of MpttNodes
-    QVector<AdocMpttNode> mpttNodes = Mptt::toMpttVector(root);
+        if (!emptyTree.exec())
+        {
+            qDebug() << emptyTree.lastError().text();
+            throw 0;
+        }
+
+        entityTreeNodeIds_.clear();
+        if (root == nullptr)
+            return;
+    }
 
-    // B. Insert into the database
     QSqlQuery insert = getPreparedQuery("insertEntityTreeRow",
-                                        "INSERT INTO entity_tree (type_id, type, entity_id, label, lft, rgt) "
+                                        "INSERT INTO entity_tree (parent_id, position, type_id, type, entity_id, label) "
                                         "VALUES (?, ?, ?, ?, ?, ?)");
-
-    foreach (const AdocMpttNode &mpttNode, mpttNodes)
+    QSqlQuery update = getPreparedQuery("updateEntityTreeRow",
+                                        "UPDATE entity_tree "
+                                        "SET parent_id = ?, position = ?, type_id = ?, type = ?, entity_id = ?, label = ? "
+                                        "WHERE id = ?");
+
+    // A. Pre-order traversal such that every parent is inserted before its children. Each stack entry contains a node,
+    //    the node id of its parent, and its row.
+    QVector<QPair<AdocTreeNode *, QPair<int, int> > > stack;
+    stack << qMakePair(root, qMakePair(0, 0));
+
+    QVector<QPair<AdocTreeNode *, QPair<int, int> > > savedNodes;
+    QVector<int> savedNodeIds;
+    QSet<int> nodeIds;
+    nodeIds.reserve(entityTreeNodeIds_.size());
+    while (!stack.isEmpty())
     {
-        AdocTreeNode *treeNode = mpttNode.treeNode_;
+        AdocTreeNode *node = stack.last().first;
+        int parentNodeId = stack.last().second.first;
+        int row = stack.last().second.second;
+        stack.pop_back();
+
+        int nodeId = node->nodeId();
+        bool isSaved = nodeId != 0 && entityTreeNodeIds_.contains(nodeId);
+        if (!isSaved || node->isDirty(parentNodeId, row))
+        {
+            QSqlQuery &query = isSaved ? update : insert;
+            if (parentNodeId != 0)
+                query.bindValue(0, parentNodeId);
+            else
+                query.bindValue(0, QVariant(QVariant::Int));
+            query.bindValue(1, row);
+            query.bindValue(2, node->nodeType_);
+            query.bindValue(3, AdocTreeNode::textForType(node->nodeType_));
+            if (node->entityId() != 0)
+                query.bindValue(4, node->entityId());
+            else
+                query.bindValue(4, QVariant(QVariant::Int));
+            if (node->label_.isEmpty() == false)
+                query.bindValue(5, node->label_);
+            else
+                query.bindValue(5, QVariant(QVariant::String));
+            if (isSaved)
+                query.bindValue(6, nodeId);
+
+            if (!query.exec())
+            {
+                qDebug() << query.lastError().text();
+                throw 0;
+            }
 
-        insert.bindValue(0, treeNode->nodeType_);
-        insert.bindValue(1, AdocTreeNode::textForType(treeNode->nodeType_));
-        if (treeNode->entityId() != 0)
-            insert.bindValue(2, treeNode->entityId());
-        else
-            insert.bindValue(2, QVariant(QVariant::Int));
-        if (treeNode->label_.isEmpty() == false)
-            insert.bindValue(3, treeNode->label_);
-        else
-            insert.bindValue(3, QVariant(QVariant::String));
-        insert.bindValue(4, mpttNode.left_);
-        insert.bindValue(5, mpttNode.right_);
+            if (!isSaved)
+                nodeId = query.lastInsertId().toInt();
 
-        if (!insert.exec())
+            savedNodes << qMakePair(node, qMakePair(parentNodeId, row));
+            savedNodeIds << nodeId;
+        }
+        nodeIds << nodeId;
+
+        // Push the children in reverse so that they are popped in order
+        for (int i=node->childCount()-1; i>=0; --i)
+            stack << qMakePair(node->childAt(i), qMakePair(nodeId, i));
+    }
+    insert.finish();
+    update.finish();
+
+    // B. Remove nodes that are no longer in the tree
+    QSqlQuery remove = getPreparedQuery("deleteEntityTreeRow",
+                                        "DELETE FROM entity_tree WHERE id = ?");
+    foreach (int nodeId, entityTreeNodeIds_)
+    {
+        if (nodeIds.contains(nodeId))
+            continue;
+
+        remove.bindValue(0, nodeId);
+        if (!remove.exec())
         {
-            qDebug() << insert.lastError().text();
+            qDebug() << remove.lastError().text();
             throw 0;
         }
     }
+    remove.finish();
 
-    insert.finish();
+    // C. All changes have been written
+    for (int i=0, z=savedNodes.size(); i<z; ++i)
+        savedNodes.at(i).first->markSaved(savedNodeIds.at(i), savedNodes.at(i).second.first, savedNodes.at(i).second.second);
+    entityTreeNodeIds_ = nodeIds;
+}
+
+/**
+  * Without a prefetcher, request is simply discarded and all records are read on demand.
+  *
+  * @param request [IPrefetchRequest *]
+  * @returns QFuture<void>
+  */
+QFuture<void> SqliteAdocSource::prefetch(IPrefetchRequest *request)
+{
+    if (prefetcher_ == nullptr)
+        return AbstractAdocSource::prefetch(request);
+
+    return prefetcher_->prefetch(request);
+}
+
+/**
+  * @returns int
+  */
+int SqliteAdocSource::prefetchGeneration() const
+{
+    if (prefetcher_ == nullptr)
+        return AbstractAdocSource::prefetchGeneration();
+
+    return prefetcher_->generation();
 }
 
 /**
@@ -458,29 +713,20 @@ void SqliteAdocSource::createTables() const
     QSqlQuery query(db);
 
     // Table: entity_tree
-    if (!query.exec("CREATE TABLE entity_tree ("
-                    "    type_id integer not null,"
-                    "    type text not null,"
-                    "    entity_id integer,"
-                    "    label text,"
-                    "    lft integer not null,"
-                    "    rgt integer not null,"
-                    "    check(lft > 0),"
-                    "    check(rgt > lft)"
-                    ")"))
+    if (!query.exec(createEntityTreeTableSql()))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+
+    if (!query.exec("CREATE INDEX entity_tree_parent_id_position_index ON entity_tree(parent_id, position)"))
     {
         qDebug() << Q_FUNC_INFO << query.lastError().text();
         throw 0;
     }
 
     // Table: astrings
-    if (!query.exec("CREATE TABLE astrings ("
-                    "    id integer not null primary key,"
-                    "    digest text not null,"
-                    "    length integer not null,"
-                    "    sequence text not null,"
-                    "    check(length = length(sequence))"
-                    ");"))
+    if (!query.exec(createAnonSeqTableSql("astrings")))
     {
         qDebug() << Q_FUNC_INFO << query.lastError().text();
         throw 0;
@@ -570,28 +816,14 @@ void SqliteAdocSource::createTables() const
         throw 0;
     }
 
-    if (!query.exec("CREATE TABLE amino_msas_members ("
-                    "    amino_msa_id integer not null,"
-                    "    amino_seq_id integer not null,"
-                    "    position integer not null,"
-                    "    sequence text not null,"
-                    "    primary key(amino_msa_id, amino_seq_id),"
-                    "    foreign key(amino_msa_id) references amino_msas(id) on update cascade on delete cascade,"
-                    "    foreign key(amino_seq_id) references amino_seqs(id) on update cascade on delete cascade"
-                    ");"))
+    if (!query.exec(createMsaMembersTableSql("amino_msas_members", "amino")))
     {
         qDebug() << Q_FUNC_INFO << query.lastError().text();
         throw 0;
     }
 
     // Table: dstrings
-    if (!query.exec("CREATE TABLE dstrings ("
-                    "    id integer not null primary key,"
-                    "    digest text not null,"
-                    "    length integer not null,"
-                    "    sequence text not null,"
-                    "    check(length = length(sequence))"
-                    ");"))
+    if (!query.exec(createAnonSeqTableSql("dstrings")))
     {
         qDebug() << Q_FUNC_INFO << query.lastError().text();
         throw 0;
@@ -696,15 +928,7 @@ void SqliteAdocSource::createTables() const
         throw 0;
     }
 
-    if (!query.exec("CREATE TABLE dna_msas_members ("
-                    "    dna_msa_id integer not null,"
-                    "    dna_seq_id integer not null,"
-                    "    position integer not null,"
-                    "    sequence text not null,"
-                    "    primary key(dna_msa_id, dna_seq_id),"
-                    "    foreign key(dna_msa_id) references dna_msas(id) on update cascade on delete cascade,"
-                    "    foreign key(dna_seq_id) references dna_seqs(id) on update cascade on delete cascade"
-                    ");"))
+    if (!query.exec(createMsaMembersTableSql("dna_msas_members", "dna")))
     {
         qDebug() << Q_FUNC_INFO << query.lastError().text();
         throw 0;
@@ -737,6 +961,8 @@ void SqliteAdocSource::createTables() const
         qDebug() << Q_FUNC_INFO << query.lastError().text();
         throw 0;
     }
+
+    setSchemaVersion(kCurrentSchemaVersion);
 }
 
 /**
@@ -758,6 +984,404 @@ bool SqliteAdocSource::isValidDatabase()
     return query.exec("PRAGMA integrity_check");
 }
 
+/**
+  * Databases without a schema version (version 0) predate versioning and store MD5 sequence digests. Databases with a
+  * version newer than kCurrentSchemaVersion were created by a newer release and are not opened.
+  *
+  * All upgrade steps are performed within a single transaction. Some steps rebuild tables that other tables reference;
+  * therefore, foreign key enforcement is disabled during the upgrade (sqlite ignores this pragma inside a transaction)
+  * and the foreign keys are instead verified just before committing.
+  *
+  * @returns bool
+  */
+bool SqliteAdocSource::migrate()
+{
+    int version = schemaVersion();
+    if (version == kCurrentSchemaVersion)
+        return true;
+
+    if (version < 0 || version > kCurrentSchemaVersion)
+        return false;
+
+    QSqlDatabase db = database();
+    QSqlQuery pragma(db);
+    if (!pragma.exec("PRAGMA foreign_keys = OFF"))
+        return false;
+
+    bool migrated = db.transaction() && migrateFromVersion(version);
+    if (migrated)
+        migrated = db.commit();
+    else
+        db.rollback();
+
+    if (!pragma.exec("PRAGMA foreign_keys = ON"))
+        return false;
+
+    return migrated;
+}
+
+/**
+  * @param version [int]
+  * @returns bool
+  */
+bool SqliteAdocSource::migrateFromVersion(int version)
+{
+    try
+    {
+        // Version 1: astrings and dstrings digests are computed with hash128 rather than MD5
+        if (version < 1)
+        {
+            migrateDigests("astrings");
+            migrateDigests("dstrings");
+        }
+
+        // Version 2: msa members are stored as gap run encodings rather than gapped sequence text
+        if (version < 2)
+        {
+            migrateMsaMembers("amino", "astrings", "astring_id");
+            migrateMsaMembers("dna", "dstrings", "dstring_id");
+        }
+
+        // Version 3: large astrings and dstrings sequences are compressed
+        if (version < 3)
+        {
+            migrateSequenceCodec("astrings");
+            migrateSequenceCodec("dstrings");
+        }
+
+        // Version 4: the entity tree is stored as parent/position rows rather than a modified preorder tree
+        if (version < 4)
+            migrateEntityTree();
+
+        setSchemaVersion(kCurrentSchemaVersion);
+
+        QSqlQuery query(database());
+        if (!query.exec("PRAGMA foreign_key_check") || query.next())
+        {
+            qDebug() << Q_FUNC_INFO << "Foreign key violation after migration";
+            return false;
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+  * Recomputes the digest of every sequence in tableName, which must contain the columns id, digest, and sequence.
+  *
+  * @param tableName [const QString &]
+  */
+void SqliteAdocSource::migrateDigests(const QString &tableName) const
+{
+    QSqlDatabase db = database();
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    if (!select.exec(QString("SELECT id, sequence FROM %1").arg(tableName)))
+    {
+        qDebug() << Q_FUNC_INFO << select.lastError().text();
+        throw 0;
+    }
+
+    // Compute all digests before updating so that the select is not reading from a table that is being modified
+    QVector<QPair<int, QByteArray> > idDigests;
+    while (select.next())
+        idDigests << qMakePair(select.value(0).toInt(), Seq(select.value(1).toByteArray()).digest());
+    select.finish();
+
+    QSqlQuery update(db);
+    if (!update.prepare(QString("UPDATE %1 SET digest = ? WHERE id = ?").arg(tableName)))
+    {
+        qDebug() << Q_FUNC_INFO << update.lastError().text();
+        throw 0;
+    }
+
+    for (int i=0, z=idDigests.size(); i<z; ++i)
+    {
+        update.bindValue(0, idDigests.at(i).second);
+        update.bindValue(1, idDigests.at(i).first);
+        if (!update.exec())
+        {
+            qDebug() << Q_FUNC_INFO << update.lastError().text();
+            throw 0;
+        }
+    }
+}
+
+/**
+  * Converts the modified preorder tree traversal (lft, rgt) rows of entity_tree into parent/position rows. Each node's
+  * parent is the nearest preceding node (in lft order) whose rgt exceeds its lft. Tables that already have the
+  * parent_id column are left as is.
+  *
+  * The old table is renamed (rather than the new one) so that the self-referencing foreign key of the new table
+  * refers to entity_tree regardless of how the sqlite version handles renaming referenced tables.
+  */
+void SqliteAdocSource::migrateEntityTree() const
+{
+    QSqlDatabase db = database();
+    QSqlQuery query(db);
+    if (!query.exec("PRAGMA table_info(entity_tree)"))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+    bool hasParentIdColumn = false;
+    while (query.next() && !hasParentIdColumn)
+        hasParentIdColumn = query.value(1).toString() == "parent_id";
+    query.finish();
+    if (hasParentIdColumn)
+        return;
+
+    if (!query.exec("ALTER TABLE entity_tree RENAME TO entity_tree_v3") ||
+        !query.exec(createEntityTreeTableSql()) ||
+        !query.exec("CREATE INDEX entity_tree_parent_id_position_index ON entity_tree(parent_id, position)"))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    if (!select.exec("SELECT type_id, type, entity_id, label, lft, rgt FROM entity_tree_v3 ORDER BY lft"))
+    {
+        qDebug() << Q_FUNC_INFO << select.lastError().text();
+        throw 0;
+    }
+
+    QSqlQuery insert(db);
+    if (!insert.prepare("INSERT INTO entity_tree (id, parent_id, position, type_id, type, entity_id, label) "
+                        "VALUES (?, ?, ?, ?, ?, ?, ?)"))
+    {
+        qDebug() << Q_FUNC_INFO << insert.lastError().text();
+        throw 0;
+    }
+
+    // Each ancestor entry contains the node id, its rgt value, and the number of children inserted thus far
+    QVector<QPair<int, QPair<int, int> > > ancestors;
+    int nodeId = 0;
+    while (select.next())
+    {
+        int left = select.value(4).toInt();
+        int right = select.value(5).toInt();
+        while (!ancestors.isEmpty() && ancestors.last().second.first < left)
+            ancestors.pop_back();
+
+        ++nodeId;
+        if (ancestors.isEmpty())
+        {
+            if (nodeId != 1)
+            {
+                qDebug() << Q_FUNC_INFO << "Entity tree contains multiple roots";
+                throw 0;
+            }
+            insert.bindValue(1, QVariant(QVariant::Int));
+            insert.bindValue(2, 0);
+        }
+        else
+        {
+            insert.bindValue(1, ancestors.last().first);
+            insert.bindValue(2, ancestors.last().second.second);
+            ++ancestors.last().second.second;
+        }
+        insert.bindValue(0, nodeId);
+        insert.bindValue(3, select.value(0));
+        insert.bindValue(4, select.value(1));
+        insert.bindValue(5, select.value(2));
+        insert.bindValue(6, select.value(3));
+        if (!insert.exec())
+        {
+            qDebug() << Q_FUNC_INFO << insert.lastError().text();
+            throw 0;
+        }
+
+        ancestors << qMakePair(nodeId, qMakePair(right, 0));
+    }
+    select.finish();
+    insert.finish();
+
+    if (!query.exec("DROP TABLE entity_tree_v3"))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+}
+
+/**
+  * Converts the gapped sequence text of each member in the prefix_msas_members table (e.g. amino_msas_members) into
+  * its gap run encoding. The table is rebuilt (rather than altered) because sqlite cannot drop columns. Tables that
+  * already have the gap_runs column are left as is.
+  *
+  * @param prefix [const QString &]
+  * @param anonSeqTableName [const QString &]
+  * @param anonSeqIdColumn [const QString &]
+  */
+void SqliteAdocSource::migrateMsaMembers(const QString &prefix,
+                                         const QString &anonSeqTableName,
+                                         const QString &anonSeqIdColumn) const
+{
+    QString tableName = prefix + "_msas_members";
+    QString newTableName = tableName + "_v2";
+
+    QSqlDatabase db = database();
+    QSqlQuery query(db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(tableName)))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+    bool hasSequenceColumn = false;
+    while (query.next() && !hasSequenceColumn)
+        hasSequenceColumn = query.value(1).toString() == "sequence";
+    query.finish();
+    if (!hasSequenceColumn)
+        return;
+
+    if (!query.exec(createMsaMembersTableSql(newTableName, prefix)))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    if (!select.exec(QString("SELECT a.%1_msa_id, a.%1_seq_id, a.position, a.sequence, c.sequence "
+                             "FROM %2 a JOIN %1_seqs b ON (a.%1_seq_id = b.id) "
+                             "JOIN %3 c ON (b.%4 = c.id)").arg(prefix, tableName, anonSeqTableName, anonSeqIdColumn)))
+    {
+        qDebug() << Q_FUNC_INFO << select.lastError().text();
+        throw 0;
+    }
+
+    QSqlQuery insert(db);
+    if (!insert.prepare(QString("INSERT INTO %1 (%2_msa_id, %2_seq_id, position, gap_runs) "
+                                "VALUES (?, ?, ?, ?)").arg(newTableName, prefix)))
+    {
+        qDebug() << Q_FUNC_INFO << insert.lastError().text();
+        throw 0;
+    }
+
+    while (select.next())
+    {
+        Seq parentSeq(select.value(4).toByteArray());
+        Subseq subseq(parentSeq);
+        if (!subseq.setBioString(select.value(3).toByteArray()))
+        {
+            qDebug() << Q_FUNC_INFO << "Msa member is not a subsequence of its parent sequence";
+            throw 0;
+        }
+
+        insert.bindValue(0, select.value(0));
+        insert.bindValue(1, select.value(1));
+        insert.bindValue(2, select.value(2));
+        insert.bindValue(3, subseq.gapRunEncoding());
+        if (!insert.exec())
+        {
+            qDebug() << Q_FUNC_INFO << insert.lastError().text();
+            throw 0;
+        }
+    }
+    select.finish();
+    insert.finish();
+
+    if (!query.exec(QString("DROP TABLE %1").arg(tableName)) ||
+        !query.exec(QString("ALTER TABLE %1 RENAME TO %2").arg(newTableName, tableName)))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+}
+
+/**
+  * Rebuilds tableName (astrings or dstrings) with a codec column and stores each of its sequences via
+  * SequenceCodec::encode. Tables that already have the codec column are left as is.
+  *
+  * @param tableName [const QString &]
+  */
+void SqliteAdocSource::migrateSequenceCodec(const QString &tableName) const
+{
+    QString newTableName = tableName + "_v3";
+
+    QSqlDatabase db = database();
+    QSqlQuery query(db);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(tableName)))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+    bool hasCodecColumn = false;
+    while (query.next() && !hasCodecColumn)
+        hasCodecColumn = query.value(1).toString() == "codec";
+    query.finish();
+    if (hasCodecColumn)
+        return;
+
+    if (!query.exec(createAnonSeqTableSql(newTableName)))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    if (!select.exec(QString("SELECT id, digest, length, sequence FROM %1").arg(tableName)))
+    {
+        qDebug() << Q_FUNC_INFO << select.lastError().text();
+        throw 0;
+    }
+
+    QSqlQuery insert(db);
+    if (!insert.prepare(QString("INSERT INTO %1 (id, digest, length, codec, sequence) "
+                                "VALUES (?, ?, ?, ?, ?)").arg(newTableName)))
+    {
+        qDebug() << Q_FUNC_INFO << insert.lastError().text();
+        throw 0;
+    }
+
+    while (select.next())
+    {
+        SequenceCodec::Codec codec;
+        QByteArray data = SequenceCodec::encode(select.value(3).toByteArray(), codec);
+
+        insert.bindValue(0, select.value(0));
+        insert.bindValue(1, select.value(1));
+        insert.bindValue(2, select.value(2));
+        insert.bindValue(3, codec);
+        insert.bindValue(4, data);
+        if (!insert.exec())
+        {
+            qDebug() << Q_FUNC_INFO << insert.lastError().text();
+            throw 0;
+        }
+    }
+    select.finish();
+    insert.finish();
+
+    // Foreign keys referencing tableName are preserved because foreign key enforcement is disabled (see migrate)
+    if (!query.exec(QString("DROP TABLE %1").arg(tableName)) ||
+        !query.exec(QString("ALTER TABLE %1 RENAME TO %2").arg(newTableName, tableName)) ||
+        !query.exec(QString("CREATE INDEX %1_digest_index ON %1(digest)").arg(tableName)))
+    {
+        qDebug() << Q_FUNC_INFO << query.lastError().text();
+        throw 0;
+    }
+}
+
+/**
+  * Each SqliteAdocSource (including those used by SqliteAdocPrefetcher on another thread) requires its own connection
+  * name because QSqlDatabase::addDatabase replaces any existing connection with the same name. The counter is atomic
+  * because connections may be opened from multiple threads.
+  *
+  * @param fileName [const QString &]
+  * @returns QString
+  */
+QString SqliteAdocSource::nextConnectionName(const QString &fileName)
+{
+    return QFileInfo(fileName).fileName() + QString::number(connectionNumber_.fetchAndAddOrdered(1));
+}
+
 /**
   * @param fileName [const QString &]
   * @returns bool
@@ -768,7 +1392,7 @@ bool SqliteAdocSource::openOrCreate(const QString &fileName)
     if (connectionName_.isEmpty() == false)
         close();
 
-    QString connectionName = QFileInfo(fileName).fileName() + QString::number(connectionNumber_);
+    QString connectionName = nextConnectionName(fileName);
     bool opened = false;
     {
         // Hide the QSqlDatabase reference inside a code block so that we can remove it later if it failed to open
@@ -783,7 +1407,6 @@ bool SqliteAdocSource::openOrCreate(const QString &fileName)
     }
 
     connectionName_ = connectionName;
-    ++connectionNumber_;
 
     fileName_ = fileName;
 
@@ -814,27 +1437,68 @@ void SqliteAdocSource::runPragmas()
         throw 0;
     }
 
-    if (!query.exec("pragma journal_mode = memory"))
+    // Write-ahead logging keeps commits append-only and permits other connections (e.g. the SqliteAdocCompactor
+    // thread) to write while this connection reads. In-memory databases do not support it.
+    if (fileName_ == ":memory:")
+    {
+        if (!query.exec("pragma journal_mode = memory"))
+        {
+            qDebug() << Q_FUNC_INFO << query.lastError().text();
+            throw 0;
+        }
+    }
+    else
+    {
+        if (!query.exec("pragma journal_mode = WAL"))
+        {
+            qDebug() << Q_FUNC_INFO << query.lastError().text();
+            throw 0;
+        }
+
+        // In WAL mode, synchronous = normal remains consistent after a crash and only syncs during checkpoints
+        if (!query.exec("pragma synchronous = normal"))
+        {
+            qDebug() << Q_FUNC_INFO << query.lastError().text();
+            throw 0;
+        }
+    }
+}
+
+/**
+  * @returns int
+  */
+int SqliteAdocSource::schemaVersion() const
+{
+    QSqlQuery query(database());
+    if (!query.exec("PRAGMA user_version") || !query.next())
+        return -1;
+
+    return query.value(0).toInt();
+}
+
+/**
+  * @param version [int]
+  */
+void SqliteAdocSource::setSchemaVersion(int version) const
+{
+    QSqlQuery query(database());
+    if (!query.exec(QString("PRAGMA user_version = %1").arg(version)))
     {
         qDebug() << Q_FUNC_INFO << query.lastError().text();
         throw 0;
     }
-
-//    if (!query.exec("pragma synchronous = off"))
-    //        throw;
 }
 
 /**
   */
-void SqliteAdocSource::removeCruftAstrings()
+void SqliteAdocSource::removeCruftAstrings(const QSqlDatabase &database)
 {
-    QSqlQuery query = getPreparedQuery("removeCruftAstrings",
-                                       "DELETE FROM astrings "
-                                       "WHERE id IN ( "
-                                       "  SELECT a.id "
-                                       "  FROM astrings a LEFT OUTER JOIN amino_seqs b ON (a.id = b.astring_id) "
-                                       "  WHERE b.astring_id is null)");
-    if (!query.exec())
+    QSqlQuery query(database);
+    if (!query.exec("DELETE FROM astrings "
+                    "WHERE id IN ( "
+                    "  SELECT a.id "
+                    "  FROM astrings a LEFT OUTER JOIN amino_seqs b ON (a.id = b.astring_id) "
+                    "  WHERE b.astring_id is null)"))
     {
         qDebug() << query.lastError().text();
         throw 0;
@@ -843,31 +1507,28 @@ void SqliteAdocSource::removeCruftAstrings()
 
 /**
   */
-void SqliteAdocSource::removeCruftDstrings()
+void SqliteAdocSource::removeCruftDstrings(const QSqlDatabase &database)
 {
-    QSqlQuery query = getPreparedQuery("removeCruftDstrings",
-                                       "DELETE FROM dstrings "
-                                       "WHERE id IN ( "
-                                       "  SELECT a.id "
-                                       "  FROM dstrings a LEFT OUTER JOIN dna_seqs b ON (a.id = b.dstring_id) "
-                                       "  WHERE b.dstring_id is null)");
-    if (!query.exec())
+    QSqlQuery query(database);
+    if (!query.exec("DELETE FROM dstrings "
+                    "WHERE id IN ( "
+                    "  SELECT a.id "
+                    "  FROM dstrings a LEFT OUTER JOIN dna_seqs b ON (a.id = b.dstring_id) "
+                    "  WHERE b.dstring_id is null)"))
     {
         qDebug() << query.lastError().text();
         throw 0;
     }
 }
 
-void SqliteAdocSource::removeOrphanPrimerSearchParameters()
+void SqliteAdocSource::removeOrphanPrimerSearchParameters(const QSqlDatabase &database)
 {
-    QSqlQuery query = getPreparedQuery("removeOrphanPrimerSearchParameters",
-                                       "DELETE FROM primer_search_parameters "
-                                       "WHERE id IN ("
-                                       "   SELECT a.id"
-                                       "   FROM primer_search_parameters a LEFT OUTER JOIN primers b ON (a.id = b.primer_search_parameters_id) "
-                                       "   WHERE b.primer_search_parameters_id is null)");
-
-    if (!query.exec())
+    QSqlQuery query(database);
+    if (!query.exec("DELETE FROM primer_search_parameters "
+                    "WHERE id IN ("
+                    "   SELECT a.id"
+                    "   FROM primer_search_parameters a LEFT OUTER JOIN primers b ON (a.id = b.primer_search_parameters_id) "
+                    "   WHERE b.primer_search_parameters_id is null)"))
     {
         qDebug() << query.lastError().text();
         throw 0;
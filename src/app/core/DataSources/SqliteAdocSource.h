@@ -9,6 +9,8 @@
 #ifndef SQLITEADOCSOURCE_H
 #define SQLITEADOCSOURCE_H
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtSql/QSqlDatabase>
 
@@ -23,6 +25,8 @@
 #include "Crud/DbAminoMsaCrud.h"
 #include "Crud/DbDnaMsaCrud.h"
 
+class SqliteAdocPrefetcher;
+
 class SqliteAdocSource : public AbstractAdocSource,
                          public AbstractDbSource
 {
@@ -35,12 +39,15 @@ public:
 
     // -------------------------------------------------------------------------------------------------
     // Public methods
+    //! Opens another connection to fileName, which must already be open (and thus validated and migrated) elsewhere
+    bool attach(const QString &fileName);
     void close();
     bool createAndOpen(const QString &fileName);
     bool isOpen() const;
     QString fileName() const;
     bool open(const QString &fileName);
     bool saveAs(const QString &fileName);
+    void setPrefetcher(SqliteAdocPrefetcher *prefetcher);  // Services prefetch requests; not owned
 
 
     // -------------------------------------------------------------------------------------------------
@@ -52,9 +59,13 @@ public:
     void removeCruft();
     void vacuum();
 
-    AdocTreeNode *readEntityTree();
+    AdocTreeNode *readEntityTree();             // Reads the root and its children; deeper nodes are read on demand
+    QVector<AdocTreeNode *> readEntityTreeChildren(AdocTreeNode *parent);
     void saveEntityTree(AdocTreeNode *root);
 
+    QFuture<void> prefetch(IPrefetchRequest *request);
+    int prefetchGeneration() const;
+
     IAnonSeqEntityCrud<Astring, AstringPod> *astringCrud();
     IEntityCrud<AminoSeq, AminoSeqPod> *aminoSeqCrud();
     IAnonSeqEntityCrud<Dstring, DstringPod> *dstringCrud();
@@ -65,21 +76,39 @@ public:
 
     IBlastReportCrud *blastReportCrud();
 
+
+    // -------------------------------------------------------------------------------------------------
+    // Static public methods
+    static void removeCruft(const QSqlDatabase &database);      // Removes all unreferenced records via database
+
 private:
     void createTables() const;
     QSqlDatabase database() const;
     bool isValidDatabase();
+    bool migrate();                 // Upgrades the schema of an older database to kCurrentSchemaVersion
+    void migrateDigests(const QString &tableName) const;
+    void migrateEntityTree() const;
+    bool migrateFromVersion(int version);   // Performs each upgrade step newer than version (within the current transaction)
+    void migrateMsaMembers(const QString &prefix, const QString &anonSeqTableName, const QString &anonSeqIdColumn) const;
+    void migrateSequenceCodec(const QString &tableName) const;
     bool openOrCreate(const QString &fileName);
+    static QString nextConnectionName(const QString &fileName); // Returns a connection name that is unique across all threads
     void runPragmas();              // Sets up pragmas that should be present for every database connection
+    int schemaVersion() const;      // Returns the schema version (sqlite user_version) or -1 if it could not be read
+    void setSchemaVersion(int version) const;
 
     // Specific cruft-removal methods
-    void removeCruftAstrings();
-    void removeCruftDstrings();
-    void removeOrphanPrimerSearchParameters();
+    static void removeCruftAstrings(const QSqlDatabase &database);
+    static void removeCruftDstrings(const QSqlDatabase &database);
+    static void removeOrphanPrimerSearchParameters(const QSqlDatabase &database);
+
+    static const int kCurrentSchemaVersion = 4;
 
     QString connectionName_;
-    static int connectionNumber_;
+    static QAtomicInt connectionNumber_;
     QString fileName_;
+    QSet<int> entityTreeNodeIds_;   // Identifiers of the entity_tree rows that have been read or saved
+    SqliteAdocPrefetcher *prefetcher_;
 
     DbAstringCrud astringCrud_;
     DbAminoSeqCrud aminoSeqCrud_;
@@ -2,9 +2,17 @@
 #include <QtCore/QString>
 #include <QtTest/QtTest>
 #include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
 
+#include "../IPrefetchRequest.h"
+#include "../SqliteAdocCompactor.h"
+#include "../SqliteAdocPrefetcher.h"
 #include "../SqliteAdocSource.h"
+#include "../Crud/SequenceCodec.h"
 #include "../../AdocTreeNode.h"
+#include "../../Entities/Astring.h"
+#include "../../Seq.h"
+#include "../../Subseq.h"
 
 class TestSqliteAdocSource : public QObject
 {
@@ -20,6 +28,38 @@ private Q_SLOTS:
 
     void readEntityTree();
     void saveEntityTree();
+    void saveEntityTreeIncremental();
+
+    void schemaVersion();
+    void migrateDigests();
+    void migrateMsaMembers();
+    void migrateSequenceCodec();
+    void migrateEntityTree();
+
+    void compactor();
+    void prefetcher();
+    void prefetcherSaveAs();
+};
+
+// Records the thread it was run in and the astrings it read
+class ReadAstringsRequest : public IPrefetchRequest
+{
+public:
+    ReadAstringsRequest(const QVector<int> &ids, QThread **thread, QVector<AstringPod> *pods)
+        : ids_(ids), thread_(thread), pods_(pods)
+    {
+    }
+
+    void run(IAdocSource *adocSource)
+    {
+        *thread_ = QThread::currentThread();
+        *pods_ = adocSource->crud(static_cast<Astring *>(nullptr))->read(ids_);
+    }
+
+private:
+    QVector<int> ids_;
+    QThread **thread_;
+    QVector<AstringPod> *pods_;
 };
 
 void TestSqliteAdocSource::createAndOpen()
@@ -102,51 +142,101 @@ void TestSqliteAdocSource::readEntityTree()
 
     // Test: insert some data and see how it loads
     QSqlQuery query(source.database());
-    if (!query.prepare("INSERT INTO entity_tree (type_id, type, entity_id, label, lft, rgt) "
-                       "VALUES (?, ?, ?, ?, ?, ?)"))
+    if (!query.prepare("INSERT INTO entity_tree (id, parent_id, position, type_id, type, entity_id, label) "
+                       "VALUES (?, ?, ?, ?, ?, ?, ?)"))
     {
         qDebug() << query.lastError().text();
         QVERIFY(0);
     }
 
-    query.bindValue(0, eRootNode);
-    query.bindValue(1, "Root");
-    query.bindValue(2, QVariant(QVariant::Int));
-    query.bindValue(3, "Root");
-    query.bindValue(4, 1);
-    query.bindValue(5, 6);
+    query.bindValue(0, 1);
+    query.bindValue(1, QVariant(QVariant::Int));
+    query.bindValue(2, 0);
+    query.bindValue(3, eRootNode);
+    query.bindValue(4, "Root");
+    query.bindValue(5, QVariant(QVariant::Int));
+    query.bindValue(6, "Root");
     QVERIFY(query.exec());
 
-    query.bindValue(0, eGroupNode);
-    query.bindValue(1, "Group");
-    query.bindValue(2, QVariant(QVariant::Int));
-    query.bindValue(3, "PAS domains");
-    query.bindValue(4, 2);
-    query.bindValue(5, 3);
+    query.bindValue(0, 4);
+    query.bindValue(1, 1);
+    query.bindValue(2, 0);
+    query.bindValue(3, eGroupNode);
+    query.bindValue(4, "Group");
+    query.bindValue(5, QVariant(QVariant::Int));
+    query.bindValue(6, "Domains");
     QVERIFY(query.exec());
 
-    query.bindValue(0, eGroupNode);
-    query.bindValue(1, "Group");
-    query.bindValue(2, QVariant(QVariant::Int));
-    query.bindValue(3, "ChIP-Seq");
-    query.bindValue(4, 4);
-    query.bindValue(5, 5);
+    // Insert the second child first and with smaller ids than their parent to check that rows are ordered by position
+    query.bindValue(0, 2);
+    query.bindValue(1, 4);
+    query.bindValue(2, 1);
+    query.bindValue(3, eGroupNode);
+    query.bindValue(4, "Group");
+    query.bindValue(5, QVariant(QVariant::Int));
+    query.bindValue(6, "ChIP-Seq");
     QVERIFY(query.exec());
 
+    query.bindValue(0, 3);
+    query.bindValue(1, 4);
+    query.bindValue(2, 0);
+    query.bindValue(3, eGroupNode);
+    query.bindValue(4, "Group");
+    query.bindValue(5, QVariant(QVariant::Int));
+    query.bindValue(6, "PAS domains");
+    QVERIFY(query.exec());
+
+    // Test: only the root and its children are read initially
     root = source.readEntityTree();
-    QCOMPARE(root->childCount(), 2);
-    QCOMPARE(root->childAt(0)->nodeType_, eGroupNode);
-    QCOMPARE(root->childAt(0)->entityId(), 0);
-    QCOMPARE(root->childAt(0)->label_, QString("PAS domains"));
-    QCOMPARE(root->childAt(0)->childCount(), 0);
-
-    QCOMPARE(root->childAt(1)->nodeType_, eGroupNode);
-    QCOMPARE(root->childAt(1)->entityId(), 0);
-    QCOMPARE(root->childAt(1)->label_, QString("ChIP-Seq"));
-    QCOMPARE(root->childAt(1)->childCount(), 0);
+    QCOMPARE(root->nodeId(), 1);
+    QVERIFY(root->canFetchChildren() == false);
+    QCOMPARE(root->childCount(), 1);
+    QCOMPARE(root->childAt(0)->label_, QString("Domains"));
+    QCOMPARE(root->childAt(0)->nodeId(), 4);
+    QVERIFY(root->isDirty(0, 0) == false);
+    QVERIFY(root->childAt(0)->isDirty(1, 0) == false);
+
+    AdocTreeNode *domains = root->childAt(0);
+    QCOMPARE(domains->childCount(), 0);
+    QVERIFY(domains->canFetchChildren());
+
+    // Test: read the children on demand
+    AdocTreeNodeVector children = source.readEntityTreeChildren(domains);
+    QCOMPARE(children.size(), 2);
+    QCOMPARE(domains->childCount(), 0);
+    domains->appendChildren(children);
+    domains->setCanFetchChildren(false);
+
+    QCOMPARE(domains->childAt(0)->nodeType_, eGroupNode);
+    QCOMPARE(domains->childAt(0)->entityId(), 0);
+    QCOMPARE(domains->childAt(0)->label_, QString("PAS domains"));
+    QCOMPARE(domains->childAt(0)->childCount(), 0);
+    QVERIFY(domains->childAt(0)->canFetchChildren() == false);
+    QVERIFY(domains->childAt(0)->isDirty(4, 0) == false);
+
+    QCOMPARE(domains->childAt(1)->nodeType_, eGroupNode);
+    QCOMPARE(domains->childAt(1)->entityId(), 0);
+    QCOMPARE(domains->childAt(1)->label_, QString("ChIP-Seq"));
+    QCOMPARE(domains->childAt(1)->childCount(), 0);
+    QVERIFY(domains->childAt(1)->canFetchChildren() == false);
+    QVERIFY(domains->childAt(1)->isDirty(4, 1) == false);
+
+    QVERIFY(source.readEntityTreeChildren(domains->childAt(0)).isEmpty());
     delete root;
     root = nullptr;
 
+    // Test: multiple roots denote a corrupt tree
+    QVERIFY(query.exec("UPDATE entity_tree SET parent_id = NULL WHERE id = 4"));
+    try
+    {
+        root = source.readEntityTree();
+        QVERIFY(0);
+    }
+    catch (...)
+    {
+    }
+    QVERIFY(root == nullptr);
+
     source.close();
 }
 
@@ -161,19 +251,19 @@ void TestSqliteAdocSource::saveEntityTree()
 
     // Test: make sure that all prior records are erased
     QSqlQuery insert(source.database());
-    if (!insert.prepare("INSERT INTO entity_tree (type_id, type, entity_id, label, lft, rgt) "
+    if (!insert.prepare("INSERT INTO entity_tree (parent_id, position, type_id, type, entity_id, label) "
                        "VALUES (?, ?, ?, ?, ?, ?)"))
     {
         qDebug() << insert.lastError().text();
         QVERIFY(0);
     }
 
-    insert.bindValue(0, eGroupNode);
-    insert.bindValue(1, "Dummy");
-    insert.bindValue(2, QVariant(QVariant::Int));
-    insert.bindValue(3, "Dummy node");
-    insert.bindValue(4, 1);
-    insert.bindValue(5, 6);
+    insert.bindValue(0, QVariant(QVariant::Int));
+    insert.bindValue(1, 0);
+    insert.bindValue(2, eGroupNode);
+    insert.bindValue(3, "Dummy");
+    insert.bindValue(4, QVariant(QVariant::Int));
+    insert.bindValue(5, "Dummy node");
     QVERIFY(insert.exec());
 
     source.saveEntityTree(nullptr);
@@ -183,12 +273,6 @@ void TestSqliteAdocSource::saveEntityTree()
     QCOMPARE(query.value(0).toInt(), 0);
 
     // Test: repeat the above, but this time with a real tree
-    insert.bindValue(0, eGroupNode);
-    insert.bindValue(1, "Dummy");
-    insert.bindValue(2, QVariant(QVariant::Int));
-    insert.bindValue(3, "Dummy node");
-    insert.bindValue(4, 1);
-    insert.bindValue(5, 6);
     QVERIFY(insert.exec());
 
     AdocTreeNode *root = new AdocTreeNode(eRootNode, "Root");
@@ -207,6 +291,8 @@ void TestSqliteAdocSource::saveEntityTree()
     QVERIFY(query.exec("SELECT count(*) FROM entity_tree"));
     QVERIFY(query.next());
     QCOMPARE(query.value(0).toInt(), 3);
+    QVERIFY(root->nodeId() != 0);
+    QVERIFY(root->childAt(1)->isDirty(root->nodeId(), 1) == false);
 
     // Test: re-read the entries to make sure they were saved properly
     AdocTreeNode *root2 = source.readEntityTree();
@@ -223,6 +309,579 @@ void TestSqliteAdocSource::saveEntityTree()
     source.close();
 }
 
+void TestSqliteAdocSource::saveEntityTreeIncremental()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+
+    AdocTreeNode *root = new AdocTreeNode(eRootNode, "Root");
+    AdocTreeNode *groupA = new AdocTreeNode(eGroupNode, "A");
+    AdocTreeNode *groupB = new AdocTreeNode(eGroupNode, "B");
+    root->appendChild(groupA);
+    root->appendChild(groupB);
+    groupA->appendChild(new AdocTreeNode(eAminoSeqNode, QString(), 5));
+    groupA->appendChild(new AdocTreeNode(eAminoSeqNode, QString(), 6));
+    source.saveEntityTree(root);
+
+    // Use a trigger to record which rows are written by each save
+    QSqlQuery query(source.database());
+    QVERIFY(query.exec("CREATE TABLE writes (id integer)"));
+    QVERIFY(query.exec("CREATE TRIGGER entity_tree_insert AFTER INSERT ON entity_tree "
+                       "BEGIN INSERT INTO writes VALUES (new.id); END"));
+    QVERIFY(query.exec("CREATE TRIGGER entity_tree_update AFTER UPDATE ON entity_tree "
+                       "BEGIN INSERT INTO writes VALUES (new.id); END"));
+
+    // Test: saving an unchanged tree does not write anything
+    source.saveEntityTree(root);
+    QVERIFY(query.exec("SELECT count(*) FROM writes"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+
+    // Test: relabeling a node only writes that node
+    groupB->label_ = "B2";
+    source.saveEntityTree(root);
+    QVERIFY(query.exec("SELECT id FROM writes"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), groupB->nodeId());
+    QVERIFY(!query.next());
+    QVERIFY(query.exec("DELETE FROM writes"));
+
+    // Test: moving a node writes it and the siblings whose positions changed
+    AdocTreeNode *seq6 = groupA->childAt(1);
+    groupB->appendChild(groupA->takeChildAt(0));
+    source.saveEntityTree(root);
+    QVERIFY(query.exec("SELECT count(*) FROM writes"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 2);
+    QVERIFY(query.prepare("SELECT parent_id, position FROM entity_tree WHERE id = ?"));
+    query.bindValue(0, seq6->nodeId());
+    QVERIFY(query.exec());
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), groupA->nodeId());
+    QCOMPARE(query.value(1).toInt(), 0);
+    QVERIFY(query.exec("DELETE FROM writes"));
+
+    // Test: removing a node deletes it and its descendants without writing any other rows
+    root->removeChildAt(1);
+    source.saveEntityTree(root);
+    QVERIFY(query.exec("SELECT count(*) FROM writes"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+    QVERIFY(query.exec("SELECT count(*) FROM entity_tree"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 3);
+
+    // Test: a node restored after its row was deleted (e.g. undoing a removal) is inserted anew with its descendants
+    int groupANodeId = groupA->nodeId();
+    root->takeChildAt(0);
+    source.saveEntityTree(root);
+    QVERIFY(query.exec("SELECT count(*) FROM entity_tree"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 1);
+
+    root->appendChild(groupA);
+    source.saveEntityTree(root);
+    QVERIFY(query.exec("SELECT count(*) FROM entity_tree"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 3);
+    QVERIFY(groupA->nodeId() != groupANodeId);
+    QVERIFY(query.exec("DELETE FROM writes"));
+
+    // Test: the saved tree is read back identically
+    AdocTreeNode *root2 = source.readEntityTree();
+    QCOMPARE(root2->childCount(), 1);
+    QVERIFY(*root2->childAt(0) == *groupA);
+    QVERIFY(root2->childAt(0)->canFetchChildren());
+
+    // Test: saving a tree with children that have not been read leaves those children as is
+    root2->childAt(0)->label_ = "A2";
+    source.saveEntityTree(root2);
+    QVERIFY(query.exec("SELECT count(*) FROM entity_tree"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 3);
+    QVERIFY(query.exec("DELETE FROM writes"));
+
+    root2->childAt(0)->appendChildren(source.readEntityTreeChildren(root2->childAt(0)));
+    root2->childAt(0)->setCanFetchChildren(false);
+    QCOMPARE(root2->childAt(0)->childCount(), 1);
+    QVERIFY(*root2->childAt(0)->childAt(0) == *seq6);
+
+    // Test: a node added to the re-read tree is inserted beneath its parent
+    root2->childAt(0)->appendChild(new AdocTreeNode(eAminoSeqNode, QString(), 7));
+    source.saveEntityTree(root2);
+    QVERIFY(query.exec("SELECT count(*) FROM writes"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 1);
+    QVERIFY(query.exec("SELECT count(*) FROM entity_tree WHERE entity_id = 7 AND position = 1"));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 1);
+
+    delete root;
+    delete root2;
+    source.close();
+
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::schemaVersion()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+    QCOMPARE(source.schemaVersion(), SqliteAdocSource::kCurrentSchemaVersion);
+    source.close();
+
+    QVERIFY(source.open(fileName));
+    QCOMPARE(source.schemaVersion(), SqliteAdocSource::kCurrentSchemaVersion);
+
+    // Test: databases from a newer version should not be opened
+    source.setSchemaVersion(SqliteAdocSource::kCurrentSchemaVersion + 1);
+    source.close();
+    QVERIFY(source.open(fileName) == false);
+    QVERIFY(source.isOpen() == false);
+
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::migrateDigests()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+
+    // Setup: simulate an unversioned database containing MD5 digests
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.prepare("INSERT INTO astrings (digest, length, sequence) VALUES (?, ?, ?)"));
+        query.bindValue(0, QCryptographicHash::hash("ACDEF", QCryptographicHash::Md5));
+        query.bindValue(1, 5);
+        query.bindValue(2, "ACDEF");
+        QVERIFY(query.exec());
+
+        QVERIFY(query.prepare("INSERT INTO dstrings (digest, length, sequence) VALUES (?, ?, ?)"));
+        query.bindValue(0, QCryptographicHash::hash("ACGT", QCryptographicHash::Md5));
+        query.bindValue(1, 4);
+        query.bindValue(2, "ACGT");
+        QVERIFY(query.exec());
+        query.bindValue(0, QCryptographicHash::hash("TTTT", QCryptographicHash::Md5));
+        query.bindValue(1, 4);
+        query.bindValue(2, "TTTT");
+        QVERIFY(query.exec());
+    }
+    source.setSchemaVersion(0);
+    source.close();
+
+    QVERIFY(source.open(fileName));
+    QCOMPARE(source.schemaVersion(), SqliteAdocSource::kCurrentSchemaVersion);
+
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("SELECT digest FROM astrings"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toByteArray(), Seq("ACDEF").digest());
+        QVERIFY(!query.next());
+
+        QVERIFY(query.exec("SELECT digest FROM dstrings ORDER BY id"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toByteArray(), Seq("ACGT").digest());
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toByteArray(), Seq("TTTT").digest());
+        QVERIFY(!query.next());
+    }
+
+    // Test: the migrated digests are found via the crud interface
+    QCOMPARE(source.dstringCrud()->readByDigests(QVector<QByteArray>() << Seq("TTTT").digest()).first().seq_.constData(), "TTTT");
+    source.close();
+
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::migrateMsaMembers()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+
+    // Setup: simulate a version 1 database in which msa members are stored as gapped sequence text
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("DROP TABLE amino_msas_members"));
+        QVERIFY(query.exec("CREATE TABLE amino_msas_members ("
+                           "    amino_msa_id integer not null,"
+                           "    amino_seq_id integer not null,"
+                           "    position integer not null,"
+                           "    sequence text not null,"
+                           "    primary key(amino_msa_id, amino_seq_id),"
+                           "    foreign key(amino_msa_id) references amino_msas(id) on update cascade on delete cascade,"
+                           "    foreign key(amino_seq_id) references amino_seqs(id) on update cascade on delete cascade"
+                           ");"));
+
+        QVERIFY(query.exec("INSERT INTO astrings (id, digest, length, sequence) VALUES (1, 'x', 6, 'ABCDEF')"));
+        QVERIFY(query.exec("INSERT INTO astrings (id, digest, length, sequence) VALUES (2, 'y', 4, 'WXYZ')"));
+        QVERIFY(query.exec("INSERT INTO amino_seqs (id, astring_id, start, stop) VALUES (1, 1, 1, 6)"));
+        QVERIFY(query.exec("INSERT INTO amino_seqs (id, astring_id, start, stop) VALUES (2, 2, 1, 4)"));
+        QVERIFY(query.exec("INSERT INTO amino_msas (id, name) VALUES (1, 'msa')"));
+        QVERIFY(query.exec("INSERT INTO amino_msas_members (amino_msa_id, amino_seq_id, position, sequence) "
+                           "VALUES (1, 1, 1, '--BC-D')"));
+        QVERIFY(query.exec("INSERT INTO amino_msas_members (amino_msa_id, amino_seq_id, position, sequence) "
+                           "VALUES (1, 2, 2, '.WX.YZ')"));
+    }
+    source.setSchemaVersion(1);
+    source.close();
+
+    QVERIFY(source.open(fileName));
+    QCOMPARE(source.schemaVersion(), SqliteAdocSource::kCurrentSchemaVersion);
+
+    // Test: the sequence column has been replaced
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("PRAGMA table_info(amino_msas_members)"));
+        QStringList columns;
+        while (query.next())
+            columns << query.value(1).toString();
+        QCOMPARE(columns, QStringList() << "amino_msa_id" << "amino_seq_id" << "position" << "gap_runs");
+    }
+
+    // Test: the members are rebuilt from their encodings
+    MsaMembersPod pod = source.aminoMsaCrud()->readMsaMembers(1, 0, -1);
+    QCOMPARE(pod.seqIds_, QVector<int>() << 1 << 2);
+    QCOMPARE(pod.gapRunEncodings_.size(), 2);
+
+    Subseq subseq1(Seq("ABCDEF"));
+    QVERIFY(subseq1.setGapRunEncoding(pod.gapRunEncodings_.at(0)));
+    QVERIFY(subseq1 == "--BC-D");
+    QCOMPARE(subseq1.start(), 2);
+    QCOMPARE(subseq1.stop(), 4);
+
+    Subseq subseq2(Seq("WXYZ"));
+    QVERIFY(subseq2.setGapRunEncoding(pod.gapRunEncodings_.at(1)));
+    QVERIFY(subseq2 == ".WX.YZ");
+    source.close();
+
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::migrateSequenceCodec()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+
+    Seq longSeq(QByteArray("ACGT").repeated(5000));
+
+    // Setup: simulate a version 2 database in which all sequences are stored as uncompressed text
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("DROP TABLE dstrings"));
+        QVERIFY(query.exec("CREATE TABLE dstrings ("
+                           "    id integer not null primary key,"
+                           "    digest text not null,"
+                           "    length integer not null,"
+                           "    sequence text not null,"
+                           "    check(length = length(sequence))"
+                           ");"));
+        QVERIFY(query.exec("CREATE INDEX dstrings_digest_index ON dstrings(digest)"));
+
+        QVERIFY(query.prepare("INSERT INTO dstrings (id, digest, length, sequence) VALUES (?, ?, ?, ?)"));
+        query.bindValue(0, 1);
+        query.bindValue(1, Seq("ACGT").digest());
+        query.bindValue(2, 4);
+        query.bindValue(3, "ACGT");
+        QVERIFY(query.exec());
+        query.bindValue(0, 2);
+        query.bindValue(1, longSeq.digest());
+        query.bindValue(2, longSeq.length());
+        query.bindValue(3, longSeq.asByteArray());
+        QVERIFY(query.exec());
+
+        QVERIFY(query.exec("INSERT INTO dna_seqs (id, dstring_id, start, stop) VALUES (1, 2, 1, 20000)"));
+    }
+    source.setSchemaVersion(2);
+    source.close();
+
+    QVERIFY(source.open(fileName));
+    QCOMPARE(source.schemaVersion(), SqliteAdocSource::kCurrentSchemaVersion);
+
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("SELECT id, codec FROM dstrings ORDER BY id"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(1).toInt(), static_cast<int>(SequenceCodec::eNoCodec));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(1).toInt(), static_cast<int>(SequenceCodec::eZlibCodec));
+        QVERIFY(!query.next());
+
+        // Test: rebuilding the dstrings table did not cascade to the dna_seqs that reference it
+        QVERIFY(query.exec("SELECT count(*) FROM dna_seqs WHERE dstring_id = 2"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+
+        // Test: foreign keys are enforced once again
+        QVERIFY(!query.exec("INSERT INTO dna_seqs (id, dstring_id, start, stop) VALUES (2, 99, 1, 4)"));
+
+        // Test: digest index was recreated
+        QVERIFY(query.exec("SELECT count(*) FROM sqlite_master WHERE type = 'index' AND name = 'dstrings_digest_index'"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+    }
+
+    // Test: the compressed sequence is transparently decompressed via the crud interface
+    QVector<DstringPod> pods = source.dstringCrud()->read(QVector<int>() << 1 << 2);
+    QCOMPARE(pods.at(0).seq_.constData(), "ACGT");
+    QCOMPARE(pods.at(1).seq_.asByteArray(), longSeq.asByteArray());
+    source.close();
+
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::migrateEntityTree()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+
+    // Setup: simulate a version 3 database in which the entity tree is stored as a modified preorder tree
+    //        Root (1, 10)
+    //        |___ A (2, 7)
+    //        |    |___ Seq 5 (3, 4)
+    //        |    |___ Seq 6 (5, 6)
+    //        |___ B (8, 9)
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("DROP TABLE entity_tree"));
+        QVERIFY(query.exec("CREATE TABLE entity_tree ("
+                           "    type_id integer not null,"
+                           "    type text not null,"
+                           "    entity_id integer,"
+                           "    label text,"
+                           "    lft integer not null,"
+                           "    rgt integer not null,"
+                           "    check(lft > 0),"
+                           "    check(rgt > lft)"
+                           ")"));
+
+        QVERIFY(query.prepare("INSERT INTO entity_tree (type_id, type, entity_id, label, lft, rgt) "
+                              "VALUES (?, ?, ?, ?, ?, ?)"));
+        query.bindValue(0, eRootNode); query.bindValue(1, "Root"); query.bindValue(2, QVariant(QVariant::Int));
+        query.bindValue(3, "Root"); query.bindValue(4, 1); query.bindValue(5, 10);
+        QVERIFY(query.exec());
+        query.bindValue(0, eGroupNode); query.bindValue(1, "Group"); query.bindValue(2, QVariant(QVariant::Int));
+        query.bindValue(3, "B"); query.bindValue(4, 8); query.bindValue(5, 9);
+        QVERIFY(query.exec());
+        query.bindValue(0, eGroupNode); query.bindValue(1, "Group"); query.bindValue(2, QVariant(QVariant::Int));
+        query.bindValue(3, "A"); query.bindValue(4, 2); query.bindValue(5, 7);
+        QVERIFY(query.exec());
+        query.bindValue(0, eAminoSeqNode); query.bindValue(1, "AminoSeq"); query.bindValue(2, 6);
+        query.bindValue(3, QVariant(QVariant::String)); query.bindValue(4, 5); query.bindValue(5, 6);
+        QVERIFY(query.exec());
+        query.bindValue(0, eAminoSeqNode); query.bindValue(1, "AminoSeq"); query.bindValue(2, 5);
+        query.bindValue(3, QVariant(QVariant::String)); query.bindValue(4, 3); query.bindValue(5, 4);
+        QVERIFY(query.exec());
+    }
+    source.setSchemaVersion(3);
+    source.close();
+
+    QVERIFY(source.open(fileName));
+    QCOMPARE(source.schemaVersion(), SqliteAdocSource::kCurrentSchemaVersion);
+
+    AdocTreeNode *root = source.readEntityTree();
+    QCOMPARE(root->nodeType_, eRootNode);
+    QCOMPARE(root->childCount(), 2);
+    QCOMPARE(root->childAt(0)->label_, QString("A"));
+    QCOMPARE(root->childAt(1)->label_, QString("B"));
+    QCOMPARE(root->childAt(1)->childCount(), 0);
+    AdocTreeNode *groupA = root->childAt(0);
+    groupA->appendChildren(source.readEntityTreeChildren(groupA));
+    QCOMPARE(groupA->childCount(), 2);
+    QCOMPARE(groupA->childAt(0)->nodeType_, eAminoSeqNode);
+    QCOMPARE(groupA->childAt(0)->entityId(), 5);
+    QCOMPARE(groupA->childAt(1)->entityId(), 6);
+    delete root;
+
+    // Test: the new table enforces its self-referencing foreign key
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(!query.exec("INSERT INTO entity_tree (parent_id, position, type_id, type) VALUES (99, 0, 2, 'Group')"));
+        QVERIFY(query.exec("SELECT count(*) FROM sqlite_master WHERE name = 'entity_tree_v3'"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 0);
+    }
+    source.close();
+
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::compactor()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+
+    {
+        QSqlQuery query(source.database());
+
+        // Test: file databases use write-ahead logging
+        QVERIFY(query.exec("PRAGMA journal_mode"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toString(), QString("wal"));
+        query.finish();
+
+        // Setup: an astring that is not referenced by any amino seq
+        QVERIFY(query.exec("INSERT INTO astrings (id, digest, length, sequence) VALUES (1, 'x', 4, 'ACDE')"));
+    }
+
+    SqliteAdocCompactor compactor;
+    QSignalSpy spyCompacted(&compactor, SIGNAL(compacted(QString)));
+    QSignalSpy spyError(&compactor, SIGNAL(error(QString,QString)));
+    QVERIFY(compactor.compact(fileName));
+    QCOMPARE(compactor.fileName(), fileName);
+    QVERIFY(compactor.wait(30000));
+    QCOMPARE(spyError.size(), 0);
+    QCOMPARE(spyCompacted.size(), 1);
+    QCOMPARE(spyCompacted.first().first().toString(), fileName);
+
+    // Test: the compaction is visible to the original connection
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("SELECT count(*) FROM astrings"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 0);
+    }
+
+    // Test: a database that cannot be opened emits error
+    QVERIFY(compactor.compact("missing/directory/bob.db"));
+    QVERIFY(compactor.wait(30000));
+    QCOMPARE(spyCompacted.size(), 1);
+    QCOMPARE(spyError.size(), 1);
+    QCOMPARE(spyError.first().first().toString(), QString("missing/directory/bob.db"));
+
+    source.close();
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::prefetcher()
+{
+    QString fileName = "bob.db";
+    QFile::remove(fileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("INSERT INTO astrings (id, digest, length, sequence) VALUES (1, 'x', 4, 'ACDE')"));
+    }
+
+    QThread *thread = nullptr;
+    QVector<AstringPod> pods;
+
+    // Test: without a prefetcher, requests are discarded
+    QVERIFY(source.prefetch(new ReadAstringsRequest(QVector<int>() << 1, &thread, &pods)).isCanceled());
+    QCOMPARE(source.prefetchGeneration(), 0);
+
+    SqliteAdocPrefetcher prefetcher;
+    source.setPrefetcher(&prefetcher);
+
+    // Test: requests are discarded until the prefetcher has been opened
+    QVERIFY(source.prefetch(new ReadAstringsRequest(QVector<int>() << 1, &thread, &pods)).isCanceled());
+    QVERIFY(thread == nullptr);
+
+    // Test: in-memory databases cannot be prefetched
+    QCOMPARE(prefetcher.open(":memory:"), false);
+
+    // Test: requests are run on the prefetcher thread with its own connection
+    QVERIFY(prefetcher.open(fileName));
+    QCOMPARE(prefetcher.fileName(), fileName);
+    QFuture<void> future = source.prefetch(new ReadAstringsRequest(QVector<int>() << 1, &thread, &pods));
+    future.waitForFinished();
+    QVERIFY(future.isCanceled() == false);
+    QVERIFY(thread != nullptr);
+    QVERIFY(thread != QThread::currentThread());
+    QCOMPARE(pods.size(), 1);
+    QCOMPARE(pods.first().id_, 1);
+    QCOMPARE(pods.first().seq_.asByteArray(), QByteArray("ACDE"));
+
+    // Test: the source connection remains usable
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("SELECT count(*) FROM astrings"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 1);
+    }
+
+    // Test: invalidate increments the generation
+    prefetcher.invalidate();
+    QCOMPARE(prefetcher.generation(), 1);
+    QCOMPARE(source.prefetchGeneration(), 1);
+
+    // Test: requests are discarded once the prefetcher has stopped
+    prefetcher.stop();
+    QVERIFY(source.prefetch(new ReadAstringsRequest(QVector<int>() << 1, &thread, &pods)).isCanceled());
+
+    source.setPrefetcher(nullptr);
+    source.close();
+    QFile::remove(fileName);
+}
+
+void TestSqliteAdocSource::prefetcherSaveAs()
+{
+    QString fileName = "bob.db";
+    QString saveAsFileName = "bob2.db";
+    QFile::remove(fileName);
+    QFile::remove(saveAsFileName);
+
+    SqliteAdocSource source;
+    QVERIFY(source.createAndOpen(fileName));
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("INSERT INTO astrings (id, digest, length, sequence) VALUES (1, 'x', 4, 'ACDE')"));
+    }
+
+    SqliteAdocPrefetcher prefetcher;
+    source.setPrefetcher(&prefetcher);
+    QVERIFY(prefetcher.open(fileName));
+
+    // Test: the prefetcher connection to the saved file does not replace that of the source
+    QVERIFY(source.saveAs(saveAsFileName));
+    QCOMPARE(source.fileName(), saveAsFileName);
+    QVERIFY(prefetcher.open(saveAsFileName));
+
+    QThread *thread = nullptr;
+    QVector<AstringPod> pods;
+    source.prefetch(new ReadAstringsRequest(QVector<int>() << 1, &thread, &pods)).waitForFinished();
+    QCOMPARE(pods.size(), 1);
+    QCOMPARE(pods.first().seq_.asByteArray(), QByteArray("ACDE"));
+
+    QVERIFY(source.isOpen());
+    {
+        QSqlQuery query(source.database());
+        QVERIFY(query.exec("INSERT INTO astrings (id, digest, length, sequence) VALUES (2, 'y', 4, 'FGHI')"));
+        QVERIFY(query.exec("SELECT count(*) FROM astrings"));
+        QVERIFY(query.next());
+        QCOMPARE(query.value(0).toInt(), 2);
+    }
+
+    prefetcher.stop();
+    source.setPrefetcher(nullptr);
+    source.close();
+    QFile::remove(fileName);
+    QFile::remove(saveAsFileName);
+}
+
 QTEST_APPLESS_MAIN(TestSqliteAdocSource);
 
 #include "TestSqliteAdocSource.moc"
@@ -14,16 +14,25 @@ CONFIG   -= app_bundle
 TEMPLATE = app
 
 
+HEADERS += ../SqliteAdocCompactor.h
+
 SOURCES += TestSqliteAdocSource.cpp \
            ../SqliteAdocSource.cpp \
+           ../SqliteAdocPrefetcher.cpp \
+           ../SqliteAdocCompactor.cpp \
            ../../BioString.cpp \
            ../../Msa.cpp \
            ../../Seq.cpp \
            ../../UngappedSubseq.cpp \
            ../../Subseq.cpp \
+           ../../NonGapRunIndex.cpp \
+           ../../SubseqChangeRecord.cpp \
            ../../misc.cpp \
            ../../constants.cpp \
            ../Crud/DbAstringCrud.cpp \
+           ../Crud/SequenceCodec.cpp \
+           ../Crud/MultiIdSelect.cpp \
+           ../Crud/MultiRowInsert.cpp \
            ../Crud/DbAminoSeqCrud.cpp \
            ../Crud/DbDstringCrud.cpp \
            ../Crud/DbDnaSeqCrud.cpp \
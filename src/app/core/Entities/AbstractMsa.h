@@ -60,7 +60,7 @@ Q_DECLARE_TYPEINFO(AbstractMsaPod, Q_MOVABLE_TYPE);
 struct MsaMembersPod
 {
     QVector<int> seqIds_;
-    QVector<QByteArray> gappedSequences_;
+    QVector<QByteArray> gapRunEncodings_;       //!< Subseq::gapRunEncoding of each member
 };
 Q_DECLARE_TYPEINFO(MsaMembersPod, Q_MOVABLE_TYPE);
 
@@ -0,0 +1,71 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef GAPMATCHER_H
+#define GAPMATCHER_H
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+#include "constants.h"
+
+#ifdef __SSE2__
+/**
+  * GapMatcher compares 16 (or with AVX2, 32) characters at a time against each gap character (as defined by
+  * constants::kGapCharacters). Characters that are not compared in blocks should be classified with the tables
+  * returned by characterTables() (see misc.h).
+  */
+class GapMatcher
+{
+public:
+    GapMatcher() : nGapChars_(0)
+    {
+        for (const char *x = constants::kGapCharacters; *x && nGapChars_ < kMaxGapChars; ++x, ++nGapChars_)
+        {
+            gapVectors_[nGapChars_] = _mm_set1_epi8(*x);
+#ifdef __AVX2__
+            wideGapVectors_[nGapChars_] = _mm256_set1_epi8(*x);
+#endif
+        }
+    }
+
+    //! Returns a vector in which each byte is 0xFF if the corresponding character of chars is a gap and zero otherwise
+    __m128i gaps(__m128i chars) const
+    {
+        __m128i isGap = _mm_cmpeq_epi8(chars, gapVectors_[0]);
+        for (int i=1; i< nGapChars_; ++i)
+            isGap = _mm_or_si128(isGap, _mm_cmpeq_epi8(chars, gapVectors_[i]));
+        return isGap;
+    }
+
+#ifdef __AVX2__
+    //! Returns a vector in which each byte is 0xFF if the corresponding character of chars is a gap and zero otherwise
+    __m256i gaps(__m256i chars) const
+    {
+        __m256i isGap = _mm256_cmpeq_epi8(chars, wideGapVectors_[0]);
+        for (int i=1; i< nGapChars_; ++i)
+            isGap = _mm256_or_si256(isGap, _mm256_cmpeq_epi8(chars, wideGapVectors_[i]));
+        return isGap;
+    }
+#endif
+
+private:
+    static const int kMaxGapChars = 8;
+
+    __m128i gapVectors_[kMaxGapChars];
+#ifdef __AVX2__
+    __m256i wideGapVectors_[kMaxGapChars];
+#endif
+    int nGapChars_;
+};
+#endif
+
+#endif // GAPMATCHER_H
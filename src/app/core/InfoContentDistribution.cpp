@@ -35,6 +35,19 @@ bool infoUnitLessThan(const InfoUnit &a, const InfoUnit &b)
     return a.info_ < b.info_;
 }
 
+/**
+  * @param vectorInfoUnit [const VectorInfoUnit &]
+  * @returns double
+  */
+static double sumInfo(const VectorInfoUnit &vectorInfoUnit)
+{
+    double total = 0.;
+    VectorInfoUnit::ConstIterator it = vectorInfoUnit.constBegin();
+    for (; it != vectorInfoUnit.constEnd(); ++it)
+        total += (*it).info_;
+    return total;
+}
+
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -55,6 +68,7 @@ InfoContentDistribution::InfoContentDistribution(const CharCountDistribution &ch
     maxInfo_ = log2(possibleLetters_);
     smallSampleErrorFactor_ = static_cast<double>(possibleLetters_ - 1) / (2. * log(2.));
     infoContent_ = computeInfoContent(charCountDistribution);
+    rebuildColumnInfo();
 }
 
 
@@ -69,16 +83,15 @@ VectorVectorInfoUnit InfoContentDistribution::infoContent() const
     return infoContent_;
 }
 
+/**
+  * @param column [const int]
+  * @returns double
+  */
 double InfoContentDistribution::columnInfo(const int column) const
 {
     ASSERT(column > 0 && column <= length());
 
-    const VectorInfoUnit &vectorInfoUnit = infoContent_.at(column - 1);
-    double sumInfo = 0.;
-    VectorInfoUnit::ConstIterator it = vectorInfoUnit.constBegin();
-    for (; it != vectorInfoUnit.constEnd(); ++it)
-        sumInfo += (*it).info_;
-    return sumInfo;
+    return columnInfo_.at(column);
 }
 
 /**
@@ -118,10 +131,22 @@ bool InfoContentDistribution::smallSampleErrorCorrection() const
   */
 double InfoContentDistribution::totalInfo() const
 {
-    double sumInfo = 0.;
-    for (int i=1, z=length(); i<=z; ++i)
-        sumInfo += columnInfo(i);
-    return sumInfo;
+    return columnInfo_.sum();
+}
+
+/**
+  * Because the column totals are maintained in a SegmentTree, this requires logarithmic time regardless of the width
+  * of range.
+  *
+  * @param range [const ClosedIntRange &]
+  * @returns double
+  */
+double InfoContentDistribution::totalInfo(const ClosedIntRange &range) const
+{
+    ASSERT_X(range.begin_ > 0 && range.begin_ <= range.end_, "invalid range.begin");
+    ASSERT_X(range.end_ <= length(), "invalid range.end");
+
+    return columnInfo_.sum(range);
 }
 
 
@@ -154,12 +179,11 @@ VectorVectorInfoUnit InfoContentDistribution::computeInfoContent(const CharCount
 
     double divisor = charCountDistribution.divisor();
 
-    // Iterate through each column of the charCountDistribution
-    const VectorHashCharInt &charCounts = charCountDistribution.charCounts();
-    for (int i=actualRange.begin_; i<= actualRange.end_; ++i)
+    // Iterate through each column of the charCountDistribution within range
+    const VectorHashCharInt &charCounts = charCountDistribution.charCounts(actualRange);
+    for (int i=0, z=charCounts.size(); i<z; ++i)
     {
-        // -1 to account for zero-based vector layout
-        const HashCharInt &hashCharInt = charCounts.at(i-1);
+        const HashCharInt &hashCharInt = charCounts.at(i);
 
         infoContent << VectorInfoUnit();
         VectorInfoUnit &vectorInfoUnit = infoContent.last();
@@ -195,3 +219,35 @@ VectorVectorInfoUnit InfoContentDistribution::computeInfoContent(const CharCount
 
     return infoContent;
 }
+
+/**
+  */
+void InfoContentDistribution::rebuildColumnInfo()
+{
+    QVector<double> columnTotals(infoContent_.size());
+    for (int i=0, z=infoContent_.size(); i<z; ++i)
+        columnTotals[i] = sumInfo(infoContent_.at(i));
+    columnInfo_.rebuild(columnTotals);
+}
+
+/**
+  * Each column is updated in logarithmic time; however, if range spans a sizable fraction of all columns, it is faster
+  * to simply rebuild the totals for every column.
+  *
+  * @param range [const ClosedIntRange &]
+  */
+void InfoContentDistribution::updateColumnInfo(const ClosedIntRange &range)
+{
+    ASSERT(columnInfo_.length() == infoContent_.size());
+    ASSERT_X(range.begin_ > 0 && range.begin_ <= range.end_, "invalid range.begin");
+    ASSERT_X(range.end_ <= length(), "invalid range.end");
+
+    if (range.length() * 4 >= length())
+    {
+        rebuildColumnInfo();
+        return;
+    }
+
+    for (int i=range.begin_; i<= range.end_; ++i)
+        columnInfo_.set(i, sumInfo(infoContent_.at(i - 1)));
+}
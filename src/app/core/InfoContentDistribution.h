@@ -13,6 +13,7 @@
 #include "PODs/InfoUnit.h"
 #include "macros.h"
 #include "types.h"
+#include "util/SegmentTree.h"
 
 /**
   */
@@ -30,13 +31,17 @@ public:
     int possibleLetters() const;                            //!< Returns the number of possible letters
     bool smallSampleErrorCorrection() const;                //!< Returns true if small sample error correction is enabled; false otherwise
     double totalInfo() const;                               //!< Returns the total information for the entire char count distribution
+    double totalInfo(const ClosedIntRange &range) const;    //!< Returns the total information of the columns in range
 
 protected:
     //! Determines the information content of charCountDistribution between range and returns a VectorVectorInfoUnit
     VectorVectorInfoUnit computeInfoContent(const CharCountDistribution &charCountDistribution,
                                             const ClosedIntRange &range = ClosedIntRange()) const;
+    void rebuildColumnInfo();                               //!< Recomputes the total information of every column from infoContent_
+    void updateColumnInfo(const ClosedIntRange &range);     //!< Recomputes the total information of the columns in range from infoContent_
 
     VectorVectorInfoUnit infoContent_;          // The raw information content in doubles
+    SegmentTree<double> columnInfo_;            // Total information per column; must be kept in sync with infoContent_
     bool smallSampleErrorCorrection_;           // Flag denoting whether to use small error correction
 
 private:
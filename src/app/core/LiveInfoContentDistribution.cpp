@@ -62,6 +62,7 @@ void LiveInfoContentDistribution::setSmallSampleErrorCorrection(bool enabled)
         return;
 
     infoContent_ = computeInfoContent(liveCharCountDistribution_->charCountDistribution());
+    rebuildColumnInfo();
     emit dataChanged(ClosedIntRange(1, infoContent_.size()));
 }
 
@@ -79,6 +80,8 @@ void LiveInfoContentDistribution::onSourceColumnsInserted(const ClosedIntRange &
     infoContent_.insert(range.begin_ - 1, range.length(), VectorInfoUnit());
     for (int i=range.begin_ - 1, j=0, z= range.end_ - 1; i<= z; ++i, ++j)
         infoContent_[i] = addition.at(j);
+    columnInfo_.insert(range.begin_, range.length());
+    updateColumnInfo(range);
 
     emit columnsInserted(range);
 }
@@ -89,6 +92,7 @@ void LiveInfoContentDistribution::onSourceColumnsInserted(const ClosedIntRange &
 void LiveInfoContentDistribution::onSourceColumnsRemoved(const ClosedIntRange &range)
 {
     infoContent_.remove(range.begin_ - 1, range.length());
+    columnInfo_.remove(range.begin_, range.length());
     emit columnsRemoved(range);
 }
 
@@ -101,6 +105,7 @@ void LiveInfoContentDistribution::onSourceDataChanged(const ClosedIntRange &rang
     ASSERT(changed.size() == range.length());
     for (int i=range.begin_ - 1, j=0, z= range.end_ - 1; i<= z; ++i, ++j)
         infoContent_[i] = changed.at(j);
+    updateColumnInfo(range);
 
     emit dataChanged(range);
 }
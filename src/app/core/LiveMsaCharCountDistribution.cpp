@@ -26,7 +26,7 @@ LiveMsaCharCountDistribution::LiveMsaCharCountDistribution(const ObservableMsa *
 {
     if (msa_)
     {
-        charCountDistribution_ = calculateMsaCharCountDistribution(*msa_);
+        charCountDistribution_ = ::calculateMsaCharCountDistributionParallel(*msa_);
 //        charCountDistribution_.setDivisor(msa->rowCount());
 
         connect(msa_, SIGNAL(gapColumnsInserted(ClosedIntRange)), SLOT(onMsaGapColumnsInserted(ClosedIntRange)));
@@ -196,11 +196,10 @@ void LiveMsaCharCountDistribution::onMsaRowsAboutToBeRemoved(const ClosedIntRang
     bool rowsSpansAllSequences = rows.begin_ == 1 && rows.end_ == msa_->rowCount();
     if (!rowsSpansAllSequences)
     {
-        CharCountDistribution difference = ::calculateMsaCharCountDistribution(*msa_,
-                                                                               PosiRect(QPoint(1,
-                                                                                               rows.begin_),
-                                                                                        QPoint(msa_->length(),
-                                                                                               rows.end_)));
+        CharCountDistribution difference =
+                ::calculateMsaCharCountDistributionParallel(*msa_,
+                                                            PosiRect(QPoint(1, rows.begin_),
+                                                                     QPoint(msa_->length(), rows.end_)));
         charCountDistribution_.subtract(difference);
         charCountDistribution_.removeZeroValueKeys();
     }
@@ -233,9 +232,9 @@ void LiveMsaCharCountDistribution::onMsaRowsInserted(const ClosedIntRange &rows)
     if (charCountDistribution_.length())
     {
         CharCountDistribution difference =
-                ::calculateMsaCharCountDistribution(*msa_,
-                                                    PosiRect(QPoint(1, rows.begin_),
-                                                             QPoint(msa_->length(), rows.end_)));
+                ::calculateMsaCharCountDistributionParallel(*msa_,
+                                                            PosiRect(QPoint(1, rows.begin_),
+                                                                     QPoint(msa_->length(), rows.end_)));
         charCountDistribution_.add(difference);
         charCountDistribution_.removeZeroValueKeys();
         emit dataChanged(ClosedIntRange(1, msa()->length()));
@@ -245,7 +244,7 @@ void LiveMsaCharCountDistribution::onMsaRowsInserted(const ClosedIntRange &rows)
         ASSERT_X(rows.begin_ == 1 && rows.end_ == msa_->rowCount(),
                  "if distribution is empty, rows must cover all sequences in msa");
 
-        charCountDistribution_ = calculateMsaCharCountDistribution(*msa_);
+        charCountDistribution_ = ::calculateMsaCharCountDistributionParallel(*msa_);
         emit columnsInserted(ClosedIntRange(1, msa_->length()));
     }
 }
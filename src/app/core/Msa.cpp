@@ -6,11 +6,73 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include "GapMatcher.h"
 #include "Msa.h"
+#include "SubseqChangeRecord.h"
 #include "global.h"
 #include "macros.h"
 #include "misc.h"
 
+/**
+  * Clears every byte of mask whose corresponding character in row is not a gap. Both row and mask must contain at
+  * least n bytes. Returns true if at least one byte of mask remains set; false otherwise.
+  *
+  * When compiled with AVX2 or SSE2 support, 32 or 16 characters respectively are compared against each gap character
+  * at a time. The remaining tail (and all characters in the absence of these instruction sets) is processed with a
+  * lookup table.
+  *
+  * @param row [const char *]
+  * @param mask [char *]
+  * @param n [int]
+  * @returns bool
+  */
+static bool andGapMask(const char *row, char *mask, int n)
+{
+    int i = 0;
+    int remaining = 0;
+
+#ifdef __SSE2__
+    GapMatcher gapMatcher;
+  #ifdef __AVX2__
+    __m256i any = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+        __m256i result = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + i)),
+                                          gapMatcher.gaps(chars));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(mask + i), result);
+        any = _mm256_or_si256(any, result);
+    }
+    remaining = _mm256_movemask_epi8(any);
+  #else
+    __m128i any = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        __m128i result = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + i)),
+                                       gapMatcher.gaps(chars));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(mask + i), result);
+        any = _mm_or_si128(any, result);
+    }
+    remaining = _mm_movemask_epi8(any);
+  #endif
+#endif
+
+    const char *table = characterTables().gapMask_;
+    for (; i< n; ++i)
+    {
+        mask[i] &= table[static_cast<unsigned char>(row[i])];
+        remaining |= mask[i];
+    }
+
+    return remaining != 0;
+}
+
 class SubseqLessThanHelperPrivate
 {
 public:
@@ -39,6 +101,131 @@ private:
     const ISubseqLessThan *lessThanHelper_;
 };
 
+// Bulk row edits spanning fewer cells than this are performed serially because the threading overhead would dominate
+static const int kMinimumParallelCells = 1 << 18;
+// Minimum number of rows assigned to each task
+static const int kMinimumRowsPerTask = 32;
+
+// Row edits block the calling (typically GUI) thread until every task has finished. Thus, they use their own thread
+// pool rather than queueing behind long running tasks (e.g. sequence imports) in the global QThreadPool.
+Q_GLOBAL_STATIC(QThreadPool, rowEditThreadPool)
+
+/**
+  * Splits rows into contiguous, ordered row ranges that may be edited concurrently. If the edit (spanning roughly
+  * nCells characters) is too small to benefit from threading or only a single thread is available, an empty vector is
+  * returned and the rows should be edited serially.
+  *
+  * @param rows [const ClosedIntRange &]
+  * @param nCells [qint64]
+  * @returns QVector<ClosedIntRange>
+  */
+static QVector<ClosedIntRange> parallelRowRanges(const ClosedIntRange &rows, qint64 nCells)
+{
+    int nThreads = QThread::idealThreadCount();
+    int nRows = rows.length();
+    if (nThreads <= 1 || nRows < 2 * kMinimumRowsPerTask || nCells < kMinimumParallelCells)
+        return QVector<ClosedIntRange>();
+
+    // Several row ranges per thread helps balance the load between threads
+    int nRanges = qMin(nThreads * 4, nRows / kMinimumRowsPerTask);
+    int rangeHeight = (nRows + nRanges - 1) / nRanges;
+
+    QVector<ClosedIntRange> rowRanges;
+    rowRanges.reserve(nRanges);
+    for (int top=rows.begin_; top<= rows.end_; top += rangeHeight)
+        rowRanges << ClosedIntRange(top, qMin(top + rangeHeight - 1, rows.end_));
+
+    return rowRanges;
+}
+
+/**
+  * Inserts the same gap columns into each subseq of a row range. The semaphore is released once the task has finished.
+  */
+class InsertGapsTask : public QRunnable
+{
+public:
+    InsertGapsTask(Subseq *const *subseqs, const ClosedIntRange &rows, int column, int count, char gapCharacter,
+                   QSemaphore *semaphore)
+        : subseqs_(subseqs), rows_(rows), column_(column), count_(count), gapCharacter_(gapCharacter),
+          semaphore_(semaphore)
+    {
+    }
+
+    void run()
+    {
+        for (int i=rows_.begin_; i<= rows_.end_; ++i)
+            subseqs_[i - 1]->insertGaps(column_, count_, gapCharacter_);
+
+        semaphore_->release();
+    }
+
+private:
+    Subseq *const *subseqs_;
+    ClosedIntRange rows_;
+    int column_;
+    int count_;
+    char gapCharacter_;
+    QSemaphore *semaphore_;
+};
+
+/**
+  * Removes the same gap ranges from each subseq of a row range. The semaphore is released once the task has finished.
+  */
+class RemoveGapsTask : public QRunnable
+{
+public:
+    RemoveGapsTask(Subseq *const *subseqs, const ClosedIntRange &rows, const QVector<ClosedIntRange> &gapRanges,
+                   QSemaphore *semaphore)
+        : subseqs_(subseqs), rows_(rows), gapRanges_(gapRanges), semaphore_(semaphore)
+    {
+    }
+
+    void run()
+    {
+        for (int i=rows_.begin_; i<= rows_.end_; ++i)
+            subseqs_[i - 1]->removeGaps(gapRanges_);
+
+        semaphore_->release();
+    }
+
+private:
+    Subseq *const *subseqs_;
+    ClosedIntRange rows_;
+    const QVector<ClosedIntRange> &gapRanges_;
+    QSemaphore *semaphore_;
+};
+
+/**
+  * Applies a RowEditMethod to each row of a row range and collects the resulting pods (in row order) into a vector
+  * that belongs exclusively to this task. The semaphore is released once the task has finished.
+  */
+class Msa::RowEditTask : public QRunnable
+{
+public:
+    RowEditTask(Msa *msa, RowEditMethod rowEditMethod, const ClosedIntRange &rows, const ClosedIntRange &columns,
+                SubseqChangePodVector *pods, QSemaphore *semaphore)
+        : msa_(msa), rowEditMethod_(rowEditMethod), rows_(rows), columns_(columns), pods_(pods), semaphore_(semaphore)
+    {
+    }
+
+    void run()
+    {
+        pods_->reserve(rows_.length());
+        for (int i=rows_.begin_; i<= rows_.end_; ++i)
+            (msa_->*rowEditMethod_)(i, columns_, *pods_);
+
+        semaphore_->release();
+    }
+
+private:
+    Msa *msa_;
+    RowEditMethod rowEditMethod_;
+    ClosedIntRange rows_;
+    ClosedIntRange columns_;
+    SubseqChangePodVector *pods_;
+    QSemaphore *semaphore_;
+};
+
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -334,27 +521,7 @@ SubseqChangePodVector Msa::collapseLeft(const PosiRect &msaRect)
     ASSERT_X(normalizedMsaRect.right() <= length(), "msaRect.right out of range");
     ASSERT_X(normalizedMsaRect.bottom() <= subseqCount(), "msaRect.bottom out of range");
 
-    QVector<SubseqChangePod> pods;
-    pods.reserve(msaRect.height());
-    for (int row=normalizedMsaRect.top(), bottom = normalizedMsaRect.bottom(); row <= bottom; ++row)
-    {
-        Subseq *subseq = subseqFromRow(row);
-        const ClosedIntRange &horizRange = normalizedMsaRect.horizontalRange();
-        BioString difference = subseq->mid(horizRange);
-        ClosedIntRange collapseRange = subseq->collapseLeft(horizRange);
-        if (collapseRange.isEmpty() == false)
-        {
-            if (collapseRange.begin_ > horizRange.begin_)
-                difference = difference.mid(collapseRange.begin_ - horizRange.begin_ + 1, collapseRange.length());
-            else if (collapseRange.end_ < horizRange.end_)
-                difference.chop(horizRange.end_ - collapseRange.end_);
-
-            pods << SubseqChangePod(row, collapseRange, SubseqChangePod::eInternal, difference);
-        }
-    }
-
-    pods.squeeze();
-    return pods;
+    return editRows(&Msa::collapseLeftRow, normalizedMsaRect.verticalRange(), normalizedMsaRect.horizontalRange());
 }
 
 /**
@@ -369,27 +536,7 @@ SubseqChangePodVector Msa::collapseRight(const PosiRect &msaRect)
     ASSERT_X(normalizedMsaRect.right() <= length(), "msaRect.right out of range");
     ASSERT_X(normalizedMsaRect.bottom() <= subseqCount(), "msaRect.bottom out of range");
 
-    QVector<SubseqChangePod> pods;
-    pods.reserve(msaRect.height());
-    for (int row=normalizedMsaRect.top(), bottom = normalizedMsaRect.bottom(); row <= bottom; ++row)
-    {
-        Subseq *subseq = subseqFromRow(row);
-        const ClosedIntRange &horizRange = normalizedMsaRect.horizontalRange();
-        BioString difference = subseq->mid(horizRange);
-        ClosedIntRange collapseRange = subseq->collapseRight(horizRange);
-        if (collapseRange.isEmpty() == false)
-        {
-            if (collapseRange.begin_ > horizRange.begin_)
-                difference = difference.mid(collapseRange.begin_ - horizRange.begin_ + 1, collapseRange.length());
-            else if (collapseRange.end_ < horizRange.end_)
-                difference.chop(horizRange.end_ - collapseRange.end_);
-
-            pods << SubseqChangePod(row, collapseRange, SubseqChangePod::eInternal, difference);
-        }
-    }
-
-    pods.squeeze();
-    return pods;
+    return editRows(&Msa::collapseRightRow, normalizedMsaRect.verticalRange(), normalizedMsaRect.horizontalRange());
 }
 
 /**
@@ -439,19 +586,7 @@ QVector<SubseqChangePod> Msa::extendLeft(int msaColumn, const ClosedIntRange &ro
     ASSERT_X(isValidColumn(msaColumn), "msaColumn out of range");
     ASSERT_X(isValidRowRange(rows), "rows out of range");
 
-    QVector<SubseqChangePod> pods;
-    pods.reserve(rows.length());
-    for (int i=rows.begin_; i<= rows.end_; ++i)
-    {
-        int nNewCharacters = leftExtendableLength(msaColumn, i);
-        if (nNewCharacters > 0)
-            pods << extendLeft(i, nNewCharacters);
-    }
-
-    // Very likely that not all sequences were extended; release the unused memory
-    pods.squeeze();
-
-    return pods;
+    return editRows(&Msa::extendLeftRow, rows, ClosedIntRange(msaColumn, msaColumn));
 }
 
 /**
@@ -515,19 +650,7 @@ QVector<SubseqChangePod> Msa::extendRight(int msaColumn, const ClosedIntRange &r
     ASSERT_X(isValidColumn(msaColumn), "msaColumn out of range");
     ASSERT_X(isValidRowRange(rows), "rows out of range");
 
-    QVector<SubseqChangePod> pods;
-    pods.reserve(rows.length());
-    for (int i=rows.begin_; i<= rows.end_; ++i)
-    {
-        int nNewCharacters = rightExtendableLength(msaColumn, i);
-        if (nNewCharacters > 0)
-            pods << extendRight(i, nNewCharacters);
-    }
-
-    // Very likely that not all sequences were extended; release the unused memory
-    pods.squeeze();
-
-    return pods;
+    return editRows(&Msa::extendRightRow, rows, ClosedIntRange(msaColumn, msaColumn));
 }
 
 /**
@@ -642,9 +765,23 @@ void Msa::insertGapColumns(int column, int count, char gapCharacter)
     // Alignment must have at least one sequence to insert gap columns
     ASSERT_X(isEmpty() == false, "At least one sequence is required");
 
-    // Step through each subseq and add the gaps
-    for (int i=0, z=rowCount(); i<z; ++i)
-        subseqs_[i]->insertGaps(column, count, gapCharacter);
+    QVector<ClosedIntRange> rowRanges = parallelRowRanges(ClosedIntRange(1, rowCount()),
+                                                          static_cast<qint64>(rowCount()) * (length() + count));
+    if (rowRanges.isEmpty())
+    {
+        // Step through each subseq and add the gaps
+        for (int i=0, z=rowCount(); i<z; ++i)
+            subseqs_[i]->insertGaps(column, count, gapCharacter);
+        return;
+    }
+
+    // The last row range is edited in the calling thread
+    QSemaphore semaphore;
+    for (int i=0, z=rowRanges.size() - 1; i<z; ++i)
+        rowEditThreadPool()->start(new InsertGapsTask(subseqs_.constData(), rowRanges.at(i), column, count,
+                                                      gapCharacter, &semaphore));
+    InsertGapsTask(subseqs_.constData(), rowRanges.last(), column, count, gapCharacter, &semaphore).run();
+    semaphore.acquire(rowRanges.size());
 }
 
 /**
@@ -1066,16 +1203,28 @@ QVector<ClosedIntRange> Msa::removeGapColumns()
   */
 QVector<ClosedIntRange> Msa::removeGapColumns(const ClosedIntRange &columnRange)
 {
-    QVector<ClosedIntRange> contiguousGapRanges = findGapColumns_iteratorRowBased(columnRange);
+    QVector<ClosedIntRange> contiguousGapRanges = findGapColumns_bitmap(columnRange);
+    if (contiguousGapRanges.isEmpty())
+        return contiguousGapRanges;
 
-    for (int i=contiguousGapRanges.count()-1; i >= 0; --i)
+    QVector<ClosedIntRange> rowRanges = parallelRowRanges(ClosedIntRange(1, rowCount()),
+                                                          static_cast<qint64>(rowCount()) * length());
+    if (rowRanges.isEmpty())
     {
-        int first = contiguousGapRanges.at(i).begin_;
-        int contiguousGapSize = contiguousGapRanges.at(i).end_ - first + 1;
+        // Remove all the gap ranges from each subseq in a single pass
         for (int j=0, z= rowCount(); j<z; ++j)
-            subseqs_.at(j)->removeGaps(first, contiguousGapSize);
+            subseqs_.at(j)->removeGaps(contiguousGapRanges);
+        return contiguousGapRanges;
     }
 
+    // The last row range is edited in the calling thread
+    QSemaphore semaphore;
+    for (int i=0, z=rowRanges.size() - 1; i<z; ++i)
+        rowEditThreadPool()->start(new RemoveGapsTask(subseqs_.constData(), rowRanges.at(i), contiguousGapRanges,
+                                                      &semaphore));
+    RemoveGapsTask(subseqs_.constData(), rowRanges.last(), contiguousGapRanges, &semaphore).run();
+    semaphore.acquire(rowRanges.size());
+
     return contiguousGapRanges;
 }
 
@@ -1098,8 +1247,9 @@ int Msa::rightExtendableLength(int msaColumn, int row) const
     ASSERT_X(isValidColumn(msaColumn), "msaColumn out of range");
     ASSERT_X(isValidRow(row), "row out of range");
 
+    // Every row has the same length; reading it from this subseq avoids touching rows that are edited concurrently
     Subseq *subseq = subseqFromRow(row);
-    int nFillableGaps = msaColumn - (length() - subseq->tailGaps());
+    int nFillableGaps = msaColumn - (subseq->length() - subseq->tailGaps());
     if (nFillableGaps < 1)
         return 0;
 
@@ -1348,56 +1498,7 @@ QVector<SubseqChangePod> Msa::trimLeft(int msaColumn, const ClosedIntRange &rows
     ASSERT_X(isValidColumn(msaColumn), "msaColumn out of range");
     ASSERT_X(isValidRowRange(rows), "rows out of range");
 
-    QVector<SubseqChangePod> pods;
-    pods.reserve(rows.length());
-    for (int i=rows.begin_; i<= rows.end_; ++i)
-    {
-        Subseq *subseq = subseqFromRow(i);
-        int nHeadGaps = subseq->headGaps();
-        if (msaColumn <= nHeadGaps)
-            continue;
-
-        ClosedIntRange trimRange(nHeadGaps + 1, msaColumn);
-        int nTrimmableChars = subseq->nonGapsBetween(trimRange);
-
-        // Prevent trim operations from removing all characters so we reduce the number of trimmable characters by one
-        // Additionally, adjust the trim range at the same time
-        if (subseq->ungappedLength() - nTrimmableChars < 1)
-        {
-            const char *x = subseq->constData() + trimRange.end_ - 1;   // - 1 to map to 0-based indices
-            forever
-            {
-                --trimRange.end_;
-                if (!::isGapCharacter(*x))
-                    break;
-
-                --x;
-            }
-            --nTrimmableChars;
-        }
-        if (nTrimmableChars == 0)
-            continue;
-
-        // Could simply call the trimLeft(i, nCharsToTrim) method; however, that would require looping through the
-        // sequence again looking for the exact range to trim. This would duplicate effort, since we already know
-        // the exact range to trim. The only complication is that the trimRange.end_ might have trailing gap characters.
-        // Thus, we remove these in this loop.
-        const char *x = subseq->constData() + trimRange.end_ - 1;
-        while (::isGapCharacter(*x))
-        {
-            --x;
-            --trimRange.end_;
-        }
-
-        BioString difference = subseq->mid(trimRange);
-        subseq->trimLeft(trimRange, nTrimmableChars);
-        pods << SubseqChangePod(i,
-                                trimRange,
-                                SubseqChangePod::eTrimLeft,
-                                difference);
-    }
-
-    return pods;
+    return editRows(&Msa::trimLeftRow, rows, ClosedIntRange(msaColumn, msaColumn));
 }
 
 /**
@@ -1451,56 +1552,7 @@ QVector<SubseqChangePod> Msa::trimRight(int msaColumn, const ClosedIntRange &row
     ASSERT_X(isValidColumn(msaColumn), "msaColumn out of range");
     ASSERT_X(isValidRowRange(rows), "rows out of range");
 
-    QVector<SubseqChangePod> pods;
-    pods.reserve(rows.length());
-    for (int i=rows.begin_; i<= rows.end_; ++i)
-    {
-        Subseq *subseq = subseqFromRow(i);
-        int firstTailGap = length() - subseq->tailGaps() + 1;
-        if (msaColumn >= firstTailGap)
-            continue;
-
-        ClosedIntRange trimRange(msaColumn, firstTailGap - 1);
-        int nTrimmableChars = subseq->nonGapsBetween(trimRange);
-
-        // Prevent trim operations from removing all characters so we reduce the number of trimmable characters by one
-        // Additionally, adjust the trim range at the same time
-        if (subseq->ungappedLength() - nTrimmableChars < 1)
-        {
-            const char *x = subseq->constData() + trimRange.begin_ - 1; // - 1 to map to 0-based indices
-            forever
-            {
-                ++trimRange.begin_;
-                if (!::isGapCharacter(*x))
-                    break;
-
-                ++x;
-            }
-            --nTrimmableChars;
-        }
-        if (nTrimmableChars == 0)
-            continue;
-
-        // Could simply call the trimRight(i, nCharsToTrim) method; however, that would require looping through the
-        // sequence again looking for the exact range to trim. This would duplicate effort, since we already know
-        // the exact range to trim. The only complication is that the trimRange.begin_ might have leading gap characters
-        // Thus, we remove these in this loop.
-        const char *x = subseq->constData() + trimRange.begin_ - 1;
-        while (::isGapCharacter(*x))
-        {
-            ++x;
-            ++trimRange.begin_;
-        }
-
-        BioString difference = subseq->mid(trimRange);
-        subseq->trimRight(trimRange, nTrimmableChars);
-        pods << SubseqChangePod(i,
-                                trimRange,
-                                SubseqChangePod::eTrimRight,
-                                difference);
-    }
-
-    return pods;
+    return editRows(&Msa::trimRightRow, rows, ClosedIntRange(msaColumn, msaColumn));
 }
 
 /**
@@ -1563,48 +1615,202 @@ SubseqChangePodVector Msa::undo(const SubseqChangePodVector &subseqChangePodVect
         if (pod.isNull())
             continue;
 
-        // This is the operation that we are "undo'ing"
-        switch(pod.operation_)
-        {
-        case SubseqChangePod::eExtendLeft:
-            subseqFromRow(pod.row_)->trimLeft(pod.columns_);
-            undoneChangePods << pod;
-            undoneChangePods.last().operation_ = SubseqChangePod::eTrimLeft;
-            break;
-        case SubseqChangePod::eExtendRight:
-            subseqFromRow(pod.row_)->trimRight(pod.columns_);
-            undoneChangePods << pod;
-            undoneChangePods.last().operation_ = SubseqChangePod::eTrimRight;
-            break;
-        case SubseqChangePod::eTrimLeft:
-            undoneChangePods << extendLeft(pod.columns_.begin_, pod.row_, pod.difference_);
-            break;
-        case SubseqChangePod::eTrimRight:
-            undoneChangePods << extendRight(pod.columns_.begin_, pod.row_, pod.difference_);
-            break;
-        case SubseqChangePod::eInternal:
-            {
-                Subseq *subseq = subseqFromRow(pod.row_);
-                undoneChangePods << pod;
-                BioString old = subseq->mid(pod.columns_);
-                subseq->rearrange(pod.columns_, undoneChangePods.last().difference_);
-                undoneChangePods.last().difference_ = old;
-            }
-            break;
-
-        default:
-            ASSERT_X(0, "Unimplemented switch condition");
-            break;
-        }
+        undoPod(pod, undoneChangePods);
     }
 
     return undoneChangePods;
 }
 
+/**
+  * Equivalent to undoing the SubseqChangePodVector that was used to construct subseqChangeRecord. Each pod is decoded
+  * just before it is undone because its characters are recovered from the current state of this msa.
+  *
+  * @param subseqChangeRecord [const SubseqChangeRecord &]
+  * @returns SubseqChangePodVector
+  */
+SubseqChangePodVector Msa::undo(const SubseqChangeRecord &subseqChangeRecord)
+{
+    SubseqChangePodVector undoneChangePods;
+    undoneChangePods.reserve(subseqChangeRecord.size());
+    SubseqChangeRecord::Reader reader(subseqChangeRecord);
+    while (reader.hasNext())
+        undoPod(reader.next(*this), undoneChangePods);
+
+    return undoneChangePods;
+}
+
 
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 // Private methods
+/**
+  * @param row [int]
+  * @param columns [const ClosedIntRange &]
+  * @param pods [SubseqChangePodVector &]
+  * @see collapseLeft()
+  */
+void Msa::collapseLeftRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods)
+{
+    Subseq *subseq = subseqFromRow(row);
+    BioString difference = subseq->mid(columns);
+    ClosedIntRange collapseRange = subseq->collapseLeft(columns);
+    if (collapseRange.isEmpty())
+        return;
+
+    if (collapseRange.begin_ > columns.begin_)
+        difference = difference.mid(collapseRange.begin_ - columns.begin_ + 1, collapseRange.length());
+    else if (collapseRange.end_ < columns.end_)
+        difference.chop(columns.end_ - collapseRange.end_);
+
+    pods << SubseqChangePod(row, collapseRange, SubseqChangePod::eInternal, difference);
+}
+
+/**
+  * @param row [int]
+  * @param columns [const ClosedIntRange &]
+  * @param pods [SubseqChangePodVector &]
+  * @see collapseRight()
+  */
+void Msa::collapseRightRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods)
+{
+    Subseq *subseq = subseqFromRow(row);
+    BioString difference = subseq->mid(columns);
+    ClosedIntRange collapseRange = subseq->collapseRight(columns);
+    if (collapseRange.isEmpty())
+        return;
+
+    if (collapseRange.begin_ > columns.begin_)
+        difference = difference.mid(collapseRange.begin_ - columns.begin_ + 1, collapseRange.length());
+    else if (collapseRange.end_ < columns.end_)
+        difference.chop(columns.end_ - collapseRange.end_);
+
+    pods << SubseqChangePod(row, collapseRange, SubseqChangePod::eInternal, difference);
+}
+
+/**
+  * Each row is edited by rowEditMethod, which is passed columns and appends a pod to the supplied vector for any row
+  * it changes. Because the rows are independent of one another, edits that span many cells are split into row ranges
+  * which are edited concurrently by the calling thread and a dedicated thread pool. Each range collects its pods into
+  * a separate vector and these are concatenated in range order, so the returned pods are always in row order
+  * regardless of how the work was divided. This method blocks until all rows have been edited.
+  *
+  * @param rowEditMethod [RowEditMethod]
+  * @param rows [const ClosedIntRange &]
+  * @param columns [const ClosedIntRange &]
+  * @returns SubseqChangePodVector
+  */
+SubseqChangePodVector Msa::editRows(RowEditMethod rowEditMethod, const ClosedIntRange &rows, const ClosedIntRange &columns)
+{
+    QVector<ClosedIntRange> rowRanges = parallelRowRanges(rows, static_cast<qint64>(rows.length()) * length());
+    if (rowRanges.isEmpty())
+    {
+        SubseqChangePodVector pods;
+        pods.reserve(rows.length());
+        for (int i=rows.begin_; i<= rows.end_; ++i)
+            (this->*rowEditMethod)(i, columns, pods);
+
+        // Very likely that not all rows were changed; release the unused memory
+        pods.squeeze();
+
+        return pods;
+    }
+
+    QVector<SubseqChangePodVector> rangePods(rowRanges.size());
+    SubseqChangePodVector *output = rangePods.data();
+    // The last row range is edited in the calling thread
+    QSemaphore semaphore;
+    int last = rowRanges.size() - 1;
+    for (int i=0; i< last; ++i)
+        rowEditThreadPool()->start(new RowEditTask(this, rowEditMethod, rowRanges.at(i), columns, output + i, &semaphore));
+    RowEditTask(this, rowEditMethod, rowRanges.at(last), columns, output + last, &semaphore).run();
+    semaphore.acquire(rowRanges.size());
+
+    int nPods = 0;
+    foreach (const SubseqChangePodVector &podsInRange, rangePods)
+        nPods += podsInRange.size();
+
+    SubseqChangePodVector pods;
+    pods.reserve(nPods);
+    foreach (const SubseqChangePodVector &podsInRange, rangePods)
+        pods << podsInRange;
+
+    return pods;
+}
+
+/**
+  * @param row [int]
+  * @param columns [const ClosedIntRange &]
+  * @param pods [SubseqChangePodVector &]
+  * @see extendLeft()
+  */
+void Msa::extendLeftRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods)
+{
+    int nNewCharacters = leftExtendableLength(columns.begin_, row);
+    if (nNewCharacters > 0)
+        pods << extendLeft(row, nNewCharacters);
+}
+
+/**
+  * @param row [int]
+  * @param columns [const ClosedIntRange &]
+  * @param pods [SubseqChangePodVector &]
+  * @see extendRight()
+  */
+void Msa::extendRightRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods)
+{
+    int nNewCharacters = rightExtendableLength(columns.begin_, row);
+    if (nNewCharacters > 0)
+        pods << extendRight(row, nNewCharacters);
+}
+
+/**
+  * Bitmap strategy for finding columns containing purely gaps. A mask with one byte per column in columnRange is
+  * initialized to all ones and then AND-ed with the gap status of each row's characters (see andGapMask). Rows are
+  * processed sequentially, so each subseq is read once from beginning to end, and the search stops as soon as no
+  * column remains a candidate. Finally, the contiguous ranges of set bytes are collected from the mask.
+  *
+  * Unlike findGapColumns_iteratorRowBased, the amount of work per row does not depend on how fragmented the gap
+  * ranges become and no ranges are inserted or erased while iterating.
+  *
+  * @param columnRange [const ClosedIntRange &]
+  * @returns QVector<ClosedIntRange>
+  * @see findGapColumns_iteratorRowBased()
+  */
+QVector<ClosedIntRange> Msa::findGapColumns_bitmap(const ClosedIntRange &columnRange) const
+{
+    ASSERT(columnRange.begin_ >= 0 && columnRange.begin_ <= columnRange.end_);
+    ASSERT(columnRange.end_ <= columnCount());
+
+    QVector<ClosedIntRange> contiguousGapRanges;
+    if (isEmpty())
+        return contiguousGapRanges;
+
+    int begin = qMax(1, columnRange.begin_);
+    int n = columnRange.end_ - begin + 1;
+    if (n <= 0)
+        return contiguousGapRanges;
+
+    QByteArray mask(n, static_cast<char>(0xFF));
+    char *m = mask.data();
+    for (int i=0, z=rowCount(); i<z; ++i)
+        if (!andGapMask(subseqs_.at(i)->constData() + begin - 1, m, n))
+            return contiguousGapRanges;
+
+    for (int i=0; i< n; ++i)
+    {
+        if (!m[i])
+            continue;
+
+        int column = begin + i;
+        if (contiguousGapRanges.isEmpty() || contiguousGapRanges.last().end_ != column - 1)
+            contiguousGapRanges << ClosedIntRange(column, column);
+        else
+            ++contiguousGapRanges.last().end_;
+    }
+
+    return contiguousGapRanges;
+}
+
 /**
   * Iterator, row-based strategy for finding columns containing purely gaps. The approach follows the given rules (X
   * indicates columns currently recognized as all-gaps, and * indicates a column that has just been identified with a
@@ -1728,6 +1934,157 @@ QVector<ClosedIntRange> Msa::findGapColumns_nonIteratorColumnBased() const
     return contiguousGapRanges;
 }
 
+/**
+  * @param row [int]
+  * @param columns [const ClosedIntRange &]
+  * @param pods [SubseqChangePodVector &]
+  * @see trimLeft()
+  */
+void Msa::trimLeftRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods)
+{
+    int msaColumn = columns.begin_;
+    Subseq *subseq = subseqFromRow(row);
+    int nHeadGaps = subseq->headGaps();
+    if (msaColumn <= nHeadGaps)
+        return;
+
+    ClosedIntRange trimRange(nHeadGaps + 1, msaColumn);
+    int nTrimmableChars = subseq->nonGapsBetween(trimRange);
+
+    // Prevent trim operations from removing all characters so we reduce the number of trimmable characters by one
+    // Additionally, adjust the trim range at the same time
+    if (subseq->ungappedLength() - nTrimmableChars < 1)
+    {
+        const char *x = subseq->constData() + trimRange.end_ - 1;   // - 1 to map to 0-based indices
+        forever
+        {
+            --trimRange.end_;
+            if (!::isGapCharacter(*x))
+                break;
+
+            --x;
+        }
+        --nTrimmableChars;
+    }
+    if (nTrimmableChars == 0)
+        return;
+
+    // Could simply call the trimLeft(row, nCharsToTrim) method; however, that would require looping through the
+    // sequence again looking for the exact range to trim. This would duplicate effort, since we already know
+    // the exact range to trim. The only complication is that the trimRange.end_ might have trailing gap characters.
+    // Thus, we remove these in this loop.
+    const char *x = subseq->constData() + trimRange.end_ - 1;
+    while (::isGapCharacter(*x))
+    {
+        --x;
+        --trimRange.end_;
+    }
+
+    BioString difference = subseq->mid(trimRange);
+    subseq->trimLeft(trimRange, nTrimmableChars);
+    pods << SubseqChangePod(row,
+                            trimRange,
+                            SubseqChangePod::eTrimLeft,
+                            difference);
+}
+
+/**
+  * @param row [int]
+  * @param columns [const ClosedIntRange &]
+  * @param pods [SubseqChangePodVector &]
+  * @see trimRight()
+  */
+void Msa::trimRightRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods)
+{
+    int msaColumn = columns.begin_;
+    Subseq *subseq = subseqFromRow(row);
+    int firstTailGap = subseq->length() - subseq->tailGaps() + 1;
+    if (msaColumn >= firstTailGap)
+        return;
+
+    ClosedIntRange trimRange(msaColumn, firstTailGap - 1);
+    int nTrimmableChars = subseq->nonGapsBetween(trimRange);
+
+    // Prevent trim operations from removing all characters so we reduce the number of trimmable characters by one
+    // Additionally, adjust the trim range at the same time
+    if (subseq->ungappedLength() - nTrimmableChars < 1)
+    {
+        const char *x = subseq->constData() + trimRange.begin_ - 1; // - 1 to map to 0-based indices
+        forever
+        {
+            ++trimRange.begin_;
+            if (!::isGapCharacter(*x))
+                break;
+
+            ++x;
+        }
+        --nTrimmableChars;
+    }
+    if (nTrimmableChars == 0)
+        return;
+
+    // Could simply call the trimRight(row, nCharsToTrim) method; however, that would require looping through the
+    // sequence again looking for the exact range to trim. This would duplicate effort, since we already know
+    // the exact range to trim. The only complication is that the trimRange.begin_ might have leading gap characters
+    // Thus, we remove these in this loop.
+    const char *x = subseq->constData() + trimRange.begin_ - 1;
+    while (::isGapCharacter(*x))
+    {
+        ++x;
+        ++trimRange.begin_;
+    }
+
+    BioString difference = subseq->mid(trimRange);
+    subseq->trimRight(trimRange, nTrimmableChars);
+    pods << SubseqChangePod(row,
+                            trimRange,
+                            SubseqChangePod::eTrimRight,
+                            difference);
+}
+
+/**
+  * Reverts the change described by pod and appends a pod describing this reversal to undoneChangePods.
+  *
+  * @param pod [const SubseqChangePod &]
+  * @param undoneChangePods [SubseqChangePodVector &]
+  */
+void Msa::undoPod(const SubseqChangePod &pod, SubseqChangePodVector &undoneChangePods)
+{
+    // This is the operation that we are "undo'ing"
+    switch(pod.operation_)
+    {
+    case SubseqChangePod::eExtendLeft:
+        subseqFromRow(pod.row_)->trimLeft(pod.columns_);
+        undoneChangePods << pod;
+        undoneChangePods.last().operation_ = SubseqChangePod::eTrimLeft;
+        break;
+    case SubseqChangePod::eExtendRight:
+        subseqFromRow(pod.row_)->trimRight(pod.columns_);
+        undoneChangePods << pod;
+        undoneChangePods.last().operation_ = SubseqChangePod::eTrimRight;
+        break;
+    case SubseqChangePod::eTrimLeft:
+        undoneChangePods << extendLeft(pod.columns_.begin_, pod.row_, pod.difference_);
+        break;
+    case SubseqChangePod::eTrimRight:
+        undoneChangePods << extendRight(pod.columns_.begin_, pod.row_, pod.difference_);
+        break;
+    case SubseqChangePod::eInternal:
+        {
+            Subseq *subseq = subseqFromRow(pod.row_);
+            undoneChangePods << pod;
+            BioString old = subseq->mid(pod.columns_);
+            subseq->rearrange(pod.columns_, undoneChangePods.last().difference_);
+            undoneChangePods.last().difference_ = old;
+        }
+        break;
+
+    default:
+        ASSERT_X(0, "Unimplemented switch condition");
+        break;
+    }
+}
+
 
 
 
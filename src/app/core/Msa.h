@@ -17,6 +17,7 @@
 #include "PODs/SubseqChangePod.h"
 #include "Entities/AbstractSeq.h"
 
+class SubseqChangeRecord;
 
 class ISubseqLessThan
 {
@@ -47,6 +48,11 @@ public:
   * No gap columns will be automatically inserted. This must be done separately if needed to accommodate additional
   * characters.
   *
+  * Because each row may be edited independently of the others, the bulk column operations (inserting and removing gap
+  * columns, collapsing, extending, leveling, and trimming) split large edits into row ranges that are processed by the
+  * calling thread and a thread pool reserved for these edits. These methods block until every row has been edited and
+  * return their SubseqChangePods in row order exactly as a serial edit would.
+  *
   * All subseq members must possess the same grammar as the Msa. Any subseqs with a different grammar that defined by
   * the MSA will be rejected.
   *
@@ -157,6 +163,8 @@ public:
     SubseqChangePod trimRight(int row, int nCharsToRemove);                     //!< Trim nCharsToRemove from the right of the subseq at row and return a pod describing this change
     //!< Performs the inverse of each change in subseqChangePodVector and returns a equivalently sized vector of the changes that were made
     SubseqChangePodVector undo(const SubseqChangePodVector &subseqChangePodVector);
+    //! Performs the inverse of each change stored in subseqChangeRecord and returns a vector of the changes that were made
+    SubseqChangePodVector undo(const SubseqChangeRecord &subseqChangeRecord);
 
 
 protected:
@@ -170,11 +178,30 @@ protected:
 
 
 private:
+    // ------------------------------------------------------------------------------------------------
+    // Private types
+    class RowEditTask;
+    //! Edits the subseq at row within columns (or up to columns.begin_) and appends a pod describing any change to pods
+    typedef void (Msa::*RowEditMethod)(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods);
+
+
     // ------------------------------------------------------------------------------------------------
     // Private methods
+    void collapseLeftRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods);
+    void collapseRightRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods);
+    //! Applies rowEditMethod to each of rows (concurrently for large edits) and returns the resulting pods in row order
+    SubseqChangePodVector editRows(RowEditMethod rowEditMethod, const ClosedIntRange &rows, const ClosedIntRange &columns);
+    void extendLeftRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods);
+    void extendRightRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods);
+    //! Finds the gap columns within columnRange by AND-reducing a per-column gap mask across all rows
+    QVector<ClosedIntRange> findGapColumns_bitmap(const ClosedIntRange &columnRange) const;
     //! This method is presumably the better method for finding gaps :) Need to test
     QVector<ClosedIntRange> findGapColumns_iteratorRowBased(const ClosedIntRange &columnRange) const;
     QVector<ClosedIntRange> findGapColumns_nonIteratorColumnBased() const;
+    void trimLeftRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods);
+    void trimRightRow(int row, const ClosedIntRange &columns, SubseqChangePodVector &pods);
+    //! Reverts the change described by pod and appends a pod describing the reversal to undoneChangePods
+    void undoPod(const SubseqChangePod &pod, SubseqChangePodVector &undoneChangePods);
 
     // ------------------------------------------------------------------------------------------------
     // Private members
@@ -0,0 +1,415 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include "NonGapRunIndex.h"
+#include "macros.h"
+#include "misc.h"
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Constructors
+/**
+  */
+NonGapRunIndex::NonGapRunIndex()
+    : length_(0), valid_(false)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  */
+void NonGapRunIndex::clear()
+{
+    runs_.clear();
+    length_ = 0;
+    valid_ = false;
+}
+
+/**
+  * @param position [int]
+  * @returns int
+  */
+int NonGapRunIndex::firstNonGapAtOrAfter(int position) const
+{
+    ASSERT(valid_);
+    ASSERT_X(position >= 1 && position <= length_, "position out of range");
+
+    int i = runAtOrBefore(position);
+    if (i != -1 && runs_.at(i).end_ >= position)
+        return position;
+
+    return (i + 1 < runs_.size()) ? runs_.at(i + 1).begin_ : 0;
+}
+
+/**
+  * Does not consider the character at position.
+  *
+  * @param position [int]
+  * @returns int
+  * @see BioString::gapsLeftOf()
+  */
+int NonGapRunIndex::gapsLeftOf(int position) const
+{
+    ASSERT(valid_);
+    ASSERT_X(position >= 1 && position <= length_, "position out of range");
+
+    if (position == 1)
+        return 0;
+
+    int i = runAtOrBefore(position - 1);
+    int previousRunEnd = (i != -1) ? runs_.at(i).end_ : 0;
+    if (previousRunEnd >= position - 1)
+        return 0;
+
+    return position - 1 - previousRunEnd;
+}
+
+/**
+  * Does not consider the character at position.
+  *
+  * @param position [int]
+  * @returns int
+  * @see BioString::gapsRightOf()
+  */
+int NonGapRunIndex::gapsRightOf(int position) const
+{
+    ASSERT(valid_);
+    ASSERT_X(position >= 1 && position <= length_, "position out of range");
+
+    if (position == length_)
+        return 0;
+
+    int i = runAtOrBefore(position + 1);
+    if (i != -1 && runs_.at(i).end_ >= position + 1)
+        return 0;
+
+    int nextRunBegin = (i + 1 < runs_.size()) ? runs_.at(i + 1).begin_ : length_ + 1;
+    return nextRunBegin - position - 1;
+}
+
+/**
+  * @param position [int]
+  * @returns bool
+  */
+bool NonGapRunIndex::hasGapAt(int position) const
+{
+    ASSERT(valid_);
+    ASSERT_X(position >= 1 && position <= length_, "position out of range");
+
+    int i = runAtOrBefore(position);
+    return i == -1 || position > runs_.at(i).end_;
+}
+
+/**
+  * @returns int
+  */
+int NonGapRunIndex::headGaps() const
+{
+    ASSERT(valid_);
+
+    return (runs_.isEmpty()) ? length_ : runs_.first().begin_ - 1;
+}
+
+/**
+  * Any run containing position is split in two and all subsequent runs are shifted nGaps positions to the right. Does
+  * nothing if the index is not valid.
+  *
+  * @param position [int]
+  * @param nGaps [int]
+  */
+void NonGapRunIndex::insertGaps(int position, int nGaps)
+{
+    if (!valid_)
+        return;
+
+    ASSERT_X(position >= 1 && position <= length_ + 1, "position out of range");
+    ASSERT_X(nGaps >= 0, "nGaps must be positive");
+    if (nGaps == 0)
+        return;
+
+    length_ += nGaps;
+
+    int i = runAtOrBefore(position - 1);
+    if (i != -1 && runs_.at(i).end_ >= position)
+    {
+        Run &run = runs_[i];
+        Run rightRun(position + nGaps, run.end_ + nGaps, run.nNonGapsBefore_ + position - run.begin_);
+        run.end_ = position - 1;
+        runs_.insert(i + 1, rightRun);
+        i += 2;
+    }
+    else
+    {
+        ++i;
+    }
+
+    for (int z=runs_.size(); i<z; ++i)
+    {
+        runs_[i].begin_ += nGaps;
+        runs_[i].end_ += nGaps;
+    }
+}
+
+/**
+  * @returns bool
+  */
+bool NonGapRunIndex::isValid() const
+{
+    return valid_;
+}
+
+/**
+  * @param position [int]
+  * @returns int
+  */
+int NonGapRunIndex::lastNonGapAtOrBefore(int position) const
+{
+    ASSERT(valid_);
+    ASSERT_X(position >= 1 && position <= length_, "position out of range");
+
+    int i = runAtOrBefore(position);
+    return (i != -1) ? qMin(position, runs_.at(i).end_) : 0;
+}
+
+/**
+  * @returns int
+  */
+int NonGapRunIndex::length() const
+{
+    return length_;
+}
+
+/**
+  * @returns int
+  */
+int NonGapRunIndex::nonGaps() const
+{
+    ASSERT(valid_);
+
+    if (runs_.isEmpty())
+        return 0;
+
+    const Run &lastRun = runs_.last();
+    return lastRun.nNonGapsBefore_ + lastRun.end_ - lastRun.begin_ + 1;
+}
+
+/**
+  * @param range [const ClosedIntRange &]
+  * @returns int
+  */
+int NonGapRunIndex::nonGapsBetween(const ClosedIntRange &range) const
+{
+    ASSERT_X(range.begin_ >= 1 && range.begin_ <= length_, "range.begin_ out of range");
+    ASSERT_X(range.end_ >= range.begin_ && range.end_ <= length_, "range.end_ out of range");
+
+    return nonGapsUpTo(range.end_) - nonGapsUpTo(range.begin_ - 1);
+}
+
+/**
+  * @param position [int]
+  * @returns int
+  */
+int NonGapRunIndex::nonGapsUpTo(int position) const
+{
+    ASSERT(valid_);
+    ASSERT_X(position >= 0 && position <= length_, "position out of range");
+
+    int i = runAtOrBefore(position);
+    if (i == -1)
+        return 0;
+
+    const Run &run = runs_.at(i);
+    return run.nNonGapsBefore_ + qMin(position, run.end_) - run.begin_ + 1;
+}
+
+/**
+  * @param n [int]
+  * @returns int
+  */
+int NonGapRunIndex::positionOfNonGap(int n) const
+{
+    ASSERT(valid_);
+    ASSERT_X(n >= 1 && n <= nonGaps(), "n out of range");
+
+    // Find the last run that is preceded by fewer than n non-gaps
+    int lo = 0;
+    int hi = runs_.size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (runs_.at(mid).nNonGapsBefore_ < n)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    const Run &run = runs_.at(lo - 1);
+    return run.begin_ + n - run.nNonGapsBefore_ - 1;
+}
+
+/**
+  * @param characters [const char *]
+  * @param length [int]
+  */
+void NonGapRunIndex::rebuild(const char *characters, int length)
+{
+    ASSERT(length >= 0);
+
+    runs_.clear();
+    length_ = length;
+    valid_ = true;
+    if (length > 0)
+        appendRuns(characters, ClosedIntRange(1, length), 0, runs_);
+}
+
+/**
+  * Because the removed characters are all gaps, the runs themselves are unchanged except that they are shifted left by
+  * the number of gaps removed before them and runs that become adjacent are merged. Does nothing if the index is not
+  * valid.
+  *
+  * @param gapRanges [const QVector<ClosedIntRange> &]
+  */
+void NonGapRunIndex::removeGaps(const QVector<ClosedIntRange> &gapRanges)
+{
+    if (!valid_ || gapRanges.isEmpty())
+        return;
+
+    QVector<Run> runs;
+    runs.reserve(runs_.size());
+    int r = 0;
+    int nGapsRemoved = 0;
+    foreach (const Run &run, runs_)
+    {
+        for (; r < gapRanges.size() && gapRanges.at(r).end_ < run.begin_; ++r)
+            nGapsRemoved += gapRanges.at(r).length();
+
+        Run shiftedRun(run.begin_ - nGapsRemoved, run.end_ - nGapsRemoved, run.nNonGapsBefore_);
+        if (!runs.isEmpty() && runs.last().end_ + 1 == shiftedRun.begin_)
+            runs.last().end_ = shiftedRun.end_;
+        else
+            runs << shiftedRun;
+    }
+    for (; r < gapRanges.size(); ++r)
+        nGapsRemoved += gapRanges.at(r).length();
+
+    runs_ = runs;
+    length_ -= nGapsRemoved;
+}
+
+/**
+  * @returns int
+  */
+int NonGapRunIndex::tailGaps() const
+{
+    ASSERT(valid_);
+
+    return (runs_.isEmpty()) ? length_ : length_ - runs_.last().end_;
+}
+
+/**
+  * Only the runs that overlap or abut range are rescanned; the non-gap counts of all subsequent runs are then
+  * adjusted. Does nothing if the index is not valid.
+  *
+  * @param characters [const char *]
+  * @param range [const ClosedIntRange &]
+  */
+void NonGapRunIndex::update(const char *characters, const ClosedIntRange &range)
+{
+    if (!valid_)
+        return;
+
+    ASSERT_X(range.begin_ >= 1 && range.begin_ <= length_, "range.begin_ out of range");
+    ASSERT_X(range.end_ >= range.begin_ && range.end_ <= length_, "range.end_ out of range");
+
+    // Identify the runs [first, last] that overlap or abut range
+    int first = runAtOrBefore(range.begin_ - 1);
+    if (first == -1 || runs_.at(first).end_ < range.begin_ - 1)
+        ++first;
+    int last = runAtOrBefore(range.end_ + 1);
+
+    ClosedIntRange scanRange = range;
+    if (first <= last)
+    {
+        scanRange.begin_ = qMin(scanRange.begin_, runs_.at(first).begin_);
+        scanRange.end_ = qMax(scanRange.end_, runs_.at(last).end_);
+    }
+    int nNonGapsBefore = (first < runs_.size()) ? runs_.at(first).nNonGapsBefore_ : nonGaps();
+
+    QVector<Run> runs;
+    runs.reserve(runs_.size() + 1);
+    for (int i=0; i< first; ++i)
+        runs << runs_.at(i);
+    appendRuns(characters, scanRange, nNonGapsBefore, runs);
+
+    int nNonGaps = (runs.isEmpty()) ? 0 : runs.last().nNonGapsBefore_ + runs.last().end_ - runs.last().begin_ + 1;
+    for (int i=qMax(first, last + 1), z=runs_.size(); i<z; ++i)
+    {
+        runs << runs_.at(i);
+        runs.last().nNonGapsBefore_ = nNonGaps;
+        nNonGaps += runs.last().end_ - runs.last().begin_ + 1;
+    }
+
+    runs_ = runs;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Private static methods
+/**
+  * @param characters [const char *]
+  * @param range [const ClosedIntRange &]
+  * @param nNonGapsBefore [int]
+  * @param runs [QVector<Run> &]
+  */
+void NonGapRunIndex::appendRuns(const char *characters, const ClosedIntRange &range, int nNonGapsBefore, QVector<Run> &runs)
+{
+    const char *x = characters + range.begin_ - 1;
+    int i = range.begin_;
+    while (i <= range.end_)
+    {
+        for (; i <= range.end_ && ::isGapCharacter(*x); ++i, ++x)
+            ;
+        if (i > range.end_)
+            break;
+
+        int runBegin = i;
+        for (; i <= range.end_ && !::isGapCharacter(*x); ++i, ++x)
+            ;
+
+        runs << Run(runBegin, i - 1, nNonGapsBefore);
+        nNonGapsBefore += i - runBegin;
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  * @param position [int]
+  * @returns int
+  */
+int NonGapRunIndex::runAtOrBefore(int position) const
+{
+    int lo = 0;
+    int hi = runs_.size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (runs_.at(mid).begin_ <= position)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo - 1;
+}
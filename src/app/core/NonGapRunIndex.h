@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef NONGAPRUNINDEX_H
+#define NONGAPRUNINDEX_H
+
+#include <QtCore/QVector>
+
+#include "util/ClosedIntRange.h"
+
+/**
+  * NonGapRunIndex answers gap related queries about a gapped character string in logarithmic time.
+  *
+  * The index stores the position of each maximal run of non-gap characters along with the number of non-gap characters
+  * that precede it. Because alignment rows typically have far fewer gap runs than characters, the index is small and
+  * queries such as the number of non-gaps up to a given position reduce to a binary search over the runs.
+  *
+  * The index does not own or reference the characters it describes. It must be rebuilt from the characters (see
+  * rebuild) and then kept current by notifying it of every change to the characters via insertGaps, removeGaps, and
+  * update. Alternatively, it may be cleared whenever a change is inconvenient to describe and rebuilt on demand. All
+  * queries require a valid index.
+  *
+  * Like BioString, positions are 1-based.
+  */
+class NonGapRunIndex
+{
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Constructors
+    NonGapRunIndex();                                                           //!< Construct an invalid index
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    void clear();                                                               //!< Releases all runs and invalidates the index
+    int firstNonGapAtOrAfter(int position) const;                               //!< Returns the position of the first non-gap character at or after position or 0 if there is none
+    int gapsLeftOf(int position) const;                                         //!< Returns the number of contiguous gap characters to the left of the character at position
+    int gapsRightOf(int position) const;                                        //!< Returns the number of contiguous gap characters to the right of the character at position
+    bool hasGapAt(int position) const;                                          //!< Returns true if there is a gap at position; false otherwise
+    int headGaps() const;                                                       //!< Returns the number of gaps before the first non-gap character
+    //! Notifies the index that nGaps gap characters were inserted at position (before the character previously at position)
+    void insertGaps(int position, int nGaps);
+    bool isValid() const;                                                       //!< Returns true if the index has been built and not cleared since; false otherwise
+    int lastNonGapAtOrBefore(int position) const;                               //!< Returns the position of the last non-gap character at or before position or 0 if there is none
+    int length() const;                                                         //!< Returns the number of characters described by the index
+    int nonGaps() const;                                                        //!< Returns the total number of non-gap characters
+    int nonGapsBetween(const ClosedIntRange &range) const;                      //!< Returns the number of non-gap characters in range
+    int nonGapsUpTo(int position) const;                                        //!< Returns the number of non-gap characters between 1 and position (inclusive); position may be 0
+    int positionOfNonGap(int n) const;                                          //!< Returns the position of the n'th (1-based) non-gap character
+    void rebuild(const char *characters, int length);                           //!< Rebuilds the index from the first length characters
+    //! Notifies the index that the ordered, non-overlapping gapRanges (which consisted solely of gaps) were removed
+    void removeGaps(const QVector<ClosedIntRange> &gapRanges);
+    int tailGaps() const;                                                       //!< Returns the number of gaps after the last non-gap character
+    //! Notifies the index that the characters in range have been overwritten; characters refers to the updated string
+    void update(const char *characters, const ClosedIntRange &range);
+
+
+private:
+    // ------------------------------------------------------------------------------------------------
+    // Private structs
+    struct Run
+    {
+        int begin_;                     //!< Position of the first non-gap character in this run
+        int end_;                       //!< Position of the last non-gap character in this run
+        int nNonGapsBefore_;            //!< Number of non-gap characters in all preceding runs
+
+        Run(int begin = 0, int end = -1, int nNonGapsBefore = 0)
+            : begin_(begin), end_(end), nNonGapsBefore_(nNonGapsBefore)
+        {
+        }
+    };
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Private static methods
+    //! Appends the runs found in range of characters to runs; nNonGapsBefore is the number of non-gaps preceding range
+    static void appendRuns(const char *characters, const ClosedIntRange &range, int nNonGapsBefore, QVector<Run> &runs);
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Private methods
+    int runAtOrBefore(int position) const;                                      //!< Returns the index of the last run beginning at or before position or -1 if there is none
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Private members
+    QVector<Run> runs_;
+    int length_;
+    bool valid_;
+};
+
+#endif // NONGAPRUNINDEX_H
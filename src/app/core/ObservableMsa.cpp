@@ -573,3 +573,16 @@ SubseqChangePodVector ObservableMsa::undo(const SubseqChangePodVector &subseqCha
 
     return undoneChangePods;
 }
+
+/**
+  * @param subseqChangeRecord [const SubseqChangeRecord &]
+  * @returns SubseqChangePodVector
+  */
+SubseqChangePodVector ObservableMsa::undo(const SubseqChangeRecord &subseqChangeRecord)
+{
+    SubseqChangePodVector undoneChangePods = Msa::undo(subseqChangeRecord);
+    if (undoneChangePods.size() > 0)
+        emit subseqsChanged(undoneChangePods);
+
+    return undoneChangePods;
+}
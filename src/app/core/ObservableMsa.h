@@ -85,6 +85,8 @@ public Q_SLOTS:
     SubseqChangePodVector trimRight(int msaColumn, const ClosedIntRange &rows); //!< Maximally trim the stop positions of rows to msaColumn as possible
     //!< Performs the inverse of each change in subseqChangePodVector and returns a equivalently sized vector of the changes that were made
     SubseqChangePodVector undo(const SubseqChangePodVector &subseqChangePodVector);
+    //! Performs the inverse of each change stored in subseqChangeRecord and returns a vector of the changes that were made
+    SubseqChangePodVector undo(const SubseqChangeRecord &subseqChangeRecord);
 
 Q_SIGNALS:
     // ------------------------------------------------------------------------------------------------
@@ -0,0 +1,377 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtCore/QHash>
+
+#include <cstring>
+
+#include "PackedDnaString.h"
+#include "macros.h"
+#include "misc.h"
+
+// Characters indexed by their 2-bit code
+static const char kTwoBitCharacters[] = "ACGT";
+
+/**
+  * Lookup tables mapping characters to their 2-bit codes and packed bytes to their characters and reverse complements.
+  */
+struct PackedDnaTables
+{
+    signed char twoBitCodes_[256];                  //!< Character -> 2-bit code or -1 if it is stored unpacked
+    char characters_[256][4];                       //!< Byte of four 2-bit codes -> its four characters
+    unsigned char reverseComplement_[256];          //!< Byte of four 2-bit codes -> reversed and complemented byte
+
+    PackedDnaTables()
+    {
+        for (int i=0; i< 256; ++i)
+            twoBitCodes_[i] = -1;
+        for (int i=0; i< 4; ++i)
+            twoBitCodes_[static_cast<unsigned char>(kTwoBitCharacters[i])] = i;
+
+        for (int i=0; i< 256; ++i)
+        {
+            for (int j=0; j< 4; ++j)
+                characters_[i][j] = kTwoBitCharacters[(i >> (j << 1)) & 0x03];
+
+            // The complement of a 2-bit code is its inverse; reverse the order of the four codes
+            unsigned char inverse = ~i;
+            reverseComplement_[i] = ((inverse & 0x03) << 6) |
+                                    ((inverse & 0x0C) << 2) |
+                                    ((inverse & 0x30) >> 2) |
+                                    ((inverse & 0xC0) >> 6);
+        }
+    }
+};
+
+/**
+  * @returns const PackedDnaTables &
+  */
+static const PackedDnaTables &packedDnaTables()
+{
+    static const PackedDnaTables tables;
+    return tables;
+}
+
+/**
+  * Builds the tables during static initialization so that they are never built concurrently (see misc.cpp).
+  *
+  * @returns int
+  */
+static int initializePackedDnaTables()
+{
+    packedDnaTables();
+    return 0;
+}
+Q_CONSTRUCTOR_FUNCTION(initializePackedDnaTables)
+
+/**
+  * The first character occupies the most significant bits of code.
+  *
+  * @param kmer [const BioString &]
+  * @param code [quint64 &]
+  * @returns bool
+  */
+static bool encodeKmer(const BioString &kmer, quint64 &code)
+{
+    const signed char *codes = packedDnaTables().twoBitCodes_;
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(kmer.constData());
+    code = 0;
+    for (int i=0, z=kmer.length(); i<z; ++i)
+    {
+        if (codes[x[i]] < 0)
+            return false;
+
+        code = (code << 2) | codes[x[i]];
+    }
+
+    return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Constructors
+/**
+  */
+PackedDnaString::PackedDnaString()
+    : length_(0)
+{
+}
+
+/**
+  * The 2-bit slots of unpacked characters and the bits beyond the last character are always zero, so that equal
+  * sequences always have identical packed bytes.
+  *
+  * @param bioString [const BioString &]
+  */
+PackedDnaString::PackedDnaString(const BioString &bioString)
+    : length_(bioString.length())
+{
+    const signed char *codes = packedDnaTables().twoBitCodes_;
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(bioString.constData());
+
+    data_.fill('\0', (length_ + 3) >> 2);
+    unsigned char *y = reinterpret_cast<unsigned char *>(data_.data());
+    for (int i=0; i< length_; ++i)
+    {
+        if (codes[x[i]] >= 0)
+            y[i >> 2] |= codes[x[i]] << ((i & 3) << 1);
+        else
+            unpackedChars_ << UnpackedChar(i + 1, x[i]);
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Operators
+/**
+  * @param other [const PackedDnaString &]
+  * @returns bool
+  */
+bool PackedDnaString::operator==(const PackedDnaString &other) const
+{
+    return length_ == other.length_ &&
+           data_ == other.data_ &&
+           unpackedChars_ == other.unpackedChars_;
+}
+
+/**
+  * @param other [const PackedDnaString &]
+  * @returns bool
+  */
+bool PackedDnaString::operator!=(const PackedDnaString &other) const
+{
+    return !operator==(other);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  * @param position [int]
+  * @returns char
+  */
+char PackedDnaString::at(int position) const
+{
+    ASSERT_X(position >= 1 && position <= length_, "position out of range");
+
+    // Binary search for an unpacked character at position
+    int low = 0;
+    int high = unpackedChars_.size() - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) >> 1;
+        int middlePosition = unpackedChars_.at(middle).position_;
+        if (middlePosition == position)
+            return unpackedChars_.at(middle).character_;
+
+        if (middlePosition < position)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+
+    int i = position - 1;
+    return kTwoBitCharacters[(static_cast<unsigned char>(data_.at(i >> 2)) >> ((i & 3) << 1)) & 0x03];
+}
+
+/**
+  * @returns PackedDnaString
+  */
+PackedDnaString PackedDnaString::complement() const
+{
+    PackedDnaString result(*this);
+    if (isEmpty())
+        return result;
+
+    unsigned char *x = reinterpret_cast<unsigned char *>(result.data_.data());
+    for (int i=0, z=result.data_.size(); i<z; ++i)
+        x[i] = ~x[i];
+    result.clearPadding();
+    result.complementUnpackedChars();
+
+    return result;
+}
+
+/**
+  * Each window of k characters that does not contain an unpacked character is encoded as a rolling 2-bit code, as is
+  * the reverse complement of the window. Both codes are looked up amongst those of kmers. Thus, the cost is linear in
+  * the sequence length regardless of the number of kmers. A kmer that contains characters other than A, C, G, and T
+  * never occurs. Occurrences may overlap and a kmer that is its own reverse complement is counted once per strand.
+  *
+  * The result is identical to calling toBioString().count(kmer) + reverseComplement().toBioString().count(kmer) for
+  * each of kmers.
+  *
+  * @param kmers [const QVector<BioString> &]
+  * @returns QVector<int>
+  */
+QVector<int> PackedDnaString::countOnBothStrands(const QVector<BioString> &kmers) const
+{
+    QVector<int> counts(kmers.size(), 0);
+    if (kmers.isEmpty())
+        return counts;
+
+    int k = kmers.first().length();
+    ASSERT_X(k >= 1 && k <= kMaxKmerLength, "kmer length out of range");
+    if (k > length_)
+        return counts;
+
+    QHash<quint64, int> kmerCounts;
+    kmerCounts.reserve(kmers.size());
+    foreach (const BioString &kmer, kmers)
+    {
+        ASSERT_X(kmer.length() == k, "kmers must have equal lengths");
+        quint64 code;
+        if (encodeKmer(kmer, code))
+            kmerCounts.insert(code, 0);
+    }
+    if (kmerCounts.isEmpty())
+        return counts;
+
+    quint64 mask = (k == kMaxKmerLength) ? ~Q_UINT64_C(0) : (Q_UINT64_C(1) << (2 * k)) - 1;
+    int reverseShift = 2 * (k - 1);
+
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(data_.constData());
+    const UnpackedChar *unpackedChar = unpackedChars_.constData();
+    const UnpackedChar *unpackedEnd = unpackedChar + unpackedChars_.size();
+    quint64 forward = 0;
+    quint64 reverse = 0;
+    int nPacked = 0;                // Number of consecutive packed characters ending at i
+    for (int i=0; i< length_; ++i)
+    {
+        if (unpackedChar != unpackedEnd && unpackedChar->position_ == i + 1)
+        {
+            ++unpackedChar;
+            nPacked = 0;
+            continue;
+        }
+
+        quint64 code = (x[i >> 2] >> ((i & 3) << 1)) & 0x03;
+        forward = ((forward << 2) | code) & mask;
+        reverse = (reverse >> 2) | ((code ^ 0x03) << reverseShift);
+        if (++nPacked < k)
+            continue;
+
+        QHash<quint64, int>::iterator it = kmerCounts.find(forward);
+        if (it != kmerCounts.end())
+            ++it.value();
+        it = kmerCounts.find(reverse);
+        if (it != kmerCounts.end())
+            ++it.value();
+    }
+
+    for (int i=0, z=kmers.size(); i<z; ++i)
+    {
+        quint64 code;
+        if (encodeKmer(kmers.at(i), code))
+            counts[i] = kmerCounts.value(code);
+    }
+
+    return counts;
+}
+
+/**
+  * Each byte is reversed and complemented with a single table lookup. Because the last byte may be partially filled,
+  * the reversed bytes are shifted by the number of unused character slots as they are written.
+  *
+  * @returns PackedDnaString
+  */
+PackedDnaString PackedDnaString::reverseComplement() const
+{
+    PackedDnaString result(*this);
+    if (isEmpty())
+        return result;
+
+    const unsigned char *table = packedDnaTables().reverseComplement_;
+    int n = data_.size();
+    int shift = ((n << 2) - length_) << 1;
+
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(data_.constData()) + n - 1;
+    unsigned char *y = reinterpret_cast<unsigned char *>(result.data_.data());
+    if (shift == 0)
+    {
+        for (int i=0; i< n; ++i, --x)
+            y[i] = table[*x];
+    }
+    else
+    {
+        unsigned char current = table[*x];
+        for (int i=0; i< n; ++i)
+        {
+            unsigned char next = (i + 1 < n) ? table[*--x] : 0;
+            y[i] = (current >> shift) | (next << (8 - shift));
+            current = next;
+        }
+        result.clearPadding();
+    }
+
+    for (int i=0, j=unpackedChars_.size() - 1; j>= 0; ++i, --j)
+        result.unpackedChars_[i] = UnpackedChar(length_ - unpackedChars_.at(j).position_ + 1, unpackedChars_.at(j).character_);
+    result.complementUnpackedChars();
+
+    return result;
+}
+
+/**
+  * @returns BioString
+  */
+BioString PackedDnaString::toBioString() const
+{
+    QByteArray characters;
+    characters.resize(length_);
+    char *y = characters.data();
+
+    const char (*table)[4] = packedDnaTables().characters_;
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(data_.constData());
+    int nFullBytes = length_ >> 2;
+    for (int i=0; i< nFullBytes; ++i, y += 4)
+        memcpy(y, table[x[i]], 4);
+    if (length_ & 3)
+        memcpy(y, table[x[nFullBytes]], length_ & 3);
+
+    y = characters.data();
+    foreach (const UnpackedChar &unpackedChar, unpackedChars_)
+        y[unpackedChar.position_ - 1] = unpackedChar.character_;
+
+    return BioString(characters, eDnaGrammar);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  */
+void PackedDnaString::clearPadding()
+{
+    int nUsed = length_ & 3;
+    if (nUsed == 0)
+        return;
+
+    unsigned char mask = (1 << (nUsed << 1)) - 1;
+    data_[data_.size() - 1] = static_cast<unsigned char>(data_.at(data_.size() - 1)) & mask;
+}
+
+/**
+  * Also zeroes the 2-bit slot of each unpacked character, which may have been inverted along with the packed codes.
+  */
+void PackedDnaString::complementUnpackedChars()
+{
+    const unsigned char *complement = characterTables().complement_;
+    unsigned char *y = reinterpret_cast<unsigned char *>(data_.data());
+    for (int i=0, z=unpackedChars_.size(); i<z; ++i)
+    {
+        UnpackedChar &unpackedChar = unpackedChars_[i];
+        unpackedChar.character_ = complement[static_cast<unsigned char>(unpackedChar.character_)];
+
+        int j = unpackedChar.position_ - 1;
+        y[j >> 2] &= ~(0x03 << ((j & 3) << 1));
+    }
+}
@@ -0,0 +1,143 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef PACKEDDNASTRING_H
+#define PACKEDDNASTRING_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+#include "BioString.h"
+
+/**
+  * PackedDnaString is a compact, immutable and lossless representation of a DNA sequence.
+  *
+  * BioString requires one byte per character. PackedDnaString stores each character in 2 bits (A = 0, C = 1, G = 2,
+  * T = 3). Every other character (lower case nucleotides, ambiguity codes, gaps, etc.) is recorded in a sparse list of
+  * unpacked characters ordered by position, and its 2-bit slot is left zero. Thus, any BioString may be packed and
+  * sequences that consist mostly of upper case A, C, G, and T require roughly a quarter of the memory.
+  *
+  * The complement of a 2-bit code is its bitwise inverse. Both complement() and reverseComplement() therefore process
+  * four characters at a time via a lookup table and only the unpacked characters are complemented individually (using
+  * the same rules as BioString::complement).
+  *
+  * countOnBothStrands() counts the occurrences of short words of A, C, G, and T on both strands in a single pass using
+  * rolling 2-bit codes, without unpacking the sequence or constructing its reverse complement.
+  *
+  * Like BioString, positions are 1-based.
+  */
+class PackedDnaString
+{
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Constants
+    static const int kMaxKmerLength = 32;                                       //!< Longest word that may be counted with countOnBothStrands
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Constructors
+    PackedDnaString();                                                          //!< Construct an empty packed string
+    explicit PackedDnaString(const BioString &bioString);                       //!< Construct a packed representation of bioString
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Operators
+    bool operator==(const PackedDnaString &other) const;                        //!< Returns true if other has the same sequence; false otherwise
+    bool operator!=(const PackedDnaString &other) const;                        //!< Returns true if other has a different sequence; false otherwise
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    char at(int position) const;                                                //!< Returns the character at position (1-based)
+    PackedDnaString complement() const;                                         //!< Returns the DNA complement
+    //! Returns the number of times each of kmers, which must have equal lengths of at most kMaxKmerLength, occurs in this sequence and its reverse complement
+    QVector<int> countOnBothStrands(const QVector<BioString> &kmers) const;
+    bool isEmpty() const;                                                       //!< Returns true if there are no characters; false otherwise
+    int length() const;                                                         //!< Returns the number of characters
+    int packedSize() const;                                                     //!< Returns the number of bytes used to store the 2-bit codes
+    PackedDnaString reverseComplement() const;                                  //!< Returns the reversed DNA complement
+    BioString toBioString() const;                                              //!< Returns the unpacked characters as a DNA BioString
+    int unpackedCount() const;                                                  //!< Returns the number of characters other than A, C, G, and T
+
+
+private:
+    // ------------------------------------------------------------------------------------------------
+    // Private structures
+    struct UnpackedChar
+    {
+        int position_;                  //!< 1-based position
+        char character_;
+
+        UnpackedChar() : position_(0), character_('\0')
+        {
+        }
+
+        UnpackedChar(int position, char character) : position_(position), character_(character)
+        {
+        }
+
+        bool operator==(const UnpackedChar &other) const
+        {
+            return position_ == other.position_ && character_ == other.character_;
+        }
+    };
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Private methods
+    void clearPadding();                                                        //!< Zeroes the unused bits of the last byte
+    void complementUnpackedChars();                                             //!< Replaces each unpacked character with its complement
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Private members
+    QByteArray data_;
+    int length_;
+    QVector<UnpackedChar> unpackedChars_;
+};
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Inline methods
+/**
+  * @returns bool
+  */
+inline
+bool PackedDnaString::isEmpty() const
+{
+    return length_ == 0;
+}
+
+/**
+  * @returns int
+  */
+inline
+int PackedDnaString::length() const
+{
+    return length_;
+}
+
+/**
+  * @returns int
+  */
+inline
+int PackedDnaString::packedSize() const
+{
+    return data_.size();
+}
+
+/**
+  * @returns int
+  */
+inline
+int PackedDnaString::unpackedCount() const
+{
+    return unpackedChars_.size();
+}
+
+#endif // PACKEDDNASTRING_H
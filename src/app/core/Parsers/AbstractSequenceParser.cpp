@@ -10,6 +10,8 @@
 #include <QtCore/QFileInfo>
 #include <QtCore/QTextStream>
 
+#include <climits>
+
 #include "AbstractSequenceParser.h"
 #include "../macros.h"
 
@@ -18,10 +20,11 @@
 // -------------------------------------------------------------------------------------------------
 // Public methods
 /**
+  * May be called from any thread. A parse in progress throws CanceledError at its next opportunity.
   */
 void AbstractSequenceParser::cancel()
 {
-    canceled_ = true;
+    canceled_.fetchAndStoreOrdered(1);
 }
 
 /**
@@ -30,18 +33,8 @@ void AbstractSequenceParser::cancel()
   */
 SequenceParseResultPod AbstractSequenceParser::parseFile(const QString &fileName) const
 {
-    ASSERT(fileName.isEmpty() == false);
-    QFileInfo fileInfo(fileName);
-    ASSERT(fileInfo.isDir() == false);
-
-    if (fileInfo.exists() == false)
-        throw QString("File, %1, does not exist").arg(fileName);
-
-    if (fileInfo.size() == 0)
-        throw QString("Empty file");
-
-    QFile file(fileName);
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
+    QFile file;
+    openFile(fileName, file, QIODevice::ReadOnly | QIODevice::Text);
 
     QTextStream inputStream(&file);
     return parseStream(inputStream, file.size());
@@ -70,3 +63,50 @@ SequenceParseResultPod AbstractSequenceParser::parseStream(QTextStream &textStre
 
     return SequenceParseResultPod(parseSimpleSeqPods(textStream, totalBytes));
 }
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Protected methods
+/**
+  * progressChanged only accepts int values; therefore, both values are scaled down equally for inputs larger than
+  * 2 GB.
+  *
+  * @param bytesRead [qint64]
+  * @param totalBytes [qint64]
+  */
+void AbstractSequenceParser::emitByteProgress(qint64 bytesRead, qint64 totalBytes) const
+{
+    int shift = 0;
+    while ((totalBytes >> shift) > INT_MAX)
+        ++shift;
+
+    emit progressChanged(static_cast<int>(bytesRead >> shift), static_cast<int>(totalBytes >> shift));
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Static protected methods
+/**
+  * @param fileName [const QString &]
+  * @param file [QFile &]
+  * @param openMode [QIODevice::OpenMode]
+  * @throws QString
+  */
+void AbstractSequenceParser::openFile(const QString &fileName, QFile &file, QIODevice::OpenMode openMode)
+{
+    ASSERT(fileName.isEmpty() == false);
+    QFileInfo fileInfo(fileName);
+    ASSERT(fileInfo.isDir() == false);
+
+    if (fileInfo.exists() == false)
+        throw QString("File, %1, does not exist").arg(fileName);
+
+    if (fileInfo.size() == 0)
+        throw QString("Empty file");
+
+    file.setFileName(fileName);
+    if (!file.open(openMode))
+        throw QString("Unable to open file, %1").arg(fileName);
+}
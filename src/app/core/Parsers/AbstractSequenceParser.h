@@ -12,6 +12,10 @@
 #include "ISequenceParser.h"
 #include "../PODs/SequenceParseResultPod.h"
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QIODevice>
+
+class QFile;
 class QObject;
 class QString;
 
@@ -25,11 +29,15 @@ public:
     virtual SequenceParseResultPod parseStream(QTextStream &textStream, int totalBytes) const;
 
 protected:
-    AbstractSequenceParser(QObject *parent) : ISequenceParser(parent), canceled_(false) {}
+    AbstractSequenceParser(QObject *parent) : ISequenceParser(parent), canceled_(0) {}
 
     virtual QVector<SimpleSeqPod> parseSimpleSeqPods(QTextStream &textStream, int totalBytes) const = 0;
 
-    bool canceled_;
+    void emitByteProgress(qint64 bytesRead, qint64 totalBytes) const;          //!< Emits progressChanged for byte counts which may exceed the range of an int
+    //! Opens fileName with openMode after verifying that it exists and is not empty
+    static void openFile(const QString &fileName, QFile &file, QIODevice::OpenMode openMode);
+
+    QAtomicInt canceled_;                       //!< Non-zero once cancel has been called (possibly from another thread)
 };
 
 #endif // ABSTRACTSEQUENCEPARSER_H
@@ -6,13 +6,97 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QFile>
 #include <QtCore/QHash>
 #include <QtCore/QStringList>
 #include <QtCore/QTextStream>
 
+#include <climits>
+#include <cstring>
+
 #include "ClustalParser.h"
+#include "../exceptions/CanceledError.h"
+#include "../global.h"
 #include "../macros.h"
 
+/**
+  * @param ch [char]
+  * @returns bool
+  */
+static inline bool isAsciiSpace(char ch)
+{
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+/**
+  * @param ch [char]
+  * @returns bool
+  */
+static inline bool isAsciiDigit(char ch)
+{
+    return ch >= '0' && ch <= '9';
+}
+
+/**
+  * Returns a pointer to the beginning of the line following the line that begins at x (or end if there are no more
+  * lines). lineEnd is set to the end of the line that begins at x excluding its terminal \n or \r\n characters.
+  *
+  * @param x [const char *]
+  * @param end [const char *]
+  * @param lineEnd [const char *&]
+  * @returns const char *
+  */
+static const char *nextLine(const char *x, const char *end, const char *&lineEnd)
+{
+    const char *newline = static_cast<const char *>(memchr(x, '\n', end - x));
+    lineEnd = (newline != nullptr) ? newline : end;
+    if (lineEnd > x && *(lineEnd - 1) == '\r')
+        --lineEnd;
+
+    return (newline != nullptr) ? newline + 1 : end;
+}
+
+/**
+  * @param begin [const char *]
+  * @param end [const char *]
+  * @returns bool
+  */
+static bool isBlank(const char *begin, const char *end)
+{
+    for (const char *x = begin; x < end; ++x)
+        if (!isAsciiSpace(*x))
+            return false;
+
+    return true;
+}
+
+/**
+  * Byte-oriented equivalent of ClustalParser::isConsensusLine.
+  *
+  * @param begin [const char *]
+  * @param end [const char *]
+  * @returns bool
+  */
+static bool isConsensus(const char *begin, const char *end)
+{
+    if (begin == end || !isAsciiSpace(*begin))
+        return false;
+
+    bool hasConsensusChar = false;
+    for (const char *x = begin + 1; x < end; ++x)
+    {
+        if (isAsciiSpace(*x))
+            continue;
+
+        if (*x != '.' && *x != ':' && *x != '*')
+            return false;
+
+        hasConsensusChar = true;
+    }
+
+    return hasConsensusChar;
+}
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Constructors and destructor
@@ -76,6 +160,49 @@ bool ClustalParser::isCompatibleString(const QString &chunk) const
     return false;
 }
 
+/**
+  * Produces the same results as parsing the equivalent text with parseStream.
+  *
+  * @param data [const char *]
+  * @param size [qint64]
+  * @returns SequenceParseResultPod
+  */
+SequenceParseResultPod ClustalParser::parseBytes(const char *data, qint64 size) const
+{
+    ASSERT(size >= 0);
+    ASSERT(data != nullptr || size == 0);
+
+    SequenceParseResultPod clustalPod(parseSimpleSeqPods(data, size));
+    clustalPod.isAlignment_ = eTrue;
+
+    return clustalPod;
+}
+
+/**
+  * Memory maps fileName and parses it with parseBytes. If the file cannot be mapped, falls back to the streaming text
+  * implementation.
+  *
+  * @param fileName [const QString &]
+  * @returns SequenceParseResultPod
+  */
+SequenceParseResultPod ClustalParser::parseFile(const QString &fileName) const
+{
+    QFile file;
+    openFile(fileName, file, QIODevice::ReadOnly);
+
+    const uchar *data = file.map(0, file.size());
+    if (data == nullptr)
+    {
+        file.close();
+        return AbstractSequenceParser::parseFile(fileName);
+    }
+
+    SequenceParseResultPod clustalPod = parseBytes(reinterpret_cast<const char *>(data), file.size());
+    file.unmap(const_cast<uchar *>(data));
+
+    return clustalPod;
+}
+
 /**
   * @param textStream [QTextStream &]
   * @param totalBytes [int]
@@ -188,6 +315,185 @@ QPair<QString, QString> ClustalParser::parseAlignmentLine(const QString &line) c
     return captures;
 }
 
+/**
+  * Byte-oriented equivalent of parseSimpleSeqPodsNoRegex that makes a single pass over data. Each alignment line is
+  * split into its identifier and fragment in place and the fragment's non-whitespace characters are copied directly
+  * into the end of its sequence's buffer. Buffers grow geometrically while reading the first block; once the first
+  * block is complete, the number of remaining blocks is estimated from its size in bytes and every buffer is resized
+  * to hold the entire (estimated) alignment. Thus, the remaining blocks rarely cause any reallocation.
+  *
+  * @param data [const char *]
+  * @param size [qint64]
+  * @returns QVector<SimpleSeqPod>
+  */
+QVector<SimpleSeqPod> ClustalParser::parseSimpleSeqPods(const char *data, qint64 size) const
+{
+    const char *end = data + size;
+    const char *x = data;
+
+    // Ignore all empty/blank header whitespace
+    while (x < end && isAsciiSpace(*x))
+        ++x;
+
+    // Empty file
+    if (x == end)
+        throw "empty file";
+
+    // Header line must begin with CLUSTAL
+    const char *lineEnd = nullptr;
+    const char *line = x;
+    x = nextLine(line, end, lineEnd);
+    if (lineEnd - line < 7 || qstrnicmp(line, "CLUSTAL", 7) != 0)
+        throw "missing or invalid CLUSTAL header line";
+
+    if (x < end)
+    {
+        line = x;
+        x = nextLine(line, end, lineEnd);
+        if (lineEnd != line)
+            throw "blank line must immediately follow the CLUSTAL header line";
+    }
+
+    QVector<QByteArray> identifiers;
+    QVector<QByteArray> alignments;     // Buffers which are larger than their alignment (see lengths)
+    QVector<int> lengths;               // Number of characters in each alignment buffer
+    int nSequences = 0;                 // Number of sequences per block; zero until the first block is complete
+    int row = 0;                        // Number of alignment lines read in the current block
+    int blockWidth = 0;
+    const char *blockBegin = nullptr;
+    forever
+    {
+        bool atEnd = x >= end;
+        line = x;
+        if (!atEnd)
+            x = nextLine(line, end, lineEnd);
+
+        if (atEnd || isBlank(line, lineEnd))
+        {
+            // Finish the current block (if any)
+            if (row > 0)
+            {
+                if (nSequences == 0)
+                {
+                    nSequences = row;
+
+                    // Preallocate enough space for the estimated number of blocks plus one
+                    qint64 blockBytes = qMax(static_cast<qint64>(line - blockBegin), static_cast<qint64>(1));
+                    qint64 capacity = static_cast<qint64>(blockWidth) * ((end - line) / blockBytes + 2);
+                    capacity = qMin(capacity, static_cast<qint64>(INT_MAX / 2));
+                    for (int i=0; i< nSequences; ++i)
+                        if (capacity > alignments.at(i).size())
+                            alignments[i].resize(static_cast<int>(capacity));
+                }
+                else if (row != nSequences)
+                {
+                    throw "unequal number of sequences between blocks";
+                }
+
+                row = 0;
+                emitByteProgress(line - data, size);
+
+                if (canceled_)
+                    throw CanceledError();
+            }
+
+            if (atEnd)
+                break;
+
+            continue;
+        }
+
+        if (isConsensus(line, lineEnd))
+            continue;
+
+        // Alignment lines must begin with a non-space identifier followed by whitespace and the alignment fragment
+        if (isAsciiSpace(*line))
+            throw "malformed alignment line";
+
+        const char *identifierEnd = line + 1;
+        while (identifierEnd < lineEnd && !isAsciiSpace(*identifierEnd))
+            ++identifierEnd;
+        const char *fragment = identifierEnd;
+        while (fragment < lineEnd && isAsciiSpace(*fragment))
+            ++fragment;
+        if (fragment == lineEnd)
+            throw "malformed alignment line";
+
+        // Remove trailing whitespace and any terminal number that is preceded by a space
+        const char *fragmentEnd = lineEnd;
+        while (isAsciiSpace(*(fragmentEnd - 1)))
+            --fragmentEnd;
+        const char *digits = fragmentEnd;
+        while (digits > fragment && isAsciiDigit(*(digits - 1)))
+            --digits;
+        if (digits < fragmentEnd && digits > fragment && isAsciiSpace(*(digits - 1)))
+            fragmentEnd = digits;
+
+        int identifierLength = identifierEnd - line;
+        if (nSequences == 0)
+        {
+            identifiers << QByteArray(line, identifierLength);
+            alignments << QByteArray();
+            lengths << 0;
+        }
+        else
+        {
+            if (row >= nSequences)
+                throw "unequal number of sequences between blocks";
+
+            const QByteArray &identifier = identifiers.at(row);
+            if (identifier.size() != identifierLength || memcmp(identifier.constData(), line, identifierLength) != 0)
+            {
+                if (identifiers.contains(QByteArray(line, identifierLength)))
+                    throw "sequence identifiers ordered differently from previous blocks";
+
+                throw "found sequence identifiers in current block that are distinct from previous block(s)";
+            }
+        }
+
+        if (row == 0)
+            blockBegin = line;
+
+        // Append the non-whitespace fragment characters directly to the end of this sequence's buffer
+        QByteArray &alignment = alignments[row];
+        int length = lengths.at(row);
+        int maxLength = length + (fragmentEnd - fragment);
+        if (maxLength > alignment.size())
+            alignment.resize(qMax(maxLength, 2 * alignment.size()));
+        char *y = alignment.data() + length;
+        for (const char *z = fragment; z < fragmentEnd; ++z)
+            if (!isAsciiSpace(*z))
+                *y++ = *z;
+
+        int width = y - alignment.constData() - length;
+        if (row == 0)
+            blockWidth = width;
+        else if (width != blockWidth)
+            throw "alignments within block do not all have the same length";
+        lengths[row] = length + width;
+
+        ++row;
+    }
+
+    emitByteProgress(size, size);
+
+    if (nSequences == 0)
+        throw "no sequences found";
+    else if (nSequences == 1)
+        throw "alignment must have more than one sequence";
+
+    QVector<SimpleSeqPod> simpleSeqPods;
+    simpleSeqPods.reserve(nSequences);
+    for (int i=0; i< nSequences; ++i)
+    {
+        alignments[i].resize(lengths.at(i));
+        simpleSeqPods << SimpleSeqPod(QString::fromLocal8Bit(identifiers.at(i).constData(), identifiers.at(i).size()),
+                                      alignments.at(i));
+    }
+
+    return simpleSeqPods;
+}
+
 /**
   * Does not use a regular expression for parsing.
   *
@@ -331,10 +637,9 @@ QVector<SimpleSeqPod> ClustalParser::parseSimpleSeqPodsNoRegex(QTextStream &text
         totalBytesRead += line.length();
         emit progressChanged(totalBytesRead, totalBytes);
 
-        // TODO: Implement a cancel exception
         // The following is only relevant for multi-threaded applications, and is set in AbstractSequenceParser
         if (canceled_)
-            throw "[ClustalParser] Cancelled! Please implement a proper cancel exception";
+            throw CanceledError();
     }
 
     emit progressChanged(totalBytes, totalBytes);
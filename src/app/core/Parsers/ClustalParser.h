@@ -15,6 +15,12 @@
 
 #include "AbstractSequenceParser.h"
 
+/**
+  * In addition to the generic QTextStream interface, ClustalParser provides a byte-oriented parsing path (parseBytes)
+  * which makes a single pass over the raw file data. parseFile memory maps the file and uses this path. Each block
+  * fragment is appended directly to its sequence's buffer; after the first block, these buffers are preallocated for
+  * the whole alignment based upon the number of bytes and alignment width of the first block.
+  */
 class ClustalParser : public AbstractSequenceParser
 {
     Q_OBJECT
@@ -25,6 +31,9 @@ public:
     ClustalParser *clone() const;
 
     bool isCompatibleString(const QString &chunk) const;
+    //! Parses the size bytes of Clustal data beginning at data
+    SequenceParseResultPod parseBytes(const char *data, qint64 size) const;
+    SequenceParseResultPod parseFile(const QString &fileName) const;
 
     virtual SequenceParseResultPod parseStream(QTextStream &textStream, int totalBytes) const;
 
@@ -34,6 +43,7 @@ protected:
 private:
     bool isConsensusLine(const QString &line) const;
     QPair<QString, QString> parseAlignmentLine(const QString &line) const;
+    QVector<SimpleSeqPod> parseSimpleSeqPods(const char *data, qint64 size) const;
     QVector<SimpleSeqPod> parseSimpleSeqPodsNoRegex(QTextStream &textStream, int totalBytes) const;
 
     // Deprecated
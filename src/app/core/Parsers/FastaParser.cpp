@@ -6,17 +6,262 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFile>
+#include <QtCore/QRunnable>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QSemaphore>
 #include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <cstring>
 
 #include "FastaParser.h"
 #include "../PODs/SequenceParseResultPod.h"
+#include "../exceptions/CanceledError.h"
 #include "../BioString.h"
 #include "../constants.h"
 #include "../global.h"
 #include "../macros.h"
 #include "../misc.h"
 
+// Inputs with fewer record bytes than this are always parsed in the calling thread
+static const qint64 kMinimumParallelBytes = 1 << 22;
+// Size of each chunk when parsing serially; progress is reported after each chunk
+static const qint64 kSerialChunkSize = 1 << 16;
+// Minimum size of each chunk when parsing in parallel
+static const qint64 kMinimumParallelChunkSize = 1 << 20;
+// Interval at which progress is reported while waiting for helper tasks to finish
+static const int kProgressIntervalMs = 100;
+
+/**
+  * @param ch [char]
+  * @returns bool
+  */
+static inline bool isAsciiSpace(char ch)
+{
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+/**
+  * Copies the sequence characters between begin and end (exclusive) into a new byte array. Newline characters are
+  * skipped by copying whole lines at a time; any other whitespace (e.g. carriage returns) is removed later by the
+  * BioString constructor.
+  *
+  * @param begin [const char *]
+  * @param end [const char *]
+  * @returns QByteArray
+  */
+static QByteArray copySequenceLines(const char *begin, const char *end)
+{
+    QByteArray sequence(end - begin, '\0');
+    char *y = sequence.data();
+    while (begin < end)
+    {
+        const char *newline = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        const char *lineEnd = (newline != nullptr) ? newline : end;
+        memcpy(y, begin, lineEnd - begin);
+        y += lineEnd - begin;
+        begin = lineEnd + 1;
+    }
+    sequence.resize(y - sequence.constData());
+
+    return sequence;
+}
+
+/**
+  * Returns a pointer to the first newline in [begin, end) that is immediately followed by a > symbol or nullptr if
+  * there is no such record separator.
+  *
+  * @param begin [const char *]
+  * @param end [const char *]
+  * @returns const char *
+  */
+static const char *findRecordSeparator(const char *begin, const char *end)
+{
+    while (begin < end)
+    {
+        const char *newline = static_cast<const char *>(memchr(begin, '\n', end - begin));
+        if (newline == nullptr || newline + 1 >= end)
+            return nullptr;
+
+        if (*(newline + 1) == '>')
+            return newline;
+
+        begin = newline + 1;
+    }
+
+    return nullptr;
+}
+
+/**
+  * Returns a pointer to the > symbol that begins the first record in [begin, end) or end if the data solely consists
+  * of whitespace. Throws an error if any non-whitespace character precedes the first record.
+  *
+  * @param begin [const char *]
+  * @param end [const char *]
+  * @returns const char *
+  */
+static const char *findFirstRecord(const char *begin, const char *end)
+{
+    if (begin == end || *begin == '>')
+        return begin;
+
+    for (const char *x = begin; x < end; ++x)
+    {
+        if (*x == '\n' && x + 1 < end && *(x + 1) == '>')
+            return x + 1;
+        else if (!isAsciiSpace(*x))
+            throw "First non-whitespace character must be the > symbol";
+    }
+
+    return end;
+}
+
+/**
+  * Parses the FASTA records in [begin, end) and appends them to simpleSeqPods. begin must point to the > symbol of the
+  * first record and end must either be the end of the data or point to the > symbol of a subsequent record. Parsing
+  * stops early if *canceled becomes non-zero.
+  *
+  * @param begin [const char *]
+  * @param end [const char *]
+  * @param simpleSeqPods [QVector<SimpleSeqPod> &]
+  * @param canceled [const QAtomicInt *]
+  */
+static void parseFastaRecords(const char *begin, const char *end, QVector<SimpleSeqPod> &simpleSeqPods, const QAtomicInt *canceled)
+{
+    const char *x = begin;
+    for (int nRecords = 1; x < end; ++nRecords)
+    {
+        ASSERT(*x == '>');
+
+        const char *header = x + 1;
+        const char *headerEnd = static_cast<const char *>(memchr(header, '\n', end - header));
+        const char *separator = nullptr;
+        if (headerEnd != nullptr)
+            separator = findRecordSeparator(headerEnd, end);
+        else
+            headerEnd = end;
+
+        const char *recordEnd = (separator != nullptr) ? separator : end;
+
+        BioString sequence;
+        if (headerEnd < recordEnd)
+            sequence = BioString(copySequenceLines(headerEnd + 1, recordEnd));
+
+        simpleSeqPods << SimpleSeqPod(QString::fromLocal8Bit(header, headerEnd - header).trimmed(), sequence);
+
+        x = (separator != nullptr) ? separator + 1 : end;
+
+        if (nRecords % 1024 == 0 && *canceled)
+            return;
+    }
+}
+
+/**
+  * FastaChunks divides the FASTA records between begin and end into consecutive, record-aligned chunks of roughly
+  * targetChunkSize bytes. Each call to parseNextChunk claims and parses the next unparsed chunk; thus, any number of
+  * threads may call it concurrently. The records of each chunk are stored separately and may be merged in their
+  * original order via mergedSimpleSeqPods once all chunks have been parsed.
+  */
+class FastaChunks
+{
+public:
+    FastaChunks(const char *begin, const char *end, qint64 targetChunkSize, const QAtomicInt *canceled)
+        : nextChunk_(0), kbParsed_(0), canceled_(canceled)
+    {
+        ASSERT(targetChunkSize > 0);
+
+        boundaries_ << begin;
+        const char *x = begin;
+        while (end - x > targetChunkSize)
+        {
+            const char *separator = findRecordSeparator(x + targetChunkSize - 1, end);
+            if (separator == nullptr)
+                break;
+
+            x = separator + 1;
+            boundaries_ << x;
+        }
+        boundaries_ << end;
+
+        simpleSeqPods_.resize(count());
+    }
+
+    int count() const
+    {
+        return boundaries_.size() - 1;
+    }
+
+    //! Returns the (approximate, rounded down to the nearest kilobyte per chunk) number of bytes parsed thus far
+    qint64 bytesParsed() const
+    {
+        return static_cast<qint64>(static_cast<int>(kbParsed_)) << 10;
+    }
+
+    //! Returns false if there are no more chunks to parse or parsing has been canceled; true otherwise
+    bool parseNextChunk()
+    {
+        int i = nextChunk_.fetchAndAddOrdered(1);
+        if (i >= count() || *canceled_)
+            return false;
+
+        // Other threads may be writing to other entries; access the data directly to avoid any detach checks
+        parseFastaRecords(boundaries_.at(i), boundaries_.at(i + 1), simpleSeqPods_.data()[i], canceled_);
+        kbParsed_.fetchAndAddOrdered(static_cast<int>((boundaries_.at(i + 1) - boundaries_.at(i)) >> 10));
+        return true;
+    }
+
+    QVector<SimpleSeqPod> mergedSimpleSeqPods() const
+    {
+        if (count() == 1)
+            return simpleSeqPods_.first();
+
+        int total = 0;
+        for (int i=0, z=count(); i<z; ++i)
+            total += simpleSeqPods_.at(i).size();
+
+        QVector<SimpleSeqPod> merged;
+        merged.reserve(total);
+        for (int i=0, z=count(); i<z; ++i)
+            merged += simpleSeqPods_.at(i);
+
+        return merged;
+    }
+
+private:
+    QVector<const char *> boundaries_;                  //!< Chunk i spans [boundaries_[i], boundaries_[i+1])
+    QVector<QVector<SimpleSeqPod> > simpleSeqPods_;     //!< Parsed records of each chunk
+    QAtomicInt nextChunk_;
+    QAtomicInt kbParsed_;
+    const QAtomicInt *canceled_;
+};
+
+/**
+  * Helper task that parses chunks until none remain and then releases semaphore.
+  */
+class FastaChunkTask : public QRunnable
+{
+public:
+    FastaChunkTask(FastaChunks *chunks, QSemaphore *semaphore)
+        : chunks_(chunks), semaphore_(semaphore)
+    {
+    }
+
+    void run()
+    {
+        while (chunks_->parseNextChunk())
+            ;
+
+        semaphore_->release();
+    }
+
+private:
+    FastaChunks *chunks_;
+    QSemaphore *semaphore_;
+};
+
 
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
@@ -24,7 +269,7 @@
 /**
   * @param parent [QObject *]
   */
-FastaParser::FastaParser(QObject *parent) : AbstractSequenceParser(parent)
+FastaParser::FastaParser(QObject *parent) : AbstractSequenceParser(parent), maxThreads_(0)
 {
 }
 
@@ -33,7 +278,9 @@ FastaParser::FastaParser(QObject *parent) : AbstractSequenceParser(parent)
   */
 FastaParser *FastaParser::clone() const
 {
-    return new FastaParser();
+    FastaParser *fastaParser = new FastaParser();
+    fastaParser->maxThreads_ = maxThreads_;
+    return fastaParser;
 }
 
 
@@ -70,6 +317,65 @@ bool FastaParser::isCompatibleString(const QString &chunk) const
     return false;
 }
 
+/**
+  * @returns int
+  */
+int FastaParser::maxThreads() const
+{
+    return maxThreads_;
+}
+
+/**
+  * Produces the same results as parsing the equivalent text with parseStream.
+  *
+  * @param data [const char *]
+  * @param size [qint64]
+  * @returns SequenceParseResultPod
+  */
+SequenceParseResultPod FastaParser::parseBytes(const char *data, qint64 size) const
+{
+    ASSERT(size >= 0);
+    ASSERT(data != nullptr || size == 0);
+
+    return SequenceParseResultPod(parseSimpleSeqPods(data, size));
+}
+
+/**
+  * @param fileName [const QString &]
+  * @returns SequenceParseResultPod
+  */
+SequenceParseResultPod FastaParser::parseFile(const QString &fileName) const
+{
+    QFile file;
+    openFile(fileName, file, QIODevice::ReadOnly);
+
+    const uchar *data = file.map(0, file.size());
+    if (data == nullptr)
+    {
+        file.close();
+        return AbstractSequenceParser::parseFile(fileName);
+    }
+
+    SequenceParseResultPod resultPod = parseBytes(reinterpret_cast<const char *>(data), file.size());
+    file.unmap(const_cast<uchar *>(data));
+
+    return resultPod;
+}
+
+
+/**
+  * Only applies to the byte-oriented parsing path (parseBytes and parseFile). A value of zero (the default) uses
+  * QThread::idealThreadCount() threads; a value of one always parses in the calling thread.
+  *
+  * @param maxThreads [int]
+  */
+void FastaParser::setMaxThreads(int maxThreads)
+{
+    ASSERT(maxThreads >= 0);
+    maxThreads_ = maxThreads;
+}
+
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Protected methods
@@ -179,10 +485,9 @@ QVector<SimpleSeqPod> FastaParser::parseSimpleSeqPods(QTextStream &textStream, i
         totalBytesRead += block.length();
         emit progressChanged(totalBytesRead, totalBytes);
 
-        // TODO: Implement a cancel exception
         // The following is only relevant for multi-threaded applications, and is set in AbstractSequenceParser
         if (canceled_)
-            throw "[FastaParser] Cancelled! Please implement a proper cancel exception";
+            throw CanceledError();
     } while (block.isNull() == false);
 
     // ---------------------------------------------------------------------
@@ -207,3 +512,57 @@ QVector<SimpleSeqPod> FastaParser::parseSimpleSeqPods(QTextStream &textStream, i
 
     return simpleSeqPods;
 }
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  * Byte-oriented equivalent of parseSimpleSeqPods(QTextStream &, int). Record boundaries (\n>) and header lines are
+  * located with memchr and each sequence is copied exactly once out of data.
+  *
+  * The records are divided into record-aligned chunks. Small inputs (or if maxThreads() is 1) are parsed chunk by
+  * chunk in the calling thread. Otherwise, helper tasks are started on the global QThreadPool and all threads - the
+  * calling thread included - claim and parse chunks until none remain. Because the calling thread participates, this
+  * never waits on pool threads that are unavailable. Each chunk's records are stored separately and concatenated in
+  * file order once all chunks have been parsed. Progress is only emitted from the calling thread and reflects the
+  * bytes parsed across all chunks.
+  *
+  * @param data [const char *]
+  * @param size [qint64]
+  * @returns QVector<SimpleSeqPod>
+  */
+QVector<SimpleSeqPod> FastaParser::parseSimpleSeqPods(const char *data, qint64 size) const
+{
+    const char *end = data + size;
+    const char *x = findFirstRecord(data, end);
+    if (x == end)
+        return QVector<SimpleSeqPod>();
+
+    qint64 headerBytes = x - data;
+    qint64 recordBytes = end - x;
+    int nThreads = (maxThreads_ > 0) ? maxThreads_ : QThread::idealThreadCount();
+    bool parallel = nThreads > 1 && recordBytes >= kMinimumParallelBytes;
+    qint64 chunkSize = (parallel) ? qMax(kMinimumParallelChunkSize, recordBytes / (nThreads * 8))
+                                  : kSerialChunkSize;
+
+    FastaChunks chunks(x, end, chunkSize, &canceled_);
+    int nHelpers = (parallel) ? qMin(nThreads - 1, chunks.count() - 1) : 0;
+    QSemaphore semaphore;
+    for (int i=0; i< nHelpers; ++i)
+        QThreadPool::globalInstance()->start(new FastaChunkTask(&chunks, &semaphore));
+
+    while (chunks.parseNextChunk())
+        emitByteProgress(headerBytes + chunks.bytesParsed(), size);
+
+    // Wait for the helpers to finish their last chunks
+    while (!semaphore.tryAcquire(nHelpers, kProgressIntervalMs))
+        emitByteProgress(headerBytes + chunks.bytesParsed(), size);
+
+    if (canceled_)
+        throw CanceledError();
+
+    emitByteProgress(size, size);
+
+    return chunks.mergedSimpleSeqPods();
+}
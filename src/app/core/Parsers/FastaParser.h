@@ -22,6 +22,16 @@
   * o Invalid sequence data (handled externally)
   *
   * Empty headers and/or sequences are not handled here
+  *
+  * In addition to the generic QTextStream interface, FastaParser provides a byte-oriented parsing path (parseBytes)
+  * which scans the raw file data directly for record boundaries. parseFile memory maps the file and uses this path,
+  * which avoids decoding the entire file into UTF-16 QStrings and builds each sequence directly from the mapped bytes.
+  * If the file cannot be mapped (e.g. a very large file on a 32-bit platform), parseFile falls back to the streaming
+  * text implementation.
+  *
+  * Large inputs are split into record-aligned chunks which are parsed concurrently on the global QThreadPool (see
+  * setMaxThreads). The calling thread (e.g. the thread of a SignalSequenceParser) parses chunks as well and emits the
+  * aggregate progress of all chunks. The resulting records are always in file order.
   */
 class FastaParser : public AbstractSequenceParser
 {
@@ -33,9 +43,19 @@ public:
     FastaParser *clone() const;
 
     bool isCompatibleString(const QString &chunk) const;
+    int maxThreads() const;                                                     //!< Returns the maximum number of threads used for byte-oriented parsing (0 = ideal thread count)
+    //! Parses the size bytes of FASTA data beginning at data
+    SequenceParseResultPod parseBytes(const char *data, qint64 size) const;
+    SequenceParseResultPod parseFile(const QString &fileName) const;
+    void setMaxThreads(int maxThreads);                                         //!< Sets the maximum number of threads used for byte-oriented parsing to maxThreads
 
 protected:
     QVector<SimpleSeqPod> parseSimpleSeqPods(QTextStream &textStream, int totalBytes) const;
+
+private:
+    QVector<SimpleSeqPod> parseSimpleSeqPods(const char *data, qint64 size) const;
+
+    int maxThreads_;
 };
 
 #endif // FASTAPARSER_H
@@ -7,6 +7,7 @@
 ****************************************************************************/
 
 #include "SignalSequenceParser.h"
+#include "../exceptions/CanceledError.h"
 #include "../macros.h"
 
 #include <QtDebug>
@@ -46,14 +47,21 @@ void SignalSequenceParser::parseFile(const QString &fileName)
     {
         emit parseSuccess(sequenceParser_->parseFile(fileName));
     }
+    catch (const CanceledError &)
+    {
+        emit parseCanceled();
+    }
     catch (const char *errorMessage)
     {
         emit parseError(errorMessage);
     }
+    catch (const QString &errorMessage)
+    {
+        emit parseError(errorMessage);
+    }
     catch (...)
     {
-        // TODO
-        emit parseCanceled();
+        emit parseError("An unknown error occurred while parsing the file");
     }
 
     emit parseOver();
@@ -6,7 +6,9 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QTemporaryFile>
 #include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
 
 #include "../ClustalParser.h"
 #include "../../PODs/SequenceParseResultPod.h"
@@ -27,8 +29,17 @@ private slots:
     void parseStream_data();
     void parseStream();
 
+    void parseBytes_withErrors_data();
+    void parseBytes_withErrors();
+
+    void parseBytes_data();
+    void parseBytes();
+
+    void parseFile();
+
     void benchNoRegex();
     void benchRegex();
+    void benchParseFile();
 };
 
 typedef QVector<SimpleSeqPod> SimpleSeqPodVector;
@@ -478,6 +489,102 @@ void TestClustalParser::parseStream()
     }
 }
 
+void TestClustalParser::parseBytes_withErrors_data()
+{
+    parseStream_withErrors_data();
+}
+
+void TestClustalParser::parseBytes_withErrors()
+{
+    QFETCH(QString, input);
+
+    QByteArray bytes = input.toLocal8Bit();
+
+    ClustalParser cp;
+    try
+    {
+        SequenceParseResultPod resultPod = cp.parseBytes(bytes.constData(), bytes.size());
+        QVERIFY(0);
+    }
+    catch (...)
+    {
+        QVERIFY(1);
+    }
+}
+
+void TestClustalParser::parseBytes_data()
+{
+    parseStream_data();
+}
+
+void TestClustalParser::parseBytes()
+{
+    QFETCH(QString, input);
+    QFETCH(SimpleSeqPodVector, simpleSeqPods);
+
+    QByteArray bytes = input.toLocal8Bit();
+
+    ClustalParser cp;
+    try
+    {
+        SequenceParseResultPod resultPod = cp.parseBytes(bytes.constData(), bytes.size());
+        QCOMPARE(resultPod.grammar_, eUnknownGrammar);
+        QCOMPARE(resultPod.isAlignment_, eTrue);
+        QCOMPARE(resultPod.simpleSeqPods_, simpleSeqPods);
+    }
+    catch (...)
+    {
+        QVERIFY(0);
+    }
+}
+
+void TestClustalParser::parseFile()
+{
+    ClustalParser cp;
+
+    // Test: Windows line endings are not translated when the file is memory mapped
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    file.write("\r\nCLUSTAL W(1.83) - multiple sequence alignment\r\n\r\n"
+               "1   ABC 3\r\n"
+               "2   A-C 3\r\n"
+               "    * *\r\n"
+               "\r\n"
+               "1   DEF 6\r\n"
+               "2   -E- 5\r\n");
+    file.close();
+
+    QSignalSpy spyProgress(&cp, SIGNAL(progressChanged(int,int)));
+    SequenceParseResultPod resultPod = cp.parseFile(file.fileName());
+    QCOMPARE(resultPod.isAlignment_, eTrue);
+    QCOMPARE(resultPod.simpleSeqPods_, SimpleSeqPodVector() << SimpleSeqPod("1", "ABCDEF") << SimpleSeqPod("2", "A-C-E-"));
+
+    // Test: final progress indicates all bytes have been processed
+    QVERIFY(spyProgress.count() > 0);
+    QCOMPARE(spyProgress.last().at(0).toInt(), static_cast<int>(file.size()));
+    QCOMPARE(spyProgress.last().at(1).toInt(), static_cast<int>(file.size()));
+
+    // Test: the byte-oriented and streaming text implementations produce identical results
+    QString fileName = "files/1_tarhs.aln";
+    QFile textFile(fileName);
+    QVERIFY(textFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    QTextStream textStream(&textFile);
+    SequenceParseResultPod textPod = cp.parseStream(textStream, textFile.size());
+    textFile.close();
+
+    resultPod = cp.parseFile(fileName);
+    QVERIFY(resultPod.simpleSeqPods_.size() > 2);
+    QCOMPARE(resultPod.simpleSeqPods_, textPod.simpleSeqPods_);
+
+    // Test: non-existent file
+    try
+    {
+        cp.parseFile("this-file-does-not-exist.aln");
+        QVERIFY(0);
+    }
+    catch (const QString &) {}
+}
+
 void TestClustalParser::benchNoRegex()
 {
     QString filename = "files/1_tarhs.aln";
@@ -510,5 +617,15 @@ void TestClustalParser::benchRegex()
     }
 }
 
+void TestClustalParser::benchParseFile()
+{
+    QString filename = "files/1_tarhs.aln";
+    ClustalParser parser;
+
+    QBENCHMARK {
+        parser.parseFile(filename);
+    }
+}
+
 QTEST_APPLESS_MAIN(TestClustalParser)
 #include "TestClustalParser.moc"
@@ -6,10 +6,13 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QTemporaryFile>
 #include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
 
 #include "../FastaParser.h"
 #include "../../PODs/SequenceParseResultPod.h"
+#include "../../exceptions/CanceledError.h"
 
 class TestFastaParser : public QObject
 {
@@ -19,6 +22,12 @@ private slots:
     void isCompatibleString();
     void parseStream_data();
     void parseStream();
+    void parseBytes_data();
+    void parseBytes();
+    void parseFile();
+    void parseBytesParallel();
+    void cancel();
+    void setMaxThreads();
 };
 
 typedef QVector<SimpleSeqPod> SimpleSeqPodVector;
@@ -118,6 +127,171 @@ void TestFastaParser::parseStream()
     }
 }
 
+void TestFastaParser::parseBytes_data()
+{
+    parseStream_data();
+}
+
+void TestFastaParser::parseBytes()
+{
+    QFETCH(QString, sample);
+    QFETCH(TriBool, isParseSuccessful);
+    QFETCH(SimpleSeqPodVector, simpleSeqPods);
+
+    QByteArray bytes = sample.toLocal8Bit();
+
+    FastaParser fp;
+    SequenceParseResultPod resultPod;
+
+    try
+    {
+        resultPod = fp.parseBytes(bytes.constData(), bytes.size());
+        QCOMPARE(isParseSuccessful, eTrue);
+        QCOMPARE(resultPod.grammar_, eUnknownGrammar);
+        QCOMPARE(resultPod.isAlignment_, eUnknown);
+        QCOMPARE(resultPod.simpleSeqPods_, simpleSeqPods);
+    }
+    catch(...)
+    {
+        QCOMPARE(isParseSuccessful, eFalse);
+    }
+}
+
+void TestFastaParser::parseFile()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    // Windows line endings are not translated when the file is memory mapped
+    file.write("\r\n>Header\r\nABC\r\nDEF\r\n>Header2  \r\nGHI");
+    file.close();
+
+    FastaParser fp;
+    QSignalSpy spyProgress(&fp, SIGNAL(progressChanged(int,int)));
+    SequenceParseResultPod resultPod = fp.parseFile(file.fileName());
+    QCOMPARE(resultPod.simpleSeqPods_, SimpleSeqPodVector() << SimpleSeqPod("Header", "ABCDEF") << SimpleSeqPod("Header2", "GHI"));
+
+    // Test: final progress indicates all bytes have been processed
+    QVERIFY(spyProgress.count() > 0);
+    QCOMPARE(spyProgress.last().at(0).toInt(), static_cast<int>(file.size()));
+    QCOMPARE(spyProgress.last().at(1).toInt(), static_cast<int>(file.size()));
+
+    // Test: large file spanning many progress intervals
+    QTemporaryFile file2;
+    QVERIFY(file2.open());
+    SimpleSeqPodVector expectedPods;
+    for (int i=0; i< 2000; ++i)
+    {
+        QByteArray header = "Sequence " + QByteArray::number(i);
+        file2.write(">" + header + "\n" + "ACGTACGTAC\nGTACGT\n");
+        expectedPods << SimpleSeqPod(QString(header), "ACGTACGTACGTACGT");
+    }
+    file2.close();
+
+    spyProgress.clear();
+    resultPod = fp.parseFile(file2.fileName());
+    QCOMPARE(resultPod.simpleSeqPods_, expectedPods);
+    QVERIFY(spyProgress.count() > 1);
+
+    // Test: non-existent file
+    try
+    {
+        fp.parseFile("this-file-does-not-exist.fa");
+        QVERIFY(0);
+    }
+    catch (const QString &) {}
+}
+
+void TestFastaParser::parseBytesParallel()
+{
+    // Setup: build enough data (> 4 MB) to be split into multiple chunks
+    QByteArray data = "\n  \n";
+    SimpleSeqPodVector expectedPods;
+    for (int i=0; data.size() < 6 * 1024 * 1024; ++i)
+    {
+        QByteArray header = "Sequence " + QByteArray::number(i);
+        QByteArray sequence;
+        for (int j=0, z=i % 200; j<z; ++j)
+            sequence += "ACGT"[(i + j) % 4];
+
+        data += ">" + header + "\r\n";
+        for (int j=0; j< sequence.size(); j += 60)
+            data += sequence.mid(j, 60) + "\n";
+        expectedPods << SimpleSeqPod(QString(header), BioString(sequence));
+    }
+
+    FastaParser fp;
+    fp.setMaxThreads(1);
+    QSignalSpy spyProgress(&fp, SIGNAL(progressChanged(int,int)));
+    SequenceParseResultPod serialPod = fp.parseBytes(data.constData(), data.size());
+    QCOMPARE(serialPod.simpleSeqPods_, expectedPods);
+    QVERIFY(spyProgress.count() > 1);
+    QCOMPARE(spyProgress.last().at(0).toInt(), data.size());
+
+    for (int nThreads=2; nThreads<= 8; nThreads *= 2)
+    {
+        fp.setMaxThreads(nThreads);
+        spyProgress.clear();
+        SequenceParseResultPod parallelPod = fp.parseBytes(data.constData(), data.size());
+        QCOMPARE(parallelPod.simpleSeqPods_, expectedPods);
+
+        // Test: progress should never decrease and should finish with all bytes parsed
+        QVERIFY(spyProgress.count() > 0);
+        int lastProgress = 0;
+        for (int i=0; i< spyProgress.count(); ++i)
+        {
+            QVERIFY(spyProgress.at(i).at(0).toInt() >= lastProgress);
+            lastProgress = spyProgress.at(i).at(0).toInt();
+            QCOMPARE(spyProgress.at(i).at(1).toInt(), data.size());
+        }
+        QCOMPARE(lastProgress, data.size());
+    }
+
+    // Test: junk before the first record is still rejected
+    data.prepend("junk");
+    try
+    {
+        fp.parseBytes(data.constData(), data.size());
+        QVERIFY(0);
+    }
+    catch (const char *) {}
+}
+
+void TestFastaParser::cancel()
+{
+    QByteArray data = ">Sequence\nACGT\n";
+
+    FastaParser fp;
+    fp.cancel();
+
+    // Test: both parsing paths throw a CanceledError once canceled
+    try
+    {
+        fp.parseBytes(data.constData(), data.size());
+        QVERIFY(0);
+    }
+    catch (const CanceledError &) {}
+
+    try
+    {
+        fp.parseString(QString(data));
+        QVERIFY(0);
+    }
+    catch (const CanceledError &) {}
+}
+
+void TestFastaParser::setMaxThreads()
+{
+    FastaParser fp;
+    QCOMPARE(fp.maxThreads(), 0);
+
+    fp.setMaxThreads(3);
+    QCOMPARE(fp.maxThreads(), 3);
+
+    // Test: clones share the same thread setting
+    QScopedPointer<FastaParser> clone(fp.clone());
+    QCOMPARE(clone->maxThreads(), 3);
+}
+
 
 QTEST_APPLESS_MAIN(TestFastaParser)
 #include "TestFastaParser.moc"
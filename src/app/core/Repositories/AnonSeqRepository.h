@@ -66,7 +66,9 @@ public:
         {
             // Since we are finding by an alternative to the id, it is necessary to increase the reference count, which
             // would not otherwise be done.
-            return seqIdentityMap_.value(digest);
+            const typename T::SPtr &anonSeq = seqIdentityMap_.value(digest);
+            this->touch(anonSeq->id());
+            return anonSeq;
         }
 
         // Normally, we would use the protected entityMapper_ instance; however, because of virtual inheritance, this
@@ -78,6 +80,8 @@ public:
         // inconvenience, we utilize a local pointer of the proper type obtained upon construction.
         typename T::SPtr anonSeq(anonSeqMapper_->findOneByDigest(digest));
         this->add(anonSeq, true);  // Ignore null pointers
+        if (anonSeq)
+            this->touch(anonSeq->id());
         return anonSeq;
     }
 
@@ -109,6 +113,27 @@ public:
         return true;
     }
 
+protected:
+    virtual void evict(const QVector<typename T::SPtr> &anonSeqs)
+    {
+        foreach (const typename T::SPtr &anonSeq, anonSeqs)
+            if (seqIdentityMap_.value(anonSeq->seq_.digest()) == anonSeq)
+                seqIdentityMap_.remove(anonSeq->seq_.digest());
+
+        GenericRepository<T>::evict(anonSeqs);
+    }
+
+    // Entities added via this class are also referenced by the seqIdentityMap_
+    virtual long repositoryUseCount(const typename T::SPtr &anonSeq) const
+    {
+        // Note: constFind is used to avoid copying the pointer, which would increase its use count
+        typename QHash<QByteArray, typename T::SPtr>::ConstIterator it = seqIdentityMap_.constFind(anonSeq->seq_.digest());
+        if (it != seqIdentityMap_.constEnd() && it.value() == anonSeq)
+            return 2;
+
+        return 1;
+    }
+
 private:
     IAnonSeqMapper<T> *anonSeqMapper_;          // Should be equivalent to the protected entityMapper_ instance,
                                                 // but keeping a copy for ourselves avoids the need to make a dynamic
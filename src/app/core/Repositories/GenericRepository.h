@@ -9,7 +9,9 @@
 #ifndef GENERICREPOSITORY_H
 #define GENERICREPOSITORY_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QHash>
+#include <QtCore/QLinkedList>
 #include <QtCore/QSet>
 #include <QtCore/QVector>
 
@@ -23,6 +25,13 @@
 typedef QPair<int, int> IntPair;
 
 /**
+  * GenericRepository loads entities on demand from its entity mapper and caches them by id.
+  *
+  * By default, all entities that have been found remain cached until the repository is destroyed. If a cache limit is
+  * set, the least recently found entities are evicted whenever the number of cached entities exceeds this limit.
+  * Only those entities that may be transparently reloaded from the entity mapper are eligible for eviction; namely,
+  * those that are not new, not dirty, not erased, and not referenced outside of the repository. Thus, the cache limit
+  * is a soft limit that is exceeded if there are not enough eligible entities.
   */
 template<typename T>
 class GenericRepository : public virtual MemoryOnlyRepository<T>
@@ -38,10 +47,21 @@ public:
     // Public methods
     virtual IEntityMapper<T> *entityMapper() const;
 
+    int cacheLimit() const;                             //!< Returns the maximum number of entities to cache
+    //! Sets the maximum number of entities to cache to cacheLimit (0 = unlimited) and evicts any excess entities
+    void setCacheLimit(int cacheLimit);
+    qint64 cacheHits() const;                           //!< Returns the number of ids found in the cache
+    qint64 cacheMisses() const;                         //!< Returns the number of ids fetched from the entity mapper
+    qint64 cacheEvictions() const;                      //!< Returns the number of entities evicted from the cache
+    void resetCacheCounters();                          //!< Resets the hit, miss, and eviction counters to zero
+
     // Duplicate ids are permitted; however, the reference count will be incremented accordingly (3 of the same id will
     // increase the reference count 3x).
     typename T::SPtr find(const int id);
     QVector<typename T::SPtr> find(const QVector<int> &ids);
+    //! Asynchronously reads ahead those entities with ids that are neither cached nor erased
+    QFuture<void> prefetch(const QVector<int> &ids);
+    virtual void removeCruft();
 
     bool save(const QVector<int> &ids);
     virtual bool save(const QVector<typename T::SPtr> &entities);
@@ -49,11 +69,31 @@ public:
 
 
 protected:
+    //! Removes entities from the cache; reimplement to release any additional references held by the repository
+    virtual void evict(const QVector<typename T::SPtr> &entities);
+    //! Returns the number of references to the cached entity that are held by this repository
+    virtual long repositoryUseCount(const typename T::SPtr &entity) const;
+    void touch(int id);                                 //!< Marks the entity with id as the most recently used
+
     IEntityMapper<T> *entityMapper_;
 
 
 private:
+    bool isEvictable(const typename T::SPtr &entity) const;
+    void evictLeastRecentlyUsed();
+    void removeFromRecentlyUsed(int id);                //!< Forgets the recently used position of id (if any)
     QVector<typename T::SPtr> toSmartPointers(const QVector<T *> &rawEntities);
+
+    int cacheLimit_;
+    qint64 cacheHits_;
+    qint64 cacheMisses_;
+    qint64 cacheEvictions_;
+    QLinkedList<int> recentlyUsedIds_;                  //!< Cached entity ids ordered from least to most recently used
+    QHash<int, QLinkedList<int>::iterator> recentlyUsedPositions_;     //!< {entity id => position in recentlyUsedIds_}
+
+#ifdef TESTING
+    friend class TestAnonSeqRepository;
+#endif
 };
 
 
@@ -67,7 +107,11 @@ template<typename T>
 inline
 GenericRepository<T>::GenericRepository(IEntityMapper<T> *entityMapper)
     : MemoryOnlyRepository<T>(),
-      entityMapper_(entityMapper)
+      entityMapper_(entityMapper),
+      cacheLimit_(0),
+      cacheHits_(0),
+      cacheMisses_(0),
+      cacheEvictions_(0)
 {
     ASSERT(entityMapper_ !=  nullptr);
 }
@@ -100,6 +144,69 @@ IEntityMapper<T> *GenericRepository<T>::entityMapper() const
     return entityMapper_;
 }
 
+/**
+  * @returns int
+  */
+template<typename T>
+inline
+int GenericRepository<T>::cacheLimit() const
+{
+    return cacheLimit_;
+}
+
+/**
+  * @param cacheLimit [int]
+  */
+template<typename T>
+inline
+void GenericRepository<T>::setCacheLimit(int cacheLimit)
+{
+    ASSERT(cacheLimit >= 0);
+    cacheLimit_ = cacheLimit;
+    evictLeastRecentlyUsed();
+}
+
+/**
+  * @returns qint64
+  */
+template<typename T>
+inline
+qint64 GenericRepository<T>::cacheHits() const
+{
+    return cacheHits_;
+}
+
+/**
+  * @returns qint64
+  */
+template<typename T>
+inline
+qint64 GenericRepository<T>::cacheMisses() const
+{
+    return cacheMisses_;
+}
+
+/**
+  * @returns qint64
+  */
+template<typename T>
+inline
+qint64 GenericRepository<T>::cacheEvictions() const
+{
+    return cacheEvictions_;
+}
+
+/**
+  */
+template<typename T>
+inline
+void GenericRepository<T>::resetCacheCounters()
+{
+    cacheHits_ = 0;
+    cacheMisses_ = 0;
+    cacheEvictions_ = 0;
+}
+
 /**
   * @param id [const int]
   * @returns T::SPtr
@@ -114,6 +221,9 @@ typename T::SPtr GenericRepository<T>::find(const int id)
 }
 
 /**
+  * Eviction is deferred until all requested entities have been found; because the returned vector references each of
+  * these entities, none of them will be evicted.
+  *
   * @param ids [const QVector<int> &]
   * @returns QVector<T *>
   */
@@ -140,12 +250,15 @@ QVector<typename T::SPtr> GenericRepository<T>::find(const QVector<int> &ids)
         if (this->identityHash_.contains(id))
         {
             entities[i] = this->identityHash_.value(id);
+            touch(id);
+            ++cacheHits_;
             continue;
         }
 
         // Object with this id not in local cache, add to list of ids to request from the data mapper
         idsNotInRepo << id;
         indicesOfIdsNotInRepo << i;
+        ++cacheMisses_;
     }
 
     // There are some ids not present in the repository, fetch them in bulk from the data mapper
@@ -159,12 +272,49 @@ QVector<typename T::SPtr> GenericRepository<T>::find(const QVector<int> &ids)
             int entityId = ids.at(indicesOfIdsNotInRepo.at(i));
             ASSERT(this->identityHash_.value(entityId) != nullptr);
             entities[indicesOfIdsNotInRepo.at(i)] = this->identityHash_.value(entityId);
+            touch(entityId);
         }
+
+        evictLeastRecentlyUsed();
     }
 
     return entities;
 }
 
+/**
+  * Entities are not constructed until they are found; thus, the cache is unaffected by prefetching.
+  *
+  * @param ids [const QVector<int> &]
+  * @returns QFuture<void>
+  */
+template<typename T>
+inline
+QFuture<void> GenericRepository<T>::prefetch(const QVector<int> &ids)
+{
+    QSet<int> idsNotInRepo;
+    foreach (const int id, ids)
+        if (!this->softErasedIds_.contains(id) && !this->identityHash_.contains(id))
+            idsNotInRepo << id;
+
+    if (idsNotInRepo.isEmpty())
+        return QFuture<void>();
+
+    return entityMapper_->prefetch(idsNotInRepo.toList().toVector());
+}
+
+/**
+  * Soft erased entities are no longer cached and thus are also removed from the recently used list.
+  */
+template<typename T>
+inline
+void GenericRepository<T>::removeCruft()
+{
+    foreach (const int id, this->softErasedIds_)
+        removeFromRecentlyUsed(id);
+
+    MemoryOnlyRepository<T>::removeCruft();
+}
+
 /**
   * No attempt is made to call the save(T::SPtr) method because it will incur additional overhead creating a vector copy
   * of pointers.
@@ -200,11 +350,14 @@ bool GenericRepository<T>::save(const QVector<int> &ids)
     if (!entityMapper_->save(entitiesToSave))
         return false;
 
-    // Save was successful, update the identityHash with the correct ids for newly inserted entities
+    // Save was successful, update the identityHash with the correct ids for newly inserted entities. Now that these
+    // may be reloaded from the entity mapper, they are also eligible for eviction.
     foreach (int oldId, transientIds)
     {
         typename T::SPtr entity = this->identityHash_.take(oldId);
+        removeFromRecentlyUsed(oldId);
         this->identityHash_.insert(entity->id(), entity);
+        touch(entity->id());
     }
 
     return true;
@@ -242,11 +395,14 @@ bool GenericRepository<T>::save(const QVector<typename T::SPtr> &entities)
     if (!entityMapper_->save(entitiesToSave))
         return false;
 
-    // Save was successful, update the identityHash with the correct ids for newly inserted entities
+    // Save was successful, update the identityHash with the correct ids for newly inserted entities. Now that these
+    // may be reloaded from the entity mapper, they are also eligible for eviction.
     foreach (int oldId, transientIds)
     {
         typename T::SPtr entity = this->identityHash_.take(oldId);
+        removeFromRecentlyUsed(oldId);
         this->identityHash_.insert(entity->id(), entity);
+        touch(entity->id());
     }
 
     return true;
@@ -287,15 +443,122 @@ bool GenericRepository<T>::saveAll()
         entityMapper_->erase(temp);
     }
 
-    MemoryOnlyRepository<T>::removeCruft();
+    removeCruft();
 
     return true;
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Protected methods
+/**
+  * @param entities [const QVector<typename T::SPtr> &]
+  */
+template<typename T>
+inline
+void GenericRepository<T>::evict(const QVector<typename T::SPtr> &entities)
+{
+    QVector<T *> rawEntities;
+    rawEntities.reserve(entities.size());
+    foreach (const typename T::SPtr &entity, entities)
+    {
+        this->identityHash_.remove(entity->id());
+        removeFromRecentlyUsed(entity->id());
+        rawEntities << entity.get();
+    }
+
+    entityMapper_->teardown(rawEntities);
+}
+
+/**
+  * @param entity [const typename T::SPtr &]
+  * @returns long
+  */
+template<typename T>
+inline
+long GenericRepository<T>::repositoryUseCount(const typename T::SPtr & /* entity */) const
+{
+    return 1;
+}
+
+/**
+  * @param id [int]
+  */
+template<typename T>
+inline
+void GenericRepository<T>::touch(int id)
+{
+    if (recentlyUsedPositions_.contains(id))
+        recentlyUsedIds_.erase(recentlyUsedPositions_.value(id));
+
+    recentlyUsedPositions_.insert(id, recentlyUsedIds_.insert(recentlyUsedIds_.end(), id));
+}
+
+
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 // Private methods
+/**
+  * @param entity [const typename T::SPtr &]
+  * @returns bool
+  */
+template<typename T>
+inline
+bool GenericRepository<T>::isEvictable(const typename T::SPtr &entity) const
+{
+    return !entity->isNew() &&
+           !entity->isDirty() &&
+           !this->softErasedIds_.contains(entity->id()) &&
+           entity.use_count() == repositoryUseCount(entity);
+}
+
+/**
+  * Ids are removed from the recently used list whenever their entities leave the cache via evict, removeCruft, or
+  * save; thus, the list does not grow beyond the number of cached entities.
+  */
+template<typename T>
+inline
+void GenericRepository<T>::evictLeastRecentlyUsed()
+{
+    if (cacheLimit_ == 0 || this->identityHash_.size() <= cacheLimit_)
+        return;
+
+    int nToEvict = this->identityHash_.size() - cacheLimit_;
+    QVector<typename T::SPtr> entitiesToEvict;
+    foreach (const int id, recentlyUsedIds_)
+    {
+        if (entitiesToEvict.size() == nToEvict)
+            break;
+
+        // Test before copying the pointer, which increases its use count
+        typename QHash<int, typename T::SPtr>::ConstIterator entityIt = this->identityHash_.constFind(id);
+        if (entityIt != this->identityHash_.constEnd() && isEvictable(entityIt.value()))
+            entitiesToEvict << entityIt.value();
+    }
+
+    if (entitiesToEvict.isEmpty())
+        return;
+
+    evict(entitiesToEvict);
+    cacheEvictions_ += entitiesToEvict.size();
+}
+
+/**
+  * @param id [int]
+  */
+template<typename T>
+inline
+void GenericRepository<T>::removeFromRecentlyUsed(int id)
+{
+    QHash<int, QLinkedList<int>::iterator>::Iterator it = recentlyUsedPositions_.find(id);
+    if (it == recentlyUsedPositions_.end())
+        return;
+
+    recentlyUsedIds_.erase(it.value());
+    recentlyUsedPositions_.erase(it);
+}
+
 /**
   * @param rawEntities [const QVector<T *> &]
   * @param ignoreNull [bool]
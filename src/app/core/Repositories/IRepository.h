@@ -9,6 +9,7 @@
 #ifndef IREPOSITORY_H
 #define IREPOSITORY_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QVector>
 
 #include "../Entities/IEntity.h"
@@ -37,6 +38,8 @@ public:
     {
         return vFind(ids);
     }
+    // Hint that the entities with ids will soon be found; returns a future that finishes once they have been read ahead
+    virtual QFuture<void> prefetch(const QVector<int> &ids) = 0;
     virtual bool saveAll() = 0;
     virtual bool save(const int id) = 0;
     virtual bool save(const QVector<int> &ids) = 0;
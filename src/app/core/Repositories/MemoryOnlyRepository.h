@@ -9,6 +9,7 @@
 #ifndef MEMORYONLYREPOSITORY_H
 #define MEMORYONLYREPOSITORY_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QHash>
 #include <QtCore/QSet>
 #include <QtCore/QVector>
@@ -115,6 +116,9 @@ public:
     // Duplicate ids are permitted
     virtual QVector<typename T::SPtr> find(const QVector<int> &ids);
 
+    // All entities are already in memory; therefore, there is nothing to prefetch
+    virtual QFuture<void> prefetch(const QVector<int> &ids);
+
     virtual void removeCruft();
 
     bool unerase(const int id);
@@ -421,6 +425,17 @@ QVector<typename T::SPtr> MemoryOnlyRepository<T>::find(const QVector<int> &ids)
     return found;
 }
 
+/**
+  * @param ids [const QVector<int> &]
+  * @returns QFuture<void>
+  */
+template<typename T>
+inline
+QFuture<void> MemoryOnlyRepository<T>::prefetch(const QVector<int> & /* ids */)
+{
+    return QFuture<void>();
+}
+
 /**
   * Persist release of the soft erased entries.
   */
@@ -10,9 +10,109 @@
 
 #include "../AnonSeqRepository.h"
 #include "../../DataMappers/AnonSeqMapper.h"
+#include "../../DataMappers/IAnonSeqMapper.h"
 #include "../../DataSources/SqliteAdocSource.h"
 #include "../../Entities/Astring.h"
 
+/**
+  * MockAstringMapper builds Astrings from an in-memory set of sequences and counts how often it is asked to do so,
+  * which reveals whether the repository served an entity from its cache.
+  */
+class MockAstringMapper : public IAnonSeqMapper<Astring>
+{
+public:
+    MockAstringMapper() : nFound_(0), nDigestLookups_(0), nextId_(1)
+    {
+    }
+
+    int addSeq(const QByteArray &residues)
+    {
+        int id = nextId_++;
+        residues_.insert(id, residues);
+        return id;
+    }
+
+    virtual IAdocSource *adocSource() const                             {   return nullptr;     }
+    virtual bool erase(const int /* id */) const                        {   return true;        }
+    virtual bool erase(const QVector<int> & /* ids */) const            {   return true;        }
+    virtual bool erase(Astring * /* astring */) const                   {   return true;        }
+    virtual bool erase(const QVector<Astring *> & /* astrings */) const {   return true;        }
+
+    virtual Astring *find(const int id) const
+    {
+        ++nFound_;
+        if (!residues_.contains(id))
+            return nullptr;
+
+        return new Astring(id, Seq(residues_.value(id), eAminoGrammar));
+    }
+
+    virtual QVector<Astring *> find(const QVector<int> &ids) const
+    {
+        QVector<Astring *> astrings;
+        foreach (const int id, ids)
+            astrings << find(id);
+        return astrings;
+    }
+
+    virtual Astring *findOneByDigest(const QByteArray &digest) const
+    {
+        ++nDigestLookups_;
+        QHash<int, QByteArray>::ConstIterator it = residues_.constBegin();
+        for (; it != residues_.constEnd(); ++it)
+            if (Seq(it.value(), eAminoGrammar).digest() == digest)
+                return new Astring(it.key(), Seq(it.value(), eAminoGrammar));
+
+        return nullptr;
+    }
+
+    virtual QVector<Astring *> findByDigests(const QVector<QByteArray> &digests) const
+    {
+        QVector<Astring *> astrings;
+        foreach (const QByteArray &digest, digests)
+            astrings << findOneByDigest(digest);
+        return astrings;
+    }
+
+    virtual QFuture<void> prefetch(const QVector<int> & /* ids */) const
+    {
+        return QFuture<void>();
+    }
+
+    virtual void readAhead(IAdocSource * /* adocSource */, const QVector<int> & /* ids */, int /* generation */) const
+    {
+    }
+
+    virtual bool save(Astring *astring) const
+    {
+        return save(QVector<Astring *>() << astring);
+    }
+
+    virtual bool save(const QVector<Astring *> &astrings) const
+    {
+        foreach (Astring *astring, astrings)
+        {
+            if (astring->isNew())
+            {
+                astring->setId(nextId_++);
+                residues_.insert(astring->id(), astring->seq_.asByteArray());
+            }
+            astring->setClean();
+        }
+        return true;
+    }
+
+    virtual void teardown(Astring * /* astring */) const                        {}
+    virtual void teardown(const QVector<Astring *> & /* astrings */) const      {}
+
+    mutable int nFound_;            //!< Number of entities constructed by find
+    mutable int nDigestLookups_;    //!< Number of calls to findOneByDigest
+
+private:
+    mutable int nextId_;
+    mutable QHash<int, QByteArray> residues_;
+};
+
 class TestAnonSeqRepository : public QObject
 {
     Q_OBJECT
@@ -20,6 +120,11 @@ class TestAnonSeqRepository : public QObject
 private slots:
     void construction();
     void findBySeq();
+    void evictLeastRecentlyUsed();
+    void nonEvictableEntities();
+    void evictFromDigestMap();
+    void findAfterEviction();
+    void recentlyUsedIdsFollowCache();
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -28,14 +133,14 @@ private slots:
 void TestAnonSeqRepository::construction()
 {
     SqliteAdocSource source;
-    AnonSeqMapper<Astring> astringMapper(&source);
+    AnonSeqMapper<Astring, AstringPod> astringMapper(&source);
     AnonSeqRepository<Astring> repo(&astringMapper);
 }
 
 void TestAnonSeqRepository::findBySeq()
 {
     SqliteAdocSource source;
-    AnonSeqMapper<Astring> astringMapper(&source);
+    AnonSeqMapper<Astring, AstringPod> astringMapper(&source);
 
     QFile::remove("test.db");
     QVERIFY(source.createAndOpen("test.db"));
@@ -43,28 +148,230 @@ void TestAnonSeqRepository::findBySeq()
     // Test: insertion and save through the repository
     Seq seq1("ABCDEF", eAminoGrammar);
     {
-        Astring *astring = new Astring(::newEntityId<Astring>(), seq1);
+        AstringSPtr astring(new Astring(::newEntityId<Astring>(), seq1));
         astring->addCoil(Coil(ClosedIntRange(1, 4)));
         AnonSeqRepository<Astring> repo(&astringMapper);
-        QVERIFY(repo.addOne(astring, false));
+        QVERIFY(repo.add(astring, false));
         repo.saveAll();
-
-        astring = nullptr;  // Repo takes care of deleting pointer
     }
 
     // Test: fetch sequence not already loaded in the repository
     {
         AnonSeqRepository<Astring> repo(&astringMapper);
-        Astring *inserted = repo.findBySeq(seq1);
-        QVERIFY(inserted != nullptr);
+        AstringSPtr inserted = repo.findBySeq(seq1);
+        QVERIFY(inserted);
         QCOMPARE(inserted->seq_, seq1);
         QCOMPARE(inserted->coils().size(), 1);
         QCOMPARE(inserted->coils().at(0), Coil(ClosedIntRange(1, 4)));
-        inserted = nullptr;
     }
 
     QFile::remove("test.db");
 }
 
+void TestAnonSeqRepository::evictLeastRecentlyUsed()
+{
+    MockAstringMapper mapper;
+    int id1 = mapper.addSeq("ACDEF");
+    int id2 = mapper.addSeq("GHIKL");
+    int id3 = mapper.addSeq("MNPQR");
+    int id4 = mapper.addSeq("STVWY");
+
+    AnonSeqRepository<Astring> repo(&mapper);
+    repo.setCacheLimit(3);
+
+    // Test: entities are evicted in the order they were last found
+    repo.find(id1);
+    repo.find(id2);
+    repo.find(id3);
+    repo.find(id1);
+    QCOMPARE(repo.cacheEvictions(), qint64(0));
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << id2 << id3 << id1);
+
+    repo.find(id4);
+    QCOMPARE(repo.cacheEvictions(), qint64(1));
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << id3 << id1 << id4);
+    QVERIFY(repo.identityHash_.contains(id2) == false);
+
+    // Test: a cached entity is a hit, an evicted entity must be fetched again
+    repo.resetCacheCounters();
+    int nFound = mapper.nFound_;
+    repo.find(id3);
+    QCOMPARE(repo.cacheHits(), qint64(1));
+    QCOMPARE(mapper.nFound_, nFound);
+
+    repo.find(id2);
+    QCOMPARE(repo.cacheMisses(), qint64(1));
+    QCOMPARE(mapper.nFound_, nFound + 1);
+    QCOMPARE(repo.cacheEvictions(), qint64(1));
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << id4 << id3 << id2);
+
+    // Test: lowering the limit evicts the excess entities immediately
+    repo.setCacheLimit(1);
+    QCOMPARE(repo.cacheEvictions(), qint64(3));
+    QCOMPARE(repo.identityHash_.size(), 1);
+    QVERIFY(repo.identityHash_.contains(id2));
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << id2);
+}
+
+void TestAnonSeqRepository::nonEvictableEntities()
+{
+    MockAstringMapper mapper;
+    int id1 = mapper.addSeq("ACDEF");
+    int id2 = mapper.addSeq("GHIKL");
+    int id3 = mapper.addSeq("MNPQR");
+    int id4 = mapper.addSeq("STVWY");
+    int id5 = mapper.addSeq("ACDEG");
+
+    AnonSeqRepository<Astring> repo(&mapper);
+    repo.setCacheLimit(1);
+
+    // Dirty
+    repo.find(id1)->setDirty(Ag::eCoreDataFlag, true);
+
+    // Referenced outside of the repository
+    AstringSPtr astring2 = repo.find(id2);
+
+    // Soft erased
+    QVERIFY(repo.erase(QVector<AstringSPtr>() << repo.find(id3)));
+
+    // New
+    AstringSPtr newAstring(Astring::createEntity(Seq("FGHIK", eAminoGrammar)));
+    int newId = newAstring->id();
+    QVERIFY(repo.add(newAstring, false));
+    newAstring.reset();
+
+    QCOMPARE(repo.cacheEvictions(), qint64(0));
+
+    // Test: only the entity that may be reloaded is evicted; the limit is exceeded rather than evicting the others
+    repo.find(id4);
+    repo.find(id5);
+    QCOMPARE(repo.cacheEvictions(), qint64(1));
+    QVERIFY(repo.identityHash_.contains(id4) == false);
+    QVERIFY(repo.identityHash_.contains(id1));
+    QVERIFY(repo.identityHash_.contains(id2));
+    QVERIFY(repo.identityHash_.contains(id3));
+    QVERIFY(repo.identityHash_.contains(newId));
+    QVERIFY(repo.identityHash_.contains(id5));
+
+    // Test: once clean and released, entities become evictable
+    repo.find(id1)->setClean();
+    astring2.reset();
+    repo.setCacheLimit(1);
+    QCOMPARE(repo.cacheEvictions(), qint64(4));
+    QCOMPARE(repo.identityHash_.size(), 2);
+    QVERIFY(repo.identityHash_.contains(id3));
+    QVERIFY(repo.identityHash_.contains(newId));
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << id3);
+}
+
+void TestAnonSeqRepository::evictFromDigestMap()
+{
+    MockAstringMapper mapper;
+    Seq seq1("ACDEF", eAminoGrammar);
+    int id1 = mapper.addSeq(seq1.asByteArray());
+    int id2 = mapper.addSeq("GHIKL");
+    int id3 = mapper.addSeq("MNPQR");
+
+    AnonSeqRepository<Astring> repo(&mapper);
+    repo.setCacheLimit(1);
+
+    // Test: the digest map shares the cached entity
+    AstringSPtr astring = repo.findBySeq(seq1);
+    QVERIFY(astring);
+    QCOMPARE(astring->id(), id1);
+    QCOMPARE(mapper.nDigestLookups_, 1);
+    QVERIFY(repo.findBySeq(seq1) == astring);
+    QCOMPARE(mapper.nDigestLookups_, 1);
+    QVERIFY(repo.find(id1) == astring);
+
+    // Test: the reference held by the digest map does not count as an outside reference, but this one does
+    repo.find(id2);
+    QCOMPARE(repo.cacheEvictions(), qint64(0));
+
+    astring.reset();
+    repo.find(id3);
+    QCOMPARE(repo.cacheEvictions(), qint64(2));
+    QCOMPARE(repo.identityHash_.size(), 1);
+    QVERIFY(repo.identityHash_.contains(id3));
+
+    // Test: eviction also removes the entity from the digest map, so it is looked up again
+    astring = repo.findBySeq(seq1);
+    QVERIFY(astring);
+    QCOMPARE(astring->id(), id1);
+    QCOMPARE(astring->seq_, seq1);
+    QCOMPARE(mapper.nDigestLookups_, 2);
+}
+
+void TestAnonSeqRepository::findAfterEviction()
+{
+    MockAstringMapper mapper;
+    int id1 = mapper.addSeq("ACDEF");
+    int id2 = mapper.addSeq("GHIKL");
+    int id3 = mapper.addSeq("MNPQR");
+
+    AnonSeqRepository<Astring> repo(&mapper);
+    repo.setCacheLimit(2);
+
+    repo.find(id1);
+    repo.find(id2);
+    repo.find(id3);
+    QCOMPARE(repo.cacheEvictions(), qint64(1));
+    QVERIFY(repo.identityHash_.contains(id1) == false);
+
+    // Test: evicted and cached ids are returned in the requested order; duplicate ids share one entity
+    repo.resetCacheCounters();
+    int nFound = mapper.nFound_;
+    QVector<AstringSPtr> astrings = repo.find(QVector<int>() << id1 << id3 << id1);
+    QCOMPARE(astrings.size(), 3);
+    QVERIFY(astrings.at(0));
+    QVERIFY(astrings.at(1));
+    QCOMPARE(astrings.at(0)->id(), id1);
+    QCOMPARE(astrings.at(0)->seq_, Seq("ACDEF", eAminoGrammar));
+    QCOMPARE(astrings.at(1)->id(), id3);
+    QVERIFY(astrings.at(2) == astrings.at(0));
+    QCOMPARE(repo.cacheHits(), qint64(1));
+    QCOMPARE(repo.cacheMisses(), qint64(2));
+    QCOMPARE(mapper.nFound_, nFound + 1);
+
+    // Test: the entities just found are retained while referenced; the other one is evicted
+    QCOMPARE(repo.cacheEvictions(), qint64(1));
+    QVERIFY(repo.identityHash_.contains(id2) == false);
+    QVERIFY(repo.findBySeq(Seq("ACDEF", eAminoGrammar)) == astrings.at(0));
+}
+
+void TestAnonSeqRepository::recentlyUsedIdsFollowCache()
+{
+    MockAstringMapper mapper;
+    int id1 = mapper.addSeq("ACDEF");
+    int id2 = mapper.addSeq("GHIKL");
+
+    AnonSeqRepository<Astring> repo(&mapper);
+    repo.find(id1);
+    repo.find(id2);
+    QVERIFY(repo.erase(QVector<AstringSPtr>() << repo.find(id1)));
+
+    AstringSPtr newAstring = repo.findBySeqOrCreate(Seq("MNPQR", eAminoGrammar));
+    QVERIFY(newAstring->isNew());
+    int newId = newAstring->id();
+    QVERIFY(repo.find(newId) == newAstring);
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << id2 << id1 << newId);
+
+    // Test: saving replaces the transient id and removing the cruft drops the erased id
+    QVERIFY(repo.saveAll());
+    QVERIFY(newAstring->isNew() == false);
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << id2 << newAstring->id());
+    QCOMPARE(repo.recentlyUsedPositions_.size(), 2);
+    QVERIFY(repo.recentlyUsedPositions_.contains(newId) == false);
+    QVERIFY(repo.recentlyUsedPositions_.contains(id1) == false);
+
+    // Test: eviction drops the evicted ids
+    newAstring.reset();
+    repo.setCacheLimit(1);
+    QCOMPARE(repo.cacheEvictions(), qint64(1));
+    QCOMPARE(repo.identityHash_.size(), 1);
+    QCOMPARE(repo.recentlyUsedIds_, QLinkedList<int>() << repo.identityHash_.keys().first());
+    QCOMPARE(repo.recentlyUsedPositions_.size(), 1);
+}
+
 QTEST_APPLESS_MAIN(TestAnonSeqRepository)
 #include "TestAnonSeqRepository.moc"
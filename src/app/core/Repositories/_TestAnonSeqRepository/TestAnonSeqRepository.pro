@@ -19,11 +19,15 @@ SOURCES += TestAnonSeqRepository.cpp \
            ../../Entities/AminoSeq.cpp \
            ../../DataSources/AbstractDbSource.cpp \
            ../../DataSources/SqliteAdocSource.cpp \
+           ../../DataSources/SqliteAdocPrefetcher.cpp \
            ../../Seq.cpp \
            ../../BioString.cpp \
            ../../misc.cpp \
            ../../constants.cpp \
            ../../DataSources/Crud/DbAstringCrud.cpp \
+           ../../DataSources/Crud/SequenceCodec.cpp \
+           ../../DataSources/Crud/MultiIdSelect.cpp \
+           ../../DataSources/Crud/MultiRowInsert.cpp \
            ../../DataSources/Crud/DbAminoSeqCrud.cpp \
            ../../MpttNode.cpp \
            ../../MpttTreeConverter.cpp
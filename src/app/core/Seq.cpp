@@ -47,6 +47,28 @@ Seq::Seq(const ::QByteArray &byteArray, Grammar grammar) : BioString(byteArray,
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 // Public methods
+/**
+  */
+void Seq::clear()
+{
+    BioString::clear();
+    digest_.clear();
+}
+
+/**
+  * Because the digest is never empty (even for an empty sequence), an empty digest_ indicates that it has not yet been
+  * computed.
+  *
+  * @returns QByteArray
+  */
+QByteArray Seq::digest() const
+{
+    if (digest_.isEmpty())
+        digest_ = BioString::digest();
+
+    return digest_;
+}
+
 /**
   * @returns BioString
   */
@@ -15,6 +15,10 @@
 
 /**
   * Full length, source-agnostic, ungapped, fixed representation of a biological sequence.
+  *
+  * Seqs are frequently looked up by their digest (e.g. AnonSeqRepository); therefore, the digest is computed upon first
+  * request and cached until the sequence data is changed. As with the implicitly shared Qt classes, a single Seq
+  * instance should not be accessed from multiple threads simultaneously.
   */
 class Seq : private BioString
 {
@@ -39,6 +43,8 @@ public:
 
     // ------------------------------------------------------------------------------------------------
     // Public methods
+    void clear();                                                               //!< Removes all characters
+    QByteArray digest() const;                                                  //!< Returns the (cached) 128-bit digest of this sequence
     BioString toBioString() const;                                              //!< Creates a copy of this Seq as a BioString
 
 
@@ -59,11 +65,9 @@ public:
     using BioString::at;
     using BioString::backTranscribe;
     using BioString::capacity;
-    using BioString::clear;
     using BioString::constData;
     using BioString::contains;
     using BioString::count;
-    using BioString::digest;
     using BioString::endsWith;
     using BioString::grammar;
     using BioString::indexOf;
@@ -83,6 +87,10 @@ public:
     using BioString::squeeze;
     using BioString::startsWith;
     using BioString::transcribe;
+
+
+private:
+    mutable QByteArray digest_;                                                 //!< Lazily computed digest; empty if not yet computed
 };
 
 #endif // SEQ_H
@@ -6,6 +6,9 @@
 **
 ****************************************************************************/
 
+#include <climits>
+#include <cstring>
+
 #include "Subseq.h"
 #include "constants.h"
 #include "global.h"
@@ -63,6 +66,34 @@ bool Subseq::operator!=(const Subseq &other) const
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Public methods
+/**
+  * @param range [const ClosedIntRange &]
+  * @returns ClosedIntRange
+  * @see BioString::collapseLeft()
+  */
+ClosedIntRange Subseq::collapseLeft(const ClosedIntRange &range)
+{
+    ClosedIntRange changedRange = BioString::collapseLeft(range);
+    if (!changedRange.isEmpty())
+        nonGapRunIndex_.update(constData(), changedRange);
+
+    return changedRange;
+}
+
+/**
+  * @param range [const ClosedIntRange &]
+  * @returns ClosedIntRange
+  * @see BioString::collapseRight()
+  */
+ClosedIntRange Subseq::collapseRight(const ClosedIntRange &range)
+{
+    ClosedIntRange changedRange = BioString::collapseRight(range);
+    if (!changedRange.isEmpty())
+        nonGapRunIndex_.update(constData(), changedRange);
+
+    return changedRange;
+}
+
 /**
   * Convenience method for calling extendLeft(simpleExtension.subseqPosition_, simpleExtension.seqRange)
   *
@@ -98,6 +129,7 @@ void Subseq::extendLeft(int position, const BioString &bioString)
     char *x = data() + position - 1;
     const char *src = bioString.constData();
     memcpy(x, src, bioString.length());
+    nonGapRunIndex_.update(constData(), ClosedIntRange(position, position + bioString.length() - 1));
 
     start_ -= ul;
 }
@@ -128,6 +160,7 @@ void Subseq::extendLeft(int position, const ClosedIntRange &parentSeqRange)
     char *x = data() + position - 1;
     const char *src = parentSeq_.constData() + parentSeqRange.begin_ - 1;
     memcpy(x, src, parentSeqRange.length());
+    nonGapRunIndex_.update(constData(), ClosedIntRange(position, position + parentSeqRange.length() - 1));
 
     start_ = parentSeqRange.begin_;
 }
@@ -168,6 +201,7 @@ void Subseq::extendRight(int position, const BioString &bioString)
     char *x = data() + position - 1;
     const char *src = bioString.constData();
     memcpy(x, src, bioString.length());
+    nonGapRunIndex_.update(constData(), ClosedIntRange(position, position + bioString.length() - 1));
 
     stop_ += ul;
 }
@@ -199,10 +233,118 @@ void Subseq::extendRight(int position, const ClosedIntRange &parentSeqRange)
     char *x = data() + position - 1;
     const char *src = parentSeq_.constData() + parentSeqRange.begin_ - 1;
     memcpy(x, src, parentSeqRange.length());
+    nonGapRunIndex_.update(constData(), ClosedIntRange(position, position + parentSeqRange.length() - 1));
 
     stop_ = parentSeqRange.end_;
 }
 
+/**
+  * The encoding consists of the following unsigned LEB128 varints:
+  *
+  * start, stop, number of gap runs, and then for each gap run: the number of residues between it and the previous gap
+  * run (or the beginning), its length, and (as a single byte) its gap character.
+  *
+  * The residues themselves are not stored because they are simply the characters start..stop of the parent Seq. Thus,
+  * the encoding of a typical alignment row is a tiny fraction of its gapped sequence.
+  *
+  * @returns QByteArray
+  */
+::QByteArray Subseq::gapRunEncoding() const
+{
+    ::QByteArray runs;
+    quint32 nRuns = 0;
+    quint32 nResidues = 0;
+    const char *x = constData();
+    const char *end = x + length();
+    while (x < end)
+    {
+        if (!::isGapCharacter(*x))
+        {
+            ++nResidues;
+            ++x;
+            continue;
+        }
+
+        char gapCharacter = *x;
+        const char *runBegin = x;
+        while (x < end && *x == gapCharacter)
+            ++x;
+
+        appendVarint(runs, nResidues);
+        appendVarint(runs, x - runBegin);
+        runs.append(gapCharacter);
+        nResidues = 0;
+        ++nRuns;
+    }
+
+    ::QByteArray encoding;
+    encoding.reserve(runs.size() + 15);
+    appendVarint(encoding, start_);
+    appendVarint(encoding, stop_);
+    appendVarint(encoding, nRuns);
+    encoding.append(runs);
+
+    return encoding;
+}
+
+/**
+  * @param position [int]
+  * @returns int
+  * @see BioString::gapsLeftOf()
+  */
+int Subseq::gapsLeftOf(int position) const
+{
+    ASSERT_X(position >= 1 && position <= length(), "position out of range");
+
+    return nonGapRunIndex().gapsLeftOf(position);
+}
+
+/**
+  * @param position [int]
+  * @returns int
+  * @see BioString::gapsRightOf()
+  */
+int Subseq::gapsRightOf(int position) const
+{
+    ASSERT_X(position >= 1 && position <= length(), "position out of range");
+
+    return nonGapRunIndex().gapsRightOf(position);
+}
+
+/**
+  * @param position [int]
+  * @returns bool
+  */
+bool Subseq::hasGapAt(int position) const
+{
+    ASSERT_X(position >= 1 && position <= length(), "position out of range");
+
+    return nonGapRunIndex().hasGapAt(position);
+}
+
+/**
+  * @returns int
+  */
+int Subseq::headGaps() const
+{
+    return nonGapRunIndex().headGaps();
+}
+
+/**
+  * @param position [int]
+  * @param nGaps [int]
+  * @param gapChar [char]
+  * @returns Subseq &
+  * @see BioString::insertGaps()
+  */
+Subseq &Subseq::insertGaps(int position, int nGaps, char gapChar)
+{
+    BioString::insertGaps(position, nGaps, gapChar);
+    nonGapRunIndex_.insertGaps(position, nGaps);
+
+    return *this;
+}
+
 /**
   * Because a Subseq must always have at least one non-gap character, this method will not return a range that includes
   * all non-gap characters regardless of position. Note the returned ClosedIntRange is relative to the Subseq
@@ -229,47 +371,21 @@ ClosedIntRange Subseq::leftTrimRange(int position) const
 {
     ASSERT_X(position >= 1 && position <= length(), "position out of range");
 
-    ClosedIntRange range;
-    int lastNonGapPos = 0;             // In case position includes the last non-gap character, we can easily
-                                       // move the range back to this position
-    const char *x = constData();
-    for (int i=1; i<= position; ++i, ++x)
-    {
-        if (!::isGapCharacter(*x))
-        {
-            if (range.begin_ == 0)
-                range.begin_ = i;
-            else
-                lastNonGapPos = range.end_;
+    const NonGapRunIndex &index = nonGapRunIndex();
+    int nNonGaps = index.nonGapsUpTo(position);
+    if (nNonGaps == 0)
+        return ClosedIntRange();
 
-            range.end_ = i;
-        }
-    }
-
-    // If we have not found at least one non-gap by position, then return an empty range
-    if (range.isEmpty())
-        return range;
-
-    // Now check that there is at least one more non-gap beyond position
-    bool hasExtraNonGap = false;
-    for (int i=position+1; *x; ++i, ++x)
+    // At least one non-gap character must remain beyond the trimmed range
+    if (nNonGaps == index.nonGaps())
     {
-        if (!::isGapCharacter(*x))
-        {
-            hasExtraNonGap = true;
-            break;
-        }
-    }
-
-    if (!hasExtraNonGap)
-    {
-        if (lastNonGapPos == 0)
+        if (nNonGaps == 1)
             return ClosedIntRange();
 
-        range.end_ = lastNonGapPos;
+        return ClosedIntRange(index.headGaps() + 1, index.positionOfNonGap(nNonGaps - 1));
     }
 
-    return range;
+    return ClosedIntRange(index.headGaps() + 1, index.lastNonGapAtOrBefore(position));
 }
 
 /**
@@ -280,10 +396,23 @@ int Subseq::mapToSeq(int position) const
 {
     ASSERT_X(position >= 1 && position <= length(), "position out of range");
 
-    if (hasGapAt(position))
+    const NonGapRunIndex &index = nonGapRunIndex();
+    if (index.hasGapAt(position))
         return -1;
 
-    return start_ + nonGapsBetween(ClosedIntRange(1, position)) - 1;
+    return start_ + index.nonGapsUpTo(position) - 1;
+}
+
+/**
+  * @param range [const ClosedIntRange &]
+  * @returns int
+  */
+int Subseq::nonGapsBetween(const ClosedIntRange &range) const
+{
+    ASSERT_X(range.begin_ >= 1 && range.begin_ <= length(), "range.begin_ out of range");
+    ASSERT_X(range.end_ >= range.begin_ && range.end_ <= length(), "range.end_ out of range");
+
+    return nonGapRunIndex().nonGapsBetween(range);
 }
 
 /**
@@ -297,6 +426,48 @@ void Subseq::rearrange(const ClosedIntRange &range, const BioString &bioString)
     ASSERT_X(mid(range).ungapped() == bioString.ungapped(), "different ungapped values between subseq range and bioString");
 
     BioString::replace(range, bioString);
+    nonGapRunIndex_.update(constData(), range);
+}
+
+/**
+  * @returns Subseq &
+  */
+Subseq &Subseq::removeGaps()
+{
+    BioString::removeGaps();
+    nonGapRunIndex_.clear();
+
+    return *this;
+}
+
+/**
+  * @param position [int]
+  * @param nGaps [int]
+  * @returns Subseq &
+  * @see BioString::removeGaps()
+  */
+Subseq &Subseq::removeGaps(int position, int nGaps)
+{
+    int oldLength = length();
+    BioString::removeGaps(position, nGaps);
+    int nGapsRemoved = oldLength - length();
+    if (nGapsRemoved > 0)
+        nonGapRunIndex_.removeGaps(QVector<ClosedIntRange>() << ClosedIntRange(position, position + nGapsRemoved - 1));
+
+    return *this;
+}
+
+/**
+  * @param gapRanges [const QVector<ClosedIntRange> &]
+  * @returns Subseq &
+  * @see BioString::removeGaps()
+  */
+Subseq &Subseq::removeGaps(const QVector<ClosedIntRange> &gapRanges)
+{
+    BioString::removeGaps(gapRanges);
+    nonGapRunIndex_.removeGaps(gapRanges);
+
+    return *this;
 }
 
 /**
@@ -419,6 +590,7 @@ bool Subseq::replace(int position, int amount, const BioString &replacement)
     }
 
     BioString::replace(position, amount, replacement);
+    nonGapRunIndex_.clear();
     return true;
 }
 
@@ -465,47 +637,22 @@ ClosedIntRange Subseq::rightTrimRange(int position) const
 {
     ASSERT_X(position >= 1 && position <= length(), "position out of range");
 
-    ClosedIntRange range;
-    int lastNonGapPos = 0;             // In case position includes the last non-gap character, we can easily
-                                       // move the range back to this position
-    const char *x = constData() + length() - 1;
-    for (int i=length(); i>= position; --i, --x)
-    {
-        if (!::isGapCharacter(*x))
-        {
-            if (range.end_ == -1)
-                range.end_ = i;
-            else
-                lastNonGapPos = range.begin_;
-
-            range.begin_ = i;
-        }
-    }
-
-    // If we have not found at least one non-gap by position, then return an empty range
-    if (range.isEmpty())
-        return range;
+    const NonGapRunIndex &index = nonGapRunIndex();
+    int nNonGaps = index.nonGaps() - index.nonGapsUpTo(position - 1);
+    if (nNonGaps == 0)
+        return ClosedIntRange();
 
-    // Now check that there is at least one more non-gap beyond position
-    bool hasExtraNonGap = false;
-    for (int i=position-1; i>0; --i, --x)
+    // At least one non-gap character must remain before the trimmed range
+    int lastNonGap = length() - index.tailGaps();
+    if (nNonGaps == index.nonGaps())
     {
-        if (!::isGapCharacter(*x))
-        {
-            hasExtraNonGap = true;
-            break;
-        }
-    }
-
-    if (!hasExtraNonGap)
-    {
-        if (lastNonGapPos == 0)
+        if (nNonGaps == 1)
             return ClosedIntRange();
 
-        range.begin_ = lastNonGapPos;
+        return ClosedIntRange(index.positionOfNonGap(2), lastNonGap);
     }
 
-    return range;
+    return ClosedIntRange(index.firstNonGapAtOrAfter(position), lastNonGap);
 }
 
 /**
@@ -554,6 +701,7 @@ bool Subseq::setBioString(const char *str)
     if (start != -1)
     {
         BioString::operator=(str);
+        nonGapRunIndex_.clear();
         start_ = start;
         stop_ = start_ + gapless.length() - 1;
 
@@ -563,6 +711,81 @@ bool Subseq::setBioString(const char *str)
     return false;
 }
 
+/**
+  * Unlike setBioString, no search of the parent Seq is necessary: the encoding is validated in its entirety and then
+  * the substring is assembled directly by copying the residues from the parent Seq and filling in the gap runs. This
+  * Subseq is not changed if encoding is invalid.
+  *
+  * @param encoding [const QByteArray &]
+  * @returns bool
+  * @see gapRunEncoding()
+  */
+bool Subseq::setGapRunEncoding(const ::QByteArray &encoding)
+{
+    const unsigned char *x = reinterpret_cast<const unsigned char *>(encoding.constData());
+    const unsigned char *end = x + encoding.size();
+
+    quint32 start = 0;
+    quint32 stop = 0;
+    quint32 nRuns = 0;
+    if (!readVarint(x, end, start) || !readVarint(x, end, stop) || !readVarint(x, end, nRuns))
+        return false;
+
+    if (start < 1 || stop < start || stop > static_cast<quint32>(parentSeq_.length()))
+        return false;
+
+    // Validate the gap runs and compute the total length
+    qint64 nResidues = stop - start + 1;
+    qint64 nRunResidues = 0;
+    qint64 totalLength = nResidues;
+    const unsigned char *runs = x;
+    for (quint32 i=0; i< nRuns; ++i)
+    {
+        quint32 residues = 0;
+        quint32 runLength = 0;
+        if (!readVarint(x, end, residues) || !readVarint(x, end, runLength) || x == end)
+            return false;
+
+        if (runLength == 0 || !::isGapCharacter(*x))
+            return false;
+        ++x;
+
+        nRunResidues += residues;
+        totalLength += runLength;
+        if (nRunResidues > nResidues || totalLength > INT_MAX)
+            return false;
+    }
+    if (x != end)
+        return false;
+
+    // Assemble the substring
+    resize(totalLength);
+    char *y = data();
+    const char *residue = parentSeq_.constData() + start - 1;
+    x = runs;
+    for (quint32 i=0; i< nRuns; ++i)
+    {
+        quint32 residues = 0;
+        quint32 runLength = 0;
+        readVarint(x, end, residues);
+        readVarint(x, end, runLength);
+        char gapCharacter = *x++;
+
+        memcpy(y, residue, residues);
+        y += residues;
+        residue += residues;
+        memset(y, gapCharacter, runLength);
+        y += runLength;
+    }
+    memcpy(y, residue, nResidues - nRunResidues);
+    nonGapRunIndex_.clear();
+
+    start_ = start;
+    stop_ = stop;
+
+    return true;
+}
+
 /**
   * Only updates the start position if it references a valid index within the parent Seq BioString object. If start
   * is valid and greater than stop, the stop position is also updated. Both start and stop positions only relate to
@@ -599,7 +822,7 @@ void Subseq::setStart(int newStart)
     if (newStart == start_)
         return;
 
-    int nHeadGaps = headGaps();
+    int nHeadGaps = BioString::headGaps();   // The scan is cheaper than rebuilding the gap index discarded below
 
     // Case 1
     if (newStart < start_)
@@ -629,7 +852,7 @@ void Subseq::setStart(int newStart)
     // Case 3: newStart > stop_
     else
     {
-        int nTailGaps = tailGaps(); // Capture number of tail gaps *before* removing characters
+        int nTailGaps = BioString::tailGaps(); // Capture number of tail gaps *before* removing characters
 
         // Step A: Replace all non-gap characters with gaps until we reach the current stop_
         char *x = data() + nHeadGaps;
@@ -666,6 +889,7 @@ void Subseq::setStart(int newStart)
 
     // Update the start position to the new position
     start_ = newStart;
+    nonGapRunIndex_.clear();
 }
 
 /**
@@ -703,7 +927,7 @@ void Subseq::setStop(int newStop)
     if (newStop == stop_)
         return;
 
-    int nTailGaps = tailGaps();
+    int nTailGaps = BioString::tailGaps();  // The scan is cheaper than rebuilding the gap index discarded below
 
     // Case 1
     if (newStop > stop_)
@@ -734,7 +958,7 @@ void Subseq::setStop(int newStop)
     // Case 3: newStop < start_
     else
     {
-        int nHeadGaps = headGaps();     // Note this amount is captured *before* we remove characters
+        int nHeadGaps = BioString::headGaps();     // Note this amount is captured *before* we remove characters
 
         // Step A: Replace all non-gap characters with gaps until we reach the current start_
         char *x = data() + length() - 1 - nTailGaps;
@@ -771,6 +995,34 @@ void Subseq::setStop(int newStop)
 
     // Update the stop position to the new position
     stop_ = newStop;
+    nonGapRunIndex_.clear();
+}
+
+/**
+  * @param range [const ClosedIntRange &]
+  * @param delta [int]
+  * @returns int
+  * @see BioString::slide()
+  */
+int Subseq::slide(const ClosedIntRange &range, int delta)
+{
+    int actualDelta = BioString::slide(range, delta);
+    if (actualDelta != 0)
+    {
+        ClosedIntRange changedRange(qMin(range.begin_, range.begin_ + actualDelta),
+                                    qMax(range.end_, range.end_ + actualDelta));
+        nonGapRunIndex_.update(constData(), changedRange);
+    }
+
+    return actualDelta;
+}
+
+/**
+  * @returns int
+  */
+int Subseq::tailGaps() const
+{
+    return nonGapRunIndex().tailGaps();
 }
 
 /**
@@ -831,6 +1083,7 @@ void Subseq::trimLeft(const ClosedIntRange &range, int nNonGaps)
 
     // Finally any remainder
     memcpy(x, src, range.length() - gapsWritten);
+    nonGapRunIndex_.update(constData(), range);
 }
 
 /**
@@ -892,6 +1145,22 @@ void Subseq::trimRight(const ClosedIntRange &range, int nNonGaps)
 
     // Finally any remainder
     memcpy(x, src, range.length() - gapsWritten);
+    nonGapRunIndex_.update(constData(), range);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  * @returns const NonGapRunIndex &
+  */
+const NonGapRunIndex &Subseq::nonGapRunIndex() const
+{
+    if (!nonGapRunIndex_.isValid())
+        nonGapRunIndex_.rebuild(constData(), length());
+
+    return nonGapRunIndex_;
 }
 
 
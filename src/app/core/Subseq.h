@@ -13,6 +13,7 @@
 #include <QtCore/QVector>
 
 #include "BioString.h"
+#include "NonGapRunIndex.h"
 #include "Seq.h"
 #include "UngappedSubseq.h"
 #include "global.h"
@@ -83,6 +84,15 @@
   * moveStop(-2) -> B------  (since stop now exceeds start, also update start)
   * moveStop(-3..-N) -> A-------
   * moveStop(0) -> -C---D-
+  *
+  * -----------------------------
+  * Gap queries
+  *
+  * Positional queries (e.g. mapToSeq, gapsLeftOf, nonGapsBetween) are answered from a NonGapRunIndex in logarithmic
+  * time rather than by scanning the characters. The index is built on first use and thereafter updated in place by
+  * the common alignment edits (inserting or removing gaps, sliding, collapsing, rearranging, extending, and trimming).
+  * Less frequent edits (e.g. setStart, replace) simply discard the index to be rebuilt on demand. Because the index is
+  * rebuilt from within const methods, a Subseq may not be queried concurrently from multiple threads.
   */
 class Subseq : public UngappedSubseq
 {
@@ -112,16 +122,28 @@ public:
 
     // ------------------------------------------------------------------------------------------------
     // Public methods
+    ClosedIntRange collapseLeft(const ClosedIntRange &range);                   //!< Collapses all characters in range to the left and returns the range of columns changed or empty if none were changed
+    ClosedIntRange collapseRight(const ClosedIntRange &range);                  //!< Collapses all characters in range to the right and returns the range of columns changed or empty if none were changed
     void extendLeft(const SimpleExtension &simpleExtension);                    //!< Extends the Subseq to the left using the data in simpleExtension
     void extendLeft(int position, const BioString &bioString);                  //!< Extends the Subseq to the left by replacing the characters beginning at position with bioString
     void extendLeft(int position, const ClosedIntRange &parentSeqRange);        //!< Extends the Subseq to the left by replacing the characters beginning at position with the characters specified by parentSeqRange
     void extendRight(const SimpleExtension &simpleExtension);                   //!< Extends the Subseq to the right using the data in simpleExtension
     void extendRight(int position, const BioString &bioString);                 //!< Extends the Subseq to the right by replacing the characters beginning at position with bioString
     void extendRight(int position, const ClosedIntRange &parentSeqRange);       //!< Extends the Subseq to the right by replacing the characters beginning at position with the characters specified by parentSeqRange
+    ::QByteArray gapRunEncoding() const;                                        //!< Returns a compact binary encoding of the start, stop, and gap runs of this Subseq (see setGapRunEncoding)
+    int gapsLeftOf(int position) const;                                         //!< Returns the number of contiguous gap characters to the left of the character at position
+    int gapsRightOf(int position) const;                                        //!< Returns the number of contiguous gap characters to the right of the character at position
+    bool hasGapAt(int position) const;                                          //!< Returns true if there is a gap at position; false otherwise
+    int headGaps() const;                                                       //!< Returns the number of gaps before the first non-gap character
+    Subseq &insertGaps(int position, int nGaps, char gapChar);                  //!< Insert nGaps gaps at position using gapChar and return a reference to this object
     ClosedIntRange leftTrimRange(int position) const;                           //!< Returns the ClosedIntRange that may be trimmed left of position (inclusive) or an empty ClosedIntRange if none may be trimmed
     int leftUnusedLength() const;                                               //!< Returns the number of characters in the parent Seq to the left of start (or start_ - 1)
     int mapToSeq(int position) const;                                           //!< Maps position in subseq space to its corresponding position in the parent Seq object; returns -1 if position corresponds to a gap character
+    int nonGapsBetween(const ClosedIntRange &range) const;                      //!< Returns the number of non-gap characters in range
     void rearrange(const ClosedIntRange &range, const BioString &bioString);    //!< A memory efficient version of replace that substitutes bioString for the characters in range. Requires that range and bioString have equivalent lengths and that the non-gap characters in range are equivalent in order and number to the non-gap characters in bioString
+    Subseq &removeGaps();                                                       //!< Removes all gaps and returns a reference to this object
+    Subseq &removeGaps(int position, int nGaps);                                //!< Remove up to nGaps contiguous gaps beginning with the gap at position, if the character at position is a gap and return a reference to this object
+    Subseq &removeGaps(const QVector<ClosedIntRange> &gapRanges);               //!< Removes the ordered, non-overlapping gapRanges in a single pass and returns a reference to this object
     // Override replace to ensure that the biostring remains a true substring of parentSeq_
     bool replace(int position, int amount, const BioString &bioString);         //!< Replace amount character starting from position (1-based) with bioString and return true if successful, false otherwise
     bool replace(const ClosedIntRange &range, const BioString &bioString);      //!< Replace the characters in range with bioString and return true if successful, false otherwise
@@ -130,8 +152,11 @@ public:
     bool setBioString(const BioString &bioString);                              //!< Sets the substring to bioString (which may contain gaps) if the ungapped bioString is a substring of parentSeq; returns whether this operation was successful
     bool setBioString(const ::QByteArray &byteArray);                           //!< Sets the substring to the characters in byteArray if the ungapped representation of byteArray is a substring of parentSeq; returns whether this operation was successful
     bool setBioString(const char *str);                                         //!< Sets the substring to the characters in str if the ungapped representation of str is a substring of parentSeq; returns whether this operation was successful
+    bool setGapRunEncoding(const ::QByteArray &encoding);                       //!< Rebuilds the substring from encoding (see gapRunEncoding) and the characters of parentSeq; returns false if encoding is not valid for parentSeq
     void setStart(int newStart);                                                //!< Sets the start position to newStart
     void setStop(int newStop);                                                  //!< Sets the stop position to stop
+    int slide(const ClosedIntRange &range, int delta);                          //!< Slide the characters in range up to delta positions and return the number of positions successfully moved
+    int tailGaps() const;                                                       //!< Returns the number of gaps occurring after the last non-gap character
     void trimLeft(const Trim &trim);                                            //!< Trims from the left using the data in trim
     void trimLeft(const ClosedIntRange &range, int nNonGaps = 0);               //!< Trims range from the left end of the subseq replacing the trimmed characters with gap characters; the nNonGaps is for optimization purposes and avoids the need to calculate the number of non-gaps that will be replaced. If nNonGaps is zero, then this value is auto-calculated
     void trimRight(const Trim &trim);                                           //!< Trims to the right using the data in trim
@@ -144,18 +169,10 @@ public:
 
     // ------------------------------------------------------------------------------------------------
     // Re-exposed public methods
-    using BioString::collapseLeft;
-    using BioString::collapseRight;
     using BioString::hasGaps;
     using BioString::hasNonGaps;
-    using BioString::headGaps;
-    using BioString::insertGaps;
     using BioString::leftSlidablePositions;
-    using BioString::nonGapsBetween;
-    using BioString::removeGaps;
     using BioString::rightSlidablePositions;
-    using BioString::slide;
-    using BioString::tailGaps;
     using BioString::translateGaps;
     using BioString::ungapped;
     using BioString::ungappedLength;
@@ -188,8 +205,14 @@ public:
     };
 
 private:
+    // ------------------------------------------------------------------------------------------------
+    // Private methods
+    const NonGapRunIndex &nonGapRunIndex() const;                               //!< Returns the gap index, rebuilding it first if necessary
+
+
     // ------------------------------------------------------------------------------------------------
     // Private members
+    mutable NonGapRunIndex nonGapRunIndex_;
     static const ::QByteArray gapBuffer_;
 };
 
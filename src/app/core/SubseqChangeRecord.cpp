@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <cstring>
+
+#include "SubseqChangeRecord.h"
+#include "Msa.h"
+#include "global.h"
+#include "macros.h"
+#include "misc.h"
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Constructors
+/**
+  */
+SubseqChangeRecord::SubseqChangeRecord()
+    : size_(0), compressed_(false)
+{
+}
+
+/**
+  * Each pod is encoded as: row, columns.begin_, columns.length() (all varints), the operation (one byte), and then the
+  * runs of its difference. Every run is a varint of its length shifted left by one with the low bit set for gap runs,
+  * which are additionally followed by their gap character.
+  *
+  * @param pods [const SubseqChangePodVector &]
+  */
+SubseqChangeRecord::SubseqChangeRecord(const SubseqChangePodVector &pods)
+    : size_(0), compressed_(false)
+{
+    for (int i=pods.size() - 1; i>= 0; --i)
+    {
+        const SubseqChangePod &pod = pods.at(i);
+        if (pod.isNull())
+            continue;
+
+        ASSERT(pod.columns_.length() == pod.difference_.length());
+        appendVarint(encoding_, pod.row_);
+        appendVarint(encoding_, pod.columns_.begin_);
+        appendVarint(encoding_, pod.columns_.length());
+        encoding_.append(static_cast<char>(pod.operation_));
+
+        const char *x = pod.difference_.constData();
+        const char *end = x + pod.difference_.length();
+        while (x != end)
+        {
+            const char *runBegin = x;
+            if (::isGapCharacter(*x))
+            {
+                for (++x; x != end && *x == *runBegin; ++x)
+                    ;
+                appendVarint(encoding_, ((x - runBegin) << 1) | 1);
+                encoding_.append(*runBegin);
+            }
+            else
+            {
+                for (++x; x != end && !::isGapCharacter(*x); ++x)
+                    ;
+                appendVarint(encoding_, (x - runBegin) << 1);
+            }
+        }
+
+        ++size_;
+    }
+
+    encoding_.squeeze();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  */
+void SubseqChangeRecord::clear()
+{
+    encoding_.clear();
+    size_ = 0;
+    compressed_ = false;
+}
+
+/**
+  */
+void SubseqChangeRecord::compress()
+{
+    if (compressed_ || encoding_.isEmpty())
+        return;
+
+    encoding_ = qCompress(encoding_);
+    compressed_ = true;
+}
+
+/**
+  * @returns bool
+  */
+bool SubseqChangeRecord::isCompressed() const
+{
+    return compressed_;
+}
+
+/**
+  * @returns bool
+  */
+bool SubseqChangeRecord::isEmpty() const
+{
+    return size_ == 0;
+}
+
+/**
+  * @returns int
+  */
+int SubseqChangeRecord::memoryUsage() const
+{
+    return sizeof(SubseqChangeRecord) + encoding_.capacity();
+}
+
+/**
+  * @returns int
+  */
+int SubseqChangeRecord::size() const
+{
+    return size_;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Reader constructor
+/**
+  * @param subseqChangeRecord [const SubseqChangeRecord &]
+  */
+SubseqChangeRecord::Reader::Reader(const SubseqChangeRecord &subseqChangeRecord)
+    : encoding_(subseqChangeRecord.compressed_ ? qUncompress(subseqChangeRecord.encoding_) : subseqChangeRecord.encoding_)
+{
+    x_ = reinterpret_cast<const unsigned char *>(encoding_.constData());
+    end_ = x_ + encoding_.size();
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Reader public methods
+/**
+  * @returns bool
+  */
+bool SubseqChangeRecord::Reader::hasNext() const
+{
+    return x_ != end_;
+}
+
+/**
+  * The gap runs are first laid out in the difference with a null placeholder for every non-gap character. These are
+  * then filled from the parent sequence (trims) or from the non-gap characters currently occupying the pod's columns
+  * (extensions and collapses).
+  *
+  * @param msa [const Msa &]
+  * @returns SubseqChangePod
+  */
+SubseqChangePod SubseqChangeRecord::Reader::next(const Msa &msa)
+{
+    ASSERT(hasNext());
+
+    quint32 row = 0;
+    quint32 begin = 0;
+    quint32 length = 0;
+    bool ok = readVarint(x_, end_, row) && readVarint(x_, end_, begin) && readVarint(x_, end_, length) && x_ != end_;
+    ASSERT_X(ok, "Corrupt subseq change record");
+    Q_UNUSED(ok);
+    SubseqChangePod::TrimExtOp operation = static_cast<SubseqChangePod::TrimExtOp>(*x_++);
+    ClosedIntRange columns(begin, begin + length - 1);
+
+    QByteArray difference(columns.length(), '\0');
+    char *y = difference.data();
+    int nNonGaps = 0;
+    for (int i=0; i< columns.length(); )
+    {
+        quint32 run = 0;
+        readVarint(x_, end_, run);
+        int runLength = run >> 1;
+        if (run & 1)
+            memset(y + i, *x_++, runLength);
+        else
+            nNonGaps += runLength;
+        i += runLength;
+    }
+
+    const Subseq *subseq = msa.at(row);
+    const char *source = nullptr;
+    bool sourceHasGaps = false;
+    switch (operation)
+    {
+    case SubseqChangePod::eTrimLeft:
+        source = subseq->parentSeq_.constData() + subseq->start() - nNonGaps - 1;
+        break;
+    case SubseqChangePod::eTrimRight:
+        source = subseq->parentSeq_.constData() + subseq->stop();
+        break;
+
+    default:
+        source = subseq->constData() + columns.begin_ - 1;
+        sourceHasGaps = true;
+        break;
+    }
+
+    for (char *z = y + columns.length(); y != z; ++y)
+    {
+        if (*y != '\0')
+            continue;
+
+        if (sourceHasGaps)
+        {
+            while (::isGapCharacter(*source))
+                ++source;
+        }
+        *y = *source++;
+    }
+
+    return SubseqChangePod(row, columns, operation, BioString(difference, subseq->grammar()));
+}
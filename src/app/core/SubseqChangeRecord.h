@@ -0,0 +1,89 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef SUBSEQCHANGERECORD_H
+#define SUBSEQCHANGERECORD_H
+
+#include <QtCore/QByteArray>
+
+#include "PODs/SubseqChangePod.h"
+
+class Msa;
+
+/**
+  * SubseqChangeRecord stores a SubseqChangePodVector in a compact binary form suitable for keeping on an undo stack.
+  *
+  * Each SubseqChangePod carries a copy of every character it changed; however, when the change is undone, its
+  * non-gap characters may always be recovered from the alignment itself. Trimmed characters are those of the parent
+  * sequence immediately beyond the subseq start (or stop), and the characters of extended or collapsed columns remain
+  * within those columns. Thus, only the row, columns, operation, and the arrangement of gaps within each difference are
+  * stored. The latter is encoded as alternating runs of non-gap and gap characters with their lengths stored as
+  * varints. Gap runs also store their gap character so that the original characters are restored exactly.
+  *
+  * Because pods must be undone in reverse order, they are encoded last to first and Reader decodes them in this same
+  * order. Each pod must be decoded against the msa as it exists immediately after that pod was applied, which is
+  * precisely the state reached while undoing the pods one at a time. Null pods are not stored.
+  *
+  * The encoding may be further compressed with zlib (see compress) in exchange for decompressing it whenever it is
+  * read.
+  */
+class SubseqChangeRecord
+{
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Forward declarations
+    class Reader;
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Constructors
+    SubseqChangeRecord();                                                       //!< Construct an empty record
+    explicit SubseqChangeRecord(const SubseqChangePodVector &pods);             //!< Construct a record of pods
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    void clear();                                                               //!< Removes all pods
+    void compress();                                                            //!< Compresses the encoded pods; does nothing if already compressed
+    bool isCompressed() const;                                                  //!< Returns true if the encoded pods have been compressed; false otherwise
+    bool isEmpty() const;                                                       //!< Returns true if there are no pods; false otherwise
+    int memoryUsage() const;                                                    //!< Returns the approximate number of bytes occupied by this record
+    int size() const;                                                           //!< Returns the number of pods
+
+
+private:
+    QByteArray encoding_;
+    int size_;
+    bool compressed_;
+};
+
+/**
+  * Reader decodes the pods of a SubseqChangeRecord in undo order, that is, from the last pod to the first.
+  */
+class SubseqChangeRecord::Reader
+{
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Constructor
+    Reader(const SubseqChangeRecord &subseqChangeRecord);
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    bool hasNext() const;                                                       //!< Returns true if there is another pod to decode; false otherwise
+    //! Decodes the next pod and restores its difference from msa, which must reflect the state just after the pod was applied
+    SubseqChangePod next(const Msa &msa);
+
+
+private:
+    QByteArray encoding_;
+    const unsigned char *x_;
+    const unsigned char *end_;
+};
+
+#endif // SUBSEQCHANGERECORD_H
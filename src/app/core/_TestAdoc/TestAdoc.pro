@@ -12,15 +12,20 @@ TARGET = TestAdoc
 DEPENDPATH += . ..
 INCLUDEPATH += . ..
 
-HEADERS += Adoc.h
+HEADERS += Adoc.h core/DataSources/SqliteAdocCompactor.h
 SOURCES += TestAdoc.cpp \
            Adoc.cpp \
            core/DataSources/SqliteAdocSource.cpp \
+           core/DataSources/SqliteAdocPrefetcher.cpp \
+           core/DataSources/SqliteAdocCompactor.cpp \
            core/DataSources/AbstractDbSource.cpp \
            core/BioString.cpp \
            core/Seq.cpp \
            core/DataMappers/AminoSeqMapper.cpp \
            core/DataSources/Crud/DbAstringCrud.cpp \
+           core/DataSources/Crud/SequenceCodec.cpp \
+           core/DataSources/Crud/MultiIdSelect.cpp \
+           core/DataSources/Crud/MultiRowInsert.cpp \
            core/DataSources/Crud/DbAminoSeqCrud.cpp \
            core/MpttNode.cpp \
            core/MpttTreeConverter.cpp \
@@ -109,6 +109,7 @@ private slots:
     void remove_range();
     void removeGaps();
     void removeGaps_poslen();
+    void removeGaps_ranges();
     void replace();
     void replace_range();
     void reverse();
@@ -121,12 +122,20 @@ private slots:
     void translateGaps();
     void ungapped();
     void ungappedLength();
+    void transformsLongSequences();
 
 
     // ------------------------------------------------------------------------------------------------
     // Benchmarks
     void benchSlide();
     void benchSlideViaSwap();
+    void benchComplement();
+    void benchReverseComplement();
+    void benchTr();
+    void benchTranslateGaps();
+    void benchUngapped();
+    void benchRemoveGaps();
+    void benchOnlyContainsACGT();
 
 private:
     char negativeChars[129];
@@ -732,7 +741,9 @@ void TestBioString::digest()
 {
     BioString biostring = "ABCDEF--..GHIJ";
 
-    QCOMPARE(biostring.digest(), QCryptographicHash::hash(biostring.asByteArray(), QCryptographicHash::Md5));
+    QCOMPARE(biostring.digest(), ::hash128(biostring.constData(), biostring.length()));
+    QCOMPARE(biostring.digest().toHex(), QByteArray("57ee5ccce55d9953b2535546df9b8a5d"));
+    QVERIFY(biostring.digest() != BioString("ABCDEF--..GHIK").digest());
 }
 
 void TestBioString::gapsBetween()
@@ -1255,6 +1266,41 @@ void TestBioString::removeGaps_poslen()
     */
 }
 
+void TestBioString::removeGaps_ranges()
+{
+    //                123456789012345
+    QByteArray str = "--A-B-C---DEF--";
+    BioString biostring = str;
+
+    // Test: empty vector does nothing
+    QCOMPARE(biostring.removeGaps(QVector<ClosedIntRange>()).constData(), str.constData());
+
+    // Test: single range
+    QCOMPARE(biostring.removeGaps(QVector<ClosedIntRange>() << ClosedIntRange(8, 9)), BioString("--A-B-C-DEF--"));
+
+    // Test: multiple ranges including both termini
+    biostring = str;
+    QCOMPARE(biostring.removeGaps(QVector<ClosedIntRange>() << ClosedIntRange(1, 2)
+                                                             << ClosedIntRange(4, 4)
+                                                             << ClosedIntRange(8, 10)
+                                                             << ClosedIntRange(14, 15)), BioString("AB-CDEF"));
+
+    // Test: removing all gaps
+    biostring = str;
+    QCOMPARE(biostring.removeGaps(QVector<ClosedIntRange>() << ClosedIntRange(1, 2)
+                                                             << ClosedIntRange(4, 4)
+                                                             << ClosedIntRange(6, 6)
+                                                             << ClosedIntRange(8, 10)
+                                                             << ClosedIntRange(14, 15)), BioString("ABCDEF"));
+
+    // Test: result is equivalent to removing each range individually from right to left
+    biostring = str;
+    BioString expected = str;
+    expected.removeGaps(14, 1);
+    expected.removeGaps(4, 1);
+    QCOMPARE(biostring.removeGaps(QVector<ClosedIntRange>() << ClosedIntRange(4, 4) << ClosedIntRange(14, 14)), expected);
+}
+
 void TestBioString::replace()
 {
     QByteArray str = "ABCDEF";
@@ -1584,6 +1630,68 @@ void TestBioString::ungappedLength()
     QCOMPARE(biostring.ungappedLength(), 9);
 }
 
+/**
+  * The character transforms process blocks of characters at a time; this checks them against straightforward per
+  * character implementations for sequences long enough to span several blocks and with a variety of tail lengths.
+  */
+void TestBioString::transformsLongSequences()
+{
+    const char *alphabets[] = { "ACGT", "AC-.", "ACGTacgtRYN-.X" };
+    for (int i=0; i< 300; ++i)
+    {
+        const char *alphabet = alphabets[i % 3];
+        int alphabetSize = qstrlen(alphabet);
+        int l = i % 100;
+        QByteArray str(l, ' ');
+        for (int j=0; j< l; ++j)
+            str[j] = alphabet[qrand() % alphabetSize];
+
+        QByteArray expectedUngapped;
+        QByteArray expectedTranslated = str;
+        QByteArray expectedTr = str;
+        QByteArray expectedReverseComplement;
+        bool expectedOnlyACGT = l > 0;
+        for (int j=0; j< l; ++j)
+        {
+            char ch = str.at(j);
+            if (ch == '-' || ch == '.')
+                expectedTranslated[j] = '@';
+            else
+                expectedUngapped += ch;
+            if (ch != 'A' && ch != 'C' && ch != 'G' && ch != 'T')
+                expectedOnlyACGT = false;
+            if (ch == 'A')
+                expectedTr[j] = 'Z';
+            else if (ch == '-')
+                expectedTr[j] = '.';
+
+            switch (str.at(l - j - 1))
+            {
+            case 'A':   expectedReverseComplement += 'T';    break;
+            case 'C':   expectedReverseComplement += 'G';    break;
+            case 'G':   expectedReverseComplement += 'C';    break;
+            case 'T':   expectedReverseComplement += 'A';    break;
+            case 'a':   expectedReverseComplement += 't';    break;
+            case 'c':   expectedReverseComplement += 'g';    break;
+            case 'g':   expectedReverseComplement += 'c';    break;
+            case 't':   expectedReverseComplement += 'a';    break;
+            default:    expectedReverseComplement += str.at(l - j - 1);  break;
+            }
+        }
+
+        BioString biostring(str, eDnaGrammar);
+        QCOMPARE(biostring.ungapped().asByteArray(), expectedUngapped);
+        QCOMPARE(BioString(biostring).removeGaps().asByteArray(), expectedUngapped);
+        QCOMPARE(BioString(biostring).translateGaps('@').asByteArray(), expectedTranslated);
+        QCOMPARE(BioString(biostring).tr("A-A", "Z.@").asByteArray(), expectedTr);
+        QCOMPARE(biostring.reverseComplement().asByteArray(), expectedReverseComplement);
+        QCOMPARE(biostring.reverseComplement(), biostring.complement().reverse());
+        QCOMPARE(biostring.onlyContainsACGT(), expectedOnlyACGT);
+        if (l > 0)
+            QCOMPARE(biostring.onlyContainsACGT(ClosedIntRange(1, l)), expectedOnlyACGT);
+    }
+}
+
 
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
@@ -1633,5 +1741,84 @@ void TestBioString::benchSlideViaSwap()
     }
 }
 
+/**
+  * @param length [int]
+  * @param alphabet [const char *]
+  * @returns BioString
+  */
+static BioString randomBioString(int length, const char *alphabet)
+{
+    int alphabetSize = qstrlen(alphabet);
+    QByteArray str(length, ' ');
+    for (int i=0; i< length; ++i)
+        str[i] = alphabet[qrand() % alphabetSize];
+
+    return BioString(str, eDnaGrammar);
+}
+
+void TestBioString::benchComplement()
+{
+    BioString biostring = randomBioString(1000000, "ACGTN-");
+    QBENCHMARK
+    {
+        biostring.complement();
+    }
+}
+
+void TestBioString::benchReverseComplement()
+{
+    BioString biostring = randomBioString(1000000, "ACGTN-");
+    QBENCHMARK
+    {
+        biostring.reverseComplement();
+    }
+}
+
+void TestBioString::benchTr()
+{
+    BioString biostring = randomBioString(1000000, "ACGTN-");
+    QBENCHMARK
+    {
+        biostring.tr("ACGTacgt", "TGCAtgca");
+    }
+}
+
+void TestBioString::benchTranslateGaps()
+{
+    BioString biostring = randomBioString(1000000, "ACGT-.");
+    QBENCHMARK
+    {
+        biostring.translateGaps('-');
+    }
+}
+
+void TestBioString::benchUngapped()
+{
+    BioString biostring = randomBioString(1000000, "ACGTACGTACGTACG-");
+    QBENCHMARK
+    {
+        biostring.ungapped();
+    }
+}
+
+void TestBioString::benchRemoveGaps()
+{
+    BioString source = randomBioString(1000000, "ACGTACGTACGTACG-");
+    QBENCHMARK
+    {
+        BioString biostring = source;
+        biostring.removeGaps();
+    }
+}
+
+void TestBioString::benchOnlyContainsACGT()
+{
+    BioString biostring = randomBioString(1000000, "ACGT");
+    QBENCHMARK
+    {
+        biostring.onlyContainsACGT();
+    }
+}
+
 QTEST_APPLESS_MAIN(TestBioString)
 #include "TestBioString.moc"
@@ -32,6 +32,7 @@ private slots:
     void allColumnsAreEmpty();
     void charPercents();
     void mid();
+    void setColumnHistogram();
     void setDivisor();
     void subtract_data();
     void subtract();
@@ -39,6 +40,7 @@ private slots:
     void subtractByteArray();
     void removeZeroKeyValues_data();
     void removeZeroKeyValues();
+    void mixedDenseSparseCharacters();     // Characters stored densely and sparsely behave identically
 
 private:
     VectorHashCharInt createVectorHashCharInt(bool positive = true) const;
@@ -477,6 +479,45 @@ void TestCharCountDistribution::mid()
     QCOMPARE(x.mid(ClosedIntRange(4, 4)), CharCountDistribution(data.mid(3, 1), 3));
 }
 
+void TestCharCountDistribution::setColumnHistogram()
+{
+    VectorHashCharInt data;
+    data << QHash<char, int>() << QHash<char, int>();
+    data.first().insert('C', 7);
+    data.first().insert('~', 1);
+    CharCountDistribution x(data, 3);
+
+    QVector<int> histogram(256, 0);
+    histogram['A'] = 2;
+    histogram['a'] = 1;
+    histogram['-'] = 4;
+    histogram['.'] = 5;
+
+    // Test: gaps and zero counts are not keys; previous counts of the column are replaced
+    x.setColumnHistogram(1, histogram.constData());
+    data[0].clear();
+    data[0].insert('A', 2);
+    data[0].insert('a', 1);
+    QCOMPARE(x.charCounts(), data);
+    QVERIFY(x == CharCountDistribution(data, 3));
+
+    // Test: other columns are unaffected
+    histogram.fill(0);
+    histogram['Z'] = 3;
+    histogram[200] = 1;
+    x.setColumnHistogram(2, histogram.constData());
+    data[1].insert('Z', 3);
+    data[1].insert(static_cast<char>(200), 1);
+    QCOMPARE(x.charCounts(), data);
+    QVERIFY(x == CharCountDistribution(data, 3));
+
+    // Test: an empty histogram empties the column
+    histogram.fill(0);
+    x.setColumnHistogram(1, histogram.constData());
+    x.setColumnHistogram(2, histogram.constData());
+    QVERIFY(x.allColumnsAreEmpty());
+}
+
 void TestCharCountDistribution::setDivisor()
 {
     CharCountDistribution x;
@@ -835,5 +876,56 @@ void TestCharCountDistribution::removeZeroKeyValues()
     QCOMPARE(x.charCounts(), result);
 }
 
+void TestCharCountDistribution::mixedDenseSparseCharacters()
+{
+    VectorHashCharInt data;
+    data << QHash<char, int>();
+    data.last().insert('A', 1);
+    data.last().insert('a', 2);
+    data.last().insert('?', 3);
+    data << QHash<char, int>();
+    data.last().insert('-', 4);
+    data.last().insert('~', 0);
+
+    CharCountDistribution x(data, 4);
+    QCOMPARE(x.charCounts(), data);
+    QVERIFY(x == CharCountDistribution(data, 4));
+    QVERIFY(x != CharCountDistribution(data, 3));
+
+    // Test: add and subtract a byte array containing both types of characters
+    x.add("a-", '\0', 1);
+    data[0]['a'] += 1;
+    data[1]['-'] += 1;
+    QCOMPARE(x.charCounts(), data);
+
+    x.subtract("A~", '\0', 1);
+    data[0]['A'] -= 1;
+    data[1]['~'] -= 1;
+    QCOMPARE(x.charCounts(), data);
+
+    // Test: adding another distribution at an offset
+    CharCountDistribution y(VectorHashCharInt() << data.first());
+    x.add(y, 2);
+    data[1]['A'] += 0;
+    data[1]['a'] += 3;
+    data[1]['?'] += 3;
+    QCOMPARE(x.charCounts(), data);
+
+    // Test: zero value keys of either type are removed
+    x.removeZeroValueKeys();
+    data[0].remove('A');
+    data[1].remove('A');
+    QCOMPARE(x.charCounts(), data);
+
+    // Test: percentages
+    VectorHashCharDouble percents = x.charPercents();
+    QCOMPARE(percents.size(), 2);
+    QCOMPARE(percents.first().value('a'), .75);
+    QCOMPARE(percents.first().value('?'), .75);
+    QCOMPARE(percents.last().value('-'), 1.25);
+    QCOMPARE(percents.last().value('~'), -.25);
+    QCOMPARE(percents.first().size(), data.first().size());
+}
+
 QTEST_APPLESS_MAIN(TestCharCountDistribution)
 #include "TestCharCountDistribution.moc"
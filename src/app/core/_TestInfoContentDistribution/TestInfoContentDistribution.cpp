@@ -28,6 +28,7 @@ private slots:
     void infoContent_data();
     void infoContent();
     void columnInfo();
+    void totalInfo();
 };
 Q_DECLARE_METATYPE(CharCountDistribution)
 Q_DECLARE_METATYPE(VectorVectorInfoUnit)
@@ -172,5 +173,21 @@ void TestInfoContentDistribution::columnInfo()
     QVERIFY(fabs(x.columnInfo(3) - 0.484280058) < precision);
 }
 
+void TestInfoContentDistribution::totalInfo()
+{
+    CharCountDistribution dist = ::charCountDistribution1();
+    InfoContentDistribution x(dist, 4, false);
+
+    double precision = .0001;
+    QVERIFY(fabs(x.totalInfo() - 3.12973372) < precision);
+    QVERIFY(fabs(x.totalInfo(ClosedIntRange(1, 1)) - 0.429049406) < precision);
+    QVERIFY(fabs(x.totalInfo(ClosedIntRange(2, 3)) - 2.700684314) < precision);
+    QVERIFY(fabs(x.totalInfo(ClosedIntRange(1, 3)) - x.totalInfo()) < precision);
+
+    // Test: empty distribution
+    InfoContentDistribution y(CharCountDistribution(), 4, false);
+    QCOMPARE(y.totalInfo(), 0.);
+}
+
 QTEST_APPLESS_MAIN(TestInfoContentDistribution)
 #include "TestInfoContentDistribution.moc"
@@ -133,6 +133,7 @@ void TestLiveInfoContentDistribution::dataChangedSignal()
     sourceDist.add(QByteArray("ACT"), '\0', 2);
     InfoContentDistribution y(sourceDist, 4, true);
     QVERIFY(isEqual(x.infoContent(), y.infoContent(), .00001));
+    QVERIFY(qAbs(x.totalInfo() - y.totalInfo()) < .00001);
 }
 
 void TestLiveInfoContentDistribution::columnsRemovedSignal()
@@ -152,6 +153,7 @@ void TestLiveInfoContentDistribution::columnsRemovedSignal()
     sourceDist.remove(5, 2);
     InfoContentDistribution y(sourceDist, 4, true);
     QVERIFY(isEqual(x.infoContent(), y.infoContent(), .00001));
+    QVERIFY(qAbs(x.totalInfo() - y.totalInfo()) < .00001);
 }
 
 void TestLiveInfoContentDistribution::columnsInsertedSignal()
@@ -171,6 +173,7 @@ void TestLiveInfoContentDistribution::columnsInsertedSignal()
     sourceDist.insertBlanks(3, 3);
     InfoContentDistribution y(sourceDist, 4, true);
     QVERIFY(isEqual(x.infoContent(), y.infoContent(), .00001));
+    QVERIFY(qAbs(x.totalInfo() - y.totalInfo()) < .00001);
 }
 
 QTEST_APPLESS_MAIN(TestLiveInfoContentDistribution)
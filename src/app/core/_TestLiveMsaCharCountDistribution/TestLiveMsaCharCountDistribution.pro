@@ -20,6 +20,8 @@ SOURCES += TestLiveMsaCharCountDistribution.cpp \
            ../Msa.cpp \
            ../UngappedSubseq.cpp \
            ../Subseq.cpp \
+           ../NonGapRunIndex.cpp \
+           ../SubseqChangeRecord.cpp \
            ../BioString.cpp \
            ../Seq.cpp \
            ../misc.cpp \
@@ -23,6 +23,8 @@ SOURCES += TestLiveSymbolString.cpp \
            ../Seq.cpp \
            ../UngappedSubseq.cpp \
            ../Subseq.cpp \
+           ../NonGapRunIndex.cpp \
+           ../SubseqChangeRecord.cpp \
            ../BioString.cpp \
            ../misc.cpp \
            ../constants.cpp \
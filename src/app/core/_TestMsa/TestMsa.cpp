@@ -9,6 +9,7 @@
 #include <QtTest/QtTest>
 
 #include "../Msa.h"
+#include "../SubseqChangeRecord.h"
 #include "../enums.h"
 #include "../global.h"
 
@@ -29,6 +30,7 @@ private slots:
     void at();
     void append_and_count();
     void append_grammar();      // Ensure that only sequences with the same grammar may be appended
+    void bulkEditsManyRows();   // Edits large enough to be split across threads must match editing each row singly
     void canCollapseLeft();
     void canCollapseRight();
     void canExtendLeft();
@@ -74,6 +76,7 @@ private slots:
     void removeRows();
     void removeGapColumns();
     void removeGapColumnsInRange();
+    void removeGapColumnsWide();
     void removeLast();
     void rightExtendableLength();
     void rightTrimmableLength();
@@ -99,6 +102,7 @@ private slots:
     void trimRight();
     void trimRightRowNumChars();
     void undo();
+    void undoSubseqChangeRecord();
 
 private:
     // Utility function for adding test rows for the slideRect test
@@ -332,6 +336,117 @@ void TestMsa::append_grammar()
     subseq2 = nullptr;
 }
 
+void TestMsa::bulkEditsManyRows()
+{
+    const int kRows = 256;
+    const int kColumns = 2048;
+
+    // Build two identical alignments: msa is edited in bulk and reference one row at a time
+    Msa msa;
+    Msa reference;
+    QVector<QByteArray> gappedRows;
+    for (int r=0; r< kRows; ++r)
+    {
+        QByteArray ungapped;
+        QByteArray gapped(r % 200, '-');
+        for (int i=0; i< 1200; ++i)
+        {
+            char ch = 'A' + (r * 7 + i * 13) % 26;
+            ungapped += ch;
+            gapped += ch;
+            if (i % (5 + r % 7) == 0)
+                gapped += '-';
+        }
+        gapped += QByteArray(kColumns - gapped.length(), '-');
+        gappedRows << gapped;
+
+        Seq seq(ungapped);
+        Subseq *subseq = new Subseq(seq);
+        QVERIFY(subseq->setBioString(gapped));
+        QVERIFY(msa.append(subseq));
+        Subseq *subseq2 = new Subseq(seq);
+        QVERIFY(subseq2->setBioString(gapped));
+        QVERIFY(reference.append(subseq2));
+    }
+    ClosedIntRange rows(1, kRows);
+
+    // ------------------------------------------------------------------------
+    // Test: insert and then remove gap columns
+    msa.insertGapColumns(100, 8);
+    for (int i=1; i<= kRows; ++i)
+    {
+        const QByteArray &gapped = gappedRows.at(i - 1);
+        QVERIFY(*msa.at(i) == BioString(gapped.left(99) + QByteArray(8, '-') + gapped.mid(99)));
+    }
+    QCOMPARE(msa.removeGapColumns(ClosedIntRange(100, 107)), QVector<ClosedIntRange>() << ClosedIntRange(100, 107));
+    for (int i=1; i<= kRows; ++i)
+        QVERIFY(*msa.at(i) == *reference.at(i));
+
+    // ------------------------------------------------------------------------
+    // Test: trim, extend, level, and collapse
+    SubseqChangePodVector pods;
+    SubseqChangePodVector expectedPods;
+
+    pods = msa.trimLeft(400, rows);
+    expectedPods.clear();
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.trimLeft(400, ClosedIntRange(i, i));
+    QVERIFY(pods.isEmpty() == false);
+    QVERIFY(pods == expectedPods);
+
+    pods = msa.trimRight(1200, rows);
+    expectedPods.clear();
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.trimRight(1200, ClosedIntRange(i, i));
+    QVERIFY(pods.isEmpty() == false);
+    QVERIFY(pods == expectedPods);
+
+    pods = msa.extendLeft(150, rows);
+    expectedPods.clear();
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.extendLeft(150, ClosedIntRange(i, i));
+    QVERIFY(pods.isEmpty() == false);
+    QVERIFY(pods == expectedPods);
+
+    pods = msa.extendRight(1500, rows);
+    expectedPods.clear();
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.extendRight(1500, ClosedIntRange(i, i));
+    QVERIFY(pods.isEmpty() == false);
+    QVERIFY(pods == expectedPods);
+
+    // Leveling trims all rows before extending any of them
+    pods = msa.levelLeft(300, rows);
+    expectedPods.clear();
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.trimLeft(299, ClosedIntRange(i, i));
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.extendLeft(300, ClosedIntRange(i, i));
+    QVERIFY(pods.isEmpty() == false);
+    QVERIFY(pods == expectedPods);
+
+    pods = msa.collapseLeft(PosiRect(500, 1, 600, kRows));
+    expectedPods.clear();
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.collapseLeft(PosiRect(500, i, 600, 1));
+    QVERIFY(pods.isEmpty() == false);
+    QVERIFY(pods == expectedPods);
+
+    pods = msa.collapseRight(PosiRect(700, 1, 600, kRows));
+    expectedPods.clear();
+    for (int i=1; i<= kRows; ++i)
+        expectedPods << reference.collapseRight(PosiRect(700, i, 600, 1));
+    QVERIFY(pods.isEmpty() == false);
+    QVERIFY(pods == expectedPods);
+
+    for (int i=1; i<= kRows; ++i)
+    {
+        QVERIFY(*msa.at(i) == *reference.at(i));
+        QCOMPARE(msa.at(i)->start(), reference.at(i)->start());
+        QCOMPARE(msa.at(i)->stop(), reference.at(i)->stop());
+    }
+}
+
 void TestMsa::canCollapseLeft()
 {
     Msa msa(eDnaGrammar);
@@ -2455,6 +2570,67 @@ void TestMsa::removeGapColumnsInRange()
     QVERIFY(*msa.at(3) == "GHIX");
 }
 
+void TestMsa::removeGapColumnsWide()
+{
+    // Alignments that span several vector widths exercise both the vectorized and trailing character paths
+    QByteArray ungapped1;
+    QByteArray ungapped2;
+    QByteArray gapped1;
+    QByteArray gapped2;
+    QByteArray expected1;
+    QByteArray expected2;
+    QVector<ClosedIntRange> expectedGapRanges;
+    for (int i=1; i<= 101; ++i)
+    {
+        char ch = 'A' + (i % 26);
+        if (i % 7 == 0 || (i > 40 && i <= 60))
+        {
+            // Gap column - alternate gap characters
+            gapped1 += (i % 2) ? '-' : '.';
+            gapped2 += (i % 3) ? '.' : '-';
+            if (expectedGapRanges.isEmpty() || expectedGapRanges.last().end_ != i - 1)
+                expectedGapRanges << ClosedIntRange(i, i);
+            else
+                ++expectedGapRanges.last().end_;
+        }
+        else if (i % 5 == 0)
+        {
+            // Only one row has a character
+            gapped1 += ch;
+            gapped2 += '-';
+            ungapped1 += ch;
+            expected1 += ch;
+            expected2 += '-';
+        }
+        else
+        {
+            gapped1 += ch;
+            gapped2 += ch;
+            ungapped1 += ch;
+            ungapped2 += ch;
+            expected1 += ch;
+            expected2 += ch;
+        }
+    }
+
+    Seq seq(ungapped1);
+    Subseq *subseq = new Subseq(seq);
+    QVERIFY(subseq->setBioString(gapped1));
+    Seq seq2(ungapped2);
+    Subseq *subseq2 = new Subseq(seq2);
+    QVERIFY(subseq2->setBioString(gapped2));
+
+    Msa msa;
+    QVERIFY(msa.append(subseq));
+    QVERIFY(msa.append(subseq2));
+
+    QVector<ClosedIntRange> removedGapRanges = msa.removeGapColumns();
+    QCOMPARE(removedGapRanges, expectedGapRanges);
+    QVERIFY(*msa.at(1) == expected1);
+    QVERIFY(*msa.at(2) == expected2);
+    QVERIFY(msa.removeGapColumns().isEmpty());
+}
+
 void TestMsa::removeLast()
 {
     Seq seq("ABCDEF");
@@ -3500,5 +3676,85 @@ void TestMsa::undo()
     }
 }
 
+// Helper function for undoSubseqChangeRecord
+static SubseqChangePodVector applySubseqChangeOperation(Msa &msa, int operation)
+{
+    ClosedIntRange rows(1, msa.rowCount());
+    switch (operation)
+    {
+    case 0:     return msa.trimLeft(9, rows);
+    case 1:     return msa.trimRight(8, rows);
+    case 2:     return msa.extendLeft(4, rows);
+    case 3:     return msa.extendRight(15, rows);
+    case 4:     return msa.levelLeft(6, rows);
+    case 5:     return msa.levelRight(12, rows);
+    case 6:     return msa.collapseLeft(PosiRect(3, 1, 12, msa.rowCount()));
+    case 7:     return msa.collapseRight(PosiRect(3, 1, 12, msa.rowCount()));
+
+    default:
+        return SubseqChangePodVector();
+    }
+}
+
+void TestMsa::undoSubseqChangeRecord()
+{
+    QVector<QByteArray> gappedRows;
+    gappedRows << "--ABC-DE--F-GH----"
+               << "-----IJ-K-LMN-----"
+               << "OP--Q.RS..T--UV-WX"
+               << "------------Y-----"
+               << "--Z-A-B-C-D-E-F---";
+    QByteArray flank(10, 'M');
+
+    Msa msa;
+    foreach (const QByteArray &gappedRow, gappedRows)
+    {
+        QByteArray ungapped = gappedRow;
+        ungapped.replace("-", "").replace(".", "");
+        Seq seq(flank + ungapped + flank);
+        Subseq *subseq = new Subseq(seq);
+        QVERIFY(subseq->setBioString(gappedRow));
+        QCOMPARE(subseq->start(), flank.length() + 1);
+        QVERIFY(msa.append(subseq));
+    }
+
+    for (int compress=0; compress< 2; ++compress)
+    {
+        for (int operation=0; operation< 8; ++operation)
+        {
+            SubseqChangePodVector pods = applySubseqChangeOperation(msa, operation);
+            QVERIFY(pods.isEmpty() == false);
+
+            SubseqChangeRecord record(pods);
+            QCOMPARE(record.isEmpty(), false);
+            QCOMPARE(record.size(), pods.size());
+            if (compress)
+            {
+                record.compress();
+                QVERIFY(record.isCompressed());
+            }
+
+            // Test: undoing the record restores the original rows
+            SubseqChangePodVector undonePods = msa.undo(record);
+            for (int i=1; i<= msa.rowCount(); ++i)
+                QVERIFY(*msa.at(i) == BioString(gappedRows.at(i - 1)));
+
+            // Test: and is identical to undoing the pods themselves
+            QVERIFY(applySubseqChangeOperation(msa, operation) == pods);
+            QVERIFY(msa.undo(pods) == undonePods);
+            for (int i=1; i<= msa.rowCount(); ++i)
+                QVERIFY(*msa.at(i) == BioString(gappedRows.at(i - 1)));
+        }
+    }
+
+    // Test: empty record and null pods
+    SubseqChangeRecord record;
+    QVERIFY(record.isEmpty());
+    QVERIFY(msa.undo(record).isEmpty());
+    record = SubseqChangeRecord(SubseqChangePodVector() << SubseqChangePod());
+    QVERIFY(record.isEmpty());
+    QVERIFY(msa.undo(record).isEmpty());
+}
+
 QTEST_APPLESS_MAIN(TestMsa)
 #include "TestMsa.moc"
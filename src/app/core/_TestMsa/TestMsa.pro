@@ -17,6 +17,8 @@ SOURCES += TestMsa.cpp \
            ../BioString.cpp \
            ../UngappedSubseq.cpp \
            ../Subseq.cpp \
+           ../NonGapRunIndex.cpp \
+           ../SubseqChangeRecord.cpp \
            ../Seq.cpp \
            ../constants.cpp \
            ../misc.cpp \
@@ -0,0 +1,298 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "../NonGapRunIndex.h"
+#include "../misc.h"
+
+class TestNonGapRunIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void constructor();
+    void rebuild_data();
+    void rebuild();
+    void positionOfNonGap();
+    void trimQueries();
+    void insertGaps_data();
+    void insertGaps();
+    void removeGaps_data();
+    void removeGaps();
+    void update_data();
+    void update();
+    void randomEdits();
+
+private:
+    // Compares every query of index against a scan of byteArray
+    void verifyIndex(const NonGapRunIndex &index, const QByteArray &byteArray);
+};
+
+Q_DECLARE_METATYPE(QVector<ClosedIntRange>)
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Actual test functions
+void TestNonGapRunIndex::constructor()
+{
+    NonGapRunIndex x;
+    QVERIFY(x.isValid() == false);
+    QCOMPARE(x.length(), 0);
+
+    x.rebuild("", 0);
+    QVERIFY(x.isValid());
+    QCOMPARE(x.length(), 0);
+    QCOMPARE(x.nonGaps(), 0);
+    QCOMPARE(x.headGaps(), 0);
+    QCOMPARE(x.tailGaps(), 0);
+
+    x.clear();
+    QVERIFY(x.isValid() == false);
+}
+
+void TestNonGapRunIndex::rebuild_data()
+{
+    QTest::addColumn<QByteArray>("byteArray");
+
+    QTest::newRow("single non-gap") << QByteArray("A");
+    QTest::newRow("single gap") << QByteArray("-");
+    QTest::newRow("all gaps") << QByteArray("-.--");
+    QTest::newRow("no gaps") << QByteArray("ABCDEF");
+    QTest::newRow("internal gaps") << QByteArray("AB----CD");
+    QTest::newRow("terminal gaps") << QByteArray("--A-B-CD--");
+    QTest::newRow("mixed gap characters") << QByteArray(".-AB.C--D-.E.");
+}
+
+void TestNonGapRunIndex::rebuild()
+{
+    QFETCH(QByteArray, byteArray);
+
+    NonGapRunIndex x;
+    x.rebuild(byteArray.constData(), byteArray.length());
+    verifyIndex(x, byteArray);
+}
+
+void TestNonGapRunIndex::positionOfNonGap()
+{
+    QByteArray byteArray("--A-BC---D-");
+    NonGapRunIndex x;
+    x.rebuild(byteArray.constData(), byteArray.length());
+
+    QCOMPARE(x.nonGaps(), 4);
+    QCOMPARE(x.positionOfNonGap(1), 3);
+    QCOMPARE(x.positionOfNonGap(2), 5);
+    QCOMPARE(x.positionOfNonGap(3), 6);
+    QCOMPARE(x.positionOfNonGap(4), 10);
+}
+
+void TestNonGapRunIndex::trimQueries()
+{
+    //                     12345678
+    QByteArray byteArray("-AB--C-D");
+    NonGapRunIndex x;
+    x.rebuild(byteArray.constData(), byteArray.length());
+
+    QCOMPARE(x.lastNonGapAtOrBefore(1), 0);
+    QCOMPARE(x.lastNonGapAtOrBefore(2), 2);
+    QCOMPARE(x.lastNonGapAtOrBefore(5), 3);
+    QCOMPARE(x.lastNonGapAtOrBefore(8), 8);
+
+    QCOMPARE(x.firstNonGapAtOrAfter(1), 2);
+    QCOMPARE(x.firstNonGapAtOrAfter(4), 6);
+    QCOMPARE(x.firstNonGapAtOrAfter(7), 8);
+    QCOMPARE(x.firstNonGapAtOrAfter(8), 8);
+
+    QByteArray trailingGaps("A--");
+    x.rebuild(trailingGaps.constData(), trailingGaps.length());
+    QCOMPARE(x.firstNonGapAtOrAfter(2), 0);
+}
+
+void TestNonGapRunIndex::insertGaps_data()
+{
+    QTest::addColumn<QByteArray>("byteArray");
+    QTest::addColumn<int>("position");
+    QTest::addColumn<int>("nGaps");
+
+    QTest::newRow("empty") << QByteArray() << 1 << 3;
+    QTest::newRow("before first run") << QByteArray("AB-C") << 1 << 2;
+    QTest::newRow("split run") << QByteArray("ABCD") << 3 << 2;
+    QTest::newRow("end of run") << QByteArray("AB-C") << 3 << 1;
+    QTest::newRow("within gaps") << QByteArray("A---C") << 3 << 4;
+    QTest::newRow("append") << QByteArray("A-C") << 4 << 2;
+    QTest::newRow("zero gaps") << QByteArray("ABC") << 2 << 0;
+}
+
+void TestNonGapRunIndex::insertGaps()
+{
+    QFETCH(QByteArray, byteArray);
+    QFETCH(int, position);
+    QFETCH(int, nGaps);
+
+    NonGapRunIndex x;
+    x.rebuild(byteArray.constData(), byteArray.length());
+
+    byteArray.insert(position - 1, QByteArray(nGaps, '-'));
+    x.insertGaps(position, nGaps);
+    verifyIndex(x, byteArray);
+}
+
+void TestNonGapRunIndex::removeGaps_data()
+{
+    QTest::addColumn<QByteArray>("byteArray");
+    QTest::addColumn<QVector<ClosedIntRange> >("gapRanges");
+
+    QTest::newRow("head gaps") << QByteArray("--AB") << (QVector<ClosedIntRange>() << ClosedIntRange(1, 2));
+    QTest::newRow("tail gaps") << QByteArray("AB--") << (QVector<ClosedIntRange>() << ClosedIntRange(3, 4));
+    QTest::newRow("merge runs") << QByteArray("AB--CD") << (QVector<ClosedIntRange>() << ClosedIntRange(3, 4));
+    QTest::newRow("partial run of gaps") << QByteArray("AB---CD") << (QVector<ClosedIntRange>() << ClosedIntRange(4, 5));
+    QTest::newRow("multiple") << QByteArray("-A--B.C--D-")
+                              << (QVector<ClosedIntRange>() << ClosedIntRange(1, 1)
+                                                            << ClosedIntRange(3, 4)
+                                                            << ClosedIntRange(6, 6)
+                                                            << ClosedIntRange(11, 11));
+}
+
+void TestNonGapRunIndex::removeGaps()
+{
+    QFETCH(QByteArray, byteArray);
+    QFETCH(QVector<ClosedIntRange>, gapRanges);
+
+    NonGapRunIndex x;
+    x.rebuild(byteArray.constData(), byteArray.length());
+
+    for (int i=gapRanges.size() - 1; i>=0; --i)
+        byteArray.remove(gapRanges.at(i).begin_ - 1, gapRanges.at(i).length());
+    x.removeGaps(gapRanges);
+    verifyIndex(x, byteArray);
+}
+
+void TestNonGapRunIndex::update_data()
+{
+    QTest::addColumn<QByteArray>("byteArray");
+    QTest::addColumn<int>("position");
+    QTest::addColumn<QByteArray>("replacement");
+
+    QTest::newRow("slide right") << QByteArray("-AB---C") << 2 << QByteArray("---AB");
+    QTest::newRow("slide left") << QByteArray("A---BC-") << 2 << QByteArray("BC---");
+    QTest::newRow("fill gaps joining runs") << QByteArray("AB--CD") << 3 << QByteArray("XY");
+    QTest::newRow("gap out run") << QByteArray("AB-CDE-F") << 4 << QByteArray("---");
+    QTest::newRow("extend head") << QByteArray("----AB") << 2 << QByteArray("XYZ");
+    QTest::newRow("trim tail") << QByteArray("AB-CDE") << 4 << QByteArray("---");
+    QTest::newRow("entire string") << QByteArray("A-B-C") << 1 << QByteArray("-ABC-");
+}
+
+void TestNonGapRunIndex::update()
+{
+    QFETCH(QByteArray, byteArray);
+    QFETCH(int, position);
+    QFETCH(QByteArray, replacement);
+
+    NonGapRunIndex x;
+    x.rebuild(byteArray.constData(), byteArray.length());
+
+    byteArray.replace(position - 1, replacement.length(), replacement);
+    x.update(byteArray.constData(), ClosedIntRange(position, position + replacement.length() - 1));
+    verifyIndex(x, byteArray);
+}
+
+void TestNonGapRunIndex::randomEdits()
+{
+    qsrand(1);
+    for (int i=0; i< 500; ++i)
+    {
+        QByteArray byteArray;
+        for (int j=0, z=qrand() % 30; j<z; ++j)
+            byteArray += (qrand() % 3 == 0) ? 'A' : '-';
+
+        NonGapRunIndex x;
+        x.rebuild(byteArray.constData(), byteArray.length());
+
+        for (int j=0; j< 20; ++j)
+        {
+            int length = byteArray.length();
+            int operation = qrand() % 3;
+            if (operation == 0)
+            {
+                int position = 1 + qrand() % (length + 1);
+                int nGaps = qrand() % 4;
+                byteArray.insert(position - 1, QByteArray(nGaps, '-'));
+                x.insertGaps(position, nGaps);
+            }
+            else if (operation == 1 && length > 0)
+            {
+                int position = 1 + qrand() % length;
+                if (::isGapCharacter(byteArray.at(position - 1)))
+                {
+                    byteArray.remove(position - 1, 1);
+                    x.removeGaps(QVector<ClosedIntRange>() << ClosedIntRange(position, position));
+                }
+            }
+            else if (length > 0)
+            {
+                ClosedIntRange range;
+                range.begin_ = 1 + qrand() % length;
+                range.end_ = range.begin_ + qrand() % (length - range.begin_ + 1);
+                for (int k=range.begin_; k<= range.end_; ++k)
+                    byteArray[k-1] = (qrand() % 3 == 0) ? 'A' : '-';
+                x.update(byteArray.constData(), range);
+            }
+
+            verifyIndex(x, byteArray);
+        }
+    }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Private helper functions
+void TestNonGapRunIndex::verifyIndex(const NonGapRunIndex &index, const QByteArray &byteArray)
+{
+    int length = byteArray.length();
+    QVERIFY(index.isValid());
+    QCOMPARE(index.length(), length);
+
+    int headGaps = 0;
+    while (headGaps < length && ::isGapCharacter(byteArray.at(headGaps)))
+        ++headGaps;
+    QCOMPARE(index.headGaps(), headGaps);
+
+    int tailGaps = 0;
+    while (tailGaps < length && ::isGapCharacter(byteArray.at(length - tailGaps - 1)))
+        ++tailGaps;
+    QCOMPARE(index.tailGaps(), tailGaps);
+
+    QCOMPARE(index.nonGapsUpTo(0), 0);
+    int nNonGaps = 0;
+    for (int i=1; i<= length; ++i)
+    {
+        bool isGap = ::isGapCharacter(byteArray.at(i-1));
+        if (!isGap)
+            ++nNonGaps;
+
+        QCOMPARE(index.hasGapAt(i), isGap);
+        QCOMPARE(index.nonGapsUpTo(i), nNonGaps);
+        if (!isGap)
+            QCOMPARE(index.positionOfNonGap(nNonGaps), i);
+
+        int gapsLeft = 0;
+        for (int j=i-1; j>= 1 && ::isGapCharacter(byteArray.at(j-1)); --j)
+            ++gapsLeft;
+        QCOMPARE(index.gapsLeftOf(i), gapsLeft);
+
+        int gapsRight = 0;
+        for (int j=i+1; j<= length && ::isGapCharacter(byteArray.at(j-1)); ++j)
+            ++gapsRight;
+        QCOMPARE(index.gapsRightOf(i), gapsRight);
+    }
+    QCOMPARE(index.nonGaps(), nNonGaps);
+}
+
+QTEST_APPLESS_MAIN(TestNonGapRunIndex)
+#include "TestNonGapRunIndex.moc"
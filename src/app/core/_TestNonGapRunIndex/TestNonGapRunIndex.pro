@@ -0,0 +1,20 @@
+# ----------------------------------------------------------
+# Test project file created with create_test_scaffold.pl (Mon Oct 24 10:12:31 2011)
+#
+# Copyright (C) 2011  Agile Genomics, LLC
+# All rights reserved.
+# ----------------------------------------------------------
+
+CONFIG += qtestlib debug
+QT -= gui
+TARGET = TestNonGapRunIndex
+DEPENDPATH += .
+INCLUDEPATH += .
+
+HEADERS += ../NonGapRunIndex.h
+SOURCES += TestNonGapRunIndex.cpp \
+           ../NonGapRunIndex.cpp \
+           ../misc.cpp \
+           ../constants.cpp
+
+DEFINES += TESTING
@@ -18,6 +18,8 @@ SOURCES += TestObservableMsa.cpp \
            ../BioString.cpp \
            ../UngappedSubseq.cpp \
            ../Subseq.cpp \
+           ../NonGapRunIndex.cpp \
+           ../SubseqChangeRecord.cpp \
            ../Seq.cpp \
            ../constants.cpp \
            ../misc.cpp
@@ -0,0 +1,205 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "../PackedDnaString.h"
+#include "../BioString.h"
+
+class TestPackedDnaString : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void constructor();
+    void toBioString_data();
+    void toBioString();
+    void at();
+    void complement_data();
+    void complement();
+    void reverseComplement_data();
+    void reverseComplement();
+    void countOnBothStrands();
+
+    void benchReverseComplement();
+};
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Actual test functions
+void TestPackedDnaString::constructor()
+{
+    PackedDnaString x;
+    QVERIFY(x.isEmpty());
+    QCOMPARE(x.length(), 0);
+    QCOMPARE(x.packedSize(), 0);
+    QCOMPARE(x.unpackedCount(), 0);
+    QCOMPARE(x.toBioString(), BioString(eDnaGrammar));
+
+    PackedDnaString x2((BioString()));
+    QVERIFY(x2.isEmpty());
+    QVERIFY(x2 == x);
+
+    PackedDnaString x3(BioString("ACGTA"));
+    QVERIFY(!x3.isEmpty());
+    QCOMPARE(x3.length(), 5);
+    QCOMPARE(x3.packedSize(), 2);
+    QCOMPARE(x3.unpackedCount(), 0);
+    QVERIFY(x3 != x);
+
+    PackedDnaString x4(BioString("ACGTN"));
+    QCOMPARE(x4.length(), 5);
+    QCOMPARE(x4.packedSize(), 2);
+    QCOMPARE(x4.unpackedCount(), 1);
+
+    // The slot of an unpacked character must not make it equal to a packed A
+    QVERIFY(x4 != x3);
+}
+
+void TestPackedDnaString::toBioString_data()
+{
+    QTest::addColumn<BioString>("bioString");
+
+    QTest::newRow("A") << BioString("A");
+    QTest::newRow("ACGTA") << BioString("ACGTA");
+    QTest::newRow("ACGTACGT") << BioString("ACGTACGT");
+    QTest::newRow("lower case") << BioString("acgTTg");
+    QTest::newRow("all iupac") << BioString("-ACMGRSVTWYHKDBN");
+    QTest::newRow("odd length iupac") << BioString("ACGTN");
+    QTest::newRow("gaps") << BioString("..AC--gt.");
+    QTest::newRow("non-dna") << BioString("ACGU*ACGX");
+}
+
+void TestPackedDnaString::toBioString()
+{
+    QFETCH(BioString, bioString);
+
+    QCOMPARE(PackedDnaString(bioString).toBioString(), BioString(bioString.asByteArray(), eDnaGrammar));
+}
+
+void TestPackedDnaString::at()
+{
+    BioString bioString = "ACGTTGCAA";
+    PackedDnaString x(bioString);
+    for (int i=1; i<= bioString.length(); ++i)
+        QCOMPARE(x.at(i), bioString.at(i));
+
+    bioString = "ACMGRSVTWYHKDBN-A.acgt*U";
+    PackedDnaString x2(bioString);
+    for (int i=1; i<= bioString.length(); ++i)
+        QCOMPARE(x2.at(i), bioString.at(i));
+}
+
+void TestPackedDnaString::complement_data()
+{
+    QTest::addColumn<BioString>("bioString");
+
+    QTest::newRow("empty") << BioString();
+    QTest::newRow("A") << BioString("A");
+    QTest::newRow("ACGTA") << BioString("ACGTA");
+    QTest::newRow("ACGTACGT") << BioString("ACGTACGT");
+    QTest::newRow("ACGTACGTC") << BioString("ACGTACGTC");
+    QTest::newRow("lower case") << BioString("acgtACGTa");
+    QTest::newRow("all iupac") << BioString("ACMGRSVTWYHKDBN");
+    QTest::newRow("iupac and gaps") << BioString("-ACMGRSVTWYHKDBN.");
+    QTest::newRow("non-dna") << BioString("ACGU*ACGX");
+}
+
+void TestPackedDnaString::complement()
+{
+    QFETCH(BioString, bioString);
+
+    BioString expected = BioString(bioString.asByteArray(), eDnaGrammar).complement();
+
+    PackedDnaString x(bioString);
+    QCOMPARE(x.complement().toBioString(), expected);
+    QVERIFY(x.complement() == PackedDnaString(expected));
+    QVERIFY(x.complement().complement() == x);
+}
+
+void TestPackedDnaString::reverseComplement_data()
+{
+    complement_data();
+}
+
+void TestPackedDnaString::reverseComplement()
+{
+    QFETCH(BioString, bioString);
+
+    BioString expected = BioString(bioString.asByteArray(), eDnaGrammar).reverseComplement();
+
+    PackedDnaString x(bioString);
+    QCOMPARE(x.reverseComplement().toBioString(), expected);
+    QVERIFY(x.reverseComplement().reverseComplement() == x);
+
+    // The packed bytes (including the padding) should be identical to packing the reverse complement directly
+    QVERIFY(x.reverseComplement() == PackedDnaString(expected));
+}
+
+void TestPackedDnaString::countOnBothStrands()
+{
+    PackedDnaString x;
+    QVERIFY(x.countOnBothStrands(QVector<BioString>()).isEmpty());
+    QCOMPARE(x.countOnBothStrands(QVector<BioString>() << "A"), QVector<int>() << 0);
+
+    // Every kmer of every length should match the overlapping counts in both strands
+    BioString bioString = "ACGTTGCANACGTTacgGGCCAATTGCA-TGCAACGT";
+    BioString reverseComplement = bioString.reverseComplement();
+    PackedDnaString x2(bioString);
+    for (int k=1; k<= 10; ++k)
+    {
+        QVector<BioString> kmers;
+        for (int i=1; i<= bioString.length() - k + 1; ++i)
+            kmers << bioString.mid(i, k);
+        // A kmer that is not taken from the sequence
+        kmers << BioString(QByteArray(k, 'T'));
+
+        QVector<int> counts = x2.countOnBothStrands(kmers);
+        QCOMPARE(counts.size(), kmers.size());
+        for (int i=0; i< kmers.size(); ++i)
+        {
+            // Kmers with characters other than A, C, G, and T are never counted
+            int expected = 0;
+            if (!kmers.at(i).asByteArray().contains('N') &&
+                !kmers.at(i).asByteArray().contains('-') &&
+                kmers.at(i).asByteArray().toUpper() == kmers.at(i).asByteArray())
+            {
+                expected = bioString.count(kmers.at(i)) + reverseComplement.count(kmers.at(i));
+            }
+            QCOMPARE(counts.at(i), expected);
+        }
+    }
+
+    // Palindromes are counted once per strand
+    PackedDnaString x3(BioString("GAATTCC"));
+    QCOMPARE(x3.countOnBothStrands(QVector<BioString>() << "GAATTC" << "AATT" << "TTCC" << "GGAA"),
+             QVector<int>() << 2 << 2 << 1 << 1);
+
+    // Longest kmer
+    BioString longest = "ACGTACGTTGCAACGTACGTTGCAACGTACGG";
+    QCOMPARE(longest.length(), PackedDnaString::kMaxKmerLength);
+    PackedDnaString x4(BioString(longest.asByteArray() + "A"));
+    QCOMPARE(x4.countOnBothStrands(QVector<BioString>() << longest), QVector<int>() << 1);
+}
+
+void TestPackedDnaString::benchReverseComplement()
+{
+    QByteArray characters = "ACGT";
+    QByteArray sequence;
+    sequence.reserve(1000001);
+    for (int i=0; i< 1000001; ++i)
+        sequence += characters.at(i % 7 % 4);
+
+    PackedDnaString x((BioString(sequence)));
+    QBENCHMARK {
+        x.reverseComplement();
+    }
+}
+
+QTEST_APPLESS_MAIN(TestPackedDnaString)
+#include "TestPackedDnaString.moc"
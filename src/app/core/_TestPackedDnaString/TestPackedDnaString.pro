@@ -0,0 +1,21 @@
+# ----------------------------------------------------------
+# Test project file created with create_test_scaffold.pl (Tue Oct 18 15:20:07 2011)
+#
+# Copyright (C) 2011  Agile Genomics, LLC
+# All rights reserved.
+# ----------------------------------------------------------
+
+CONFIG += qtestlib debug
+QT -= gui
+TARGET = TestPackedDnaString
+DEPENDPATH += .
+INCLUDEPATH += .
+
+HEADERS += ../PackedDnaString.h
+SOURCES += TestPackedDnaString.cpp \
+           ../PackedDnaString.cpp \
+           ../BioString.cpp \
+           ../constants.cpp \
+           ../misc.cpp
+
+DEFINES += TESTING
@@ -18,6 +18,8 @@ private slots:
     void constructor_BioString();
     void constructor_strGram();
     void constructor_byteGram();
+    void digest();
+    void clear();
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -61,5 +63,34 @@ void TestSeq::constructor_byteGram()
     QCOMPARE(seq2.constData(), "123");
 }
 
+void TestSeq::digest()
+{
+    Seq seq("ABC--DEF", eAminoGrammar);
+    QCOMPARE(seq.digest(), BioString("ABCDEF").digest());
+
+    // Test: cached value is returned for subsequent calls and travels with copies
+    QCOMPARE(seq.digest(), BioString("ABCDEF").digest());
+    Seq seq2 = seq;
+    QCOMPARE(seq2.digest(), seq.digest());
+
+    // Test: assignment replaces the cached digest
+    seq2 = Seq("GHI");
+    QCOMPARE(seq2.digest(), BioString("GHI").digest());
+    QCOMPARE(seq.digest(), BioString("ABCDEF").digest());
+
+    // Test: empty sequence
+    QCOMPARE(Seq().digest(), BioString().digest());
+}
+
+void TestSeq::clear()
+{
+    Seq seq("ABCDEF");
+    QByteArray digest = seq.digest();
+    seq.clear();
+    QVERIFY(seq.isEmpty());
+    QVERIFY(seq.digest() != digest);
+    QCOMPARE(seq.digest(), BioString().digest());
+}
+
 QTEST_APPLESS_MAIN(TestSeq)
 #include "TestSeq.moc"
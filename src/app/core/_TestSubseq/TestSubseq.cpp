@@ -41,17 +41,22 @@ private slots:
     void extendRight_simpleExtension();
     void extendRight_intClosedIntRange_data();
     void extendRight_intClosedIntRange();
+    void gapRunEncoding_data();
+    void gapRunEncoding();          // Also tests setGapRunEncoding
     void leftRightUnusedLength();
     void leftTrimRange();
     void moveStart();
     void moveStop();
     void mapToSeq();
+    void mapToSeqAfterEdits();      // Verifies that the gap index is kept current
     void rearrange();
     void replace_intint();
     void replace_range();
     void rightTrimRange();
     void setBioString_data();
     void setBioString();
+    void setGapRunEncoding_invalid_data();
+    void setGapRunEncoding_invalid();
     void setStart();
     void setStop();
     void trimLeft();
@@ -356,6 +361,38 @@ void TestSubseq::extendRight_intClosedIntRange()
     QCOMPARE(subseq.stop(), expectedStop);
 }
 
+void TestSubseq::gapRunEncoding_data()
+{
+    QTest::addColumn<QByteArray>("parentSeq");
+    QTest::addColumn<QByteArray>("gappedSequence");
+
+    QTest::newRow("single residue") << QByteArray("ABCDEF") << QByteArray("A");
+    QTest::newRow("exact parent sequence") << QByteArray("ABCDEF") << QByteArray("ABCDEF");
+    QTest::newRow("leading and trailing gaps") << QByteArray("ABCDEF") << QByteArray("----BCD--");
+    QTest::newRow("mixed gap characters") << QByteArray("ABCDEF") << QByteArray("..-C--D.E-..F");
+    QTest::newRow("interior gaps") << QByteArray("ABCDEF") << QByteArray("B-C--D---E");
+    QTest::newRow("long gap run") << QByteArray("ABCDEF") << QByteArray(300, '-') + "EF" + QByteArray(1000, '.');
+}
+
+void TestSubseq::gapRunEncoding()
+{
+    QFETCH(QByteArray, parentSeq);
+    QFETCH(QByteArray, gappedSequence);
+
+    Seq parent(parentSeq, eAminoGrammar);
+    Subseq subseq(parent);
+    QVERIFY(subseq.setBioString(gappedSequence));
+
+    QByteArray encoding = subseq.gapRunEncoding();
+    Subseq subseq2(parent);
+    QVERIFY(subseq2.setGapRunEncoding(encoding));
+    QVERIFY(subseq2 == subseq);
+    QCOMPARE(subseq2.start(), subseq.start());
+    QCOMPARE(subseq2.stop(), subseq.stop());
+    QCOMPARE(subseq2.grammar(), eAminoGrammar);
+    QCOMPARE(subseq2.gapRunEncoding(), encoding);
+}
+
 void TestSubseq::leftRightUnusedLength()
 {
     Subseq subseq(Seq("ABCDEFG"));
@@ -546,6 +583,68 @@ void TestSubseq::mapToSeq()
     QCOMPARE(subseq.mapToSeq(11), -1);
 }
 
+void TestSubseq::mapToSeqAfterEdits()
+{
+    //                 1234567
+    Subseq subseq(Seq("ABCDEFG"));
+    //                           12345678901
+    QVERIFY(subseq.setBioString("--CD-EF-G--"));
+    QCOMPARE(subseq.mapToSeq(3), 3);        // Builds the gap index
+
+    // Split the CD run
+    subseq.insertGaps(4, 2, '-');
+    QVERIFY(subseq == "--C--D-EF-G--");
+    QCOMPARE(subseq.mapToSeq(3), 3);
+    QCOMPARE(subseq.mapToSeq(4), -1);
+    QCOMPARE(subseq.mapToSeq(6), 4);
+    QCOMPARE(subseq.gapsLeftOf(6), 2);
+    QCOMPARE(subseq.nonGapsBetween(ClosedIntRange(1, 9)), 4);
+
+    // Join the D and EF runs
+    subseq.removeGaps(7, 1);
+    QVERIFY(subseq == "--C--DEF-G--");
+    QCOMPARE(subseq.mapToSeq(7), 5);
+    QCOMPARE(subseq.gapsRightOf(8), 1);
+
+    subseq.removeGaps(QVector<ClosedIntRange>() << ClosedIntRange(1, 1) << ClosedIntRange(4, 5));
+    QVERIFY(subseq == "-CDEF-G--");
+    QCOMPARE(subseq.headGaps(), 1);
+    QCOMPARE(subseq.mapToSeq(3), 4);
+    QCOMPARE(subseq.mapToSeq(7), 7);
+
+    QCOMPARE(subseq.slide(ClosedIntRange(2, 5), -1), -1);
+    QVERIFY(subseq == "CDEF--G--");
+    QCOMPARE(subseq.headGaps(), 0);
+    QCOMPARE(subseq.mapToSeq(1), 3);
+    QCOMPARE(subseq.mapToSeq(6), -1);
+
+    QCOMPARE(subseq.collapseRight(ClosedIntRange(1, 7)), ClosedIntRange(1, 6));
+    QVERIFY(subseq == "--CDEFG--");
+    QCOMPARE(subseq.gapsLeftOf(3), 2);
+    QCOMPARE(subseq.mapToSeq(7), 7);
+
+    subseq.extendLeft(1, ClosedIntRange(1, 2));
+    QVERIFY(subseq == "ABCDEFG--");
+    QCOMPARE(subseq.mapToSeq(1), 1);
+    QCOMPARE(subseq.mapToSeq(7), 7);
+    QCOMPARE(subseq.tailGaps(), 2);
+
+    subseq.trimRight(ClosedIntRange(6, 7));
+    QVERIFY(subseq == "ABCDE----");
+    QCOMPARE(subseq.tailGaps(), 4);
+    QCOMPARE(subseq.rightTrimRange(3), ClosedIntRange(3, 5));
+    QCOMPARE(subseq.leftTrimRange(9), ClosedIntRange(1, 4));
+
+    subseq.rearrange(ClosedIntRange(1, 6), "A-BCDE");
+    QVERIFY(subseq == "A-BCDE---");
+    QCOMPARE(subseq.mapToSeq(3), 2);
+
+    subseq.setStart(2);
+    QVERIFY(subseq == "--BCDE---");
+    QCOMPARE(subseq.headGaps(), 2);
+    QCOMPARE(subseq.mapToSeq(3), 2);
+}
+
 void TestSubseq::rearrange()
 {
     Subseq subseq(Seq("ABCDEF"));
@@ -886,6 +985,42 @@ void TestSubseq::setBioString()
     }
 }
 
+void TestSubseq::setGapRunEncoding_invalid_data()
+{
+    QTest::addColumn<QByteArray>("encoding");
+
+    // Bytes: start, stop, number of gap runs, [residues before run, run length, gap character]...
+    QTest::newRow("empty") << QByteArray();
+    QTest::newRow("truncated header") << QByteArray("\x01\x02", 2);
+    QTest::newRow("start of zero") << QByteArray("\x00\x02\x00", 3);
+    QTest::newRow("stop before start") << QByteArray("\x03\x02\x00", 3);
+    QTest::newRow("stop beyond parent") << QByteArray("\x01\x07\x00", 3);
+    QTest::newRow("truncated run") << QByteArray("\x01\x02\x01\x01\x02", 5);
+    QTest::newRow("zero length run") << QByteArray("\x01\x02\x01\x01\x00-", 6);
+    QTest::newRow("non-gap run character") << QByteArray("\x01\x02\x01\x01\x02X", 6);
+    QTest::newRow("too many residues before run") << QByteArray("\x01\x02\x01\x03\x02-", 6);
+    QTest::newRow("trailing bytes") << QByteArray("\x01\x02\x01\x01\x02-\x00", 7);
+    QTest::newRow("unterminated varint") << QByteArray("\x81\x82", 2);
+    QTest::newRow("varint overflow") << QByteArray("\xFF\xFF\xFF\xFF\x7F\x02\x00", 7);
+}
+
+void TestSubseq::setGapRunEncoding_invalid()
+{
+    QFETCH(QByteArray, encoding);
+
+    Subseq subseq(Seq("ABCDEF"));
+    QVERIFY(subseq.setBioString("-BC-"));
+
+    QCOMPARE(subseq.setGapRunEncoding(encoding), false);
+    QVERIFY(subseq == "-BC-");
+    QCOMPARE(subseq.start(), 2);
+    QCOMPARE(subseq.stop(), 3);
+
+    // Sanity check that the valid version of the above encodings is accepted
+    QVERIFY(subseq.setGapRunEncoding(QByteArray("\x01\x02\x01\x01\x02-", 6)));
+    QVERIFY(subseq == "A--B");
+}
+
 void TestSubseq::setStart()
 {
     Subseq subseq(Seq("ABCDEF"));
@@ -15,6 +15,7 @@ HEADERS += ../Subseq.h
 SOURCES += TestSubseq.cpp \
            ../UngappedSubseq.cpp \
            ../Subseq.cpp \
+           ../NonGapRunIndex.cpp \
            ../Seq.cpp \
            ../BioString.cpp \
            ../misc.cpp \
@@ -27,6 +27,8 @@ private slots:
     void divideVectorHashCharInt_data();
     void divideVectorHashCharInt();
     void floorPoint();
+    void hash128_data();
+    void hash128();
     void round();
 };
 
@@ -173,6 +175,29 @@ void Testmisc::floorPoint()
     QCOMPARE(::floorPoint(QPointF(10.9, 10.9)), QPoint(10, 10));
 }
 
+void Testmisc::hash128_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("expectedHex");
+
+    // Reference values from the canonical MurmurHash3_x64_128 implementation (seed = 0)
+    QTest::newRow("empty") << QByteArray() << QByteArray("00000000000000000000000000000000");
+    QTest::newRow("hello") << QByteArray("hello") << QByteArray("029bbd41b3a7d8cb191dae486a901e5b");
+    QTest::newRow("quick brown fox") << QByteArray("The quick brown fox jumps over the lazy dog")
+                                     << QByteArray("6c1b07bc7bbc4be347939ac4a93c437a");
+    QTest::newRow("17 characters") << QByteArray("ABCDEFGHIJKLMNOPQ") << QByteArray("11b27afd6a88f4993305ba76f9c2f610");
+}
+
+void Testmisc::hash128()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, expectedHex);
+
+    QByteArray digest = ::hash128(data.constData(), data.length());
+    QCOMPARE(digest.length(), 16);
+    QCOMPARE(digest.toHex(), expectedHex);
+}
+
 void Testmisc::round()
 {
     QVERIFY(qFuzzyCompare(::round(5.4, 0), 5.));
@@ -36,6 +36,8 @@ namespace constants
 
     const int kParserStreamingBufferSize = 8192;
 
+    const int kRepositoryCacheLimit = 10000;
+
     const char kDefaultAnyCharacter = 'X';
 
     const char kDnaAnyCharacter = 'N';
@@ -30,6 +30,9 @@ namespace constants
 
     extern const int kParserStreamingBufferSize;
 
+    // Maximum number of entities each sequence repository caches before evicting the least recently used
+    extern const int kRepositoryCacheLimit;
+
     // Various character sets associated with each macromolecule type
     extern const char kDefaultAnyCharacter;
 
@@ -0,0 +1,41 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef CANCELEDERROR_H
+#define CANCELEDERROR_H
+
+#include "Exception.h"
+
+/**
+  * CanceledError is thrown to unwind a long running operation (e.g. parsing a file) that has been canceled by the user.
+  * It does not indicate a failure and thus should not be reported as such.
+  */
+class CanceledError : public Exception
+{
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    virtual const QString what() const;     //!< Returns a constant message stating that the operation was canceled
+};
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  * Not capable of throwing any exceptions.
+  *
+  * @returns const QString
+  */
+inline
+const QString CanceledError::what() const
+{
+    return "The operation was canceled";
+}
+
+#endif // CANCELEDERROR_H
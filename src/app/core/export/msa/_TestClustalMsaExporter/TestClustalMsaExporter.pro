@@ -36,6 +36,8 @@ SOURCES += TestClustalMsaExporter.cpp \
     ../../../misc.cpp \
     ../../../UngappedSubseq.cpp \
     ../../../Subseq.cpp \
+    ../../../NonGapRunIndex.cpp \
+    ../../../SubseqChangeRecord.cpp \
     ../../../BioString.cpp \
     ../../../Entities/AminoMsa.cpp \
     ../../../Entities/AminoSeq.cpp \
@@ -35,6 +35,8 @@ SOURCES += TestFastaMsaExporter.cpp \
     ../../../misc.cpp \
     ../../../UngappedSubseq.cpp \
     ../../../Subseq.cpp \
+    ../../../NonGapRunIndex.cpp \
+    ../../../SubseqChangeRecord.cpp \
     ../../../BioString.cpp \
     ../../../Entities/AminoMsa.cpp \
     ../../../Entities/AminoSeq.cpp \
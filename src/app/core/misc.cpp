@@ -10,6 +10,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QIODevice>
+#include <QtCore/QtGlobal>
 
 #include <cmath>        // For the floor function
 #include <locale>       // For the isspace function
@@ -19,6 +20,101 @@
 #include "misc.h"
 
 
+/**
+  * @param x [quint64]
+  * @param r [int]
+  * @returns quint64
+  */
+static inline quint64 rotl64(quint64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+/**
+  * @param k [quint64]
+  * @returns quint64
+  */
+static inline quint64 fmix64(quint64 k)
+{
+    k ^= k >> 33;
+    k *= Q_UINT64_C(0xff51afd7ed558ccd);
+    k ^= k >> 33;
+    k *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    k ^= k >> 33;
+
+    return k;
+}
+
+/**
+  * Reads the 8 bytes at x as a little-endian 64-bit integer.
+  *
+  * @param x [const uchar *]
+  * @returns quint64
+  */
+static inline quint64 readLittleEndian64(const uchar *x)
+{
+    quint64 value = 0;
+    for (int i=7; i>=0; --i)
+        value = (value << 8) | x[i];
+
+    return value;
+}
+
+/**
+  * The complement rules are those documented in BioString::complement.
+  */
+CharacterTables::CharacterTables()
+{
+    static const char kDnaCharacters[] = "ABCDGHKMTVabcdghkmtv";
+    static const char kDnaComplements[] = "TVGHCDMKABtvghcdmkab";
+
+    for (int i=0; i< 256; ++i)
+    {
+        complement_[i] = static_cast<unsigned char>(i);
+        isGap_[i] = false;
+        gapMask_[i] = 0;
+    }
+
+    for (int i=0; kDnaCharacters[i]; ++i)
+        complement_[static_cast<unsigned char>(kDnaCharacters[i])] = static_cast<unsigned char>(kDnaComplements[i]);
+
+    for (const char *x = constants::kGapCharacters; *x; ++x)
+    {
+        isGap_[static_cast<unsigned char>(*x)] = true;
+        gapMask_[static_cast<unsigned char>(*x)] = static_cast<char>(0xFF);
+    }
+}
+
+/**
+  * Constructs the shared character tables during static initialization (i.e. before any other thread may be started)
+  * so that they are never built concurrently, even by compilers that do not initialize local statics thread-safely.
+  *
+  * @returns int
+  */
+static int initializeCharacterTables()
+{
+    characterTables();
+    return 0;
+}
+Q_CONSTRUCTOR_FUNCTION(initializeCharacterTables)
+
+
+/**
+  * Appends value to byteArray as an unsigned LEB128 varint (7 bits per byte, least significant group first).
+  *
+  * @param byteArray [QByteArray &]
+  * @param value [quint32]
+  */
+void appendVarint(QByteArray &byteArray, quint32 value)
+{
+    while (value >= 0x80)
+    {
+        byteArray.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    byteArray.append(static_cast<char>(value));
+}
+
 /**
   * Sorts and combines a vector of integers into ranges. Two or more integers that differ by 1 from the previous or
   * next integer in the vector will be combined into a pair with the first number the minimum value and the second
@@ -74,6 +170,15 @@ QVector<ClosedIntRange> convertIntVectorToClosedIntRanges(QVector<int> intVector
     return ranges;
 }
 
+/**
+  * @returns const CharacterTables &
+  */
+const CharacterTables &characterTables()
+{
+    static const CharacterTables tables;
+    return tables;
+}
+
 
 /**
   * @param vectorHashCharInt [const VectorHashCharInt &]
@@ -183,21 +288,89 @@ QString formatTimeRunning(const int seconds)
 }
 
 /**
-  * @param ch [char]
-  * @returns bool
+  * Implementation of the public domain MurmurHash3 (x64, 128-bit variant) by Austin Appleby with a seed of zero. The
+  * result is the two 64-bit hash words serialized in little-endian order, which gives the same 16 bytes on every
+  * platform and thus may be persisted.
+  *
+  * Unlike cryptographic digests such as MD5, this is not designed to resist deliberately constructed collisions;
+  * however, it processes 16 bytes per iteration with a handful of multiplies and rotates, which is many times faster.
+  *
+  * @param data [const char *]
+  * @param length [int]
+  * @returns QByteArray
   */
-bool isGapCharacter(char ch)
+QByteArray hash128(const char *data, int length)
 {
-    const char *x = constants::kGapCharacters;
-    while (*x)
+    ASSERT(length >= 0);
+    ASSERT(data || length == 0);
+
+    const quint64 c1 = Q_UINT64_C(0x87c37b91114253d5);
+    const quint64 c2 = Q_UINT64_C(0x4cf5ad432745937f);
+
+    const uchar *x = reinterpret_cast<const uchar *>(data);
+    int nBlocks = length / 16;
+
+    quint64 h1 = 0;
+    quint64 h2 = 0;
+    for (int i=0; i< nBlocks; ++i, x += 16)
     {
-        if (*x == ch)
-            return true;
+        quint64 k1 = readLittleEndian64(x);
+        quint64 k2 = readLittleEndian64(x + 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
 
-        ++x;
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
     }
 
-    return false;
+    // Tail
+    quint64 k1 = 0;
+    quint64 k2 = 0;
+    int nTail = length & 15;
+    for (int i=nTail - 1; i>= 8; --i)
+        k2 = (k2 << 8) | x[i];
+    if (nTail > 8)
+    {
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+    }
+    for (int i=qMin(nTail, 8) - 1; i>= 0; --i)
+        k1 = (k1 << 8) | x[i];
+    if (nTail > 0)
+    {
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    // Finalization
+    h1 ^= static_cast<quint64>(length);
+    h2 ^= static_cast<quint64>(length);
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    QByteArray digest(16, '\0');
+    for (int i=0; i< 8; ++i)
+    {
+        digest[i] = static_cast<char>(h1 >> (8 * i));
+        digest[i + 8] = static_cast<char>(h2 >> (8 * i));
+    }
+
+    return digest;
+}
+
+/**
+  * @param ch [char]
+  * @returns bool
+  */
+bool isGapCharacter(char ch)
+{
+    return characterTables().isGap_[static_cast<unsigned char>(ch)];
 }
 
 /**
@@ -214,6 +387,32 @@ int randomInteger(int minimum, int maximum)
     return qrand() % ((maximum + 1) - minimum) + minimum;
 }
 
+/**
+  * Reads an unsigned LEB128 varint beginning at x into value and advances x past it. Returns false if the data ends
+  * before the varint is complete or the varint does not fit within 32 bits.
+  *
+  * @param x [const unsigned char *&]
+  * @param end [const unsigned char *]
+  * @param value [quint32 &]
+  * @returns bool
+  */
+bool readVarint(const unsigned char *&x, const unsigned char *end, quint32 &value)
+{
+    value = 0;
+    for (int shift = 0; x < end && shift < 35; shift += 7)
+    {
+        unsigned char byte = *x++;
+        if (shift == 28 && byte > 0x0F)
+            return false;
+
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+
+    return false;
+}
+
 /**
   * @param byteArray [QByteArray &]
   */
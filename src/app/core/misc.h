@@ -20,15 +20,34 @@
 class QByteArray;
 class QDataStream;
 
+/**
+  * CharacterTables contains 256-entry lookup tables indexed by unsigned character value. The single shared instance
+  * returned by characterTables() is fully built by its constructor before it is first returned.
+  */
+struct CharacterTables
+{
+    CharacterTables();
+
+    unsigned char complement_[256];     //!< DNA character (either case) -> its complement; all others map to themselves
+    bool isGap_[256];                   //!< True for each gap character; false otherwise
+    char gapMask_[256];                 //!< 0xFF for each gap character; zero otherwise
+};
+
+void appendVarint(QByteArray &byteArray, quint32 value);  //!< Appends value to byteArray as an unsigned LEB128 varint
 //! Converts a vector of integers into a vector of pair's of integers describing their ranges
 QVector<QPair<int, int> > convertIntVectorToRanges(QVector<int> intVector);
 QVector<ClosedIntRange> convertIntVectorToClosedIntRanges(QVector<int> intVector);
+const CharacterTables &characterTables();               //!< Returns the shared character lookup tables
 //! Iterates through all values in vectorHashCharInt, divides them by divisor, and returns the resulting dividend set; divisor must not be zero
 VectorHashCharDouble divideVectorHashCharInt(const VectorHashCharInt &vectorHashCharInt, int divisor);
 QPoint floorPoint(const QPointF &point);                //!< Converts the floating point, point, to a QPoint by flooring its x and y values
 QString formatTimeRunning(const int seconds);           //!< Converts a number of seconds into a corresponding time string showing days, hours, minutes, and seconds in a human friendly manner
+//! Returns the 16-byte, non-cryptographic MurmurHash3 (x64, 128-bit) digest of the first length bytes of data
+QByteArray hash128(const char *data, int length);
 bool isGapCharacter(char ch);                           //!< Returns true if ch is a gap character; false otherwise
 int randomInteger(int minimum, int maximum);            //!< Returns a random integer between minimum and maximum inclusive
+//! Reads an unsigned LEB128 varint beginning at x into value and advances x past it; returns false if it is incomplete or exceeds 32 bits
+bool readVarint(const unsigned char *&x, const unsigned char *end, quint32 &value);
 void removeWhiteSpace(QByteArray &byteArray);           //!< Removes all whitespace from byteArray
 void removeWhiteSpace(QString &string);                 //!< Removes all whitespace from string
 double round(const double value, const int decimals);   //!< Rounds value with decimals remaining
@@ -6,12 +6,66 @@
 **
 ****************************************************************************/
 
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
 #include "MsaAlgorithms.h"
 
 #include "../Msa.h"
 #include "../macros.h"
 #include "../misc.h"
 
+// Regions with fewer cells than this are counted serially because the threading overhead would dominate
+static const int kMinimumParallelCells = 1 << 18;
+// Minimum number of columns assigned to each task
+static const int kMinimumTileWidth = 32;
+
+/**
+  * Counts the characters of a vertical tile of the msa into a dense histogram of 256 counts per column and stores the
+  * non-gap counts directly in the corresponding columns of the output distribution.
+  *
+  * Each task writes to a distinct range of pre-allocated output columns, so no locking is necessary. The semaphore is
+  * released once the task has finished.
+  */
+class CharCountTileTask : public QRunnable
+{
+public:
+    CharCountTileTask(const Msa &msa, const ClosedIntRange &rows, const ClosedIntRange &columns, int outputOffset,
+                      CharCountDistribution *output, QSemaphore *semaphore)
+        : msa_(msa), rows_(rows), columns_(columns), outputOffset_(outputOffset), output_(output), semaphore_(semaphore)
+    {
+    }
+
+    void run()
+    {
+        int w = columns_.length();
+        QVector<int> counts(w * 256, 0);
+        int *histogram = counts.data();
+
+        for (int i=rows_.begin_; i<= rows_.end_; ++i)
+        {
+            const unsigned char *x = reinterpret_cast<const unsigned char *>(msa_.at(i)->constData()) + columns_.begin_ - 1;
+            for (int k=0; k< w; ++k, ++x)
+                ++histogram[k * 256 + *x];
+        }
+
+        for (int k=0; k< w; ++k)
+            output_->setColumnHistogram(outputOffset_ + k + 1, histogram + k * 256);
+
+        semaphore_->release();
+    }
+
+private:
+    const Msa &msa_;
+    ClosedIntRange rows_;
+    ClosedIntRange columns_;
+    int outputOffset_;
+    CharCountDistribution *output_;
+    QSemaphore *semaphore_;
+};
+
 /**
   * If msaRect is null, then the distribution is computed for the entire msa. If region is non null, then it must be
   * valid, non-empty, and its values must fall within the boundaries of msa. Moreover, because Msa is a 1-based entity,
@@ -57,3 +111,60 @@ CharCountDistribution calculateMsaCharCountDistribution(const Msa &msa, const Po
 
     return CharCountDistribution(charCounts, targetRect.height());
 }
+
+/**
+  * Computes the same distribution as calculateMsaCharCountDistribution, but splits msaRect into vertical tiles (column
+  * ranges spanning all rows of msaRect) that are counted concurrently in the global QThreadPool. Because each tile
+  * covers distinct columns, the per-thread histograms reduce directly into disjoint columns of the result and no
+  * further merging is required.
+  *
+  * Small regions (or a maxThreads of 1) are simply counted serially. This function blocks until all tiles have been
+  * counted and msa must not be modified in the meantime.
+  *
+  * @param msa [const Msa &]
+  * @param msaRect [const PosiRect &]
+  * @param maxThreads [int]
+  * @returns CharCountDistribution
+  */
+CharCountDistribution calculateMsaCharCountDistributionParallel(const Msa &msa, const PosiRect &msaRect, int maxThreads)
+{
+    if (msa.isEmpty())
+        return CharCountDistribution();
+
+    PosiRect targetRect = msaRect.normalized();
+    if (targetRect.isNull())
+        targetRect = PosiRect(1, 1, msa.length(), msa.rowCount());
+
+    ASSERT(targetRect.isValid());
+    ASSERT(targetRect.left() > 0);
+    ASSERT(targetRect.top() > 0);
+    ASSERT(targetRect.right() <= msa.length());
+    ASSERT(targetRect.bottom() <= msa.subseqCount());
+
+    int nThreads = (maxThreads > 0) ? maxThreads : QThread::idealThreadCount();
+    int w = targetRect.width();
+    int h = targetRect.height();
+    if (nThreads <= 1 || w < 2 * kMinimumTileWidth || static_cast<qint64>(w) * h < kMinimumParallelCells)
+        return calculateMsaCharCountDistribution(msa, targetRect);
+
+    // Several tiles per thread helps balance the load between threads
+    int nTiles = qMin(nThreads * 4, w / kMinimumTileWidth);
+    int tileWidth = (w + nTiles - 1) / nTiles;
+
+    CharCountDistribution charCountDistribution(VectorHashCharInt(w), h);
+    QSemaphore semaphore;
+    int nTasks = 0;
+    for (int left=targetRect.left(); left<= targetRect.right(); left += tileWidth, ++nTasks)
+    {
+        ClosedIntRange columns(left, qMin(left + tileWidth - 1, targetRect.right()));
+        QThreadPool::globalInstance()->start(new CharCountTileTask(msa,
+                                                                   targetRect.verticalRange(),
+                                                                   columns,
+                                                                   left - targetRect.left(),
+                                                                   &charCountDistribution,
+                                                                   &semaphore));
+    }
+    semaphore.acquire(nTasks);
+
+    return charCountDistribution;
+}
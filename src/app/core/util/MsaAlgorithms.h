@@ -21,5 +21,7 @@ class Msa;
 // Public functions
 //! Computes and returns the character count distribution type of msa within the area specified by msaRects
 CharCountDistribution calculateMsaCharCountDistribution(const Msa &msa, const PosiRect &msaRect = PosiRect());
+//! Computes the character count distribution of msa within msaRect using up to maxThreads threads (0 = the ideal thread count)
+CharCountDistribution calculateMsaCharCountDistributionParallel(const Msa &msa, const PosiRect &msaRect = PosiRect(), int maxThreads = 0);
 
 #endif // MSAALGORITHMS_H
@@ -0,0 +1,196 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef SEGMENTTREE_H
+#define SEGMENTTREE_H
+
+#include <QtCore/QVector>
+
+#include "ClosedIntRange.h"
+#include "../macros.h"
+
+/**
+  * SegmentTree maintains a sequence of values and the sums of its ranges such that both changing a value and summing
+  * any range require logarithmic time.
+  *
+  * The values occupy the leaves of a complete binary tree that is stored implicitly in a single vector: the node at
+  * index i (1-based) has children 2i and 2i + 1 and the leaves begin at index length(). Each internal node holds the sum
+  * of its children and is recomputed (rather than adjusted) whenever a leaf beneath it changes. Thus, floating point
+  * values do not accumulate rounding errors over many updates.
+  *
+  * Inserting or removing values rebuilds the tree in linear time.
+  *
+  * Like BioString, positions are 1-based.
+  */
+template<typename T>
+class SegmentTree
+{
+public:
+    // ------------------------------------------------------------------------------------------------
+    // Constructors
+    /**
+      */
+    SegmentTree()
+    {
+    }
+
+    /**
+      * @param values [const QVector<T> &]
+      */
+    explicit SegmentTree(const QVector<T> &values)
+    {
+        rebuild(values);
+    }
+
+
+    // ------------------------------------------------------------------------------------------------
+    // Public methods
+    /**
+      * @param position [int]
+      * @returns T
+      */
+    T at(int position) const
+    {
+        ASSERT_X(position >= 1 && position <= length(), "position out of range");
+
+        return nodes_.at(length() + position - 1);
+    }
+
+    /**
+      */
+    void clear()
+    {
+        nodes_.clear();
+    }
+
+    /**
+      * @param position [int]
+      * @param count [int]
+      * @param value [const T &]
+      */
+    void insert(int position, int count, const T &value = T())
+    {
+        ASSERT_X(position >= 1 && position <= length() + 1, "position out of range");
+        ASSERT_X(count >= 0, "count must be positive");
+
+        QVector<T> newValues = values();
+        newValues.insert(position - 1, count, value);
+        rebuild(newValues);
+    }
+
+    /**
+      * @returns bool
+      */
+    bool isEmpty() const
+    {
+        return nodes_.isEmpty();
+    }
+
+    /**
+      * @returns int
+      */
+    int length() const
+    {
+        return nodes_.size() / 2;
+    }
+
+    /**
+      * @param values [const QVector<T> &]
+      */
+    void rebuild(const QVector<T> &values)
+    {
+        int n = values.size();
+        nodes_.fill(T(), 2 * n);
+        if (n == 0)
+            return;
+
+        T *nodes = nodes_.data();
+        const T *value = values.constData();
+        for (int i=n, z=2*n; i<z; ++i, ++value)
+            nodes[i] = *value;
+        for (int i=n-1; i>0; --i)
+            nodes[i] = nodes[2*i] + nodes[2*i + 1];
+    }
+
+    /**
+      * @param position [int]
+      * @param count [int]
+      */
+    void remove(int position, int count = 1)
+    {
+        ASSERT_X(position >= 1 && position <= length(), "position out of range");
+        ASSERT_X(count >= 0 && position + count - 1 <= length(), "count out of range");
+
+        QVector<T> newValues = values();
+        newValues.remove(position - 1, count);
+        rebuild(newValues);
+    }
+
+    /**
+      * @param position [int]
+      * @param value [const T &]
+      */
+    void set(int position, const T &value)
+    {
+        ASSERT_X(position >= 1 && position <= length(), "position out of range");
+
+        T *nodes = nodes_.data();
+        int i = length() + position - 1;
+        nodes[i] = value;
+        for (i /= 2; i > 0; i /= 2)
+            nodes[i] = nodes[2*i] + nodes[2*i + 1];
+    }
+
+    /**
+      * Every node besides the root is the child of exactly one other node; therefore, the root sums all values even when
+      * the length is not a power of two. When there is only one value, the root is that value.
+      *
+      * @returns T
+      */
+    T sum() const
+    {
+        return (length() > 0) ? nodes_.at(1) : T();
+    }
+
+    /**
+      * @param range [const ClosedIntRange &]
+      * @returns T
+      */
+    T sum(const ClosedIntRange &range) const
+    {
+        ASSERT_X(range.begin_ >= 1 && range.begin_ <= length(), "range.begin_ out of range");
+        ASSERT_X(range.end_ >= range.begin_ && range.end_ <= length(), "range.end_ out of range");
+
+        // Walk up from both boundary leaves, adding those nodes which lie entirely within range ([left, right))
+        T total = T();
+        const T *nodes = nodes_.constData();
+        for (int left = length() + range.begin_ - 1, right = length() + range.end_; left < right; left /= 2, right /= 2)
+        {
+            if (left & 1)
+                total += nodes[left++];
+            if (right & 1)
+                total += nodes[--right];
+        }
+
+        return total;
+    }
+
+    /**
+      * @returns QVector<T>
+      */
+    QVector<T> values() const
+    {
+        return nodes_.mid(length());
+    }
+
+
+private:
+    QVector<T> nodes_;          //!< Index 0 is unused, 1 is the root, and [length(), 2 * length()) are the values
+};
+
+#endif // SEGMENTTREE_H
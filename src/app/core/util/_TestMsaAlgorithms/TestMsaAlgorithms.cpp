@@ -30,6 +30,8 @@ public:
 private slots:
     void calculateMsaCharCountDistribution_data();
     void calculateMsaCharCountDistribution();
+    void calculateMsaCharCountDistributionParallel_data();
+    void calculateMsaCharCountDistributionParallel();
 
 private:
     Msa *createMsa(const QVector<QByteArray> &subseqs) const;   // Helper function for creating a Msa from subseqs
@@ -250,5 +252,52 @@ void TestMsaAlgorithms::calculateMsaCharCountDistribution()
     msa = 0;
 }
 
+void TestMsaAlgorithms::calculateMsaCharCountDistributionParallel_data()
+{
+    QTest::addColumn<Msa *>("msa");
+    QTest::addColumn<PosiRect>("msaRect");
+    QTest::addColumn<int>("maxThreads");
+
+    // Large enough to be split into tiles
+    QByteArray characters = "ACDEFGHIKLMNPQRSTVWY-.";
+    QVector<QByteArray> subseqByteArrayVector;
+    for (int j=0; j< 300; ++j)
+    {
+        QByteArray subseqString("X");
+        for (int i=1; i< 1000; ++i)
+            subseqString.append(characters.at(::randomInteger(0, characters.length()-1)));
+        subseqByteArrayVector << subseqString;
+    }
+
+    QTest::newRow("300 x 1000, entire msa, ideal threads") << createMsa(subseqByteArrayVector) << PosiRect() << 0;
+    QTest::newRow("300 x 1000, entire msa, 3 threads") << createMsa(subseqByteArrayVector) << PosiRect() << 3;
+    QTest::newRow("300 x 1000, entire msa, 1 thread") << createMsa(subseqByteArrayVector) << PosiRect() << 1;
+    QTest::newRow("300 x 1000, sub rect, 4 threads")
+            << createMsa(subseqByteArrayVector)
+            << PosiRect(QPoint(997, 290), QPoint(3, 2))
+            << 4;
+    QTest::newRow("300 x 1000, narrow rect, 4 threads")
+            << createMsa(subseqByteArrayVector)
+            << PosiRect(QPoint(500, 1), QPoint(510, 300))
+            << 4;
+}
+
+void TestMsaAlgorithms::calculateMsaCharCountDistributionParallel()
+{
+    QFETCH(Msa *, msa);
+    QFETCH(PosiRect, msaRect);
+    QFETCH(int, maxThreads);
+
+    QVERIFY(msa);
+
+    CharCountDistribution expected = ::calculateMsaCharCountDistribution(*msa, msaRect);
+    CharCountDistribution actual = ::calculateMsaCharCountDistributionParallel(*msa, msaRect, maxThreads);
+    QCOMPARE(actual.charCounts(), expected.charCounts());
+    QCOMPARE(actual.divisor(), expected.divisor());
+
+    delete msa;
+    msa = 0;
+}
+
 QTEST_APPLESS_MAIN(TestMsaAlgorithms)
 #include "TestMsaAlgorithms.moc"
@@ -21,6 +21,8 @@ SOURCES += TestMsaAlgorithms.cpp \
            ../../constants.cpp \
            ../../misc.cpp \
            ../../Subseq.cpp \
+           ../../NonGapRunIndex.cpp \
+           ../../SubseqChangeRecord.cpp \
            ../../CharCountDistribution.cpp
 
 DEFINES += TESTING
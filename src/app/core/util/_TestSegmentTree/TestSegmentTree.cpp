@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "../SegmentTree.h"
+
+class TestSegmentTree : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void constructor();
+    void set();
+    void sumRange();
+    void insert();
+    void remove();
+    void randomEdits();
+
+private:
+    // Verifies that every range sum of tree equals the sum of the corresponding values
+    static bool sumsMatch(const SegmentTree<int> &tree, const QVector<int> &values);
+};
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Actual test functions
+void TestSegmentTree::constructor()
+{
+    SegmentTree<int> x;
+    QVERIFY(x.isEmpty());
+    QCOMPARE(x.length(), 0);
+    QCOMPARE(x.sum(), 0);
+
+    SegmentTree<int> y(QVector<int>() << 5);
+    QCOMPARE(y.length(), 1);
+    QCOMPARE(y.at(1), 5);
+    QCOMPARE(y.sum(), 5);
+
+    QVector<int> values;
+    values << 3 << 1 << 4 << 1 << 5 << 9 << 2;
+    SegmentTree<int> z(values);
+    QCOMPARE(z.isEmpty(), false);
+    QCOMPARE(z.length(), 7);
+    QCOMPARE(z.values(), values);
+    QCOMPARE(z.sum(), 25);
+
+    z.clear();
+    QVERIFY(z.isEmpty());
+    QCOMPARE(z.sum(), 0);
+}
+
+void TestSegmentTree::set()
+{
+    QVector<int> values;
+    values << 3 << 1 << 4 << 1 << 5;
+    SegmentTree<int> x(values);
+
+    x.set(1, 10);
+    values[0] = 10;
+    QCOMPARE(x.at(1), 10);
+    QCOMPARE(x.sum(), 21);
+    QVERIFY(sumsMatch(x, values));
+
+    x.set(5, -5);
+    values[4] = -5;
+    QCOMPARE(x.sum(), 11);
+    QVERIFY(sumsMatch(x, values));
+}
+
+void TestSegmentTree::sumRange()
+{
+    QVector<int> values;
+    values << 3 << 1 << 4 << 1 << 5 << 9 << 2;
+    SegmentTree<int> x(values);
+
+    QCOMPARE(x.sum(ClosedIntRange(1, 1)), 3);
+    QCOMPARE(x.sum(ClosedIntRange(7, 7)), 2);
+    QCOMPARE(x.sum(ClosedIntRange(2, 4)), 6);
+    QCOMPARE(x.sum(ClosedIntRange(1, 7)), 25);
+    QVERIFY(sumsMatch(x, values));
+
+    // Test: floating point values
+    SegmentTree<double> y(QVector<double>() << .5 << .25 << .125);
+    QCOMPARE(y.sum(ClosedIntRange(2, 3)), .375);
+    QCOMPARE(y.sum(), .875);
+}
+
+void TestSegmentTree::insert()
+{
+    QVector<int> values;
+    values << 3 << 1 << 4;
+    SegmentTree<int> x(values);
+
+    // Test: insert at the beginning, middle, and end
+    x.insert(1, 2, 7);
+    values.insert(0, 2, 7);
+    QCOMPARE(x.values(), values);
+    QVERIFY(sumsMatch(x, values));
+
+    x.insert(3, 1);
+    values.insert(2, 1, 0);
+    QCOMPARE(x.values(), values);
+    QVERIFY(sumsMatch(x, values));
+
+    x.insert(x.length() + 1, 3, 1);
+    values.insert(values.size(), 3, 1);
+    QCOMPARE(x.values(), values);
+    QVERIFY(sumsMatch(x, values));
+
+    // Test: insert zero values
+    x.insert(2, 0, 5);
+    QCOMPARE(x.values(), values);
+
+    // Test: insert into empty tree
+    SegmentTree<int> y;
+    y.insert(1, 4, 2);
+    QCOMPARE(y.length(), 4);
+    QCOMPARE(y.sum(), 8);
+}
+
+void TestSegmentTree::remove()
+{
+    QVector<int> values;
+    values << 3 << 1 << 4 << 1 << 5 << 9 << 2;
+    SegmentTree<int> x(values);
+
+    x.remove(1);
+    values.remove(0);
+    QCOMPARE(x.values(), values);
+    QVERIFY(sumsMatch(x, values));
+
+    x.remove(2, 3);
+    values.remove(1, 3);
+    QCOMPARE(x.values(), values);
+    QVERIFY(sumsMatch(x, values));
+
+    x.remove(1, x.length());
+    QVERIFY(x.isEmpty());
+    QCOMPARE(x.sum(), 0);
+}
+
+void TestSegmentTree::randomEdits()
+{
+    qsrand(1);
+
+    QVector<int> values;
+    SegmentTree<int> x;
+    for (int i=0; i< 500; ++i)
+    {
+        int position = 0;
+        switch (qrand() % 3)
+        {
+        case 0:
+            position = qrand() % (values.size() + 1);
+            values.insert(position, 1, qrand() % 100);
+            x.insert(position + 1, 1, values.at(position));
+            break;
+        case 1:
+            if (values.isEmpty())
+                continue;
+            position = qrand() % values.size();
+            values.remove(position);
+            x.remove(position + 1);
+            break;
+
+        default:
+            if (values.isEmpty())
+                continue;
+            position = qrand() % values.size();
+            values[position] = qrand() % 100;
+            x.set(position + 1, values.at(position));
+            break;
+        }
+
+        QCOMPARE(x.length(), values.size());
+        if (i % 50 == 0)
+            QVERIFY(sumsMatch(x, values));
+    }
+    QVERIFY(sumsMatch(x, values));
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+// Private methods
+/**
+  * @param tree [const SegmentTree<int> &]
+  * @param values [const QVector<int> &]
+  * @returns bool
+  */
+bool TestSegmentTree::sumsMatch(const SegmentTree<int> &tree, const QVector<int> &values)
+{
+    if (tree.length() != values.size())
+        return false;
+
+    int total = 0;
+    for (int i=1; i<= values.size(); ++i)
+    {
+        total += values.at(i - 1);
+        if (tree.at(i) != values.at(i - 1))
+            return false;
+
+        int rangeTotal = 0;
+        for (int j=i; j<= values.size(); ++j)
+        {
+            rangeTotal += values.at(j - 1);
+            if (tree.sum(ClosedIntRange(i, j)) != rangeTotal)
+                return false;
+        }
+    }
+
+    return tree.sum() == total;
+}
+
+QTEST_APPLESS_MAIN(TestSegmentTree)
+#include "TestSegmentTree.moc"
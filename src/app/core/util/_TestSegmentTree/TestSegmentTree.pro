@@ -0,0 +1,17 @@
+# ----------------------------------------------------------
+# Test project file created with create_test_scaffold.pl
+#
+# Copyright (C) 2011 Agile Genomics, LLC
+# All rights reserved.
+# ----------------------------------------------------------
+
+CONFIG += qtestlib debug
+QT -= gui
+TARGET = TestSegmentTree
+DEPENDPATH += . ..
+INCLUDEPATH += . ..
+
+HEADERS += SegmentTree.h
+SOURCES += TestSegmentTree.cpp
+
+DEFINES += TESTING
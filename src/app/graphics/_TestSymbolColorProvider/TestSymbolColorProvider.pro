@@ -25,6 +25,8 @@ SOURCES += TestSymbolColorProvider.cpp \
            ../../core/BioSymbolGroup.cpp \
            ../../core/Seq.cpp \
            ../../core/Subseq.cpp \
+           ../../core/NonGapRunIndex.cpp \
+           ../../core/SubseqChangeRecord.cpp \
            ../../core/UngappedSubseq.cpp \
            ../../core/constants.cpp \
            ../../core/misc.cpp \
@@ -15,7 +15,8 @@ namespace Ag
     {
         eCollapseMsaRectCommandId = 0,
         eSetSubseqStartCommandId,
-        eSetSubseqStopCommandId
+        eSetSubseqStopCommandId,
+        eSlideMsaRectCommandId
     };
 
     enum SubCommandIds
@@ -9,12 +9,8 @@
 #ifndef ABSTRACTCOLLAPSEMSARECTCOMMAND_H
 #define ABSTRACTCOLLAPSEMSARECTCOMMAND_H
 
-#include <QtCore/QVector>
-
-#include <QtGui/QUndoCommand>
-
+#include "AbstractSubseqChangeCommand.h"
 #include "../../../core/ObservableMsa.h"
-#include "../../../core/PODs/SubseqChangePod.h"
 #include "../../../core/global.h"
 #include "../../../core/util/PosiRect.h"
 #include "../CommandIds.h"
@@ -30,9 +26,9 @@
   *
   * The simple solution is to observe when merging commands if the collpase is in the opposite direction (using subIds).
   * If this is true, then when undo is called, simply restore the original collapse before calling undo with the
-  * original change pod vector.
+  * original change record.
   */
-class AbstractCollapseMsaRectCommand : public QUndoCommand
+class AbstractCollapseMsaRectCommand : public AbstractSubseqChangeCommand
 {
 public:
     // -------------------------------------------------------------------------------------------------
@@ -47,9 +43,7 @@ public:
     virtual void undo();                                    //!< Undoes this command
 
 protected:
-    ObservableMsa *msa_;
     PosiRect msaRect_;
-    SubseqChangePodVector changePodVector_;
 
 private:
     //! Indicates if this command has been merged with a compatible collapse in the opposite direction
@@ -67,12 +61,10 @@ private:
   */
 inline
 AbstractCollapseMsaRectCommand::AbstractCollapseMsaRectCommand(ObservableMsa *msa, const PosiRect &msaRect, QUndoCommand *parentCommand)
-    : QUndoCommand(parentCommand),
-      msa_(msa),
+    : AbstractSubseqChangeCommand(msa, parentCommand),
       msaRect_(msaRect),
       reverseCollapse_(false)
 {
-    ASSERT(msa_ != nullptr);
 }
 
 /**
@@ -116,7 +108,7 @@ void AbstractCollapseMsaRectCommand::undo()
             msa_->collapseRight(msaRect_);
     }
 
-    msa_->undo(changePodVector_);
+    AbstractSubseqChangeCommand::undo();
 }
 
 
@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2011 Agile Genomics, LLC
+** All rights reserved.
+** Author: Luke Ulrich
+**
+****************************************************************************/
+
+#ifndef ABSTRACTSUBSEQCHANGECOMMAND_H
+#define ABSTRACTSUBSEQCHANGECOMMAND_H
+
+#include <QtGui/QUndoCommand>
+
+#include "../../../core/ObservableMsa.h"
+#include "../../../core/SubseqChangeRecord.h"
+#include "../../../core/global.h"
+#include "../../../core/macros.h"
+
+/**
+  * AbstractSubseqChangeCommand is the base class for those commands whose changes are fully described by the
+  * SubseqChangePodVector returned from the corresponding Msa operation.
+  *
+  * Rather than keeping the pods themselves (which contain a copy of every changed character), subclasses should store
+  * them in changeRecord_ when redone. Undo then reverts the changes from this compact record. To further reduce the
+  * memory consumed by old commands, the record may be compressed at the expense of a slower undo.
+  */
+class AbstractSubseqChangeCommand : public QUndoCommand
+{
+public:
+    // -------------------------------------------------------------------------------------------------
+    // Constructor
+    AbstractSubseqChangeCommand(ObservableMsa *msa, QUndoCommand *parentCommand = nullptr);
+
+    // -------------------------------------------------------------------------------------------------
+    // Public methods
+    int changeRecordMemoryUsage() const;                    //!< Returns the approximate number of bytes used to remember the changes
+    void compressChangeRecord();                            //!< Compresses the remembered changes
+    virtual void undo();                                    //!< Undoes this command
+
+protected:
+    ObservableMsa *msa_;
+    SubseqChangeRecord changeRecord_;                       // To remember the changes that we have done
+};
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Constructor
+/**
+  * @param msa [ObservableMsa *]
+  * @param parentCommand [QUndoCommand *]
+  */
+inline
+AbstractSubseqChangeCommand::AbstractSubseqChangeCommand(ObservableMsa *msa, QUndoCommand *parentCommand)
+    : QUndoCommand(parentCommand),
+      msa_(msa)
+{
+    ASSERT(msa_ != nullptr);
+}
+
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+// Public methods
+/**
+  * @returns int
+  */
+inline
+int AbstractSubseqChangeCommand::changeRecordMemoryUsage() const
+{
+    return changeRecord_.memoryUsage();
+}
+
+/**
+  */
+inline
+void AbstractSubseqChangeCommand::compressChangeRecord()
+{
+    changeRecord_.compress();
+}
+
+/**
+  */
+inline
+void AbstractSubseqChangeCommand::undo()
+{
+    msa_->undo(changeRecord_);
+}
+
+
+#endif // ABSTRACTSUBSEQCHANGECOMMAND_H
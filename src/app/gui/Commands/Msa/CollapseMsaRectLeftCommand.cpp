@@ -35,7 +35,7 @@ CollapseMsaRectLeftCommand::CollapseMsaRectLeftCommand(ObservableMsa *msa, const
   */
 void CollapseMsaRectLeftCommand::redo()
 {
-    changePodVector_ = msa_->collapseLeft(msaRect_);
+    changeRecord_ = SubseqChangeRecord(msa_->collapseLeft(msaRect_));
 }
 
 /**
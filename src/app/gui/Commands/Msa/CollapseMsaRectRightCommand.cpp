@@ -35,7 +35,7 @@ CollapseMsaRectRightCommand::CollapseMsaRectRightCommand(ObservableMsa *msa, con
   */
 void CollapseMsaRectRightCommand::redo()
 {
-    changePodVector_ = msa_->collapseRight(msaRect_);
+    changeRecord_ = SubseqChangeRecord(msa_->collapseRight(msaRect_));
 }
 
 /**
@@ -24,9 +24,8 @@ ExtendRowsLeftCommand::ExtendRowsLeftCommand(ObservableMsa *msa,
                                              int msaColumn,
                                              const ClosedIntRange &rows,
                                              QUndoCommand *parentCommand)
-    : QUndoCommand(parentCommand), msa_(msa), msaColumn_(msaColumn), rows_(rows)
+    : AbstractSubseqChangeCommand(msa, parentCommand), msaColumn_(msaColumn), rows_(rows)
 {
-    ASSERT(msa != nullptr);
     setText(QString("Extend rows (%1 - %2) left to column %3").arg(rows.begin_).arg(rows.end_).arg(msaColumn));
 }
 
@@ -38,12 +37,5 @@ ExtendRowsLeftCommand::ExtendRowsLeftCommand(ObservableMsa *msa,
   */
 void ExtendRowsLeftCommand::redo()
 {
-    changePodVector_ = msa_->extendLeft(msaColumn_, rows_);
-}
-
-/**
-  */
-void ExtendRowsLeftCommand::undo()
-{
-    msa_->undo(changePodVector_);
+    changeRecord_ = SubseqChangeRecord(msa_->extendLeft(msaColumn_, rows_));
 }
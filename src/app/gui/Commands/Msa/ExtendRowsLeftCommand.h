@@ -9,16 +9,13 @@
 #ifndef EXTENDROWSLEFTCOMMAND_H
 #define EXTENDROWSLEFTCOMMAND_H
 
-#include <QtCore/QVector>
-#include <QtGui/QUndoCommand>
-
-#include "../../../core/PODs/SubseqChangePod.h"
+#include "AbstractSubseqChangeCommand.h"
 #include "../../../core/util/ClosedIntRange.h"
 #include "../../../core/global.h"
 
 class ObservableMsa;
 
-class ExtendRowsLeftCommand : public QUndoCommand
+class ExtendRowsLeftCommand : public AbstractSubseqChangeCommand
 {
 public:
     ExtendRowsLeftCommand(ObservableMsa *msa,
@@ -27,13 +24,10 @@ public:
                           QUndoCommand *parentCommand = nullptr);
 
     void redo();
-    void undo();
 
 private:
-    ObservableMsa *msa_;
     int msaColumn_;
     ClosedIntRange rows_;
-    SubseqChangePodVector changePodVector_;     // To remember the changes that we have done
 };
 
 #endif // EXTENDROWSLEFTCOMMAND_H
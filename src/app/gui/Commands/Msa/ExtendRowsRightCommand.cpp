@@ -23,9 +23,8 @@ ExtendRowsRightCommand::ExtendRowsRightCommand(ObservableMsa *msa,
                                                int msaColumn,
                                                const ClosedIntRange &rows,
                                                QUndoCommand *parentCommand)
-    : QUndoCommand(parentCommand), msa_(msa), msaColumn_(msaColumn), rows_(rows)
+    : AbstractSubseqChangeCommand(msa, parentCommand), msaColumn_(msaColumn), rows_(rows)
 {
-    ASSERT(msa != nullptr);
     setText(QString("Extend rows (%1 - %2) right to column %3").arg(rows.begin_).arg(rows.end_).arg(msaColumn));
 }
 
@@ -37,12 +36,5 @@ ExtendRowsRightCommand::ExtendRowsRightCommand(ObservableMsa *msa,
   */
 void ExtendRowsRightCommand::redo()
 {
-    changePodVector_ = msa_->extendRight(msaColumn_, rows_);
-}
-
-/**
-  */
-void ExtendRowsRightCommand::undo()
-{
-    msa_->undo(changePodVector_);
+    changeRecord_ = SubseqChangeRecord(msa_->extendRight(msaColumn_, rows_));
 }
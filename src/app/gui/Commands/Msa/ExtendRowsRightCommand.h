@@ -9,16 +9,13 @@
 #ifndef EXTENDROWSRIGHTCOMMAND_H
 #define EXTENDROWSRIGHTCOMMAND_H
 
-#include <QtCore/QVector>
-#include <QtGui/QUndoCommand>
-
-#include "../../../core/PODs/SubseqChangePod.h"
+#include "AbstractSubseqChangeCommand.h"
 #include "../../../core/util/ClosedIntRange.h"
 #include "../../../core/global.h"
 
 class ObservableMsa;
 
-class ExtendRowsRightCommand : public QUndoCommand
+class ExtendRowsRightCommand : public AbstractSubseqChangeCommand
 {
 public:
     ExtendRowsRightCommand(ObservableMsa *msa,
@@ -27,13 +24,10 @@ public:
                            QUndoCommand *parentCommand = nullptr);
 
     void redo();
-    void undo();
 
 private:
-    ObservableMsa *msa_;
     int msaColumn_;
     ClosedIntRange rows_;
-    SubseqChangePodVector changePodVector_;     // To remember the changes that we have done
 };
 
 #endif // EXTENDROWSRIGHTCOMMAND_H
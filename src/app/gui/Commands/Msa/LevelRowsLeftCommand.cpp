@@ -23,9 +23,8 @@ LevelRowsLeftCommand::LevelRowsLeftCommand(ObservableMsa *msa,
                                            int msaColumn,
                                            const ClosedIntRange &rows,
                                            QUndoCommand *parentCommand)
-    : QUndoCommand(parentCommand), msa_(msa), msaColumn_(msaColumn), rows_(rows)
+    : AbstractSubseqChangeCommand(msa, parentCommand), msaColumn_(msaColumn), rows_(rows)
 {
-    ASSERT(msa != nullptr);
     setText(QString("Level rows (%1 - %2) left to column %3").arg(rows.begin_).arg(rows.end_).arg(msaColumn));
 }
 
@@ -37,12 +36,5 @@ LevelRowsLeftCommand::LevelRowsLeftCommand(ObservableMsa *msa,
   */
 void LevelRowsLeftCommand::redo()
 {
-    changePodVector_ = msa_->levelLeft(msaColumn_, rows_);
-}
-
-/**
-  */
-void LevelRowsLeftCommand::undo()
-{
-    msa_->undo(changePodVector_);
+    changeRecord_ = SubseqChangeRecord(msa_->levelLeft(msaColumn_, rows_));
 }
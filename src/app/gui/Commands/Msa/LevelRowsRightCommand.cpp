@@ -23,9 +23,8 @@ LevelRowsRightCommand::LevelRowsRightCommand(ObservableMsa *msa,
                                              int msaColumn,
                                              const ClosedIntRange &rows,
                                              QUndoCommand *parentCommand)
-    : QUndoCommand(parentCommand), msa_(msa), msaColumn_(msaColumn), rows_(rows)
+    : AbstractSubseqChangeCommand(msa, parentCommand), msaColumn_(msaColumn), rows_(rows)
 {
-    ASSERT(msa != nullptr);
     setText(QString("Level rows (%1 - %2) right to column %3").arg(rows.begin_).arg(rows.end_).arg(msaColumn));
 }
 
@@ -37,12 +36,5 @@ LevelRowsRightCommand::LevelRowsRightCommand(ObservableMsa *msa,
   */
 void LevelRowsRightCommand::redo()
 {
-    changePodVector_ = msa_->levelRight(msaColumn_, rows_);
-}
-
-/**
-  */
-void LevelRowsRightCommand::undo()
-{
-    msa_->undo(changePodVector_);
+    changeRecord_ = SubseqChangeRecord(msa_->levelRight(msaColumn_, rows_));
 }
@@ -7,6 +7,7 @@
 ****************************************************************************/
 
 #include "SlideMsaRectCommand.h"
+#include "../CommandIds.h"
 #include "../../../core/ObservableMsa.h"
 #include "../../widgets/AbstractMsaView.h"
 
@@ -36,6 +37,42 @@ SlideMsaRectCommand::SlideMsaRectCommand(AbstractMsaView *msaView,
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Public methods
+/**
+  * @returns int
+  */
+int SlideMsaRectCommand::id() const
+{
+    return Ag::eSlideMsaRectCommandId;
+}
+
+/**
+  * Only merges those slides that continue sliding the very same characters; that is, when other begins with the
+  * rectangle that this command left behind. Thus, dragging a block of characters back and forth produces a single
+  * undo step that need only remember the rectangle and the total distance slid.
+  *
+  * @param other [const QUndoCommand *]
+  * @returns bool
+  */
+bool SlideMsaRectCommand::mergeWith(const QUndoCommand *other)
+{
+    if (other->id() != id())
+        return false;
+
+    const SlideMsaRectCommand *otherCommand = static_cast<const SlideMsaRectCommand *>(other);
+    PosiRect shiftedRect = msaRect_;
+    shiftedRect.moveLeft(msaRect_.left() + delta_);
+    bool isCompatibleMerge = msa_ == otherCommand->msa_ &&
+                             msaView_ == otherCommand->msaView_ &&
+                             shiftedRect == otherCommand->msaRect_;
+    if (!isCompatibleMerge)
+        return false;
+
+    delta_ += otherCommand->delta_;
+    setText(QString("Slide rectangle [(%1, %2), (%3, %4)] %5 positions").arg(msaRect_.left()).arg(msaRect_.top()).arg(msaRect_.right()).arg(msaRect_.bottom()).arg(delta_));
+
+    return true;
+}
+
 /**
   */
 void SlideMsaRectCommand::redoDelegate()
@@ -25,6 +25,8 @@ public:
                         int delta,
                         QUndoCommand *parentCommand = nullptr);
 
+    int id() const;
+    bool mergeWith(const QUndoCommand *other);
     void redoDelegate();
     void undo();
 
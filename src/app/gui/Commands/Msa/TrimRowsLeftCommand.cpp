@@ -24,9 +24,8 @@ TrimRowsLeftCommand::TrimRowsLeftCommand(ObservableMsa *msa,
                                          int msaColumn,
                                          const ClosedIntRange &rows,
                                          QUndoCommand *parentCommand)
-    : QUndoCommand(parentCommand), msa_(msa), msaColumn_(msaColumn), rows_(rows)
+    : AbstractSubseqChangeCommand(msa, parentCommand), msaColumn_(msaColumn), rows_(rows)
 {
-    ASSERT(msa != nullptr);
     setText(QString("Trim rows (%1 - %2) left to column %3").arg(rows.begin_).arg(rows.end_).arg(msaColumn));
 }
 
@@ -38,12 +37,5 @@ TrimRowsLeftCommand::TrimRowsLeftCommand(ObservableMsa *msa,
   */
 void TrimRowsLeftCommand::redo()
 {
-    changePodVector_ = msa_->trimLeft(msaColumn_, rows_);
-}
-
-/**
-  */
-void TrimRowsLeftCommand::undo()
-{
-    msa_->undo(changePodVector_);
+    changeRecord_ = SubseqChangeRecord(msa_->trimLeft(msaColumn_, rows_));
 }
@@ -9,16 +9,13 @@
 #ifndef TRIMROWSRIGHTCOMMAND_H
 #define TRIMROWSRIGHTCOMMAND_H
 
-#include <QtCore/QVector>
-#include <QtGui/QUndoCommand>
-
-#include "../../../core/PODs/SubseqChangePod.h"
+#include "AbstractSubseqChangeCommand.h"
 #include "../../../core/util/ClosedIntRange.h"
 #include "../../../core/global.h"
 
 class ObservableMsa;
 
-class TrimRowsRightCommand : public QUndoCommand
+class TrimRowsRightCommand : public AbstractSubseqChangeCommand
 {
 public:
     TrimRowsRightCommand(ObservableMsa *msa,
@@ -27,13 +24,10 @@ public:
                         QUndoCommand *parentCommand = nullptr);
 
     void redo();
-    void undo();
 
 private:
-    ObservableMsa *msa_;
     int msaColumn_;
     ClosedIntRange rows_;
-    SubseqChangePodVector changePodVector_;     // To remember the changes that we have done
 };
 
 #endif // TRIMROWSRIGHTCOMMAND_H
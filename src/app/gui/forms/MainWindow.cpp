@@ -11,6 +11,7 @@
 #include <QtCore/QState>
 
 #include <QtGui/QAbstractButton>
+#include <QtGui/QApplication>
 #include <QtGui/QClipboard>
 #include <QtGui/QCloseEvent>
 #include <QtGui/QDockWidget>
@@ -24,6 +25,7 @@
 #include <QtGui/QPushButton>
 #include <QtGui/QScrollBar>
 #include <QtGui/QSortFilterProxyModel>
+#include <QtGui/QStatusBar>
 #include <QtGui/QTableWidget>
 #include <QtGui/QTableWidgetItem>
 #include <QtGui/QUndoStack>
@@ -165,6 +167,9 @@ MainWindow::MainWindow(QWidget *parent) :
     Qt::SortOrder defaultSortOrder = Qt::AscendingOrder;
 
     connect(&adoc_, SIGNAL(modifiedChanged(bool)), SLOT(onModifiedChanged()));
+    connect(&adoc_, SIGNAL(compactionError(QString,QString)), SLOT(onAdocCompactionError(QString,QString)));
+    connect(&adoc_, SIGNAL(compactionWaitStarted(QString)), SLOT(onAdocCompactionWaitStarted(QString)));
+    connect(&adoc_, SIGNAL(compactionWaitFinished()), SLOT(onAdocCompactionWaitFinished()));
 
     // -----------------------------------
     // The all important undo stack
@@ -176,6 +181,7 @@ MainWindow::MainWindow(QWidget *parent) :
     // Model and adapter setup
     adocTreeModel_ = new AdocTreeModel();
     adocTreeModel_->setUndoStack(undoStack_);
+    adocTreeModel_->setAdocSource(adoc_.adocSource());
 
     containerModel_ = new AdocTreeNodeFilterModel(adocTreeModel_);  // Child of the AdocTreeModel instance
     containerModel_->setAcceptableNodeTypes(QSet<AdocNodeType>() << eRootNode << eGroupNode);
@@ -1430,6 +1436,44 @@ void MainWindow::onTableViewSelectionChanged()
 // -------------------------------
 // -------------------------------
 // Other reaction slots
+/**
+  * Compaction only begins after all changes have been committed; thus, a failure here does not lose any data but
+  * leaves the file larger than necessary.
+  *
+  * @param fileName [const QString &]
+  * @param message [const QString &]
+  */
+void MainWindow::onAdocCompactionError(const QString &fileName, const QString &message)
+{
+    QMessageBox::warning(this,
+                         "Compaction error",
+                         QString("Your changes to %1 were saved; however, the file could not be compacted afterwards:\n\n%2")
+                         .arg(QFileInfo(fileName).fileName())
+                         .arg(message),
+                         QMessageBox::Ok);
+}
+
+/**
+  */
+void MainWindow::onAdocCompactionWaitFinished()
+{
+    statusBar()->clearMessage();
+    QApplication::restoreOverrideCursor();
+}
+
+/**
+  * The GUI thread is about to block until the compaction finishes. Because the event loop will not run in the
+  * meantime, the status bar is repainted immediately rather than waiting for the next paint event.
+  *
+  * @param fileName [const QString &]
+  */
+void MainWindow::onAdocCompactionWaitStarted(const QString &fileName)
+{
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    statusBar()->showMessage(QString("Finishing compaction of %1...").arg(QFileInfo(fileName).fileName()));
+    statusBar()->repaint();
+}
+
 /**
   */
 void MainWindow::onEntityStateExited()
@@ -126,6 +126,9 @@ private Q_SLOTS:
     void onTableViewSelectionChanged();
 
     // Various other reaction slots
+    void onAdocCompactionError(const QString &fileName, const QString &message);
+    void onAdocCompactionWaitFinished();
+    void onAdocCompactionWaitStarted(const QString &fileName);
     void onEntityStateExited();
     void onImportError(const QString &errorMessage);
     void onImportSuccessful(const QModelIndex &parentIndex);
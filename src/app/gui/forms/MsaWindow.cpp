@@ -24,6 +24,7 @@
 #include "MsaWindow.h"
 #include "ui_MsaWindow.h"
 
+#include "../Commands/Msa/AbstractSubseqChangeCommand.h"
 #include "../Commands/Msa/CollapseMsaRectLeftCommand.h"
 #include "../Commands/Msa/CollapseMsaRectRightCommand.h"
 #include "../Commands/Msa/TrimRowsLeftCommand.h"
@@ -74,6 +75,7 @@
 
 
 static const qreal kLabelRightMargin = 45.;   // Pixels
+static const int kUndoMemoryBudget = 32 * 1024 * 1024;      // Bytes of uncompressed change records kept for undo
 
 #include <QtDebug>
 
@@ -104,7 +106,10 @@ MsaWindow::MsaWindow(Adoc *adoc, TaskManager *taskManager, QWidget *parent) :
     selectMsaTool_(nullptr),
     zoomMsaTool_(nullptr),
     taskManager_(taskManager),
-    totalInfoContentLabel_(nullptr)
+    totalInfoContentLabel_(nullptr),
+    undoMemoryUsage_(0),
+    undoCompressedCount_(0),
+    undoIndex_(0)
 {
     undoStack_ = new QUndoStack(this);
 
@@ -156,6 +161,7 @@ MsaWindow::MsaWindow(Adoc *adoc, TaskManager *taskManager, QWidget *parent) :
     connect(undoStack_, SIGNAL(canRedoChanged(bool)), ui_->actionRedo, SLOT(setEnabled(bool)));
     connect(undoStack_, SIGNAL(cleanChanged(bool)), SLOT(onUndoCleanChanged(bool)));
     connect(undoStack_, SIGNAL(indexChanged(int)), SLOT(enableDisableActions()));
+    connect(undoStack_, SIGNAL(indexChanged(int)), SLOT(enforceUndoMemoryBudget()));
 
 
     // ----------------
@@ -1094,6 +1100,72 @@ void MsaWindow::onLogoContextMenuRequested(const QPoint &point)
         logoItem()->logoBarsItem()->setColumnIcLabelsVisible(toggleIcColumnLabelsAction->isChecked());
 }
 
+/**
+  * The undo history may not simply be truncated because closing the window without saving reverts every change on the
+  * undo stack. Instead, once the most recent commands consume more than kUndoMemoryBudget bytes, the change records of
+  * all older commands are compressed.
+  *
+  * Rather than rescanning the whole stack, the memory usage of each command is remembered and only updated for those
+  * commands which may have changed since the last call: commands that were pushed, merged, or redone (and thus have a
+  * new, uncompressed change record) and those that were removed from the stack. Undoing does not alter a change record.
+  * Because commands are only compressed from the bottom of the stack upwards, the compressed commands always occupy
+  * the first undoCompressedCount_ positions.
+  */
+void MsaWindow::enforceUndoMemoryBudget()
+{
+    int count = undoStack_->count();
+    int index = undoStack_->index();
+
+    // Forget those commands that are no longer on the stack (e.g. after clearing it or pushing a command after undoing)
+    while (undoMemoryUsages_.size() > count)
+    {
+        if (undoMemoryUsages_.size() > undoCompressedCount_)
+            undoMemoryUsage_ -= undoMemoryUsages_.last();
+        undoMemoryUsages_.pop_back();
+    }
+    undoCompressedCount_ = qMin(undoCompressedCount_, count);
+
+    // Re-measure every command done since the last call; if none, the top command in case another was merged into it.
+    // Any of these that were compressed no longer are.
+    int from = index;
+    if (index > undoIndex_)
+        from = undoIndex_;
+    else if (index == undoIndex_ && index > 0)
+        from = index - 1;
+    from = qMin(from, undoMemoryUsages_.size());
+    for (; undoCompressedCount_ > from && from < index; --undoCompressedCount_)
+        undoMemoryUsage_ += undoMemoryUsages_.at(undoCompressedCount_ - 1);
+    for (int i=from; i< index; ++i)
+    {
+        int memoryUsage = undoCommandMemoryUsage(i);
+        if (i < undoMemoryUsages_.size())
+        {
+            undoMemoryUsage_ += memoryUsage - undoMemoryUsages_.at(i);
+            undoMemoryUsages_[i] = memoryUsage;
+        }
+        else
+        {
+            undoMemoryUsage_ += memoryUsage;
+            undoMemoryUsages_ << memoryUsage;
+        }
+    }
+    undoIndex_ = index;
+
+    // Compress the oldest uncompressed commands for as long as the newer commands exceed the budget
+    while (undoCompressedCount_ < undoMemoryUsages_.size() &&
+           undoMemoryUsage_ - undoMemoryUsages_.at(undoCompressedCount_) > kUndoMemoryBudget)
+    {
+        undoMemoryUsage_ -= undoMemoryUsages_.at(undoCompressedCount_);
+        const AbstractSubseqChangeCommand *command = dynamic_cast<const AbstractSubseqChangeCommand *>(undoStack_->command(undoCompressedCount_));
+        if (command != nullptr)
+        {
+            const_cast<AbstractSubseqChangeCommand *>(command)->compressChangeRecord();
+            undoMemoryUsages_[undoCompressedCount_] = command->changeRecordMemoryUsage();
+        }
+        ++undoCompressedCount_;
+    }
+}
+
 /**
   * @param isClean [bool]
   */
@@ -1154,13 +1226,22 @@ void MsaWindow::onMsaViewSelectionChanged(const PosiRect &selection)
     if (!selectMsaTool_->isActive())
         return;
 
-    locationLabel_->setText(QString("(%1, %2) -> (%3, %4) [%5 x %6]")
-                            .arg(selection.left())
-                            .arg(selection.top())
-                            .arg(selection.right())
-                            .arg(selection.bottom())
-                            .arg(qAbs(selection.width()))
-                            .arg(qAbs(selection.height())));
+    QString text = QString("(%1, %2) -> (%3, %4) [%5 x %6]")
+                   .arg(selection.left())
+                   .arg(selection.top())
+                   .arg(selection.right())
+                   .arg(selection.bottom())
+                   .arg(qAbs(selection.width()))
+                   .arg(qAbs(selection.height()));
+
+    // The information content of the selected columns is summed in logarithmic time and thus may be updated while the
+    // selection is being dragged
+    ClosedIntRange columns = selection.normalized().horizontalRange();
+    if (liveInfoContentDistribution() != nullptr &&
+        columns.begin_ >= 1 && columns.begin_ <= columns.end_ && columns.end_ <= liveInfoContentDistribution()->length())
+        text += QString(" IC: %1").arg(QString::number(liveInfoContentDistribution()->totalInfo(columns), 'f', 2));
+
+    locationLabel_->setText(text);
 }
 
 /**
@@ -1443,3 +1524,18 @@ qreal MsaWindow::maxStringWidth(const QFont &font, const QStringList &strings) c
 
     return maxWidth;
 }
+
+/**
+  * Commands other than AbstractSubseqChangeCommands are not considered.
+  *
+  * @param index [int]
+  * @returns int
+  */
+int MsaWindow::undoCommandMemoryUsage(int index) const
+{
+    const AbstractSubseqChangeCommand *command = dynamic_cast<const AbstractSubseqChangeCommand *>(undoStack_->command(index));
+    if (command == nullptr)
+        return 0;
+
+    return command->changeRecordMemoryUsage();
+}
@@ -9,6 +9,7 @@
 #ifndef MSAWINDOW_H
 #define MSAWINDOW_H
 
+#include <QtCore/QVector>
 #include <QtGui/QMainWindow>
 #include "../../core/util/PosiRect.h"
 #include "../../core/global.h"
@@ -134,6 +135,7 @@ private Q_SLOTS:
     void onActionGapTool();
 
     void enableDisableActions();
+    void enforceUndoMemoryBudget();             // Compresses the change records of older commands on the undo stack
 
     void onMsaGapColumnsInsertFinished(const ClosedIntRange &columns, bool normal);
 
@@ -175,6 +177,7 @@ private:
     void saveMsaRegionAsImage(const QString &fileName, const PosiRect &msaRegion);
     QStringList msaLabels(const ClosedIntRange &sequenceRange) const;
     qreal maxStringWidth(const QFont &font, const QStringList &strings) const;
+    int undoCommandMemoryUsage(int index) const;    // Returns the change record memory usage of the undo command at index
 
     Adoc *adoc_;
     AbstractMsaSPtr abstractMsa_;
@@ -202,6 +205,12 @@ private:
 
     // Info content label
     QLabel *totalInfoContentLabel_;
+
+    // Undo memory budget (see enforceUndoMemoryBudget)
+    QVector<int> undoMemoryUsages_;             // Change record memory usage of each command on the undo stack
+    qint64 undoMemoryUsage_;                    // Sum of undoMemoryUsages_ from undoCompressedCount_ onwards
+    int undoCompressedCount_;                   // Number of commands at the bottom of the undo stack that are compressed
+    int undoIndex_;                             // Index of the undo stack when the budget was last enforced
 };
 
 #endif // MSAWINDOW_H
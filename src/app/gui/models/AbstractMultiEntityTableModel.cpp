@@ -588,6 +588,11 @@ void AbstractMultiEntityTableModel::setRoot(const QModelIndex &rootIndex)
     if (rootIndex.isValid() && rootIndex_ == rootIndex)
         return;
 
+    // Read any children of the new root that have not yet been read from the data source. This is done before the
+    // reset so that they are not also treated as newly inserted rows.
+    if (adocTreeModel_->canFetchMore(rootIndex))
+        adocTreeModel_->fetchMore(rootIndex);
+
     beginResetModel();
     resetVariables();
 
@@ -614,6 +619,7 @@ void AbstractMultiEntityTableModel::setRoot(const QModelIndex &rootIndex)
             if (newData.isEmpty() == false)
             {
                 loadRequestManager_.reset(new LoadRequestManager(newData));
+                prefetchNodes(loadRequestManager_->peekBatch());
                 loadTimer_->start();  // Calls processLoadRequest() repeatedly until there is no more data chunks
                                       // to be loaded
             }
@@ -990,6 +996,12 @@ void AbstractMultiEntityTableModel::processLoadRequest()
 
     QVector<LoadRequestChunk> loadRequestChunkVector = loadRequestManager_->nextBatch();
     ASSERT(loadRequestChunkVector.isEmpty() == false);
+
+    // Read the following batch in the background while this batch is processed so that it is (hopefully) ready by
+    // the next time this method is called
+    if (loadRequestManager_->isDone() == false)
+        prefetchNodes(loadRequestManager_->peekBatch());
+
     foreach (const LoadRequestChunk &loadRequestChunk, loadRequestChunkVector)
     {
         ASSERT(loadRequestChunk.nodeType_ != eUndefinedNode);
@@ -1226,6 +1238,32 @@ void AbstractMultiEntityTableModel::findAddNodes(AdocNodeType adocNodeType, cons
     loadingContainer_.entities_ << newEntities;
 }
 
+/**
+  * Requests that the repositories read ahead the entities referenced by loadRequestChunkVector so that a subsequent
+  * findAddNodes of the same chunks does not block on the data source.
+  *
+  * @param loadRequestChunkVector [const QVector<LoadRequestChunk> &]
+  */
+void AbstractMultiEntityTableModel::prefetchNodes(const QVector<LoadRequestChunk> &loadRequestChunkVector) const
+{
+    foreach (const LoadRequestChunk &loadRequestChunk, loadRequestChunkVector)
+    {
+        if (loadRequestChunk.nodeType_ == eGroupNode)
+            continue;
+
+        IRepository *repository = repositoryForNodeType(loadRequestChunk.nodeType_);
+        if (repository == nullptr)
+            continue;
+
+        QVector<int> entityIds;
+        entityIds.reserve(loadRequestChunk.end_ - loadRequestChunk.start_ + 1);
+        for (int i=loadRequestChunk.start_; i <= loadRequestChunk.end_; ++i)
+            entityIds << loadRequestChunk.nodeVector_.at(i)->entityId();
+
+        repository->prefetch(entityIds);
+    }
+}
+
 /**
   * @param entity [IEntitySPtr &]
   * @param column [int]
@@ -32,6 +32,7 @@ class AdocTreeModel;
 class IColumnAdapter;
 class IRepository;
 class LoadRequestManager;
+struct LoadRequestChunk;
 
 /**
   * Models groups and entities.
@@ -166,6 +167,7 @@ private:
     QHash<AdocNodeType, AdocTreeNodeVector> extractAcceptableNodes(const AdocTreeNode *parent, int start, int end) const;
     void findAddNodes(const QHash<AdocNodeType, AdocTreeNodeVector> &entityNodeHash);
     void findAddNodes(AdocNodeType adocNodeType, const AdocTreeNodeVector &adocTreeNodeVector, int start, int end);
+    void prefetchNodes(const QVector<LoadRequestChunk> &loadRequestChunkVector) const;
     QModelIndex indexFromEntity(const IEntitySPtr &entity, int column = 0) const;
     QModelIndex indexFromGroupNode(AdocTreeNode *groupNode, int column = 0) const;
     int mapEntityColumn(int entityType, int entityColumn) const;            // Returns the model column corresponding to entityColumn for entityType or constants::kInvalidColumn if not found
@@ -342,6 +344,15 @@ public:
         return loadRequestChunkVector;
     }
 
+    // Returns the chunks that the next call to nextBatch will return without consuming them
+    QVector<LoadRequestChunk> peekBatch() const
+    {
+        ASSERT(isDone() == false);
+
+        LoadRequestManager copy(*this);
+        return copy.nextBatch();
+    }
+
 private:
     AdocNodeType getUnfinishedType() const
     {
@@ -20,6 +20,7 @@
 
 #include "../util/ModelIndexRange.h"
 
+#include "../../core/DataSources/IAdocSource.h"
 #include "../../core/global.h"
 #include "../../core/macros.h"
 
@@ -32,7 +33,7 @@
   * @param parent [QObject *]
   */
 AdocTreeModel::AdocTreeModel(QObject *parent)
-    : AbstractBaseTreeModel<AdocTreeNode>(parent), undoStack_(nullptr)
+    : AbstractBaseTreeModel<AdocTreeNode>(parent), undoStack_(nullptr), adocSource_(nullptr)
 {
 }
 
@@ -40,6 +41,16 @@ AdocTreeModel::AdocTreeModel(QObject *parent)
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 // Public methods
+/**
+  * @param parent [const QModelIndex &]
+  * @returns bool
+  */
+bool AdocTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    AdocTreeNode *node = nodeFromIndex(parent);
+    return adocSource_ != nullptr && node != nullptr && node->canFetchChildren();
+}
+
 /**
   * @param parent [const QModelIndex &]
   * @returns int
@@ -84,6 +95,14 @@ QVariant AdocTreeModel::data(const QModelIndex &index, int role) const
     return QVariant();
 }
 
+/**
+  * @param parent [const QModelIndex &]
+  */
+void AdocTreeModel::fetchMore(const QModelIndex &parent)
+{
+    fetchChildren(nodeFromIndex(parent));
+}
+
 /**
   * @param index [const QModelIndex &]
   * @returns Qt::ItemFlags
@@ -105,6 +124,21 @@ Qt::ItemFlags AdocTreeModel::flags(const QModelIndex &index) const
     return flags;
 }
 
+/**
+  * Nodes with children that have not yet been fetched also have children so that views will offer to expand them.
+  *
+  * @param parent [const QModelIndex &]
+  * @returns bool
+  */
+bool AdocTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    AdocTreeNode *node = nodeFromIndex(parent);
+    if (node == nullptr)
+        return false;
+
+    return node->hasChildren() || node->canFetchChildren();
+}
+
 /**
   * @param index [const QModelIndex &]
   * @param value [const QVariant &]
@@ -214,6 +248,22 @@ void AdocTreeModel::setRoot(AdocTreeNode *root)
     endResetModel();
 }
 
+/**
+  * @returns IAdocSource *
+  */
+IAdocSource *AdocTreeModel::adocSource() const
+{
+    return adocSource_;
+}
+
+/**
+  * @param adocSource [IAdocSource *]
+  */
+void AdocTreeModel::setAdocSource(IAdocSource *adocSource)
+{
+    adocSource_ = adocSource;
+}
+
 /**
   * @param node [AdocTreeNode *]
   * @param parent [const QModelIndex &]
@@ -418,6 +468,9 @@ bool AdocTreeModel::removeRows(const QModelIndexList &indices)
     ASSERT(srcParentNode != nullptr);
     if (undoStack_ != nullptr)
     {
+        foreach (const ModelIndexRange &range, indexRanges)
+            fetchDescendants(srcParentNode->childrenBetween(range.start_, range.start_ + range.count_ - 1));
+
         // We deal with the undo stack here (rather than simply calling removeRows) for grouping multiple index ranges
         // into a single undo command.
         QUndoCommand *masterCommand = new QUndoCommand(QString("Removing %1 row(s)").arg(indices.size()));
@@ -455,11 +508,16 @@ bool AdocTreeModel::removeRows(const QModelIndexList &indices)
   */
 bool AdocTreeModel::removeRows(int row, int count, const QModelIndex &parent)
 {
+    // Read all descendants before they are removed so that listeners (e.g. the AdocTreeNodeEraserService) see the
+    // complete subtrees and so that these may be restored in full
+    AdocTreeNode *parentNode = nodeFromIndex(parent);
+    if (parentNode != nullptr && count > 0)
+        fetchDescendants(parentNode->childrenBetween(row, row + count - 1));
+
     if (undoStack_ != nullptr)
     {
         ASSERT(count > 0);
 
-        AdocTreeNode *parentNode = nodeFromIndex(parent);
         if (parentNode == nullptr)
             return false;
 
@@ -571,6 +629,9 @@ int AdocTreeModel::addRows(const AdocTreeNodeVector &nodes, AdocTreeNode *parent
     ASSERT(parentNode != nullptr);
     ASSERT(nodes.isEmpty() == false);
 
+    // Existing children must be read first so that the new nodes follow them
+    fetchChildren(parentNode);
+
     emit nodesAboutToBeAdded(nodes);
 
     // No check is done to verify that these nodes are not already present in the tree
@@ -583,6 +644,55 @@ int AdocTreeModel::addRows(const AdocTreeNodeVector &nodes, AdocTreeNode *parent
     return row;
 }
 
+/**
+  * Reads the children of parentNode from the data source if they have not already been read. Because these nodes are
+  * already part of the document, nodesAboutToBeAdded is not emitted.
+  *
+  * @param parentNode [AdocTreeNode *]
+  */
+void AdocTreeModel::fetchChildren(AdocTreeNode *parentNode)
+{
+    if (adocSource_ == nullptr || parentNode == nullptr || !parentNode->canFetchChildren())
+        return;
+
+    AdocTreeNodeVector children;
+    try
+    {
+        children = adocSource_->readEntityTreeChildren(parentNode);
+    }
+    catch (...)
+    {
+        qDebug() << Q_FUNC_INFO << "Unable to read the children of node" << parentNode->nodeId();
+        return;
+    }
+
+    parentNode->setCanFetchChildren(false);
+    if (children.isEmpty())
+        return;
+
+    int row = parentNode->childCount();
+    beginInsertRows(indexFromNode(parentNode), row, row + children.size() - 1);
+    parentNode->appendChildren(children);
+    endInsertRows();
+}
+
+/**
+  * @param nodes [const AdocTreeNodeVector &]
+  */
+void AdocTreeModel::fetchDescendants(const AdocTreeNodeVector &nodes)
+{
+    AdocTreeNodeVector stack = nodes;
+    while (!stack.isEmpty())
+    {
+        AdocTreeNode *node = stack.last();
+        stack.pop_back();
+
+        fetchChildren(node);
+        for (int i=0, z=node->childCount(); i<z; ++i)
+            stack << node->childAt(i);
+    }
+}
+
 /**
   * @param srcRow [int]
   * @param count [int]
@@ -594,6 +704,7 @@ int AdocTreeModel::moveRows(int srcRow, int count, AdocTreeNode *srcParentNode,
 {
     ASSERT(srcRow >= 0 && srcRow + count - 1 < srcParentNode->childCount());
 
+    fetchChildren(dstParentNode);
     int dstRow = dstParentNode->childCount();
     beginMoveRows(indexFromNode(srcParentNode), srcRow, srcRow + count - 1, indexFromNode(dstParentNode), dstRow);
     AdocTreeNodeVector nodes = srcParentNode->takeChildren(srcRow, count);
@@ -690,6 +801,8 @@ AdocTreeNodeVector AdocTreeModel::takeRows(int row, int count, const QModelIndex
     ASSERT(row >= 0 && row < parentNode->childCount());
     ASSERT(row + count <= parentNode->childCount());
 
+    fetchDescendants(parentNode->childrenBetween(row, row + count - 1));
+
     beginRemoveRows(parent, row, row + count - 1);
     AdocTreeNodeVector removedNodes = parentNode->takeChildren(row, count);
     endRemoveRows();
@@ -21,6 +21,8 @@
 // Forward declarations
 class QUndoStack;
 
+class IAdocSource;
+
 /**
   */
 class AdocTreeModel : public AbstractBaseTreeModel<AdocTreeNode>
@@ -30,9 +32,12 @@ class AdocTreeModel : public AbstractBaseTreeModel<AdocTreeNode>
 public:
     explicit AdocTreeModel(QObject *parent = 0);
 
+    bool canFetchMore(const QModelIndex &parent) const;
     int columnCount(const QModelIndex &parent = QModelIndex()) const;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
+    void fetchMore(const QModelIndex &parent);
     Qt::ItemFlags flags(const QModelIndex &index) const;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole);
 
     // Drag and drop
@@ -44,6 +49,10 @@ public:
     AdocTreeNode *root() const;
     void setRoot(AdocTreeNode *root);
 
+    // Nodes whose children have not been read are fetched from adocSource as needed
+    IAdocSource *adocSource() const;
+    void setAdocSource(IAdocSource *adocSource);
+
     bool appendRow(AdocTreeNode *node, const QModelIndex &parent);
     bool appendRows(const AdocTreeNodeVector &nodes, const QModelIndex &parent);
     void cutRows(const QModelIndexList &indices);
@@ -77,12 +86,15 @@ protected:
 private:
     int addRows(const AdocTreeNodeVector &nodes, AdocTreeNode *parentNode);
     bool destroyRows(int row, int count, const QModelIndex &parent);
+    void fetchChildren(AdocTreeNode *parentNode);
+    void fetchDescendants(const AdocTreeNodeVector &nodes);
     int moveRows(int srcRow, int count, AdocTreeNode *srcParentNode, AdocTreeNode *dstParentNode);
     bool moveRows(const QModelIndexList &modelIndexList, AdocTreeNode *dstParentNode);
     bool moveRows(const QVector<QPersistentModelIndex> &persistentModelIndexList, AdocTreeNode *dstParentNode);
     AdocTreeNodeVector takeRows(int row, int count, const QModelIndex &parent);
 
     QUndoStack *undoStack_;
+    IAdocSource *adocSource_;
 
     // Cut-Copy-Paste control
     QVector<QPersistentModelIndex> cutOrCopyIndices_;
@@ -11,6 +11,7 @@
 #include "PrimerSearchParameters.h"
 #include "ThermodynamicCalculator.h"
 #include "../core/DnaPattern.h"
+#include "../core/PackedDnaString.h"
 #include "../core/macros.h"
 
 #include <QtDebug>
@@ -59,6 +60,10 @@ QVector<PrimerPair> PrimerPairFinder::findPrimerPairs(const BioString &dnaString
         return QVector<PrimerPair>();
 
     int absMaxPrimerStart = absoluteMaxPrimerStart(range);
+    // Both strands are checked for primer uniqueness against the same packed copy, and the reverse strand is only
+    // constructed once
+    PackedDnaString packedDnaString(dnaString);
+    BioString reverseComplement = dnaString.reverseComplement();
     QVector<LitePrimer> forwardLitePrimers;
     QVector<LitePrimer> reverseLitePrimers;
 
@@ -69,6 +74,7 @@ QVector<PrimerPair> PrimerPairFinder::findPrimerPairs(const BioString &dnaString
             continue;
 
         forwardLitePrimers << findCompatibleLitePrimers(dnaString,
+                                                        packedDnaString,
                                                         acgtRange,
                                                         absMaxPrimerStart,
                                                         primerSearchParameters.forwardRestrictionEnzyme_,
@@ -77,7 +83,8 @@ QVector<PrimerPair> PrimerPairFinder::findPrimerPairs(const BioString &dnaString
         // Invert the range for the reverse direction
         ClosedIntRange reverseRange(dnaString.length() - acgtRange.end_ + 1,
                                     dnaString.length() - acgtRange.begin_ + 1);
-        reverseLitePrimers << findCompatibleLitePrimers(dnaString.reverseComplement(),
+        reverseLitePrimers << findCompatibleLitePrimers(reverseComplement,
+                                                        packedDnaString,
                                                         reverseRange,
                                                         absMaxPrimerStart,
                                                         primerSearchParameters.reverseRestrictionEnzyme_,
@@ -143,8 +150,10 @@ QVector<ClosedIntRange> PrimerPairFinder::findACGTRangesWithin(const BioString &
   * uniqueness constraints.
   *
   * dnaString must be in the 5' -> 3' orientation! Similarly, range must also be relevant to the 5' -> 3' direction.
+  * packedDnaString may be a packed copy of either dnaString or its reverse complement.
   *
   * @param dnaString [const BioString &]
+  * @param packedDnaString [const PackedDnaString &]
   * @param range [const ClosedIntRange &]
   * @param absoluteMaxPrimerStart [const int]
   * @param primerLengthRange [const ClosedIntRange &]
@@ -157,6 +166,7 @@ QVector<ClosedIntRange> PrimerPairFinder::findACGTRangesWithin(const BioString &
   */
 QVector<PrimerPairFinder::LitePrimer>
 PrimerPairFinder::findCompatibleLitePrimers(const BioString &dnaString,
+                                            const PackedDnaString &packedDnaString,
                                             const ClosedIntRange &range,
                                             const int absoluteMaxPrimerStart,
                                             const RestrictionEnzyme &restrictionEnzyme,
@@ -167,7 +177,6 @@ PrimerPairFinder::findCompatibleLitePrimers(const BioString &dnaString,
     const double sodiumConcentration = primerSearchParameters_.sodiumConcentration_;
     const double primerDnaConcentration = primerSearchParameters_.primerDnaConcentration_;
 
-    BioString fullRCString = dnaString.reverseComplement(); // Used for searching for unique primers
     BioString searchString = dnaString.mid(range);
 
     // Translation is the amount to add to both positions of a compatible primer to map its coordinates back to
@@ -190,6 +199,9 @@ PrimerPairFinder::findCompatibleLitePrimers(const BioString &dnaString,
             x += reSiteLength;
         }
 
+        // Primers that satisfy the terminal pattern and melting temperature constraints, and their core sequences
+        QVector<LitePrimer> candidatePrimers;
+        QVector<BioString> candidateCores;
         int localMaxPrimerStart = qMin(absoluteMaxPrimerStart, range.length() - primerLength);
         for (int j=1; !canceled_ && j<= localMaxPrimerStart; ++j)
         {
@@ -205,12 +217,18 @@ PrimerPairFinder::findCompatibleLitePrimers(const BioString &dnaString,
             if (!tmRange.contains(tm))
                 continue;
 
-            // Make sure the core primer sequence only occurs once in both strands
-            if (dnaString.count(x) + fullRCString.count(x) != 1)
-                continue;
-
-            compatiblePrimers << LitePrimer(tm, ClosedIntRange(j + translation, (j + primerLength - 1) + translation));
+            candidatePrimers << LitePrimer(tm, ClosedIntRange(j + translation, (j + primerLength - 1) + translation));
+            candidateCores << BioString(x, eDnaGrammar);
         }
+
+        if (canceled_)
+            break;
+
+        // Make sure the core primer sequence only occurs once in both strands
+        QVector<int> nOccurrences = countOnBothStrands(candidateCores, dnaString, packedDnaString);
+        for (int i=0, z=candidatePrimers.size(); i<z; ++i)
+            if (nOccurrences.at(i) == 1)
+                compatiblePrimers << candidatePrimers.at(i);
     }
 
     // Each of the locations in LitePrimer is with respect to searchString - not the original dnaString (unless the
@@ -280,6 +298,31 @@ QVector<PrimerPair> PrimerPairFinder::findCompatiblePrimerPairs(const QVector<Li
     return compatiblePrimerPairs;
 }
 
+/**
+  * Cores of up to PackedDnaString::kMaxKmerLength characters are all counted in a single pass over packedDnaString.
+  * Longer cores are counted individually in dnaString and its reverse complement.
+  *
+  * @param cores [const QVector<BioString> &]
+  * @param dnaString [const BioString &]
+  * @param packedDnaString [const PackedDnaString &]
+  * @returns QVector<int>
+  */
+QVector<int> PrimerPairFinder::countOnBothStrands(const QVector<BioString> &cores,
+                                                 const BioString &dnaString,
+                                                 const PackedDnaString &packedDnaString) const
+{
+    if (cores.isEmpty() || cores.first().length() <= PackedDnaString::kMaxKmerLength)
+        return packedDnaString.countOnBothStrands(cores);
+
+    BioString fullRCString = dnaString.reverseComplement();
+    QVector<int> nOccurrences;
+    nOccurrences.reserve(cores.size());
+    foreach (const BioString &core, cores)
+        nOccurrences << dnaString.count(core) + fullRCString.count(core);
+
+    return nOccurrences;
+}
+
 /**
   * @param nucleotide [const char]
   * @returns bool
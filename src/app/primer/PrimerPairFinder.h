@@ -16,6 +16,7 @@
 
 class BioString;
 class DnaPattern;
+class PackedDnaString;
 
 /**
   * Only works on stretches of DNA sequence comprised of ACGT.
@@ -43,6 +44,7 @@ private:
     bool rangeIsLessThanMinimumPrimerLength(const ClosedIntRange &range) const;
     QVector<ClosedIntRange> findACGTRangesWithin(const BioString &dnaString, const ClosedIntRange &range) const;
     QVector<LitePrimer> findCompatibleLitePrimers(const BioString &dnaString,
+                                                  const PackedDnaString &packedDnaString,
                                                   const ClosedIntRange &range,
                                                   const int absoluteMaxPrimerStart,
                                                   const RestrictionEnzyme &restrictionEnzyme,
@@ -50,6 +52,8 @@ private:
     QVector<PrimerPair> findCompatiblePrimerPairs(const QVector<LitePrimer> &forwardPrimers,
                                                   const QVector<LitePrimer> &reversePrimers,
                                                   const BioString &dnaString);
+    //! Returns the number of times each of cores occurs in dnaString and its reverse complement (packed in packedDnaString)
+    QVector<int> countOnBothStrands(const QVector<BioString> &cores, const BioString &dnaString, const PackedDnaString &packedDnaString) const;
     bool isACGT(const char nucleotide) const;
 
 
@@ -25,6 +25,7 @@ SOURCES += TestPrimerPairFinder.cpp \
            ../../core/util/ClosedIntRange.cpp \
            ../../core/BioString.cpp \
            ../../core/DnaPattern.cpp \
+           ../../core/PackedDnaString.cpp \
            ../../core/misc.cpp \
            ../../core/constants.cpp
 